@@ -30,6 +30,7 @@
         _compile_perf_trampoline_pre_fork,
         _get_entire_call_stack_as_qualnames_with_lineno_and_frame,
         _get_entire_call_stack_as_qualnames_with_lineno,
+        _get_shadow_code,
         _is_compile_perf_trampoline_pre_fork_enabled,
         clear_all_shadow_caches,
         clear_caches,
@@ -40,6 +41,8 @@
         get_and_clear_type_profiles_with_metadata,
         get_and_clear_type_profiles,
         get_parallel_gc_settings,
+        get_parallel_gc_stats,
+        set_parallel_gc_slice_budget,
         set_profile_interp_all,
         set_profile_interp_period,
         set_profile_interp,
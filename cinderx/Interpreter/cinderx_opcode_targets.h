@@ -149,10 +149,10 @@ static void *opcode_targets[256] = {
     &&TARGET_MAP_ADD,
     &&TARGET_LOAD_CLASSDEREF,
     &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
+    &&TARGET_STORE_SUBSCR_DICT,
+    &&TARGET_STORE_SUBSCR_LIST,
     &&TARGET_MATCH_CLASS,
-    &&_unknown_opcode,
+    &&TARGET_CALL_FUNCTION_BUILTIN,
     &&TARGET_SETUP_ASYNC_WITH,
     &&TARGET_FORMAT_VALUE,
     &&TARGET_BUILD_CONST_KEY_MAP,
@@ -166,13 +166,13 @@ static void *opcode_targets[256] = {
     &&TARGET_DICT_MERGE,
     &&TARGET_DICT_UPDATE,
     &&TARGET_STORE_FIELD,
-    &&_unknown_opcode,
+    &&TARGET_CALL_FUNCTION_PY,
     &&TARGET_BUILD_CHECKED_LIST,
     &&TARGET_LOAD_TYPE,
     &&TARGET_CAST,
     &&TARGET_LOAD_LOCAL,
     &&TARGET_STORE_LOCAL,
-    &&_unknown_opcode,
+    &&TARGET_FOR_ITER_TUPLE,
     &&TARGET_PRIMITIVE_BOX,
     &&TARGET_POP_JUMP_IF_ZERO,
     &&TARGET_POP_JUMP_IF_NONZERO,
@@ -187,7 +187,7 @@ static void *opcode_targets[256] = {
     &&TARGET_JUMP_IF_NONZERO_OR_POP,
     &&TARGET_FAST_LEN,
     &&TARGET_CONVERT_PRIMITIVE,
-    &&_unknown_opcode,
+    &&TARGET_FOR_ITER_RANGE,
     &&TARGET_INVOKE_NATIVE,
     &&TARGET_LOAD_CLASS,
     &&TARGET_BUILD_CHECKED_MAP,
@@ -200,10 +200,10 @@ static void *opcode_targets[256] = {
     &&TARGET_LOAD_METHOD_SUPER,
     &&TARGET_LOAD_ATTR_SUPER,
     &&TARGET_TP_ALLOC,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
+    &&TARGET_BINARY_ADD_INT,
+    &&TARGET_BINARY_ADD_FLOAT,
+    &&TARGET_COMPARE_OP_INT,
+    &&TARGET_COMPARE_OP_STR,
     &&TARGET_LOAD_METHOD_UNSHADOWED_METHOD,
     &&TARGET_LOAD_METHOD_TYPE_METHODLIKE,
     &&TARGET_BUILD_CHECKED_LIST_CACHED,
@@ -213,7 +213,7 @@ static void *opcode_targets[256] = {
     &&TARGET_INVOKE_FUNCTION_CACHED,
     &&TARGET_INVOKE_FUNCTION_INDIRECT_CACHED,
     &&TARGET_BUILD_CHECKED_MAP_CACHED,
-    &&_unknown_opcode,
+    &&TARGET_FOR_ITER_LIST,
     &&TARGET_PRIMITIVE_STORE_FAST,
     &&TARGET_CAST_CACHED_OPTIONAL,
     &&TARGET_CAST_CACHED,
@@ -16,6 +16,17 @@
 
 #define PYSHADOW_INIT_THRESHOLD 50
 
+/* Count a back-edge to the loop header at instruction index `target`, and move
+   the frame into JIT-compiled code once the loop is hot. */
+#define OSR_BACKEDGE(target) \
+    do { \
+        if (osr_countdown > 0 && (int)(target) < INSTR_OFFSET() && \
+            --osr_countdown == 0) { \
+            osr_loop_header = (target); \
+            goto osr_enter; \
+        } \
+    } while (0)
+
 PyObject *Ci_GetAIter(PyThreadState *tstate, PyObject *obj) {
     unaryfunc getter = NULL;
     PyObject *iter = NULL;
@@ -449,6 +460,13 @@ Ci_EvalFrame(PyThreadState *tstate, PyFrameObject *f, int throwflag)
        FOR_ITER is effectively a single opcode and f->f_lasti will point
        to the beginning of the combined pair.)
     */
+    /* Only frames starting from the top are moved into JIT-compiled code, which
+       keeps frames resumed by a deopt from re-entering the same compiled loop
+       (and growing the C stack) every time. */
+    unsigned osr_countdown =
+        f->f_lasti == -1 && f->f_gen == NULL ? _PyJIT_OSRThreshold() : 0;
+    int osr_loop_header = 0;
+
     assert(f->f_lasti >= -1);
     next_instr = first_instr + f->f_lasti + 1;
     stack_pointer = f->f_valuestack + f->f_stackdepth;
@@ -848,6 +866,10 @@ f->lazy_imports_cache_seq = -1;
                http://bugs.python.org/issue10044 for the discussion. In short,
                no patch shown any impact on a realistic benchmark, only a minor
                speedup on microbenchmarks. */
+            if (shadow.shadow != NULL) {
+                _PyShadow_QuickenBinaryAdd(
+                    &shadow, next_instr, left, right, oparg);
+            }
             if (PyUnicode_CheckExact(left) &&
                      PyUnicode_CheckExact(right)) {
                 sum = unicode_concatenate(tstate, left, right, f, next_instr);
@@ -1062,6 +1084,12 @@ f->lazy_imports_cache_seq = -1;
             PyObject *right = POP();
             PyObject *left = TOP();
             PyObject *sum;
+            if (shadow.shadow != NULL) {
+                /* int and float have no in-place add, so the BINARY_ADD
+                   specializations apply unchanged. */
+                _PyShadow_QuickenBinaryAdd(
+                    &shadow, next_instr, left, right, oparg);
+            }
             if (PyUnicode_CheckExact(left) && PyUnicode_CheckExact(right)) {
                 sum = unicode_concatenate(tstate, left, right, f, next_instr);
                 /* unicode_concatenate consumed the ref to left */
@@ -1154,6 +1182,10 @@ f->lazy_imports_cache_seq = -1;
             PyObject *container = SECOND();
             PyObject *v = THIRD();
             int err;
+            if (shadow.shadow != NULL) {
+                _PyShadow_QuickenStoreSubscr(
+                    &shadow, next_instr, container, sub, oparg);
+            }
             STACK_SHRINK(3);
             /* container[sub] = v */
             err = PyObject_SetItem(container, sub, v);
@@ -2121,6 +2153,10 @@ f->lazy_imports_cache_seq = -1;
             assert(oparg <= Py_GE);
             PyObject *right = POP();
             PyObject *left = TOP();
+            if (shadow.shadow != NULL) {
+                _PyShadow_QuickenCompareOp(
+                    &shadow, next_instr, left, right, oparg);
+            }
             PyObject *res = PyObject_RichCompare(left, right, oparg);
             SET_TOP(res);
             Py_DECREF(left);
@@ -2306,6 +2342,7 @@ f->lazy_imports_cache_seq = -1;
             }
             if (Py_IsFalse(cond)) {
                 Py_DECREF(cond);
+                OSR_BACKEDGE(oparg);
                 JUMPTO(oparg);
                 CHECK_EVAL_BREAKER();
                 DISPATCH();
@@ -2315,6 +2352,7 @@ f->lazy_imports_cache_seq = -1;
             if (err > 0)
                 ;
             else if (err == 0) {
+                OSR_BACKEDGE(oparg);
                 JUMPTO(oparg);
                 CHECK_EVAL_BREAKER();
             }
@@ -2333,6 +2371,7 @@ f->lazy_imports_cache_seq = -1;
             }
             if (Py_IsTrue(cond)) {
                 Py_DECREF(cond);
+                OSR_BACKEDGE(oparg);
                 JUMPTO(oparg);
                 CHECK_EVAL_BREAKER();
                 DISPATCH();
@@ -2340,6 +2379,7 @@ f->lazy_imports_cache_seq = -1;
             err = PyObject_IsTrue(cond);
             Py_DECREF(cond);
             if (err > 0) {
+                OSR_BACKEDGE(oparg);
                 JUMPTO(oparg);
                 CHECK_EVAL_BREAKER();
             }
@@ -2401,6 +2441,7 @@ f->lazy_imports_cache_seq = -1;
 
         case TARGET(JUMP_ABSOLUTE): {
             PREDICTED(JUMP_ABSOLUTE);
+            OSR_BACKEDGE(oparg);
             JUMPTO(oparg);
             CHECK_EVAL_BREAKER();
             DISPATCH();
@@ -2554,6 +2595,9 @@ f->lazy_imports_cache_seq = -1;
             PREDICTED(FOR_ITER);
             /* before: [iter]; after: [iter, iter()] *or* [] */
             PyObject *iter = TOP();
+            if (shadow.shadow != NULL) {
+                _PyShadow_QuickenForIter(&shadow, next_instr, iter, oparg);
+            }
             PyObject *next = (*Py_TYPE(iter)->tp_iternext)(iter);
             if (next != NULL) {
                 PUSH(next);
@@ -2785,6 +2829,13 @@ f->lazy_imports_cache_seq = -1;
         case TARGET(CALL_FUNCTION): {
             PREDICTED(CALL_FUNCTION);
             PyObject **sp, *res;
+            if (shadow.shadow != NULL) {
+                _PyShadow_QuickenCallFunction(&shadow,
+                                              next_instr,
+                                              PEEK(oparg + 1),
+                                              oparg,
+                                              trace_info.cframe.use_tracing);
+            }
             sp = stack_pointer;
             int awaited = IS_AWAITED();
             res = call_function(tstate,
@@ -3563,6 +3614,216 @@ f->lazy_imports_cache_seq = -1;
             DISPATCH();
         }
 
+/* Patch a quickened instruction back to its generic form and run that with
+   the stack left untouched. */
+#define SHADOW_DEOPT()                                          \
+            opcode = _PyShadow_Deoptimize(&shadow, next_instr); \
+            goto dispatch_opcode
+
+        case TARGET(BINARY_ADD_INT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(1);
+            PyObject *sum = PyLong_Type.tp_as_number->nb_add(left, right);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_FLOAT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(1);
+            PyObject *sum = PyFloat_FromDouble(
+                PyFloat_AS_DOUBLE(left) + PyFloat_AS_DOUBLE(right));
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_INT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(1);
+            PyObject *res = PyLong_Type.tp_richcompare(left, right, oparg);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res == NULL)
+                goto error;
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_STR): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyUnicode_CheckExact(left) || !PyUnicode_CheckExact(right)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(1);
+            PyObject *res = PyUnicode_RichCompare(left, right, oparg);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res == NULL)
+                goto error;
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(FOR_ITER_LIST): {
+            PyObject *iter = TOP();
+            if (!Py_IS_TYPE(iter, &PyListIter_Type)) {
+                SHADOW_DEOPT();
+            }
+            PyObject *next = _PyShadow_SeqIterNext(iter, 1);
+            if (next != NULL) {
+                PUSH(next);
+                PREDICT(STORE_FAST);
+                PREDICT(UNPACK_SEQUENCE);
+                DISPATCH();
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            JUMPBY(oparg);
+            DISPATCH();
+        }
+
+        case TARGET(FOR_ITER_TUPLE): {
+            PyObject *iter = TOP();
+            if (!Py_IS_TYPE(iter, &PyTupleIter_Type)) {
+                SHADOW_DEOPT();
+            }
+            PyObject *next = _PyShadow_SeqIterNext(iter, 0);
+            if (next != NULL) {
+                PUSH(next);
+                PREDICT(STORE_FAST);
+                PREDICT(UNPACK_SEQUENCE);
+                DISPATCH();
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            JUMPBY(oparg);
+            DISPATCH();
+        }
+
+        case TARGET(FOR_ITER_RANGE): {
+            PyObject *iter = TOP();
+            if (!Py_IS_TYPE(iter, &PyRangeIter_Type)) {
+                SHADOW_DEOPT();
+            }
+            PyObject *next = _PyShadow_RangeIterNext(iter);
+            if (next != NULL) {
+                PUSH(next);
+                PREDICT(STORE_FAST);
+                PREDICT(UNPACK_SEQUENCE);
+                DISPATCH();
+            }
+            if (_PyErr_Occurred(tstate)) {
+                goto error;
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            JUMPBY(oparg);
+            DISPATCH();
+        }
+
+/* Call the function under the arguments on the stack through its vectorcall
+   entry point, skipping the generic dispatch in PyObject_Vectorcall. */
+#define SHADOW_CALL_FUNCTION(func, vectorcall)                              \
+            int awaited = IS_AWAITED();                                     \
+            size_t nargsf = (size_t)oparg | PY_VECTORCALL_ARGUMENTS_OFFSET | \
+                            (awaited ? Ci_Py_AWAITED_CALL_MARKER : 0);      \
+            PyObject *res = (vectorcall)(                                   \
+                (func), stack_pointer - oparg, nargsf, NULL);               \
+            res = _Py_CheckFunctionResult(tstate, (func), res, NULL);       \
+            for (int i = 0; i <= oparg; i++) {                              \
+                Py_DECREF(POP());                                           \
+            }                                                               \
+            if (res == NULL) {                                              \
+                PUSH(NULL);                                                 \
+                goto error;                                                 \
+            }                                                               \
+            if (awaited && Ci_PyWaitHandle_CheckExact(res)) {               \
+                DISPATCH_EAGER_CORO_RESULT(res, PUSH);                      \
+            }                                                               \
+            assert(!Ci_PyWaitHandle_CheckExact(res));                       \
+            PUSH(res);                                                      \
+            CHECK_EVAL_BREAKER();                                           \
+            DISPATCH();
+
+        case TARGET(CALL_FUNCTION_PY): {
+            PyObject *func = PEEK(oparg + 1);
+            if (!PyFunction_Check(func)) {
+                SHADOW_DEOPT();
+            }
+            SHADOW_CALL_FUNCTION(func, ((PyFunctionObject *)func)->vectorcall);
+        }
+
+        case TARGET(CALL_FUNCTION_BUILTIN): {
+            PyObject *func = PEEK(oparg + 1);
+            /* Builtin calls are reported to profile and trace functions,
+               which only the generic path does. */
+            if (!PyCFunction_CheckExact(func) ||
+                ((PyCFunctionObject *)func)->vectorcall == NULL ||
+                trace_info.cframe.use_tracing) {
+                SHADOW_DEOPT();
+            }
+            SHADOW_CALL_FUNCTION(func, ((PyCFunctionObject *)func)->vectorcall);
+        }
+
+        case TARGET(STORE_SUBSCR_LIST): {
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            PyObject *v = THIRD();
+            if (!PyList_CheckExact(container) || !PyLong_CheckExact(sub)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(3);
+            int err = _PyShadow_StoreSubscrList(container, sub, v);
+            Py_DECREF(v);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            if (err != 0)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(STORE_SUBSCR_DICT): {
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            PyObject *v = THIRD();
+            if (!PyDict_CheckExact(container)) {
+                SHADOW_DEOPT();
+            }
+            STACK_SHRINK(3);
+            int err = PyDict_SetItem(container, sub, v);
+            Py_DECREF(v);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            if (err != 0)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(EXTENDED_ARG): {
             int oldoparg = oparg;
             NEXTOPARG();
@@ -4212,7 +4473,7 @@ f->lazy_imports_cache_seq = -1;
                   (oparg == FAST_LEN_DICT && PyDict_CheckExact(collection)) ||
                   (oparg == FAST_LEN_SET && PyAnySet_CheckExact(collection)) ||
                   (oparg == FAST_LEN_TUPLE && PyTuple_CheckExact(collection)) ||
-                  (oparg == FAST_LEN_ARRAY && PyStaticArray_CheckExact(collection)) ||
+                  (oparg == FAST_LEN_ARRAY && PyStaticArray_Check(collection)) ||
                   (oparg == FAST_LEN_STR && PyUnicode_CheckExact(collection))) {
                 inexact = 0;
               }
@@ -4364,7 +4625,7 @@ f->lazy_imports_cache_seq = -1;
                     Py_DECREF(idx);
                     goto error;
                 }
-            } else if (oparg == SEQ_ARRAY_INT64) {
+            } else if (_Py_IS_TYPED_ARRAY(oparg)) {
                 item = _Ci_StaticArray_Get(sequence, val);
                 Py_DECREF(sequence);
                 if (item == NULL) {
@@ -4430,12 +4691,12 @@ f->lazy_imports_cache_seq = -1;
                         goto error;
                     }
                 }
-            } else if (oparg == SEQ_ARRAY_INT64) {
+            } else if (_Py_IS_TYPED_ARRAY(oparg)) {
                 err = _Ci_StaticArray_Set(sequence, idx, v);
 
+                Py_DECREF(v);
                 Py_DECREF(sequence);
                 if (err != 0) {
-                    Py_DECREF(v);
                     goto error;
                 }
             } else {
@@ -4874,6 +5135,18 @@ f->lazy_imports_cache_seq = -1;
            or goto error. */
         Py_UNREACHABLE();
 
+osr_enter:
+        switch (_PyJIT_OSREnter(f, osr_loop_header, stack_pointer, &retval)) {
+            case 1:
+                /* The frame ran to completion in JIT-compiled code. */
+                goto exit_eval_frame;
+            case 0:
+                JUMPTO(osr_loop_header);
+                DISPATCH();
+            default:
+                goto error;
+        }
+
 error:
         /* Double-check exception status. */
 #ifdef NDEBUG
@@ -5319,6 +5592,19 @@ PyEntry_AutoJIT(PyFunctionObject *func,
       }
     }
 
+    if (_PyJIT_IsBackgroundCompileEnabled()) {
+      // Keep running in the interpreter while a background worker compiles
+      // the function. The worker swaps in the JIT entry point, with the GIL
+      // held, once the code is ready.
+      if (_PyJIT_ScheduleCompileFunction(func) ==
+          PYJIT_RESULT_PYTHON_EXCEPTION) {
+        return NULL;
+      }
+      func->vectorcall = (vectorcallfunc)PyEntry_LazyInit;
+      PyEntry_initnow(func);
+      return func->vectorcall((PyObject *)func, stack, nargsf, kwnames);
+    }
+
     _PyJIT_Result result = _PyJIT_CompileFunction(func);
     if (result == PYJIT_RESULT_PYTHON_EXCEPTION) {
         return NULL;
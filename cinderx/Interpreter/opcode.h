@@ -125,7 +125,10 @@ extern "C" {
   X(SET_ADD,                         146) \
   X(MAP_ADD,                         147) \
   X(LOAD_CLASSDEREF,                 148) \
+  X(STORE_SUBSCR_DICT,               150) \
+  X(STORE_SUBSCR_LIST,               151) \
   X(MATCH_CLASS,                     152) \
+  X(CALL_FUNCTION_BUILTIN,           153) \
   X(SETUP_ASYNC_WITH,                154) \
   X(FORMAT_VALUE,                    155) \
   X(BUILD_CONST_KEY_MAP,             156) \
@@ -139,11 +142,13 @@ extern "C" {
   X(DICT_MERGE,                      164) \
   X(DICT_UPDATE,                     165) \
   X(STORE_FIELD,                     166) \
+  X(CALL_FUNCTION_PY,                167) \
   X(BUILD_CHECKED_LIST,              168) \
   X(LOAD_TYPE,                       169) \
   X(CAST,                            170) \
   X(LOAD_LOCAL,                      171) \
   X(STORE_LOCAL,                     172) \
+  X(FOR_ITER_TUPLE,                  173) \
   X(PRIMITIVE_BOX,                   174) \
   X(POP_JUMP_IF_ZERO,                175) \
   X(POP_JUMP_IF_NONZERO,             176) \
@@ -158,6 +163,7 @@ extern "C" {
   X(JUMP_IF_NONZERO_OR_POP,          185) \
   X(FAST_LEN,                        186) \
   X(CONVERT_PRIMITIVE,               187) \
+  X(FOR_ITER_RANGE,                  188) \
   X(INVOKE_NATIVE,                   189) \
   X(LOAD_CLASS,                      190) \
   X(BUILD_CHECKED_MAP,               191) \
@@ -170,6 +176,10 @@ extern "C" {
   X(LOAD_METHOD_SUPER,               198) \
   X(LOAD_ATTR_SUPER,                 199) \
   X(TP_ALLOC,                        200) \
+  X(BINARY_ADD_INT,                  201) \
+  X(BINARY_ADD_FLOAT,                202) \
+  X(COMPARE_OP_INT,                  203) \
+  X(COMPARE_OP_STR,                  204) \
   X(LOAD_METHOD_UNSHADOWED_METHOD,   205) \
   X(LOAD_METHOD_TYPE_METHODLIKE,     206) \
   X(BUILD_CHECKED_LIST_CACHED,       207) \
@@ -179,6 +189,7 @@ extern "C" {
   X(INVOKE_FUNCTION_CACHED,          211) \
   X(INVOKE_FUNCTION_INDIRECT_CACHED, 212) \
   X(BUILD_CHECKED_MAP_CACHED,        213) \
+  X(FOR_ITER_LIST,                   214) \
   X(PRIMITIVE_STORE_FAST,            215) \
   X(CAST_CACHED_OPTIONAL,            216) \
   X(CAST_CACHED,                     217) \
@@ -232,8 +232,15 @@ class BytecodeInstructionBlock {
     return BytecodeInstruction(instrs_, idx);
   }
 
+  // Returns the last instruction in the block, with the oparg of any
+  // EXTENDED_ARG prefixes folded in.
   BytecodeInstruction lastInstr() const {
-    return BytecodeInstruction(instrs_, end_idx_ - 1);
+    BCIndex first = end_idx_ - 1;
+    while (first > start_idx_ &&
+           _Py_OPCODE(instrs_[(first - 1).value()]) == EXTENDED_ARG) {
+      first--;
+    }
+    return *Iterator(instrs_ + first, first, end_idx_);
   }
 
   _Py_CODEUNIT* bytecode() const {
@@ -19,6 +19,10 @@ namespace {
 // 2MiB to match Linux's huge-page size.
 constexpr size_t kAllocSize = 1024 * 1024 * 2;
 
+// Code blocks are rounded up to this size so that released blocks can be
+// reused for any function without breaking alignment.
+constexpr size_t kBlockAlignment = 16;
+
 // Allocate memory for JIT'd code.
 uint8_t* allocPages(size_t size) {
   void* res = mmap(
@@ -68,6 +72,15 @@ void CodeAllocator::freeGlobalCodeAllocator() {
   s_global_code_allocator_ = nullptr;
 }
 
+void CodeAllocator::releaseCode(void* code, size_t size) noexcept {
+  ThreadedCompileSerialize guard;
+  used_bytes_ -= size;
+  JIT_CHECK(
+      runtime_->release(code) == asmjit::kErrorOk,
+      "Releasing code at {} failed",
+      code);
+}
+
 CodeAllocatorCinder::~CodeAllocatorCinder() {
   for (void* alloc : allocations_) {
     JIT_CHECK(munmap(alloc, kAllocSize) == 0, "Freeing code memory failed");
@@ -85,22 +98,31 @@ asmjit::Error CodeAllocatorCinder::addCode(
   ASMJIT_PROPAGATE(code->resolveUnresolvedLinks());
 
   size_t max_code_size = code->codeSize();
-  size_t alloc_size = ((max_code_size / kAllocSize) + 1) * kAllocSize;
-  if (current_alloc_free_ < max_code_size) {
-    lost_bytes_ += current_alloc_free_;
-
-    uint8_t* res = allocPages(alloc_size);
-    if (!setHugePages(res, alloc_size)) {
-      fragmented_allocs_++;
-    } else {
-      huge_allocs_++;
+  size_t max_block_size =
+      asmjit::Support::alignUp(max_code_size, kBlockAlignment);
+
+  // Prefer reusing memory released by dead functions over growing the heap.
+  uint8_t* block = allocFromFreeList(max_block_size);
+  bool from_free_list = block != nullptr;
+  if (!from_free_list) {
+    size_t alloc_size = ((max_block_size / kAllocSize) + 1) * kAllocSize;
+    if (current_alloc_free_ < max_block_size) {
+      lost_bytes_ += current_alloc_free_;
+
+      uint8_t* res = allocPages(alloc_size);
+      if (!setHugePages(res, alloc_size)) {
+        fragmented_allocs_++;
+      } else {
+        huge_allocs_++;
+      }
+      current_alloc_ = static_cast<uint8_t*>(res);
+      allocations_.emplace_back(res);
+      current_alloc_free_ = alloc_size;
     }
-    current_alloc_ = static_cast<uint8_t*>(res);
-    allocations_.emplace_back(res);
-    current_alloc_free_ = alloc_size;
+    block = current_alloc_;
   }
 
-  ASMJIT_PROPAGATE(code->relocateToBase(uintptr_t(current_alloc_)));
+  ASMJIT_PROPAGATE(code->relocateToBase(uintptr_t(block)));
 
   size_t actual_code_size = code->codeSize();
   JIT_CHECK(actual_code_size <= max_code_size, "Code grew during relocation");
@@ -112,25 +134,85 @@ asmjit::Error CodeAllocatorCinder::addCode(
 
     JIT_CHECK(
         offset + buffer_size <= actual_code_size, "Inconsistent code size");
-    std::memcpy(current_alloc_ + offset, section->data(), buffer_size);
+    std::memcpy(block + offset, section->data(), buffer_size);
 
     if (virtual_size > buffer_size) {
       JIT_CHECK(
           offset + virtual_size <= actual_code_size, "Inconsistent code size");
       std::memset(
-          current_alloc_ + offset + buffer_size, 0, virtual_size - buffer_size);
+          block + offset + buffer_size, 0, virtual_size - buffer_size);
     }
   }
 
-  *dst = current_alloc_;
+  *dst = block;
 
-  current_alloc_ += actual_code_size;
-  current_alloc_free_ -= actual_code_size;
+  size_t block_size = asmjit::Support::alignUp(actual_code_size, kBlockAlignment);
+  if (!from_free_list) {
+    current_alloc_ += block_size;
+    current_alloc_free_ -= block_size;
+  } else if (block_size < max_block_size) {
+    addToFreeList(block + block_size, max_block_size - block_size);
+  }
   used_bytes_ += actual_code_size;
 
   return asmjit::kErrorOk;
 }
 
+void CodeAllocatorCinder::releaseCode(void* code, size_t size) noexcept {
+  ThreadedCompileSerialize guard;
+  used_bytes_ -= size;
+  addToFreeList(
+      static_cast<uint8_t*>(code),
+      asmjit::Support::alignUp(size, kBlockAlignment));
+}
+
+uint8_t* CodeAllocatorCinder::allocFromFreeList(size_t size) {
+  auto best_fit = free_blocks_by_size_.lower_bound(size);
+  if (best_fit == free_blocks_by_size_.end()) {
+    return nullptr;
+  }
+  auto [block_size, block] = *best_fit;
+  removeFromFreeList(free_blocks_by_addr_.find(block));
+  if (block_size > size) {
+    addToFreeList(block + size, block_size - size);
+  }
+  return block;
+}
+
+void CodeAllocatorCinder::addToFreeList(uint8_t* block, size_t size) {
+  auto next = free_blocks_by_addr_.lower_bound(block);
+  if (next != free_blocks_by_addr_.end() && block + size == next->first) {
+    size += next->second;
+    next = std::next(next);
+    removeFromFreeList(std::prev(next));
+  }
+  if (next != free_blocks_by_addr_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == block) {
+      block = prev->first;
+      size += prev->second;
+      removeFromFreeList(prev);
+    }
+  }
+  free_blocks_by_addr_.emplace(block, size);
+  free_blocks_by_size_.emplace(size, block);
+  free_bytes_ += size;
+}
+
+void CodeAllocatorCinder::removeFromFreeList(
+    std::map<uint8_t*, size_t>::iterator it) {
+  auto [block, size] = *it;
+  auto [begin, end] = free_blocks_by_size_.equal_range(size);
+  for (auto by_size = begin; by_size != end; ++by_size) {
+    if (by_size->second == block) {
+      free_blocks_by_size_.erase(by_size);
+      break;
+    }
+  }
+  free_blocks_by_addr_.erase(it);
+  free_bytes_ -= size;
+}
+
 MultipleSectionCodeAllocator::~MultipleSectionCodeAllocator() {
   if (code_alloc_ == nullptr) {
     return;
@@ -240,4 +322,14 @@ asmjit::Error MultipleSectionCodeAllocator::addCode(
   return asmjit::kErrorOk;
 }
 
+void MultipleSectionCodeAllocator::releaseCode(
+    void* code,
+    size_t size) noexcept {
+  auto start = static_cast<uint8_t*>(code);
+  if (start >= code_alloc_ && start < code_alloc_ + total_allocation_size_) {
+    return;
+  }
+  CodeAllocator::releaseCode(code, size);
+}
+
 }; // namespace jit
@@ -9,6 +9,7 @@
 #include "cinderx/ThirdParty/asmjit/src/asmjit/asmjit.h"
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -37,6 +38,11 @@ class CodeAllocator {
     return s_global_code_allocator_;
   }
 
+  // Get the global code allocator, if it exists.
+  static CodeAllocator* getUnchecked() {
+    return s_global_code_allocator_;
+  }
+
   // To be called once by JIT initialization after enough configuration has been
   // loaded to determine which global code allocator type to use.
   static void makeGlobalCodeAllocator();
@@ -56,6 +62,11 @@ class CodeAllocator {
     return runtime_->add(dst, code);
   }
 
+  // Return the memory for code previously added with addCode(), which starts
+  // at `code` and is `size` bytes long. The caller must guarantee that the
+  // code can no longer be executed.
+  virtual void releaseCode(void* code, size_t size) noexcept;
+
  protected:
   std::unique_ptr<asmjit::JitRuntime> runtime_{
       std::make_unique<asmjit::JitRuntime>()};
@@ -72,6 +83,7 @@ class CodeAllocatorCinder : public CodeAllocator {
   virtual ~CodeAllocatorCinder();
 
   asmjit::Error addCode(void** dst, asmjit::CodeHolder* code) noexcept override;
+  void releaseCode(void* code, size_t size) noexcept override;
 
   size_t lostBytes() const {
     return lost_bytes_;
@@ -85,7 +97,21 @@ class CodeAllocatorCinder : public CodeAllocator {
     return huge_allocs_;
   }
 
+  size_t freeBytes() const {
+    return free_bytes_;
+  }
+
  private:
+  // Take a block of at least `size` bytes from the free lists, or return
+  // nullptr if no released block is big enough.
+  uint8_t* allocFromFreeList(size_t size);
+
+  // Put [block, block + size) on the free lists, merging it with any adjacent
+  // free blocks.
+  void addToFreeList(uint8_t* block, size_t size);
+
+  void removeFromFreeList(std::map<uint8_t*, size_t>::iterator it);
+
   // List of chunks allocated for use in deallocation
   std::vector<void*> allocations_;
 
@@ -101,6 +127,13 @@ class CodeAllocatorCinder : public CodeAllocator {
   size_t huge_allocs_{0};
   // Number of chunks allocated which did not use huge pages.
   size_t fragmented_allocs_{0};
+
+  // Blocks of released code memory, indexed both by address (to merge
+  // neighbours) and by size (to find the best fit for new code).
+  std::map<uint8_t*, size_t> free_blocks_by_addr_;
+  std::multimap<size_t, uint8_t*> free_blocks_by_size_;
+  // Total size of all blocks on the free lists.
+  size_t free_bytes_{0};
 };
 
 class MultipleSectionCodeAllocator : public CodeAllocator {
@@ -109,6 +142,10 @@ class MultipleSectionCodeAllocator : public CodeAllocator {
 
   asmjit::Error addCode(void** dst, asmjit::CodeHolder* code) noexcept override;
 
+  // Code in the hot and cold sections is never reused, so only code that fell
+  // back to the normal allocator is actually released.
+  void releaseCode(void* code, size_t size) noexcept override;
+
  private:
   void createSlabs() noexcept;
 
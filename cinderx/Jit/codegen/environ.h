@@ -71,6 +71,10 @@ struct Environ {
 
   std::vector<PendingDebugLoc> pending_debug_locs;
 
+  // Start of every `push rbp; mov rbp, rsp` sequence, used to describe the
+  // function's frames in perf unwinding info.
+  std::vector<asmjit::Label> frame_entry_labels;
+
   // Location of incoming arguments
   std::vector<PhyLocation> arg_locations;
 
@@ -24,6 +24,7 @@
 #include "cinderx/Jit/jit_rt.h"
 #include "cinderx/Jit/lir/dce.h"
 #include "cinderx/Jit/lir/generator.h"
+#include "cinderx/Jit/lir/peephole.h"
 #include "cinderx/Jit/lir/postalloc.h"
 #include "cinderx/Jit/lir/postgen.h"
 #include "cinderx/Jit/lir/regalloc.h"
@@ -335,6 +336,11 @@ void* NativeGenerator::getVectorcallEntry() {
       "Register Allocation",
       lsalloc.run())
 
+  // Now that live ranges are fixed, move cold blocks out of the hot path. With
+  // multiple code sections they're emitted elsewhere anyway, but this keeps
+  // fall-throughs between hot blocks.
+  lir_func->sinkColdBlocks();
+
   if (!g_dump_hir_passes_json.empty()) {
     lir::JSONPrinter lir_printer;
     (*json)["cols"].emplace_back(
@@ -368,6 +374,20 @@ void* NativeGenerator::getVectorcallEntry() {
       GetFunction()->fullname,
       *lir_func);
 
+  if (getConfig().lir_peephole) {
+    PeepholeOptimizer peephole(lir_func.get(), &env_);
+    COMPILE_TIMER(
+        GetFunction()->compilation_phase_timer,
+        "Peephole Optimization",
+        peephole.run())
+
+    JIT_LOGIF(
+        g_dump_lir,
+        "LIR for {} after peephole optimization:\n{}",
+        GetFunction()->fullname,
+        *lir_func);
+  }
+
   if (!verifyPostRegAllocInvariants(lir_func.get(), std::cerr)) {
     JIT_ABORT(
         "LIR for {} failed verification:\n{}",
@@ -427,6 +447,8 @@ int NativeGenerator::GetCompiledFunctionSpillStackSize() const {
 }
 
 void NativeGenerator::generateFunctionEntry() {
+  env_.frame_entry_labels.push_back(as_->newLabel());
+  as_->bind(env_.frame_entry_labels.back());
   as_->push(x86::rbp);
   as_->mov(x86::rbp, x86::rsp);
 }
@@ -584,7 +606,9 @@ void NativeGenerator::loadOrGenerateLinkFrame(
     }
   };
 
-  if (isGen()) {
+  // Generators link their frame on resume, and OSR entries take over the
+  // interpreter's frame, which is already linked.
+  if (isGen() || GetFunction()->osr_entry.has_value()) {
     load_tstate_and_move();
     return;
   }
@@ -649,6 +673,11 @@ void NativeGenerator::loadOrGenerateLinkFrame(
 void NativeGenerator::generatePrologue(
     Label correct_arg_count,
     Label native_entry_point) {
+  if (func_->osr_entry.has_value()) {
+    generateOSRPrologue(correct_arg_count, native_entry_point);
+    return;
+  }
+
   PyCodeObject* code = GetFunction()->code;
 
   // the generic entry point, including primitive return boxing if needed
@@ -838,7 +867,6 @@ void NativeGenerator::generatePrologue(
   // Args are now validated, setup frame
   constexpr auto kFuncPtrReg = x86::rdi;
   constexpr auto kArgsReg = x86::r10;
-  constexpr auto kArgsPastSixReg = kArgsReg;
 
   asmjit::BaseNode* frame_cursor = as_->cursor();
   as_->bind(setup_frame);
@@ -850,9 +878,44 @@ void NativeGenerator::generatePrologue(
       });
   env_.addAnnotation("Link frame", frame_cursor);
 
+  generateLoadArgs(kArgsReg);
+
+  // Finally allocate the saved space required for the actual function
+  auto native_entry_cursor = as_->cursor();
+  as_->bind(native_entry_point);
+
+  setupFrameAndSaveCallerRegisters(x86::r11);
+
+  env_.addAnnotation("Native entry", native_entry_cursor);
+}
+
+void NativeGenerator::generateOSRPrologue(
+    Label correct_arg_count,
+    Label native_entry_point) {
+  // OSR entries are only called by _PyJIT_OSREnter(), with the values of the
+  // interpreter frame as arguments, so there is nothing to bind or check.
+  asmjit::BaseNode* osr_entry_cursor = as_->cursor();
+  generateFunctionEntry();
+  as_->bind(correct_arg_count);
+
+  constexpr auto kArgsReg = x86::r10;
+  loadOrGenerateLinkFrame(x86::r11, {{x86::rsi, kArgsReg}});
+  env_.addAnnotation("OSR entry", osr_entry_cursor);
+
+  generateLoadArgs(kArgsReg);
+
+  auto native_entry_cursor = as_->cursor();
+  as_->bind(native_entry_point);
+
+  setupFrameAndSaveCallerRegisters(x86::r11);
+
+  env_.addAnnotation("Native entry", native_entry_cursor);
+}
+
+void NativeGenerator::generateLoadArgs(x86::Gp args_reg) {
   asmjit::BaseNode* load_args_cursor = as_->cursor();
-  // Move arguments into their expected registers and then
-  // use r10 as the base for additional args.
+  // Move arguments into their expected registers and then use args_reg as the
+  // base for additional args.
   bool has_extra_args = false;
   for (size_t i = 0; i < env_.arg_locations.size(); i++) {
     PhyLocation arg = env_.arg_locations[i];
@@ -861,27 +924,19 @@ void NativeGenerator::generatePrologue(
       continue;
     }
     if (arg.is_gp_register()) {
-      as_->mov(x86::gpq(arg), x86::ptr(kArgsReg, i * sizeof(void*)));
+      as_->mov(x86::gpq(arg), x86::ptr(args_reg, i * sizeof(void*)));
     } else {
-      as_->movsd(x86::xmm(arg), x86::ptr(kArgsReg, i * sizeof(void*)));
+      as_->movsd(x86::xmm(arg), x86::ptr(args_reg, i * sizeof(void*)));
     }
   }
   if (has_extra_args) {
     // load the location of the remaining args, the backend will
     // deal with loading them from here...
     as_->lea(
-        kArgsPastSixReg,
-        x86::ptr(kArgsReg, (ARGUMENT_REGS.size() - 1) * sizeof(void*)));
+        args_reg,
+        x86::ptr(args_reg, (ARGUMENT_REGS.size() - 1) * sizeof(void*)));
   }
   env_.addAnnotation("Load arguments", load_args_cursor);
-
-  // Finally allocate the saved space required for the actual function
-  auto native_entry_cursor = as_->cursor();
-  as_->bind(native_entry_point);
-
-  setupFrameAndSaveCallerRegisters(x86::r11);
-
-  env_.addAnnotation("Native entry", native_entry_cursor);
 }
 
 static void
@@ -1469,7 +1524,13 @@ void NativeGenerator::generateCode(CodeHolder& codeholder) {
   // the text sections.
   std::vector<std::pair<void*, std::size_t>> code_sections;
   populateCodeSections(code_sections, codeholder, code_start_);
-  perf::registerFunction(code_sections, func->fullname, prefix);
+  perf::FunctionInfo perf_info;
+  perf_info.debug_info = env_.code_rt->debug_info();
+  for (Label label : env_.frame_entry_labels) {
+    perf_info.frame_entries.push_back(
+        codeholder.labelOffsetFromBase(label) + codeholder.baseAddress());
+  }
+  perf::registerFunction(code_sections, func->fullname, prefix, &perf_info);
 }
 
 #ifdef __ASM_DEBUG
@@ -1508,6 +1569,31 @@ static void raiseAttributeError(BorrowedRef<> receiver, BorrowedRef<> name) {
       name);
 }
 
+// Track failed guards on profiled types, and ask for the function to be
+// recompiled without them once they've failed often enough.
+static void recordProfiledGuardFailure(
+    Runtime* runtime,
+    const DeoptMetadata& deopt_meta) {
+  uint32_t threshold = getConfig().deopt_recompile_threshold;
+  if (threshold == 0 || deopt_meta.code_rt == nullptr) {
+    return;
+  }
+  ProfileRuntime& profile_runtime = runtime->profileRuntime();
+  BorrowedRef<PyCodeObject> code = deopt_meta.code();
+  BCOffset bc_off = deopt_meta.source_offset;
+  {
+    ThreadedCompileSerialize guard;
+    if (profile_runtime.getProfiledTypes(code, bc_off).empty()) {
+      // Not a guard derived from profiling data.
+      return;
+    }
+    profile_runtime.recordGuardFailure(code, bc_off);
+  }
+  if (deopt_meta.code_rt->recordGuardFailure() == threshold) {
+    runtime->requestRecompile(deopt_meta.code_rt);
+  }
+}
+
 static PyFrameObject*
 prepareForDeopt(const uint64_t* regs, Runtime* runtime, std::size_t deopt_idx) {
   JIT_CHECK(deopt_idx != -1ull, "deopt_idx must be valid");
@@ -1538,6 +1624,7 @@ prepareForDeopt(const uint64_t* regs, Runtime* runtime, std::size_t deopt_idx) {
     switch (reason) {
       case DeoptReason::kGuardFailure: {
         runtime->guardFailed(deopt_meta);
+        recordProfiledGuardFailure(runtime, deopt_meta);
         break;
       }
       case DeoptReason::kYieldFrom: {
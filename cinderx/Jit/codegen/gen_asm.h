@@ -135,6 +135,10 @@ class NativeGenerator {
   void generatePrologue(
       asmjit::Label correct_arg_count,
       asmjit::Label native_entry_point);
+  void generateOSRPrologue(
+      asmjit::Label correct_arg_count,
+      asmjit::Label native_entry_point);
+  void generateLoadArgs(asmjit::x86::Gp args_reg);
   void loadOrGenerateLinkFrame(
       asmjit::x86::Gp tstate_reg,
       const std::vector<
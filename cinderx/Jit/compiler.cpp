@@ -5,6 +5,7 @@
 #include "Python.h"
 #include "cinderx/Common/log.h"
 
+#include "cinderx/Jit/code_allocator.h"
 #include "cinderx/Jit/config.h"
 #include "cinderx/Jit/disassembler.h"
 #include "cinderx/Jit/hir/analysis.h"
@@ -14,6 +15,7 @@
 #include "cinderx/Jit/hir/printer.h"
 #include "cinderx/Jit/hir/ssa.h"
 #include "cinderx/Jit/jit_time_log.h"
+#include "cinderx/Jit/runtime.h"
 
 #include "cinderx/ThirdParty/json/json.hpp"
 
@@ -22,6 +24,18 @@
 
 namespace jit {
 
+CompiledFunction::~CompiledFunction() {
+  if (code_.empty()) {
+    return;
+  }
+  if (Runtime* runtime = Runtime::getUnchecked()) {
+    runtime->forgetCode(code_);
+  }
+  if (CodeAllocator* allocator = CodeAllocator::getUnchecked()) {
+    allocator->releaseCode(const_cast<std::byte*>(code_.data()), code_.size());
+  }
+}
+
 void CompiledFunction::disassemble() const {
   JIT_ABORT("disassemble() cannot be called in a release build.");
 }
@@ -130,9 +144,13 @@ void Compiler::runPasses(
   runPassIf(
       hir::BuiltinLoadMethodElimination{}, PassConfig::kBuiltinLoadMethodElim);
   runPassIf(hir::Simplify{}, PassConfig::kSimplify);
+  runPassIf(
+      hir::LoopInvariantCodeMotion{}, PassConfig::kLoopInvariantCodeMotion);
+  runPassIf(hir::GlobalValueNumbering{}, PassConfig::kGlobalValueNumbering);
   runPassIf(hir::CleanCFG{}, PassConfig::kCleanCFG);
   runPassIf(hir::DeadCodeElimination{}, PassConfig::kDeadCodeElim);
   runPassIf(hir::CleanCFG{}, PassConfig::kCleanCFG);
+  runPassIf(hir::EscapeAnalysis{}, PassConfig::kEscapeAnalysis);
 
   // RefcountInsertion must come last.
   runPass(jit::hir::RefcountInsertion{}, irfunc, callback);
@@ -167,9 +185,13 @@ PassConfig createConfig() {
   set(hir_opts.builtin_load_method_elim, PassConfig::kBuiltinLoadMethodElim);
   set(hir_opts.clean_cfg, PassConfig::kCleanCFG);
   set(hir_opts.dynamic_comparison_elim, PassConfig::kDynamicComparisonElim);
+  set(hir_opts.escape_analysis, PassConfig::kEscapeAnalysis);
+  set(hir_opts.global_value_numbering, PassConfig::kGlobalValueNumbering);
   set(hir_opts.guard_type_removal, PassConfig::kGuardTypeRemoval);
   // Inliner currently depends on code objects being stable.
   set(hir_opts.inliner && getConfig().stable_code, PassConfig::kInliner);
+  set(hir_opts.loop_invariant_code_motion,
+      PassConfig::kLoopInvariantCodeMotion);
   set(hir_opts.phi_elim, PassConfig::kPhiElim);
   set(hir_opts.simplify, PassConfig::kSimplify);
 
@@ -177,7 +199,8 @@ PassConfig createConfig() {
 }
 
 std::unique_ptr<CompiledFunction> Compiler::Compile(
-    const jit::hir::Preloader& preloader) {
+    const jit::hir::Preloader& preloader,
+    const hir::OSREntry* osr_entry) {
   const std::string& fullname = preloader.fullname();
   if (!PyDict_CheckExact(preloader.globals())) {
     JIT_DLOG(
@@ -209,7 +232,9 @@ std::unique_ptr<CompiledFunction> Compiler::Compile(
   }
 
   PassTimer hir_build_timer;
-  std::unique_ptr<jit::hir::Function> irfunc(jit::hir::buildHIR(preloader));
+  std::unique_ptr<jit::hir::Function> irfunc(
+      osr_entry == nullptr ? jit::hir::buildHIR(preloader)
+                           : jit::hir::buildOSRHIR(preloader, *osr_entry));
   std::size_t hir_build_time_ns = hir_build_timer.finish();
   if (nullptr != compilation_phase_timer) {
     compilation_phase_timer->end();
@@ -41,7 +41,9 @@ class CompiledFunction {
         inline_function_stats_(std::move(inline_function_stats)),
         hir_opcode_counts_(hir_opcode_counts) {}
 
-  virtual ~CompiledFunction() {}
+  // Frees the machine code, which must no longer be reachable from any
+  // function, frame or generator.
+  virtual ~CompiledFunction();
 
   // Get the buffer containing the compiled machine code.  The start of this
   // buffer is not guaranteed to be a valid entry point.
@@ -142,6 +144,9 @@ enum PassConfig : uint64_t {
   kInliner = 1 << 6,
   kPhiElim = 1 << 7,
   kSimplify = 1 << 8,
+  kGlobalValueNumbering = 1 << 9,
+  kLoopInvariantCodeMotion = 1 << 10,
+  kEscapeAnalysis = 1 << 11,
 
   // Run all the passes.
   kAll = ~uint64_t{0},
@@ -157,7 +162,12 @@ class Compiler {
   Compiler() = default;
 
   // Compile the function / code object preloaded by the given Preloader.
-  std::unique_ptr<CompiledFunction> Compile(const hir::Preloader& preloader);
+  //
+  // If osr_entry is given, the compiled code is entered from a running
+  // interpreter frame at that loop header instead of being called.
+  std::unique_ptr<CompiledFunction> Compile(
+      const hir::Preloader& preloader,
+      const hir::OSREntry* osr_entry = nullptr);
 
   // Convenience wrapper to create and compile a preloader from a
   // PyFunctionObject.
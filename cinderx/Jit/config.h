@@ -25,9 +25,12 @@ struct HIROptimizations {
   bool clean_cfg{true};
   bool dead_code_elim{true};
   bool dynamic_comparison_elim{true};
+  bool escape_analysis{true};
+  bool global_value_numbering{true};
   bool guard_type_removal{true};
   // TODO(T156009029): Inliner should be on by default.
   bool inliner{false};
+  bool loop_invariant_code_motion{true};
   bool phi_elim{true};
   bool simplify{true};
 };
@@ -53,6 +56,14 @@ struct Config {
   bool stable_globals{true};
   // Use inline caches for attribute accesses.
   bool attr_caches{true};
+  // Fall back to a process-wide cache of attribute and method lookups when an
+  // inline cache runs out of entries.
+  bool megamorphic_attr_cache{true};
+  // Run the LIR peephole optimizer after register allocation.
+  bool lir_peephole{true};
+  // Turn Static Python method calls into direct calls when no subclass
+  // overrides the method, deoptimizing if one later does.
+  bool devirtualize_methods{true};
   HIROptimizations hir_opts;
   size_t batch_compile_workers{0};
   // Sizes (in bytes) of the hot and cold code sections. Only applicable if
@@ -66,6 +77,18 @@ struct Config {
   uint32_t attr_cache_size{1};
   uint32_t auto_jit_threshold{0};
   uint32_t auto_jit_profile_threshold{0};
+  // Number of threads that compile functions which crossed the auto-JIT
+  // threshold. When zero, hot functions are compiled on the calling thread.
+  size_t auto_jit_background_workers{0};
+  // Number of back-edges a loop in an interpreted frame takes before the frame
+  // is transferred into JIT-compiled code. Zero disables on-stack replacement.
+  uint32_t osr_threshold{0};
+  // Number of failed guards on profiled types that a compiled function
+  // tolerates before it is recompiled without them. Zero disables
+  // recompilation.
+  uint32_t deopt_recompile_threshold{0};
+  // Maximum number of times a function is recompiled because of failed guards.
+  uint32_t max_recompiles{2};
   bool compile_perf_trampoline_prefork{false};
 };
 
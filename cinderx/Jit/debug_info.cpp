@@ -32,6 +32,23 @@ std::optional<UnitCallStack> DebugInfo::getUnitCallStack(uintptr_t addr) const {
   return stack;
 }
 
+std::vector<std::pair<uintptr_t, UnitCallStack>>
+DebugInfo::getAllUnitCallStacks() const {
+  std::vector<uintptr_t> addrs;
+  addrs.reserve(addr_locs_.size());
+  for (auto& [addr, node] : addr_locs_) {
+    addrs.push_back(addr);
+  }
+  std::sort(addrs.begin(), addrs.end());
+
+  std::vector<std::pair<uintptr_t, UnitCallStack>> result;
+  result.reserve(addrs.size());
+  for (uintptr_t addr : addrs) {
+    result.emplace_back(addr, *getUnitCallStack(addr));
+  }
+  return result;
+}
+
 namespace {
 
 struct Activation {
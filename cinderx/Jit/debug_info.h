@@ -65,6 +65,11 @@ class DebugInfo {
   // Returns std::nullopt if no location information was found.
   std::optional<UnitCallStack> getUnitCallStack(uintptr_t addr) const;
 
+  // Get the locations of all the active frames at every address that has
+  // location information, sorted by address.
+  std::vector<std::pair<uintptr_t, UnitCallStack>> getAllUnitCallStacks()
+      const;
+
   // Add location information for pending by resolving labels to their
   // addresses in generated code.
   void resolvePending(
@@ -13,7 +13,9 @@
 #include <folly/tracing/StaticTracepoint.h>
 
 #include <bit>
+#include <functional>
 #include <shared_mutex>
+#include <unordered_map>
 
 using jit::codegen::PhyLocation;
 
@@ -88,11 +90,96 @@ Ref<> MemoryView::readOwned(const LiveValue& value) const {
   JIT_ABORT("Unhandled ValueKind");
 }
 
+namespace {
+
+// Reads the live values of a frame being reified, allocating each virtual
+// object the first time it's seen so that every reference to it in the frame
+// sees the same object.
+class FrameValueReader {
+ public:
+  FrameValueReader(const DeoptMetadata& meta, const MemoryView& mem)
+      : meta_{meta}, mem_{mem} {}
+
+  Ref<> readOwned(const LiveValue& value) {
+    if (!value.isVirtual()) {
+      return mem_.readOwned(value);
+    }
+    auto it = materialized_.find(&value);
+    if (it != materialized_.end()) {
+      return Ref<>::create(it->second);
+    }
+    Ref<> obj = materialize(value);
+    materialized_.emplace(&value, Ref<>::create(obj));
+    return obj;
+  }
+
+ private:
+  Ref<> materialize(const LiveValue& value) {
+    auto field = [&](std::size_t i) {
+      return readOwned(meta_.live_values.at(value.fields.at(i)));
+    };
+    std::size_t nfields = value.fields.size();
+    switch (value.virtual_kind) {
+      case LiveValue::VirtualKind::kTuple: {
+        auto tuple = Ref<>::steal(PyTuple_New(nfields));
+        JIT_CHECK(tuple != nullptr, "Failed to materialize tuple on deopt");
+        for (std::size_t i = 0; i < nfields; i++) {
+          PyTuple_SET_ITEM(tuple.get(), i, field(i).release());
+        }
+        return tuple;
+      }
+      case LiveValue::VirtualKind::kList: {
+        auto list = Ref<>::steal(PyList_New(nfields));
+        JIT_CHECK(list != nullptr, "Failed to materialize list on deopt");
+        for (std::size_t i = 0; i < nfields; i++) {
+          PyList_SET_ITEM(list.get(), i, field(i).release());
+        }
+        return list;
+      }
+      case LiveValue::VirtualKind::kSlice: {
+        Ref<> start = field(0);
+        Ref<> stop = field(1);
+        Ref<> step;
+        if (nfields == 3) {
+          step = field(2);
+        }
+        auto slice =
+            Ref<>::steal(PySlice_New(start.get(), stop.get(), step.get()));
+        JIT_CHECK(slice != nullptr, "Failed to materialize slice on deopt");
+        return slice;
+      }
+      case LiveValue::VirtualKind::kIterator: {
+        Ref<> seq = field(0);
+        Ref<> index = field(1);
+        // We may be reifying a frame while its exception propagates.
+        PyObject *exc, *val, *tb;
+        PyErr_Fetch(&exc, &val, &tb);
+        auto iter = Ref<>::steal(PyObject_GetIter(seq.get()));
+        JIT_CHECK(iter != nullptr, "Failed to materialize iterator on deopt");
+        auto state = Ref<>::steal(
+            PyObject_CallMethod(iter.get(), "__setstate__", "O", index.get()));
+        JIT_CHECK(state != nullptr, "Failed to set iterator index on deopt");
+        PyErr_Restore(exc, val, tb);
+        return iter;
+      }
+      case LiveValue::VirtualKind::kNone:
+        break;
+    }
+    JIT_ABORT("Unhandled VirtualKind");
+  }
+
+  const DeoptMetadata& meta_;
+  const MemoryView& mem_;
+  std::unordered_map<const LiveValue*, Ref<>> materialized_;
+};
+
+} // namespace
+
 static void reifyLocalsplus(
     PyFrameObject* frame,
     const DeoptMetadata& meta,
     const DeoptFrameMetadata& frame_meta,
-    const MemoryView& mem) {
+    FrameValueReader& reader) {
   for (std::size_t i = 0; i < frame_meta.localsplus.size(); i++) {
     auto value = meta.getLocalValue(i, frame_meta);
     if (value == nullptr) {
@@ -100,7 +187,7 @@ static void reifyLocalsplus(
       Py_CLEAR(frame->f_localsplus[i]);
       continue;
     }
-    PyObject* obj = mem.readOwned(*value).release();
+    PyObject* obj = reader.readOwned(*value).release();
     Py_XSETREF(frame->f_localsplus[i], obj);
   }
 }
@@ -109,11 +196,11 @@ static void reifyStack(
     PyFrameObject* frame,
     const DeoptMetadata& meta,
     const DeoptFrameMetadata& frame_meta,
-    const MemoryView& mem) {
+    FrameValueReader& reader) {
   frame->f_stackdepth = frame_meta.stack.size();
   for (int i = frame_meta.stack.size() - 1; i >= 0; i--) {
     const auto& value = meta.getStackValue(i, frame_meta);
-    Ref<> obj = mem.readOwned(value);
+    Ref<> obj = reader.readOwned(value);
     if (value.isLoadMethodResult()) {
       // When we are deoptimizing a JIT-compiled function that contains an
       // optimizable LoadMethod, we need to be able to know whether or not the
@@ -208,8 +295,9 @@ static void reifyFrameImpl(
     frame->f_lasti--;
   }
   MemoryView mem{regs};
-  reifyLocalsplus(frame, meta, frame_meta, mem);
-  reifyStack(frame, meta, frame_meta, mem);
+  FrameValueReader reader{meta, mem};
+  reifyLocalsplus(frame, meta, frame_meta, reader);
+  reifyStack(frame, meta, frame_meta, reader);
   reifyBlockStack(frame, frame_meta.block_stack);
   // Generator/frame linkage happens in `materializePyFrame` in frame.cpp
 }
@@ -329,17 +417,53 @@ DeoptMetadata DeoptMetadata::fromInstr(
     i++;
   }
 
-  auto get_reg_idx = [&reg_idx](jit::hir::Register* reg) {
-    if (reg == nullptr) {
-      return -1;
-    }
-    auto it = reg_idx.find(reg);
-    JIT_CHECK(it != reg_idx.end(), "register {} not live", reg->name());
-    return it->second;
-  };
+  // VirtualObjects have no location of their own; describe each one with an
+  // extra LiveValue, appended after the ones that codegen will fill in.
+  std::function<int(jit::hir::Register*)> get_reg_idx =
+      [&](jit::hir::Register* reg) {
+        if (reg == nullptr) {
+          return -1;
+        }
+        auto it = reg_idx.find(reg);
+        if (it != reg_idx.end()) {
+          return it->second;
+        }
+        auto vobj = reg->instr();
+        JIT_CHECK(
+            vobj != nullptr && vobj->IsVirtualObject(),
+            "register {} not live",
+            reg->name());
+        LiveValue lv = {
+            .location = 0,
+            .ref_kind = hir::RefKind::kUncounted,
+            .value_kind = hir::ValueKind::kObject,
+            .source = LiveValue::Source::kUnknown,
+        };
+        hir::Type type = static_cast<const hir::VirtualObject*>(vobj)->type();
+        if (type.hasTypeExactSpec() &&
+            (type.typeSpec() == &PyListIter_Type ||
+             type.typeSpec() == &PyTupleIter_Type ||
+             type.typeSpec() == &PyRangeIter_Type)) {
+          lv.virtual_kind = LiveValue::VirtualKind::kIterator;
+        } else if (type <= hir::TTupleExact) {
+          lv.virtual_kind = LiveValue::VirtualKind::kTuple;
+        } else if (type <= hir::TListExact) {
+          lv.virtual_kind = LiveValue::VirtualKind::kList;
+        } else {
+          JIT_CHECK(type <= hir::TSlice, "Unexpected VirtualObject {}", *vobj);
+          lv.virtual_kind = LiveValue::VirtualKind::kSlice;
+        }
+        for (std::size_t i = 0; i < vobj->NumOperands(); i++) {
+          lv.fields.push_back(get_reg_idx(vobj->GetOperand(i)));
+        }
+        int idx = meta.live_values.size();
+        meta.live_values.emplace_back(std::move(lv));
+        reg_idx[reg] = idx;
+        return idx;
+      };
 
   auto populate_localsplus =
-      [get_reg_idx](DeoptFrameMetadata& meta, hir::FrameState* fs) {
+      [&get_reg_idx](DeoptFrameMetadata& meta, hir::FrameState* fs) {
         std::size_t nlocals = fs->locals.size();
         std::size_t ncells = fs->cells.size();
         meta.localsplus.resize(nlocals + ncells, -1);
@@ -351,7 +475,7 @@ DeoptMetadata DeoptMetadata::fromInstr(
         }
       };
 
-  auto populate_stack = [get_reg_idx](
+  auto populate_stack = [&get_reg_idx](
                             DeoptFrameMetadata& meta, hir::FrameState* fs) {
     std::unordered_set<jit::hir::Register*> lms_on_stack;
     for (auto& reg : fs->stack) {
@@ -393,6 +517,8 @@ DeoptMetadata DeoptMetadata::fromInstr(
 
   meta.nonce = instr.nonce();
   meta.reason = getDeoptReason(instr);
+  meta.code_rt = code_rt;
+  meta.source_offset = instr.bytecodeOffset();
   JIT_CHECK(
       meta.reason != DeoptReason::kUnhandledNullField ||
           meta.guilty_value != -1,
@@ -60,11 +60,53 @@ struct LiveValue {
   }
   Source source;
 
+  // Objects that the JIT proved never escape (see hir::VirtualObject) are
+  // never allocated by compiled code. Their LiveValue has no location;
+  // instead, `fields` holds indices into DeoptMetadata::live_values for the
+  // object's contents, and a new object of the given kind is built from them
+  // when reifying a frame.
+  enum class VirtualKind : char {
+    kNone,
+    kTuple,
+    kList,
+    kSlice,
+    // An iterator over a list, tuple or range, from an index loop. The fields
+    // are the iterable and the index of its next item.
+    kIterator,
+  };
+  static const char* virtualKindName(VirtualKind kind) {
+    switch (kind) {
+      case VirtualKind::kNone:
+        return "None";
+      case VirtualKind::kTuple:
+        return "Tuple";
+      case VirtualKind::kList:
+        return "List";
+      case VirtualKind::kSlice:
+        return "Slice";
+      case VirtualKind::kIterator:
+        return "Iterator";
+    }
+    JIT_ABORT("Unknown virtual kind");
+  }
+  VirtualKind virtual_kind{VirtualKind::kNone};
+  std::vector<int> fields{};
+
   bool isLoadMethodResult() const {
     return source == Source::kLoadMethod;
   }
 
+  bool isVirtual() const {
+    return virtual_kind != VirtualKind::kNone;
+  }
+
   std::string toString() const {
+    if (isVirtual()) {
+      return fmt::format(
+          "Virtual{}({})",
+          virtualKindName(virtual_kind),
+          fmt::join(fields, ", "));
+    }
     return fmt::format(
         "{}:{}:{}:{}",
         location.toString(),
@@ -148,6 +190,14 @@ struct DeoptMetadata {
   // Why we are de-opting
   DeoptReason reason{DeoptReason::kUnhandledException};
 
+  // Runtime data of the compiled function containing the deopting instruction.
+  CodeRuntime* code_rt{nullptr};
+
+  // Offset of the bytecode instruction that the deopting instruction was
+  // emitted for. Guards share the FrameState of the preceding Snapshot, so
+  // this can be later than instr_offset().
+  BCOffset source_offset{0};
+
   BCOffset instr_offset() const {
     /* This is tricky: For guard failures, the `next_instr_offset` points to the
        instruction itself, but for exceptions, the next_instr_offset is the
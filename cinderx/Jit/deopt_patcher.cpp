@@ -34,6 +34,12 @@ void DeoptPatcher::link(uintptr_t patchpoint, uintptr_t deopt_exit) {
   patchpoint_ = reinterpret_cast<uint8_t*>(patchpoint);
 }
 
+bool DeoptPatcher::isLinkedInto(std::span<const std::byte> code) const {
+  auto patchpoint = reinterpret_cast<const std::byte*>(patchpoint_);
+  return patchpoint != nullptr && patchpoint >= code.data() &&
+      patchpoint < code.data() + code.size();
+}
+
 void DeoptPatcher::emitPatchpoint(asmjit::x86::Builder& as) {
   // 5-byte nop - https://www.felixcloutier.com/x86/nop
   //
@@ -4,6 +4,9 @@
 
 #include "cinderx/ThirdParty/asmjit/src/asmjit/x86.h"
 
+#include <cstddef>
+#include <span>
+
 namespace jit {
 
 // A DeoptPatcher is used by the runtime to invalidate compiled code when an
@@ -50,6 +53,9 @@ class DeoptPatcher {
   // a signed 32 bit int.
   void link(uintptr_t patchpoint, uintptr_t deopt_exit);
 
+  // Return whether the patcher is linked to a patchpoint inside `code`.
+  bool isLinkedInto(std::span<const std::byte> code) const;
+
   // Write the nop that will be overwritten at runtime when patch() is called.
   static void emitPatchpoint(asmjit::x86::Builder& as);
 
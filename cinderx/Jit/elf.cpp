@@ -5,6 +5,8 @@
 #include "cinderx/Common/log.h"
 #include "cinderx/Common/util.h"
 
+#include <istream>
+#include <iterator>
 #include <ostream>
 
 namespace jit::elf {
@@ -159,6 +161,20 @@ void initHashSection(Object& elf) {
   elf.section_offset += header.size;
 }
 
+void initCodeKeysSection(Object& elf) {
+  // Not part of any segment, only read back by readEntries().
+  SectionHeader& header = elf.getSectionHeader(SectionIdx::kCodeKeys);
+  header.name_offset = elf.shstrtab.insert(".cinderx.codekeys");
+  header.type = kStringTable;
+  header.offset = elf.section_offset;
+  header.size = elf.code_keys.bytes().size();
+  header.align = 0x1;
+
+  checkAlignedSection(header, ".cinderx.codekeys");
+
+  elf.section_offset += header.size;
+}
+
 void initShstrtabSection(Object& elf) {
   SectionHeader& header = elf.getSectionHeader(SectionIdx::kShstrtab);
   header.name_offset = elf.shstrtab.insert(".shstrtab");
@@ -304,9 +320,26 @@ void writeElf(
   write(os, elf.dynamic.bytes());
   pad(os, elf.dynamic_padding);
 
+  write(os, elf.code_keys.bytes());
   write(os, elf.shstrtab.bytes());
 }
 
+std::optional<std::vector<LoadedCodeEntry>> readFailed(std::string_view why) {
+  JIT_LOG("Failed to read code entries from ELF stream: {}", why);
+  return std::nullopt;
+}
+
+// Bounds-checked view of a section's bytes in the file.
+std::optional<std::string_view> sectionBytes(
+    std::string_view file,
+    const SectionHeader& header) {
+  if (header.offset > file.size() ||
+      header.size > file.size() - header.offset) {
+    return std::nullopt;
+  }
+  return file.substr(header.offset, header.size);
+}
+
 } // namespace
 
 void writeEntries(std::ostream& os, const std::vector<CodeEntry>& entries) {
@@ -324,6 +357,8 @@ void writeEntries(std::ostream& os, const std::vector<CodeEntry>& entries) {
     sym.size = entry.code.size();
     elf.dynsym.insert(std::move(sym));
 
+    elf.code_keys.insert(entry.code_key);
+
     // TODO(T176630885): Not writing the filename or lineno yet.
 
     text_end_address += entry.code.size();
@@ -359,6 +394,7 @@ void writeEntries(std::ostream& os, const std::vector<CodeEntry>& entries) {
   initDynamicSection(elf);
   elf.dynamic_padding = alignOffset(elf, 0x8);
 
+  initCodeKeysSection(elf);
   initShstrtabSection(elf);
 
   initTextSegment(elf);
@@ -369,4 +405,89 @@ void writeEntries(std::ostream& os, const std::vector<CodeEntry>& entries) {
   writeElf(os, elf, entries);
 }
 
+std::optional<std::vector<LoadedCodeEntry>> readEntries(std::istream& is) {
+  std::string file{std::istreambuf_iterator<char>{is}, {}};
+
+  FileHeader file_header;
+  if (file.size() < sizeof(file_header)) {
+    return readFailed("file is too small");
+  }
+  std::memcpy(
+      static_cast<void*>(&file_header), file.data(), sizeof(file_header));
+  if (std::memcmp(file_header.magic, FileHeader{}.magic, 4) != 0) {
+    return readFailed("bad magic value");
+  }
+
+  std::array<SectionHeader, raw(SectionIdx::kTotal)> section_headers;
+  if (file_header.section_header_count != section_headers.size() ||
+      file_header.section_header_offset > file.size() ||
+      file.size() - file_header.section_header_offset <
+          sizeof(section_headers)) {
+    return readFailed("unexpected section header table");
+  }
+  std::memcpy(
+      &section_headers,
+      file.data() + file_header.section_header_offset,
+      sizeof(section_headers));
+
+  auto text = sectionBytes(file, section_headers[raw(SectionIdx::kText)]);
+  auto dynsym = sectionBytes(file, section_headers[raw(SectionIdx::kDynsym)]);
+  auto dynstr = sectionBytes(file, section_headers[raw(SectionIdx::kDynstr)]);
+  auto code_keys =
+      sectionBytes(file, section_headers[raw(SectionIdx::kCodeKeys)]);
+  if (!text || !dynsym || !dynstr || !code_keys) {
+    return readFailed("section extends past the end of the file");
+  }
+  uint64_t text_address = section_headers[raw(SectionIdx::kText)].address;
+
+  // Code keys are NUL-terminated strings following the leading NUL, one per
+  // function symbol.
+  std::vector<std::string_view> keys;
+  for (size_t pos = 1; pos < code_keys->size();) {
+    size_t end = code_keys->find('\0', pos);
+    if (end == std::string_view::npos) {
+      return readFailed("unterminated code key");
+    }
+    keys.emplace_back(code_keys->substr(pos, end - pos));
+    pos = end + 1;
+  }
+
+  std::vector<LoadedCodeEntry> entries;
+  size_t num_syms = dynsym->size() / sizeof(Symbol);
+  // Skip the undefined symbol at index 0.
+  for (size_t i = 1; i < num_syms; ++i) {
+    Symbol sym;
+    std::memcpy(
+        static_cast<void*>(&sym),
+        dynsym->data() + i * sizeof(Symbol),
+        sizeof(Symbol));
+    if (sym.info != (kGlobal | kFunc) ||
+        sym.section_index != raw(SectionIdx::kText)) {
+      continue;
+    }
+    size_t name_end = dynstr->find('\0', sym.name_offset);
+    if (name_end == std::string_view::npos) {
+      return readFailed("symbol name out of bounds");
+    }
+    uint64_t code_offset = sym.address - text_address;
+    if (sym.address < text_address || code_offset > text->size() ||
+        sym.size > text->size() - code_offset) {
+      return readFailed("symbol code out of bounds");
+    }
+
+    LoadedCodeEntry entry;
+    auto code = std::as_bytes(std::span{text->substr(code_offset, sym.size)});
+    entry.code.assign(code.begin(), code.end());
+    entry.func_name =
+        dynstr->substr(sym.name_offset, name_end - sym.name_offset);
+    size_t func_idx = entries.size();
+    if (func_idx < keys.size()) {
+      entry.code_key = keys[func_idx];
+    }
+    entries.emplace_back(std::move(entry));
+  }
+
+  return entries;
+}
+
 } // namespace jit::elf
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstring>
 #include <iosfwd>
+#include <optional>
 #include <span>
 #include <string>
 #include <vector>
@@ -53,6 +54,7 @@ enum class SectionIdx : uint32_t {
   kDynstr,
   kHash,
   kDynamic,
+  kCodeKeys,
   kShstrtab,
   kTotal,
 };
@@ -416,6 +418,9 @@ struct Object {
   DynamicTable dynamic;
   uint32_t dynamic_padding{0};
 
+  // Code keys of each function, in the same order as the function symbols.
+  StringTable code_keys;
+
   StringTable shstrtab;
 
   uint32_t section_offset{0};
@@ -436,6 +441,18 @@ struct CodeEntry {
   std::string func_name;
   std::string file_name;
   size_t lineno{0};
+
+  // Key identifying the code object across processes, see
+  // ProfileRuntime::codeKey().  Stored in the non-loadable .cinderx.codekeys
+  // section.
+  std::string code_key;
+};
+
+// Code entry read back from an ELF file written by writeEntries().
+struct LoadedCodeEntry {
+  std::vector<std::byte> code;
+  std::string func_name;
+  std::string code_key;
 };
 
 // Write function or code objects out to a new ELF file.
@@ -443,4 +460,8 @@ struct CodeEntry {
 // The output ELF file is always a shared library.
 void writeEntries(std::ostream& os, const std::vector<CodeEntry>& entries);
 
+// Read back the entries of an ELF file written by writeEntries().  Returns
+// std::nullopt if the stream doesn't contain a well-formed file.
+std::optional<std::vector<LoadedCodeEntry>> readEntries(std::istream& is);
+
 } // namespace jit::elf
@@ -161,6 +161,7 @@ bool isPassthrough(const Instr& instr) {
     case Opcode::kVectorCall:
     case Opcode::kVectorCallKW:
     case Opcode::kVectorCallStatic:
+    case Opcode::kVirtualObject:
     case Opcode::kWaitHandleLoadCoroOrResult:
     case Opcode::kWaitHandleLoadWaiter:
     case Opcode::kYieldAndYieldFrom:
@@ -490,6 +491,20 @@ void ForwardDataflowAnalysis::Run() {
   }
 }
 
+// A VirtualObject is never allocated, so its fields must stay alive for as
+// long as something might need to materialize it: a use of a VirtualObject is
+// also a use of each of its fields.
+template <typename UseFunc>
+static void useWithVirtualFields(Register* reg, UseFunc& use) {
+  use(reg);
+  Instr* def = reg->instr();
+  if (def != nullptr && def->IsVirtualObject()) {
+    for (std::size_t i = 0, n = def->NumOperands(); i < n; ++i) {
+      useWithVirtualFields(def->GetOperand(i), use);
+    }
+  }
+}
+
 template <typename OutputFunc, typename UseFunc>
 static void analyzeInstrLiveness(
     const Instr& instr,
@@ -505,7 +520,7 @@ static void analyzeInstrLiveness(
   }
 
   instr.visitUses([&](Register* reg) {
-    use(reg);
+    useWithVirtualFields(reg, use);
     return true;
   });
 
@@ -24,9 +24,11 @@
 #include "cinderx/Jit/hir/preload.h"
 #include "cinderx/Jit/hir/ssa.h"
 #include "cinderx/Jit/hir/type.h"
+#include "cinderx/Jit/jit_rt.h"
 #include "cinderx/Jit/profile_runtime.h"
 #include "cinderx/Jit/pyjit.h"
 #include "cinderx/Jit/threaded_compile.h"
+#include "cinderx/Jit/type_deopt_patchers.h"
 
 #include <folly/tracing/StaticTracepoint.h>
 
@@ -533,6 +535,12 @@ std::unique_ptr<Function> buildHIR(const Preloader& preloader) {
   return HIRBuilder{preloader}.buildHIR();
 }
 
+std::unique_ptr<Function> buildOSRHIR(
+    const Preloader& preloader,
+    const OSREntry& osr_entry) {
+  return HIRBuilder{preloader, osr_entry}.buildHIR();
+}
+
 // This performs an abstract interpretation over the bytecode for func in order
 // to translate it from a stack to register machine. The translation proceeds
 // in two passes over the bytecode. First, basic block boundaries are
@@ -552,7 +560,12 @@ std::unique_ptr<Function> HIRBuilder::buildHIR() {
   }
 
   std::unique_ptr<Function> irfunc = preloader_.makeFunction();
-  buildHIRImpl(irfunc.get(), /*frame_state=*/nullptr);
+  if (osr_entry_.has_value()) {
+    irfunc->osr_entry = osr_entry_;
+    buildOSRHIRImpl(irfunc.get());
+  } else {
+    buildHIRImpl(irfunc.get(), /*frame_state=*/nullptr);
+  }
   // Use RemoveTrampolineBlocks and RemoveUnreachableBlocks directly instead of
   // Run because the rest of CleanCFG requires SSA.
   CleanCFG::RemoveTrampolineBlocks(&irfunc->cfg);
@@ -624,6 +637,49 @@ BasicBlock* HIRBuilder::buildHIRImpl(
   return entry_block;
 }
 
+void HIRBuilder::buildOSRHIRImpl(Function* irfunc) {
+  temps_ = TempAllocator(&irfunc->env);
+
+  BytecodeInstructionBlock bc_instrs{code_};
+  block_map_ = createBlocks(*irfunc, bc_instrs);
+
+  // The entry block takes the place of everything the interpreter executed
+  // before reaching the loop header. Locals and cells are loaded from the
+  // frame as arguments and may be unbound; the value stack goes into the
+  // canonical stack registers so the loop's back-edges agree with it.
+  BasicBlock* entry_block = irfunc->cfg.AllocateBlock();
+  irfunc->cfg.entry_block = entry_block;
+  TranslationContext entry_tc{
+      entry_block,
+      FrameState{
+          code_,
+          preloader_.globals(),
+          preloader_.builtins(),
+          /*parent=*/nullptr}};
+  AllocateRegistersForLocals(&irfunc->env, entry_tc.frame);
+  AllocateRegistersForCells(&irfunc->env, entry_tc.frame);
+
+  uint32_t arg_idx = 0;
+  for (Register* local : entry_tc.frame.locals) {
+    entry_tc.emit<LoadArg>(local, arg_idx++, TOptObject);
+  }
+  for (Register* cell : entry_tc.frame.cells) {
+    entry_tc.emit<LoadArg>(cell, arg_idx++, TCell);
+  }
+  for (int i = 0; i < osr_entry_->stack_depth; i++) {
+    Register* value = temps_.GetOrAllocateStack(i);
+    entry_tc.emit<LoadArg>(value, arg_idx++, TObject);
+    entry_tc.frame.stack.push(value);
+  }
+
+  BCOffset loop_header_off = osr_entry_->loop_header;
+  BasicBlock* loop_header = getBlockAtOff(loop_header_off);
+  entry_block->appendWithOff<Branch>(loop_header_off, loop_header);
+
+  entry_tc.block = loop_header;
+  translate(*irfunc, bc_instrs, entry_tc);
+}
+
 void HIRBuilder::emitProfiledTypes(
     TranslationContext& tc,
     const ProfileRuntime& profile_runtime,
@@ -634,9 +690,17 @@ void HIRBuilder::emitProfiledTypes(
     // about its stack inputs.
     return;
   }
+  if (bc_instr.opcode() == FOR_ITER &&
+      index_loops_.count(bc_instr.offset())) {
+    // The iterator is a VirtualObject, which can't be guarded.
+    return;
+  }
 
-  std::vector<Type> types = profile_runtime.getProfiledTypes(
-      tc.frame.code, code_key, bc_instr.offset());
+  // Background compile workers run alongside the interpreter, which may be
+  // recording new profiles.
+  std::vector<Type> types = THREADED_COMPILE_SERIALIZED_CALL(
+      profile_runtime.getProfiledTypes(
+          tc.frame.code, code_key, bc_instr.offset()));
 
   if (types.empty() || types.size() > tc.frame.stack.size()) {
     // The types are either absent or invalid (e.g., from a different version
@@ -644,6 +708,14 @@ void HIRBuilder::emitProfiledTypes(
     return;
   }
 
+  // A previous compilation deopted too often on these types. GuardType can
+  // only check a single exact type, so the closest widening of the guard is to
+  // drop it.
+  if (THREADED_COMPILE_SERIALIZED_CALL(profile_runtime.hasGuardFailure(
+          tc.frame.code, bc_instr.offset()))) {
+    return;
+  }
+
   // TODO(T115140951): Add a more robust method of determining what type
   // information differs between interpreter runs and static JITted bytecode
   if (bc_instr.opcode() == STORE_FIELD) {
@@ -1102,7 +1174,7 @@ void HIRBuilder::translate(
           break;
         }
         case GET_ITER: {
-          emitGetIter(tc);
+          emitGetIter(irfunc.cfg, tc, bc_instrs, bc_instr);
           break;
         }
         case GET_YIELD_FROM_ITER: {
@@ -1173,7 +1245,7 @@ void HIRBuilder::translate(
           break;
         }
         case FOR_ITER: {
-          emitForIter(tc, bc_instr);
+          emitForIter(irfunc.cfg, tc, bc_instr);
           break;
         }
         case LOAD_FIELD: {
@@ -1344,13 +1416,16 @@ void HIRBuilder::translate(
     BytecodeInstruction last_bc_instr = bc_block.lastInstr();
     switch (last_bc_instr.opcode()) {
       case FOR_ITER: {
-        auto condbr = static_cast<CondBranchIterNotDone*>(last_instr);
         auto new_frame = tc.frame;
         // Sentinel value signaling iteration is complete and the iterator
         // itself
         new_frame.stack.discard(2);
-        queue.emplace_back(condbr->true_bb(), tc.frame);
-        queue.emplace_back(condbr->false_bb(), new_frame);
+        // An index loop ends its FOR_ITER in a block of its own that loads the
+        // next item, so find the successors from the bytecode.
+        queue.emplace_back(
+            getBlockAtOff(last_bc_instr.NextInstrOffset()), tc.frame);
+        queue.emplace_back(
+            getBlockAtOff(last_bc_instr.GetJumpTarget()), new_frame);
         break;
       }
       case JUMP_IF_FALSE_OR_POP:
@@ -2043,6 +2118,13 @@ bool HIRBuilder::emitInvokeMethod(
     return false;
   }
 
+  // Awaited calls keep going through the vtable so the callee can be eagerly
+  // evaluated.
+  if (target.devirt_type != nullptr && !is_classmethod && !is_awaited) {
+    emitDevirtualizedMethodCall(tc, target, nargs);
+    return false;
+  }
+
   std::vector<Register*> arg_regs =
       setupStaticArgs(tc, target, nargs, target.is_statically_typed);
 
@@ -2076,6 +2158,35 @@ bool HIRBuilder::emitInvokeMethod(
   return true;
 }
 
+void HIRBuilder::emitDevirtualizedMethodCall(
+    TranslationContext& tc,
+    const InvokeTarget& target,
+    long nargs) {
+  // No subclass of the declaring type overrides the method, so every receiver
+  // dispatches to target.func(). Creating an overriding subclass or patching
+  // the method invalidates this code.
+  auto patchpoint = tc.emit<DeoptPatchpoint>(
+      Runtime::get()->allocateDeoptPatcher<MethodOverrideDeoptPatcher>(
+          target.devirt_type, target.devirt_name, target.callable));
+  patchpoint->setGuiltyReg(tc.frame.stack.top(nargs - 1));
+  patchpoint->setDescr(
+      fmt::format("INVOKE_METHOD: {}", PyUnicode_AsUTF8(target.devirt_name)));
+
+  jit::tryCompilePreloaded(target.func());
+
+  Register* funcreg = temps_.AllocateStack();
+  Register* out = temps_.AllocateStack();
+  tc.emit<LoadConst>(funcreg, Type::fromObject(target.callable));
+  auto call = tc.emit<InvokeStaticFunction>(
+      nargs + 1, out, target.func(), target.return_type);
+  call->SetOperand(0, funcreg);
+  for (auto i = nargs - 1; i >= 0; i--) {
+    call->SetOperand(i + 1, tc.frame.stack.pop());
+  }
+  call->setFrameState(tc.frame);
+  tc.frame.stack.push(out);
+}
+
 void HIRBuilder::emitIsOp(TranslationContext& tc, int oparg) {
   auto& stack = tc.frame.stack;
   Register* right = stack.pop();
@@ -2129,6 +2240,18 @@ void HIRBuilder::emitGetLen(TranslationContext& tc) {
   stack.push(result);
 }
 
+// Attach the interpreter's counts of which way a conditional jump went to the
+// CondBranch translated from it, for use in block layout.
+static void setProfiledCounts(
+    CondBranch* branch,
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) {
+  auto& profile_runtime = Runtime::get()->profileRuntime();
+  BranchProfile profile = THREADED_COMPILE_SERIALIZED_CALL(
+      profile_runtime.getBranchProfile(code, bc_off));
+  branch->setProfiledCounts(profile.true_count, profile.false_count);
+}
+
 void HIRBuilder::emitJumpIf(
     TranslationContext& tc,
     const jit::BytecodeInstruction& bc_instr) {
@@ -2170,7 +2293,8 @@ void HIRBuilder::emitJumpIf(
     // the home of a value left on the stack at the end of a basic block, so we
     // don't need to worry about potentially storing a PyObject in them.
     tc.emit<IsTruthy>(tval, var, tc.frame);
-    tc.emit<CondBranch>(tval, true_block, false_block);
+    auto branch = tc.emit<CondBranch>(tval, true_block, false_block);
+    setProfiledCounts(branch, tc.frame.code, bc_instr.offset());
   } else {
     tc.emit<CondBranch>(var, true_block, false_block);
   }
@@ -2525,9 +2649,10 @@ static inline Type element_type_from_seq_type(int seq_type) {
     case SEQ_CHECKED_LIST:
     case SEQ_TUPLE:
       return TObject;
-    case SEQ_ARRAY_INT64:
-      return TCInt64;
     default:
+      if (_Py_IS_TYPED_ARRAY(seq_type)) {
+        return prim_type_to_type(_Py_SEQ_ARRAY_ELEMENT_TYPE(seq_type));
+      }
       JIT_ABORT("Invalid sequence type: ({})", seq_type);
       // NOTREACHED
       break;
@@ -2743,7 +2868,7 @@ void HIRBuilder::emitSequenceGet(
       oparg == SEQ_CHECKED_LIST) {
     int offset = offsetof(PyListObject, ob_item);
     tc.emit<LoadField>(ob_item, sequence, "ob_item", offset, TCPtr);
-  } else if (oparg == SEQ_ARRAY_INT64) {
+  } else if (_Py_IS_TYPED_ARRAY(oparg)) {
     Register* offset_reg = temps_.AllocateStack();
     tc.emit<LoadConst>(
         offset_reg,
@@ -2777,7 +2902,7 @@ void HIRBuilder::emitSequenceSet(
   }
   tc.emit<CheckSequenceBounds>(adjusted_idx, sequence, idx, tc.frame);
   auto ob_item = temps_.AllocateStack();
-  if (oparg == SEQ_ARRAY_INT64) {
+  if (_Py_IS_TYPED_ARRAY(oparg)) {
     Register* offset_reg = temps_.AllocateStack();
     tc.emit<LoadConst>(
         offset_reg,
@@ -3033,7 +3158,8 @@ void HIRBuilder::emitPopJumpIf(
       bc_instr.opcode() == POP_JUMP_IF_TRUE) {
     Register* tval = temps_.AllocateNonStack();
     tc.emit<IsTruthy>(tval, var, tc.frame);
-    tc.emit<CondBranch>(tval, true_block, false_block);
+    auto branch = tc.emit<CondBranch>(tval, true_block, false_block);
+    setProfiledCounts(branch, tc.frame.code, bc_instr.offset());
   } else {
     tc.emit<CondBranch>(var, true_block, false_block);
   }
@@ -3084,22 +3210,166 @@ void HIRBuilder::emitStoreSubscr(TranslationContext& tc) {
   tc.emit<StoreSubscr>(result, container, sub, value, tc.frame);
 }
 
-void HIRBuilder::emitGetIter(TranslationContext& tc) {
+void HIRBuilder::emitGetIter(
+    CFG& cfg,
+    TranslationContext& tc,
+    const jit::BytecodeInstructionBlock& bc_instrs,
+    const jit::BytecodeInstruction& bc_instr) {
   Register* iterable = tc.frame.stack.pop();
   Register* result = temps_.AllocateStack();
-  tc.emit<GetIter>(result, iterable, tc.frame);
+  if (!tryEmitIndexLoop(cfg, tc, bc_instrs, bc_instr, iterable, result)) {
+    tc.emit<GetIter>(result, iterable, tc.frame);
+  }
   tc.frame.stack.push(result);
 }
 
+// If profiling says that a for loop always iterates over an exact list, tuple
+// or range, loop over its indices instead of calling tp_iternext on an
+// iterator. Only GET_ITERs immediately followed by their FOR_ITER qualify,
+// which covers every for statement.
+bool HIRBuilder::tryEmitIndexLoop(
+    CFG& cfg,
+    TranslationContext& tc,
+    const jit::BytecodeInstructionBlock& bc_instrs,
+    const jit::BytecodeInstruction& bc_instr,
+    Register* iterable,
+    Register* iter) {
+  // An OSR entry receives the interpreter's iterators on the operand stack.
+  if (osr_entry_.has_value()) {
+    return false;
+  }
+  BCOffset for_iter_off = bc_instr.NextInstrOffset();
+  if (for_iter_off >= bc_instrs.endOffset() ||
+      bc_instrs.at(for_iter_off).opcode() != FOR_ITER) {
+    return false;
+  }
+
+  // emitProfiledTypes() has just guarded the iterable's type, if the profile
+  // had one.
+  Instr* last = tc.block->GetTerminator();
+  if (last == nullptr || !last->IsGuardType() ||
+      last->GetOperand(0) != iterable) {
+    return false;
+  }
+  Type type = static_cast<GuardType*>(last)->target();
+  Type iter_type{TBottom};
+  if (type <= TListExact) {
+    iter_type = Type::fromTypeExact(&PyListIter_Type);
+  } else if (type <= TTupleExact) {
+    iter_type = Type::fromTypeExact(&PyTupleIter_Type);
+  } else if (type <= Type::fromTypeExact(&PyRange_Type)) {
+    iter_type = Type::fromTypeExact(&PyRangeIter_Type);
+  } else {
+    return false;
+  }
+
+  IndexLoop loop{
+      .seq = temps_.AllocateNonStack(),
+      .index = temps_.AllocateNonStack(),
+      .iter_type = iter_type,
+  };
+  // Reading a list's items or a range's members through an object of another
+  // type is unsafe, and nothing below has an operand type that would keep
+  // GuardTypeRemoval from dropping the guard.
+  tc.emit<UseType>(iterable, type);
+  tc.emit<Assign>(loop.seq, iterable);
+  if (iter_type <= Type::fromTypeExact(&PyRangeIter_Type)) {
+    // Ranges too large for a range_iterator are left to the interpreter.
+    TranslationContext deopt_path{cfg.AllocateBlock(), tc.frame};
+    deopt_path.frame.next_instr_offset = bc_instr.offset();
+    deopt_path.frame.stack.push(iterable);
+    deopt_path.snapshot();
+    Deopt* deopt = deopt_path.emit<Deopt>();
+    deopt->setGuiltyReg(iterable);
+    deopt->setDescr("GET_ITER");
+
+    auto call_range_helper = [&](auto helper) {
+      Register* result = temps_.AllocateNonStack();
+      tc.emit<CallStatic>(1, result, reinterpret_cast<void*>(helper), TCInt64)
+          ->SetOperand(0, loop.seq);
+      return result;
+    };
+    loop.len = call_range_helper(JITRT_RangeIterLen);
+    Register* zero = temps_.AllocateNonStack();
+    Register* fits = temps_.AllocateNonStack();
+    tc.emit<LoadConst>(zero, Type::fromCInt(0, TCInt64));
+    tc.emit<PrimitiveCompare>(
+        fits, PrimitiveCompareOp::kGreaterThanEqual, loop.len, zero);
+    BasicBlock* fast_path = cfg.AllocateBlock();
+    tc.emit<CondBranch>(fits, fast_path, deopt_path.block);
+    tc.block = fast_path;
+    loop.start = call_range_helper(JITRT_RangeStart);
+    loop.step = call_range_helper(JITRT_RangeStep);
+  }
+  tc.emit<LoadConst>(loop.index, Type::fromCInt(0, TCInt64));
+  auto vobj = tc.emit<VirtualObject>(2, iter, iter_type);
+  vobj->SetOperand(0, loop.seq);
+  vobj->SetOperand(1, loop.index);
+  index_loops_.emplace(for_iter_off, loop);
+  return true;
+}
+
 void HIRBuilder::emitForIter(
+    CFG& cfg,
     TranslationContext& tc,
     const jit::BytecodeInstruction& bc_instr) {
+  BasicBlock* footer = getBlockAtOff(bc_instr.GetJumpTarget());
+  BasicBlock* body = getBlockAtOff(bc_instr.NextInstrOffset());
+  auto loop_it = index_loops_.find(bc_instr.offset());
+  if (loop_it != index_loops_.end()) {
+    const IndexLoop& loop = loop_it->second;
+    Register* len = loop.len;
+    if (len == nullptr) {
+      // Lists can change size while we iterate over them.
+      len = temps_.AllocateNonStack();
+      tc.emit<LoadVarObjectSize>(len, loop.seq);
+    }
+    Register* has_next = temps_.AllocateNonStack();
+    tc.emit<PrimitiveCompare>(
+        has_next, PrimitiveCompareOp::kLessThan, loop.index, len);
+    BasicBlock* next_block = cfg.AllocateBlock();
+    tc.emit<CondBranch>(has_next, next_block, footer);
+
+    tc.block = next_block;
+    Register* item = temps_.AllocateStack();
+    if (loop.iter_type <= Type::fromTypeExact(&PyListIter_Type)) {
+      Register* ob_item = temps_.AllocateNonStack();
+      tc.emit<LoadField>(
+          ob_item, loop.seq, "ob_item", offsetof(PyListObject, ob_item), TCPtr);
+      tc.emit<LoadArrayItem>(item, ob_item, loop.index, loop.seq, 0, TObject);
+    } else if (loop.iter_type <= Type::fromTypeExact(&PyTupleIter_Type)) {
+      tc.emit<LoadArrayItem>(
+          item,
+          loop.seq,
+          loop.index,
+          loop.seq,
+          offsetof(PyTupleObject, ob_item),
+          TObject);
+    } else {
+      Register* offset = temps_.AllocateNonStack();
+      Register* value = temps_.AllocateNonStack();
+      tc.emit<IntBinaryOp>(
+          offset, BinaryOpKind::kMultiply, loop.index, loop.step);
+      tc.emit<IntBinaryOp>(value, BinaryOpKind::kAdd, loop.start, offset);
+      tc.emit<PrimitiveBox>(item, value, TCInt64, tc.frame);
+    }
+    Register* one = temps_.AllocateNonStack();
+    tc.emit<LoadConst>(one, Type::fromCInt(1, TCInt64));
+    tc.emit<IntBinaryOp>(loop.index, BinaryOpKind::kAdd, loop.index, one);
+    Register* iter = temps_.AllocateStack();
+    auto vobj = tc.emit<VirtualObject>(2, iter, loop.iter_type);
+    vobj->SetOperand(0, loop.seq);
+    vobj->SetOperand(1, loop.index);
+    tc.frame.stack.topPut(0, iter);
+    tc.frame.stack.push(item);
+    // The block falls through to the loop body.
+    return;
+  }
+
   Register* iterator = tc.frame.stack.top();
   Register* next_val = temps_.AllocateStack();
   tc.emit<InvokeIterNext>(next_val, iterator, tc.frame);
   tc.frame.stack.push(next_val);
-  BasicBlock* footer = getBlockAtOff(bc_instr.GetJumpTarget());
-  BasicBlock* body = getBlockAtOff(bc_instr.NextInstrOffset());
   tc.emit<CondBranchIterNotDone>(next_val, body, footer);
 }
 
@@ -15,6 +15,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -90,6 +91,12 @@ class BlockCanonicalizer {
 // analysis.
 std::unique_ptr<Function> buildHIR(const Preloader& preloader);
 
+// Like buildHIR, but the resulting function is entered at a loop header from a
+// running interpreter frame, as described by osr_entry.
+std::unique_ptr<Function> buildOSRHIR(
+    const Preloader& preloader,
+    const OSREntry& osr_entry);
+
 // Inlining merges all of the different callee Returns (which terminate blocks,
 // leading to a bunch of distinct exit blocks) into Branches to one Return
 // block (one exit block), which the caller can transform into an Assign to the
@@ -107,8 +114,12 @@ struct InlineResult {
 
 class HIRBuilder {
  public:
-  HIRBuilder(const Preloader& preloader)
-      : code_(preloader.code()), preloader_(preloader){};
+  HIRBuilder(
+      const Preloader& preloader,
+      std::optional<OSREntry> osr_entry = std::nullopt)
+      : code_(preloader.code()),
+        preloader_(preloader),
+        osr_entry_(osr_entry){};
 
   // Translate the bytecode for code_ into HIR, in the context of the preloaded
   // globals and classloader lookups from preloader_.
@@ -140,6 +151,10 @@ class HIRBuilder {
   // Returns the entry block.
   BasicBlock* buildHIRImpl(Function* irfunc, FrameState* frame_state);
 
+  // Used by buildHIR when osr_entry_ is set. Translates only the code reachable
+  // from the OSR loop header.
+  void buildOSRHIRImpl(Function* irfunc);
+
   struct TranslationContext;
   void translate(
       Function& irfunc,
@@ -273,7 +288,18 @@ class HIRBuilder {
   bool emitInvokeNative(
       TranslationContext& tc,
       const jit::BytecodeInstruction& bc_instr);
-  void emitGetIter(TranslationContext& tc);
+  void emitGetIter(
+      CFG& cfg,
+      TranslationContext& tc,
+      const jit::BytecodeInstructionBlock& bc_instrs,
+      const jit::BytecodeInstruction& bc_instr);
+  bool tryEmitIndexLoop(
+      CFG& cfg,
+      TranslationContext& tc,
+      const jit::BytecodeInstructionBlock& bc_instrs,
+      const jit::BytecodeInstruction& bc_instr,
+      Register* iterable,
+      Register* iter);
   void emitGetYieldFromIter(CFG& cfg, TranslationContext& tc);
   void emitListAppend(
       TranslationContext& tc,
@@ -283,12 +309,17 @@ class HIRBuilder {
       const jit::BytecodeInstruction& bc_instr);
   void emitListToTuple(TranslationContext& tc);
   void emitForIter(
+      CFG& cfg,
       TranslationContext& tc,
       const jit::BytecodeInstruction& bc_instr);
   bool emitInvokeMethod(
       TranslationContext& tc,
       const jit::BytecodeInstruction& bc_instr,
       bool is_awaited);
+  void emitDevirtualizedMethodCall(
+      TranslationContext& tc,
+      const InvokeTarget& target,
+      long nargs);
   void emitLoadField(
       TranslationContext& tc,
       const jit::BytecodeInstruction& bc_instr);
@@ -485,6 +516,25 @@ class HIRBuilder {
   BorrowedRef<PyCodeObject> code_;
   BlockMap block_map_;
   const Preloader& preloader_;
+  std::optional<OSREntry> osr_entry_;
+
+  // A for loop over a list, tuple or range that tryEmitIndexLoop() lowered to
+  // a loop over the iterable's indices. The iterator on the operand stack is a
+  // VirtualObject of seq and index, so it's only allocated if we deopt inside
+  // the loop.
+  struct IndexLoop {
+    Register* seq;
+    // Index of the next item. Reassigned on every iteration.
+    Register* index;
+    // The type of the materialized iterator.
+    Type iter_type;
+    // Only set for ranges.
+    Register* len{nullptr};
+    Register* start{nullptr};
+    Register* step{nullptr};
+  };
+  // Keyed by the offset of the loop's FOR_ITER.
+  std::unordered_map<BCOffset, IndexLoop> index_loops_;
 
   TempAllocator temps_{nullptr};
 };
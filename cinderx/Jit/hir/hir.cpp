@@ -188,6 +188,7 @@ bool Instr::isReplayable() const {
     case Opcode::kUnicodeConcat:
     case Opcode::kUnicodeSubscr:
     case Opcode::kUseType:
+    case Opcode::kVirtualObject:
     case Opcode::kWaitHandleLoadCoroOrResult:
     case Opcode::kWaitHandleLoadWaiter: {
       return true;
@@ -909,6 +910,9 @@ int Function::numArgs() const {
     // code might be null if we parsed from textual ir
     return 0;
   }
+  if (osr_entry.has_value()) {
+    return numVars() + osr_entry->stack_depth;
+  }
   return code->co_argcount + code->co_kwonlyargcount +
       bool(code->co_flags & CO_VARARGS) + bool(code->co_flags & CO_VARKEYWORDS);
 }
@@ -2361,9 +2361,26 @@ class CondBranchBase : public Instr {
     return i == 0 ? &true_edge_ : &false_edge_;
   }
 
+  // How many times the interpreter took each edge while profiling the
+  // bytecode that this branch was built from. Both are zero if unknown.
+  uint32_t profiledTrueCount() const {
+    return profiled_true_count_;
+  }
+
+  uint32_t profiledFalseCount() const {
+    return profiled_false_count_;
+  }
+
+  void setProfiledCounts(uint32_t true_count, uint32_t false_count) {
+    profiled_true_count_ = true_count;
+    profiled_false_count_ = false_count;
+  }
+
  private:
   Edge true_edge_;
   Edge false_edge_;
+  uint32_t profiled_true_count_{0};
+  uint32_t profiled_false_count_{0};
 };
 
 // Transfer control to `true_bb` if `reg` is nonzero, otherwise `false_bb`.
@@ -3006,6 +3023,24 @@ class INSTR_CLASS(MakeTuple, (TObject), HasOutput, Operands<>, DeoptBase) {
   }
 };
 
+// A tuple, list, or slice that the EscapeAnalysis pass proved never escapes
+// the function. The operands are the fields the object would have been
+// filled with. No code is generated for this instruction: its output may only
+// be referenced by FrameStates (directly or as a field of another
+// VirtualObject), and the object is allocated by the deopt machinery if and
+// only if it is needed to reconstruct an interpreter frame.
+class INSTR_CLASS(VirtualObject, (TObject), HasOutput, Operands<>) {
+ public:
+  VirtualObject(Register* dst, Type type) : InstrT(dst), type_(type) {}
+
+  Type type() const {
+    return type_;
+  }
+
+ private:
+  Type type_;
+};
+
 // Initialize a tuple from a list
 DEFINE_SIMPLE_INSTR(
     MakeTupleFromList,
@@ -4138,6 +4173,16 @@ struct TypedArgument {
   unsigned long thread_safe_flags;
 };
 
+// Where a function compiled for on-stack replacement is entered. Such functions
+// take over a running interpreter frame at a loop header, and receive the
+// frame's locals, cells, and value stack (in that order) as their arguments.
+struct OSREntry {
+  // Offset of the loop header instruction.
+  BCOffset loop_header;
+  // Depth of the value stack at the loop header.
+  int stack_depth{0};
+};
+
 // Does the given code object need access to its containing PyFunctionObject at
 // runtime?
 bool usesRuntimeFunc(BorrowedRef<PyCodeObject> code);
@@ -4197,10 +4242,19 @@ class Function {
   // is the first argument a primitive?
   bool has_primitive_first_arg{false};
 
+  struct InlineFailure {
+    // Offset of the call in the outermost code object.
+    BCOffset bc_offset;
+    InlineFailureType type;
+    std::string callee;
+  };
+
   struct InlineFunctionStats {
     int num_inlined_functions{0};
     // map of {inline_failure_type -> function_names}
     InlineFailureStats failure_stats;
+    // Every call that we tried and failed to inline, in the order seen.
+    std::vector<InlineFailure> call_site_failures;
   } inline_function_stats;
 
   // vector of {locals_idx, type, optional}
@@ -4212,6 +4266,10 @@ class Function {
 
   FrameMode frameMode{FrameMode::kNormal};
 
+  // Set if this function is entered from a running interpreter frame instead
+  // of being called.
+  std::optional<OSREntry> osr_entry;
+
   CFG cfg;
 
   Environment env;
@@ -4220,7 +4278,8 @@ class Function {
   // phases
   std::unique_ptr<CompilationPhaseTimer> compilation_phase_timer{nullptr};
   // Return the total number of arguments (positional + kwonly + varargs +
-  // varkeywords)
+  // varkeywords), or the number of values taken from the interpreter frame for
+  // OSR functions.
   int numArgs() const;
 
   // Return the number of locals + cellvars + freevars
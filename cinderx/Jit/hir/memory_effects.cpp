@@ -65,6 +65,7 @@ MemoryEffects memoryEffects(const Instr& inst) {
     case Opcode::kUnicodeSubscr:
     case Opcode::kUnreachable:
     case Opcode::kUseType:
+    case Opcode::kVirtualObject:
     case Opcode::kWaitHandleLoadCoroOrResult:
     case Opcode::kWaitHandleLoadWaiter:
       return commonEffects(inst, AEmpty);
@@ -152,6 +152,7 @@ namespace jit::hir {
   V(VectorCall)                        \
   V(VectorCallStatic)                  \
   V(VectorCallKW)                      \
+  V(VirtualObject)                     \
   V(WaitHandleLoadCoroOrResult)        \
   V(WaitHandleLoadWaiter)              \
   V(WaitHandleRelease)                 \
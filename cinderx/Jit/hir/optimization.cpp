@@ -20,8 +20,11 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
 #include <list>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -57,6 +60,9 @@ PassRegistry::PassRegistry() {
   addPass(Simplify::Factory);
   addPass(DeadCodeElimination::Factory);
   addPass(GuardTypeRemoval::Factory);
+  addPass(GlobalValueNumbering::Factory);
+  addPass(LoopInvariantCodeMotion::Factory);
+  addPass(EscapeAnalysis::Factory);
   addPass(BeginInlinedFunctionElimination::Factory);
   addPass(BuiltinLoadMethodElimination::Factory);
   // AllPasses is only used for testing.
@@ -473,6 +479,591 @@ void GuardTypeRemoval::Run(Function& func) {
   reflowTypes(func);
 }
 
+namespace {
+
+// Everything that determines the result of a value-numbered instruction, other
+// than the contents of memory.
+struct ValueKey {
+  Opcode opcode;
+  std::array<Register*, 2> operands{};
+  Type type{TBottom};
+  std::array<uintptr_t, 4> data{};
+
+  bool operator==(const ValueKey& other) const = default;
+};
+
+struct ValueKeyHash {
+  std::size_t operator()(const ValueKey& key) const {
+    std::hash<uintptr_t> hasher;
+    return combineHash(
+        static_cast<std::size_t>(key.opcode),
+        std::hash<Register*>{}(key.operands[0]),
+        std::hash<Register*>{}(key.operands[1]),
+        key.type.hash(),
+        hasher(key.data[0]),
+        hasher(key.data[1]),
+        hasher(key.data[2]),
+        hasher(key.data[3]));
+  }
+};
+
+struct AvailableValue {
+  Register* value;
+  // Memory locations the value was loaded from; AEmpty for pure computations.
+  AliasClass reads;
+};
+
+using AvailableValues = UnorderedMap<ValueKey, AvailableValue, ValueKeyHash>;
+
+// Compute the key of a value-numbered instruction and the memory locations it
+// reads, or return std::nullopt if instr can't be value numbered.
+std::optional<std::pair<ValueKey, AliasClass>> valueKey(const Instr& instr) {
+  ValueKey key{instr.opcode()};
+  if (instr.NumOperands() > key.operands.size()) {
+    return std::nullopt;
+  }
+  for (std::size_t i = 0; i < instr.NumOperands(); ++i) {
+    key.operands[i] = modelReg(instr.GetOperand(i));
+  }
+
+  AliasClass reads{AEmpty};
+  switch (instr.opcode()) {
+    case Opcode::kGuardIs:
+      key.data[0] = reinterpret_cast<uintptr_t>(
+          static_cast<const GuardIs&>(instr).target());
+      break;
+    case Opcode::kGuardType:
+      key.type = static_cast<const GuardType&>(instr).target();
+      break;
+    case Opcode::kIntBinaryOp:
+      key.data[0] =
+          static_cast<uintptr_t>(static_cast<const IntBinaryOp&>(instr).op());
+      break;
+    case Opcode::kPrimitiveCompare:
+      key.data[0] = static_cast<uintptr_t>(
+          static_cast<const PrimitiveCompare&>(instr).op());
+      break;
+    case Opcode::kLoadFieldAddress:
+      break;
+    case Opcode::kLoadField: {
+      auto& load = static_cast<const LoadField&>(instr);
+      if (!load.borrowed()) {
+        // The output is owned by a following StoreField.
+        return std::nullopt;
+      }
+      key.type = load.type();
+      key.data[0] = load.offset();
+      // Object fields are written by more than StoreField (e.g. ListAppend
+      // resizes its list and SetFunctionAttr writes to its function), so
+      // don't trust the finer-grained alias classes here.
+      reads = AManagedHeapAny;
+      break;
+    }
+    case Opcode::kLoadCellItem:
+      reads = ACellItem;
+      break;
+    case Opcode::kLoadGlobalCached: {
+      auto& load = static_cast<const LoadGlobalCached&>(instr);
+      key.data[0] = reinterpret_cast<uintptr_t>(load.globals().get());
+      key.data[1] = reinterpret_cast<uintptr_t>(load.builtins().get());
+      key.data[2] = reinterpret_cast<uintptr_t>(load.code().get());
+      key.data[3] = load.name_idx();
+      reads = AGlobal;
+      break;
+    }
+    case Opcode::kLoadSplitDictItem:
+      key.data[0] = static_cast<const LoadSplitDictItem&>(instr).itemIdx();
+      reads = ADictItem;
+      break;
+    case Opcode::kLoadTupleItem:
+      key.data[0] = static_cast<const LoadTupleItem&>(instr).idx();
+      reads = ATupleItem;
+      break;
+    case Opcode::kLoadTypeAttrCacheItem: {
+      auto& load = static_cast<const LoadTypeAttrCacheItem&>(instr);
+      key.data[0] = load.cache_id();
+      key.data[1] = load.item_idx();
+      reads = ATypeAttrCache;
+      break;
+    }
+    case Opcode::kLoadTypeMethodCacheEntryType:
+      key.data[0] =
+          static_cast<const LoadTypeMethodCacheEntryType&>(instr).cache_id();
+      reads = ATypeMethodCache;
+      break;
+    default:
+      return std::nullopt;
+  }
+  return std::make_pair(key, reads);
+}
+
+// Forget the values loaded from memory that instr may write to.
+void killClobberedValues(AvailableValues& values, const Instr& instr) {
+  if (instr.IsPhi() || instr.IsBranch() || instr.IsCondBranch() ||
+      instr.IsCondBranchCheckType() || instr.IsCondBranchIterNotDone()) {
+    return;
+  }
+  AliasClass may_store = memoryEffects(instr).may_store;
+  if (may_store == AEmpty) {
+    return;
+  }
+  for (auto it = values.begin(); it != values.end();) {
+    if ((it->second.reads & may_store) != AEmpty) {
+      values.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace
+
+void GlobalValueNumbering::Run(Function& irfunc) {
+  DominatorAnalysis doms{irfunc};
+  std::unordered_map<const BasicBlock*, AvailableValues> block_out;
+  bool changed = false;
+
+  for (BasicBlock* block : irfunc.cfg.GetRPOTraversal()) {
+    // Values computed in a dominator are available in every block it
+    // dominates. Loaded values are only still valid if the dominator is the
+    // block's sole predecessor; otherwise memory may have been written on
+    // another path into the block (e.g. a loop backedge).
+    AvailableValues values;
+    if (const BasicBlock* idom = doms.immediateDominator(block)) {
+      values = block_out.at(idom);
+      bool only_pred = block->in_edges().size() == 1;
+      if (!only_pred) {
+        for (auto it = values.begin(); it != values.end();) {
+          if (it->second.reads != AEmpty) {
+            values.erase(it++);
+          } else {
+            ++it;
+          }
+        }
+      }
+    }
+
+    for (auto it = block->begin(); it != block->end();) {
+      Instr& instr = *it;
+      ++it;
+
+      auto key = valueKey(instr);
+      if (key.has_value()) {
+        auto [avail_it, inserted] = values.emplace(
+            key->first, AvailableValue{instr.GetOutput(), key->second});
+        Register* available = avail_it->second.value;
+        if (!inserted && available->type() <= instr.GetOutput()->type()) {
+          auto assign = Assign::create(instr.GetOutput(), available);
+          assign->copyBytecodeOffset(instr);
+          instr.ReplaceWith(*assign);
+          delete &instr;
+          changed = true;
+          continue;
+        }
+      }
+      killClobberedValues(values, instr);
+    }
+    block_out.emplace(block, std::move(values));
+  }
+
+  if (changed) {
+    CopyPropagation{}.Run(irfunc);
+    reflowTypes(irfunc);
+  }
+}
+
+namespace {
+
+struct NaturalLoop {
+  BasicBlock* header;
+  std::unordered_set<BasicBlock*> blocks;
+  // Blocks in the loop with an edge back to the header.
+  std::vector<BasicBlock*> latches;
+};
+
+bool hasNoMemoryEffects(const Instr& instr) {
+  return instr.IsPhi() || instr.IsBranch() || instr.IsCondBranch() ||
+      instr.IsCondBranchCheckType() || instr.IsCondBranchIterNotDone();
+}
+
+// Find all natural loops, innermost first. Loops sharing a header are merged.
+std::vector<NaturalLoop> findNaturalLoops(
+    Function& irfunc,
+    DominatorAnalysis& doms) {
+  std::unordered_map<BasicBlock*, NaturalLoop> loops;
+  for (BasicBlock* block : irfunc.cfg.GetRPOTraversal()) {
+    for (const Edge* edge : block->out_edges()) {
+      BasicBlock* header = edge->to();
+      if (doms.getBlocksDominatedBy(header).count(block) == 0) {
+        continue;
+      }
+      NaturalLoop& loop = loops[header];
+      loop.header = header;
+      loop.blocks.insert(header);
+      loop.latches.emplace_back(block);
+      Worklist<BasicBlock*> worklist;
+      worklist.push(block);
+      while (!worklist.empty()) {
+        BasicBlock* member = worklist.front();
+        worklist.pop();
+        if (!loop.blocks.insert(member).second) {
+          continue;
+        }
+        for (const Edge* in_edge : member->in_edges()) {
+          worklist.push(in_edge->from());
+        }
+      }
+    }
+  }
+
+  std::vector<NaturalLoop> result;
+  for (auto& [header, loop] : loops) {
+    result.emplace_back(std::move(loop));
+  }
+  std::sort(result.begin(), result.end(), [](auto& a, auto& b) {
+    if (a.blocks.size() != b.blocks.size()) {
+      return a.blocks.size() < b.blocks.size();
+    }
+    return a.header->id < b.header->id;
+  });
+  return result;
+}
+
+// Return the FrameState describing the interpreter's state when entering the
+// loop from its preheader, or std::nullopt if it can't be determined.
+std::optional<FrameState> loopEntryFrameState(
+    const NaturalLoop& loop,
+    BasicBlock* preheader_pred) {
+  Snapshot* snapshot = loop.header->entrySnapshot();
+  if (snapshot == nullptr) {
+    // Loop headers usually start with an eval breaker check that leads to
+    // blocks starting with the header's state.
+    for (Instr& instr : *loop.header) {
+      if (!instr.IsPhi() && !instr.IsTerminator() && !instr.isReplayable()) {
+        return std::nullopt;
+      }
+    }
+    for (const Edge* edge : loop.header->out_edges()) {
+      if (loop.blocks.count(edge->to()) != 0 &&
+          (snapshot = edge->to()->entrySnapshot()) != nullptr) {
+        break;
+      }
+    }
+  }
+  if (snapshot == nullptr || snapshot->frameState() == nullptr) {
+    return std::nullopt;
+  }
+
+  // Replace the header's Phis with their inputs from outside the loop. The
+  // state can't refer to anything else defined inside the loop.
+  std::unordered_map<Register*, Register*> entry_values;
+  loop.header->forEachPhi([&](Phi& phi) {
+    for (size_t i = 0; i < phi.NumOperands(); ++i) {
+      if (phi.basic_blocks()[i] == preheader_pred) {
+        entry_values[phi.GetOutput()] = phi.GetOperand(i);
+      }
+    }
+  });
+  FrameState frame_state = *snapshot->frameState();
+  bool valid = true;
+  auto map_reg = [&](Register*& reg) {
+    if (reg == nullptr) {
+      return;
+    }
+    auto it = entry_values.find(reg);
+    if (it != entry_values.end()) {
+      reg = it->second;
+    } else if (loop.blocks.count(reg->instr()->block()) != 0) {
+      valid = false;
+    }
+  };
+  for (auto& reg : frame_state.stack) {
+    map_reg(reg);
+  }
+  for (auto& reg : frame_state.locals) {
+    map_reg(reg);
+  }
+  for (auto& reg : frame_state.cells) {
+    map_reg(reg);
+  }
+  if (!valid) {
+    return std::nullopt;
+  }
+  return frame_state;
+}
+
+// Return true if instr can be hoisted out of loop once all of its operands are
+// available outside of it.
+bool isHoistable(const Instr& instr, AliasClass loop_stores) {
+  switch (instr.opcode()) {
+    case Opcode::kGuardIs:
+    case Opcode::kGuardType:
+      return true;
+    case Opcode::kLoadGlobalCached:
+      return (loop_stores & AGlobal) == AEmpty;
+    case Opcode::kLoadTypeAttrCacheItem:
+      return (loop_stores & ATypeAttrCache) == AEmpty;
+    case Opcode::kLoadTypeMethodCacheEntryType:
+      return (loop_stores & ATypeMethodCache) == AEmpty;
+    default:
+      return false;
+  }
+}
+
+bool hoistLoopInvariants(
+    Function& irfunc,
+    DominatorAnalysis& doms,
+    const NaturalLoop& loop) {
+  // Only handle loops with a single entry edge, so that the preheader doesn't
+  // need Phis of its own.
+  BasicBlock* entry_pred = nullptr;
+  for (const Edge* edge : loop.header->in_edges()) {
+    if (loop.blocks.count(edge->from()) != 0) {
+      continue;
+    }
+    if (entry_pred != nullptr) {
+      return false;
+    }
+    entry_pred = edge->from();
+  }
+  if (entry_pred == nullptr) {
+    return false;
+  }
+
+  AliasClass loop_stores{AEmpty};
+  for (BasicBlock* block : loop.blocks) {
+    for (Instr& instr : *block) {
+      if (!hasNoMemoryEffects(instr)) {
+        loop_stores = loop_stores | memoryEffects(instr).may_store;
+      }
+    }
+  }
+
+  // Only hoist from blocks that run on every iteration, so a hoisted guard
+  // doesn't fail for a value the loop wouldn't have checked.
+  auto runs_every_iteration = [&](BasicBlock* block) {
+    const auto& dominated = doms.getBlocksDominatedBy(block);
+    return std::all_of(
+        loop.latches.begin(), loop.latches.end(), [&](BasicBlock* latch) {
+          return dominated.count(latch) != 0;
+        });
+  };
+
+  // Guards are only hoisted from blocks that also run before the loop can
+  // exit, so they can't fail in the preheader when the loop body would have
+  // run zero times.
+  std::vector<BasicBlock*> exiting_blocks;
+  for (BasicBlock* block : loop.blocks) {
+    for (const Edge* edge : block->out_edges()) {
+      if (loop.blocks.count(edge->to()) == 0) {
+        exiting_blocks.emplace_back(block);
+        break;
+      }
+    }
+  }
+  auto runs_before_exit = [&](BasicBlock* block) {
+    const auto& dominated = doms.getBlocksDominatedBy(block);
+    return std::all_of(
+        exiting_blocks.begin(),
+        exiting_blocks.end(),
+        [&](BasicBlock* exiting) { return dominated.count(exiting) != 0; });
+  };
+
+  std::vector<Instr*> hoisted;
+  std::unordered_set<Instr*> hoisted_set;
+  auto is_invariant = [&](Register* reg) {
+    return loop.blocks.count(reg->instr()->block()) == 0 ||
+        hoisted_set.count(reg->instr()) != 0;
+  };
+  for (BasicBlock* block : irfunc.cfg.GetRPOTraversal(loop.header)) {
+    if (loop.blocks.count(block) == 0 || !runs_every_iteration(block)) {
+      continue;
+    }
+    bool can_hoist_guards = runs_before_exit(block);
+    for (Instr& instr : *block) {
+      bool is_guard = instr.IsGuardType() || instr.IsGuardIs();
+      if (!isHoistable(instr, loop_stores) ||
+          (is_guard && !can_hoist_guards)) {
+        continue;
+      }
+      bool operands_invariant = true;
+      for (size_t i = 0; i < instr.NumOperands(); ++i) {
+        operands_invariant &= is_invariant(instr.GetOperand(i));
+      }
+      if (operands_invariant) {
+        hoisted.emplace_back(&instr);
+        hoisted_set.insert(&instr);
+      }
+    }
+  }
+  if (hoisted.empty()) {
+    return false;
+  }
+
+  std::optional<FrameState> entry_state =
+      loopEntryFrameState(loop, entry_pred);
+  if (!entry_state.has_value()) {
+    return false;
+  }
+
+  BasicBlock* preheader = irfunc.cfg.AllocateBlock();
+  Instr* entry_branch = entry_pred->GetTerminator();
+  for (size_t i = 0; i < entry_branch->numEdges(); ++i) {
+    if (entry_branch->successor(i) == loop.header) {
+      entry_branch->set_successor(i, preheader);
+    }
+  }
+  loop.header->fixupPhis(entry_pred, preheader);
+
+  auto snapshot = preheader->append<Snapshot>(*entry_state);
+  snapshot->copyBytecodeOffset(*entry_branch);
+  for (Instr* instr : hoisted) {
+    JIT_DLOG("Hoisting '{}' out of loop at bb {}", *instr, loop.header->id);
+    instr->unlink();
+    preheader->Append(instr);
+  }
+  preheader->append<Branch>(loop.header)->copyBytecodeOffset(*entry_branch);
+  return true;
+}
+
+} // namespace
+
+void LoopInvariantCodeMotion::Run(Function& irfunc) {
+  // Hoisting creates blocks and moves instructions between them, so recompute
+  // the loops and dominators after every change.
+  std::unordered_set<BasicBlock*> done_headers;
+  for (bool changed = true; changed;) {
+    changed = false;
+    DominatorAnalysis doms{irfunc};
+    for (const NaturalLoop& loop : findNaturalLoops(irfunc, doms)) {
+      if (!done_headers.insert(loop.header).second) {
+        continue;
+      }
+      if (hoistLoopInvariants(irfunc, doms, loop)) {
+        changed = true;
+        break;
+      }
+    }
+  }
+}
+
+namespace {
+
+bool isEscapeCandidate(const Instr& instr) {
+  return instr.IsMakeTuple() || instr.IsMakeList() || instr.IsBuildSlice();
+}
+
+const FrameState* frameStateOf(const Instr& instr) {
+  if (auto deopt = instr.asDeoptBase()) {
+    return deopt->frameState();
+  }
+  if (instr.IsSnapshot()) {
+    return static_cast<const Snapshot&>(instr).frameState();
+  }
+  return nullptr;
+}
+
+// Find the allocations in irfunc that never escape: their only uses are as
+// UseType operands, as fields of other non-escaping allocations, and in
+// FrameStates belonging to the same (possibly inlined) frame that created
+// them. The latter restriction lets deopt rebuild each object at most once per
+// reified frame.
+std::vector<Instr*> findNonEscapingAllocations(Function& irfunc) {
+  std::unordered_map<Register*, int> candidates;
+  for (auto& block : irfunc.cfg.blocks) {
+    for (auto& instr : block) {
+      if (isEscapeCandidate(instr)) {
+        int depth = instr.asDeoptBase()->frameState()->inlineDepth();
+        candidates.emplace(instr.GetOutput(), depth);
+      }
+    }
+  }
+  if (candidates.empty()) {
+    return {};
+  }
+
+  std::unordered_set<Register*> escaped;
+  for (auto& block : irfunc.cfg.blocks) {
+    for (auto& instr : block) {
+      if (!isEscapeCandidate(instr) && !instr.IsUseType()) {
+        for (std::size_t i = 0, n = instr.NumOperands(); i < n; ++i) {
+          Register* reg = instr.GetOperand(i);
+          if (candidates.count(reg)) {
+            escaped.insert(reg);
+          }
+        }
+      }
+      if (auto deopt = instr.asDeoptBase()) {
+        Register* guilty = deopt->guiltyReg();
+        if (guilty != nullptr && candidates.count(guilty)) {
+          escaped.insert(guilty);
+        }
+      }
+      for (const FrameState* fs = frameStateOf(instr); fs != nullptr;
+           fs = fs->parent) {
+        int depth = fs->inlineDepth();
+        auto check_depth = [&](Register* reg) {
+          auto it = candidates.find(reg);
+          if (it != candidates.end() && it->second != depth) {
+            escaped.insert(reg);
+          }
+        };
+        std::for_each(fs->locals.begin(), fs->locals.end(), check_depth);
+        std::for_each(fs->cells.begin(), fs->cells.end(), check_depth);
+        std::for_each(fs->stack.begin(), fs->stack.end(), check_depth);
+      }
+    }
+  }
+
+  // An object stored into an escaping object escapes with it.
+  Worklist<Register*> worklist;
+  for (Register* reg : escaped) {
+    worklist.push(reg);
+  }
+  while (!worklist.empty()) {
+    Instr* container = worklist.front()->instr();
+    worklist.pop();
+    for (std::size_t i = 0, n = container->NumOperands(); i < n; ++i) {
+      Register* field = container->GetOperand(i);
+      if (candidates.count(field) && escaped.insert(field).second) {
+        worklist.push(field);
+      }
+    }
+  }
+
+  std::vector<Instr*> result;
+  for (auto& [reg, depth] : candidates) {
+    if (!escaped.count(reg)) {
+      result.push_back(reg->instr());
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+void EscapeAnalysis::Run(Function& irfunc) {
+  // Uses by dead instructions shouldn't keep an allocation alive.
+  DeadCodeElimination{}.Run(irfunc);
+
+  std::vector<Instr*> allocs = findNonEscapingAllocations(irfunc);
+  for (Instr* alloc : allocs) {
+    auto vobj = VirtualObject::create(
+        alloc->NumOperands(), alloc->GetOutput(), alloc->GetOutput()->type());
+    for (std::size_t i = 0, n = alloc->NumOperands(); i < n; ++i) {
+      vobj->SetOperand(i, alloc->GetOperand(i));
+    }
+    alloc->ReplaceWith(*vobj);
+    delete alloc;
+  }
+
+  if (!allocs.empty()) {
+    // Objects that only appeared in the FrameStates of their own allocations
+    // are now dead.
+    DeadCodeElimination{}.Run(irfunc);
+  }
+}
+
 static bool absorbDstBlock(BasicBlock* block) {
   if (block->GetTerminator()->opcode() != Opcode::kBranch) {
     return false;
@@ -806,11 +1397,26 @@ struct AbstractCall {
   DeoptBase* instr{nullptr};
 };
 
+static void collectFailureStats(
+    Function::InlineFunctionStats& inline_stats,
+    const AbstractCall* call_instr,
+    InlineFailureType failure_type,
+    const std::string& function) {
+  inline_stats.failure_stats[failure_type].insert(function);
+  const FrameState* frame = call_instr->instr->frameState();
+  while (frame->parent != nullptr) {
+    frame = frame->parent;
+  }
+  inline_stats.call_site_failures.push_back(
+      {frame->instr_offset(), failure_type, function});
+}
+
 static void dlogAndCollectFailureStats(
-    Function::InlineFailureStats& inline_failure_stats,
+    Function::InlineFunctionStats& inline_stats,
+    const AbstractCall* call_instr,
     InlineFailureType failure_type,
     const std::string& function) {
-  inline_failure_stats[failure_type].insert(function);
+  collectFailureStats(inline_stats, call_instr, failure_type, function);
   JIT_DLOG(
       "Can't inline {} because {}",
       function,
@@ -818,11 +1424,12 @@ static void dlogAndCollectFailureStats(
 }
 
 static void dlogAndCollectFailureStats(
-    Function::InlineFailureStats& inline_failure_stats,
+    Function::InlineFunctionStats& inline_stats,
+    const AbstractCall* call_instr,
     InlineFailureType failure_type,
     const std::string& function,
     const char* tp_name) {
-  inline_failure_stats[failure_type].insert(function);
+  collectFailureStats(inline_stats, call_instr, failure_type, function);
   JIT_DLOG(
       "Can't inline {} because {} but a {:.200s}",
       function,
@@ -837,34 +1444,35 @@ static bool canInline(
     AbstractCall* call_instr,
     BorrowedRef<PyFunctionObject> func,
     const std::string& fullname,
-    Function::InlineFailureStats& inline_failure_stats) {
+    Function::InlineFunctionStats& inline_stats) {
   if (func->func_kwdefaults != nullptr) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasKwdefaults, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasKwdefaults, fullname);
     return false;
   }
   PyCodeObject* code = reinterpret_cast<PyCodeObject*>(func->func_code);
   if (code->co_kwonlyargcount > 0) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasKwOnlyArgs, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasKwOnlyArgs, fullname);
     return false;
   }
   if (code->co_flags & CO_VARARGS) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasVarargs, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasVarargs, fullname);
 
     return false;
   }
   if (code->co_flags & CO_VARKEYWORDS) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasVarkwargs, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasVarkwargs, fullname);
 
     return false;
   }
   JIT_DCHECK(code->co_argcount >= 0, "argcount must be positive");
   if (call_instr->nargs != static_cast<size_t>(code->co_argcount)) {
     dlogAndCollectFailureStats(
-        inline_failure_stats,
+        inline_stats,
+        call_instr,
         InlineFailureType::kCalledWithMismatchedArgs,
         fullname);
 
@@ -872,27 +1480,30 @@ static bool canInline(
   }
   if (code->co_flags & kCoFlagsAnyGenerator) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kIsGenerator, fullname);
+        inline_stats, call_instr, InlineFailureType::kIsGenerator, fullname);
 
     return false;
   }
   Py_ssize_t ncellvars = PyTuple_GET_SIZE(code->co_cellvars);
   if (ncellvars > 0) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasCellvars, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasCellvars, fullname);
 
     return false;
   }
   Py_ssize_t nfreevars = PyTuple_GET_SIZE(code->co_freevars);
   if (nfreevars > 0) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kHasFreevars, fullname);
+        inline_stats, call_instr, InlineFailureType::kHasFreevars, fullname);
 
     return false;
   }
   if (usesRuntimeFunc(code)) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kNeedsRuntimeAccess, fullname);
+        inline_stats,
+        call_instr,
+        InlineFailureType::kNeedsRuntimeAccess,
+        fullname);
     return false;
   }
   return true;
@@ -903,7 +1514,7 @@ static bool canInlineWithPreloader(
     AbstractCall* call_instr,
     const std::string& fullname,
     const Preloader& preloader,
-    Function::InlineFailureStats& inline_failure_stats) {
+    Function::InlineFunctionStats& inline_stats) {
   auto has_primitive_args = [&]() {
     for (int i = 0; i < preloader.numArgs(); i++) {
       if (preloader.checkArgType(i) <= TPrimitive) {
@@ -918,7 +1529,8 @@ static bool canInlineWithPreloader(
       (preloader.returnType() <= TPrimitive || has_primitive_args())) {
     // TODO(T122371281) remove this constraint
     dlogAndCollectFailureStats(
-        inline_failure_stats,
+        inline_stats,
+        call_instr,
         InlineFailureType::kIsVectorCallWithPrimitives,
         fullname);
     return false;
@@ -932,11 +1544,11 @@ void inlineFunctionCall(Function& caller, AbstractCall* call_instr) {
   JIT_CHECK(PyCode_Check(code), "Expected PyCodeObject");
   PyObject* globals = func->func_globals;
   std::string fullname = funcFullname(func);
-  Function::InlineFailureStats& inline_failure_stats =
-      caller.inline_function_stats.failure_stats;
+  Function::InlineFunctionStats& inline_stats = caller.inline_function_stats;
   if (!PyDict_Check(globals)) {
     dlogAndCollectFailureStats(
-        inline_failure_stats,
+        inline_stats,
+        call_instr,
         InlineFailureType::kGlobalsNotDict,
         fullname,
         Py_TYPE(globals)->tp_name);
@@ -944,13 +1556,14 @@ void inlineFunctionCall(Function& caller, AbstractCall* call_instr) {
   }
   if (!PyDict_CheckExact(func->func_builtins)) {
     dlogAndCollectFailureStats(
-        inline_failure_stats,
+        inline_stats,
+        call_instr,
         InlineFailureType::kBuiltinsNotDict,
         fullname,
         Py_TYPE(func->func_builtins)->tp_name);
     return;
   }
-  if (!canInline(call_instr, func, fullname, inline_failure_stats)) {
+  if (!canInline(call_instr, func, fullname, inline_stats)) {
     JIT_DLOG("Cannot inline {} into {}", fullname, caller.fullname);
     return;
   }
@@ -968,12 +1581,12 @@ void inlineFunctionCall(Function& caller, AbstractCall* call_instr) {
   Preloader* preloader = lookupPreloader(func);
   if (!preloader) {
     dlogAndCollectFailureStats(
-        inline_failure_stats, InlineFailureType::kNeedsPreload, fullname);
+        inline_stats, call_instr, InlineFailureType::kNeedsPreload, fullname);
     return;
   }
 
   if (!canInlineWithPreloader(
-          call_instr, fullname, *preloader, inline_failure_stats)) {
+          call_instr, fullname, *preloader, inline_stats)) {
     JIT_DLOG(
         "canInlineWithPreloader vetoes inline of {} into {}",
         fullname,
@@ -1051,6 +1664,126 @@ void inlineFunctionCall(Function& caller, AbstractCall* call_instr) {
   caller.inline_function_stats.num_inlined_functions++;
 }
 
+// Get the functions that the profiled receivers of a CallMethod's LoadMethod
+// resolved to and that look inlinable, most frequent first.
+static std::vector<BorrowedRef<PyFunctionObject>> inlinableMethodTargets(
+    CallMethod* call) {
+  Instr* load_method = call->func()->instr();
+  if (call->isAwaited() || !isLoadMethodBase(*load_method) ||
+      load_method->IsLoadMethodSuper()) {
+    return {};
+  }
+  BorrowedRef<PyCodeObject> code =
+      static_cast<DeoptBase*>(load_method)->frameState()->code;
+  Preloader* caller_preloader = lookupPreloader(code);
+  if (caller_preloader == nullptr) {
+    return {};
+  }
+  std::vector<BorrowedRef<PyFunctionObject>> result;
+  for (BorrowedRef<PyFunctionObject> func :
+       caller_preloader->profiledMethodTargets(load_method->bytecodeOffset())) {
+    // Only bother with a guarded dispatch if the inliner will take the
+    // target, so check what we can up front without recording failures.
+    AbstractCall probe{func, call->NumArgs() + 1, call};
+    Function::InlineFunctionStats ignored_stats;
+    if (lookupPreloader(func) != nullptr &&
+        canInline(&probe, func, funcFullname(func), ignored_stats)) {
+      result.push_back(func);
+    }
+  }
+  return result;
+}
+
+// Turn a CallMethod whose LoadMethod was profiled to produce one or two Python
+// functions into a chain of identity checks on the loaded method, each guarding
+// a VectorCall of a known function that the inliner can pick up. The original
+// CallMethod stays on the fallback path:
+//
+//   if method is A.f: r1 = VectorCall<A.f>(self, args...)
+//   elif method is B.f: r2 = VectorCall<B.f>(self, args...)
+//   else: r3 = CallMethod(method, self, args...)
+//   result = Phi(r1, r2, r3)
+//
+// When the loaded method is a function, LoadMethod took the method path, so
+// the receiver is non-null and calling the function directly is exactly what
+// CallMethod would have done.
+static bool expandPolymorphicMethodCalls(Function& irfunc) {
+  using MethodTargets = std::vector<BorrowedRef<PyFunctionObject>>;
+  std::vector<std::pair<CallMethod*, MethodTargets>> candidates;
+  for (auto& block : irfunc.cfg.blocks) {
+    for (auto& instr : block) {
+      if (!instr.IsCallMethod()) {
+        continue;
+      }
+      auto call = static_cast<CallMethod*>(&instr);
+      auto targets = inlinableMethodTargets(call);
+      if (!targets.empty()) {
+        candidates.emplace_back(call, std::move(targets));
+      }
+    }
+  }
+
+  for (auto& [call, targets] : candidates) {
+    BCOffset bc_off = call->bytecodeOffset();
+    BasicBlock* head = call->block();
+    BasicBlock* tail = head->splitAfter(*call);
+    call->unlink();
+
+    Register* result = call->dst();
+    std::unordered_map<BasicBlock*, Register*> phi_args;
+    BasicBlock* check_block = head;
+    for (BorrowedRef<PyFunctionObject> func : targets) {
+      Register* func_reg = irfunc.env.AllocateRegister();
+      check_block->appendWithOff<LoadConst>(
+          bc_off,
+          func_reg,
+          Type::fromObject(irfunc.env.addReference(func)));
+      Register* is_target = irfunc.env.AllocateRegister();
+      check_block->appendWithOff<PrimitiveCompare>(
+          bc_off,
+          is_target,
+          PrimitiveCompareOp::kEqual,
+          call->func(),
+          func_reg);
+
+      BasicBlock* fast_block = irfunc.cfg.AllocateBlock();
+      BasicBlock* next_block = irfunc.cfg.AllocateBlock();
+      check_block->appendWithOff<CondBranch>(
+          bc_off, is_target, fast_block, next_block);
+
+      Register* self = irfunc.env.AllocateRegister();
+      fast_block->appendWithOff<RefineType>(
+          bc_off, self, TObject, call->self());
+      Register* fast_result = irfunc.env.AllocateRegister();
+      auto vector_call = fast_block->appendWithOff<VectorCall>(
+          bc_off,
+          call->NumOperands(),
+          fast_result,
+          false,
+          *call->frameState());
+      vector_call->SetOperand(0, func_reg);
+      vector_call->SetOperand(1, self);
+      for (std::size_t i = 0; i < call->NumArgs(); i++) {
+        vector_call->SetOperand(i + 2, call->arg(i));
+      }
+      fast_block->appendWithOff<Branch>(bc_off, tail);
+      phi_args.emplace(fast_block, fast_result);
+
+      check_block = next_block;
+    }
+
+    Register* slow_result = irfunc.env.AllocateRegister();
+    call->SetOutput(slow_result);
+    check_block->Append(call);
+    check_block->appendWithOff<Branch>(bc_off, tail);
+    phi_args.emplace(check_block, slow_result);
+
+    tail->push_front(Phi::create(result, phi_args));
+  }
+
+  return !candidates.empty();
+}
+
 void InlineFunctionCalls::Run(Function& irfunc) {
   if (irfunc.code == nullptr) {
     // In tests, irfunc may not have bytecode.
@@ -1063,6 +1796,9 @@ void InlineFunctionCalls::Run(Function& irfunc) {
         irfunc.fullname);
     return;
   }
+  if (expandPolymorphicMethodCalls(irfunc)) {
+    reflowTypes(irfunc);
+  }
   std::vector<AbstractCall> to_inline;
   for (auto& block : irfunc.cfg.blocks) {
     for (auto& instr : block) {
@@ -1172,7 +1908,7 @@ static bool tryEliminateLoadMethod(Function& irfunc, MethodInvoke& invoke) {
   // loading and invoking methods off an instance (e.g. {}.fromkeys(...)) is
   // resolved and called differently than from the type (e.g.
   // dict.fromkeys(...)). The code below handles the instance case only.
-  if (!(receiver_type <= TArray || receiver_type <= TBool ||
+  if (!(receiver_type.isStaticArray() || receiver_type <= TBool ||
         receiver_type <= TBytesExact || receiver_type <= TCode ||
         receiver_type <= TDictExact || receiver_type <= TFloatExact ||
         receiver_type <= TListExact || receiver_type <= TLongExact ||
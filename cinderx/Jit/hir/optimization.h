@@ -131,6 +131,48 @@ class GuardTypeRemoval : public Pass {
   }
 };
 
+// Replace instructions that recompute a value already available in a
+// dominating instruction: pure computations, duplicate guards, and loads from
+// memory locations that can't have been written to since the first load.
+class GlobalValueNumbering : public Pass {
+ public:
+  GlobalValueNumbering() : Pass("GlobalValueNumbering") {}
+
+  void Run(Function& irfunc) override;
+
+  static std::unique_ptr<GlobalValueNumbering> Factory() {
+    return std::make_unique<GlobalValueNumbering>();
+  }
+};
+
+// Hoist guards on loop-invariant values, and loads from memory that the loop
+// doesn't write to, out of natural loops and into a new preheader block. Hoisted
+// guards deopt with the FrameState of the loop's entry.
+class LoopInvariantCodeMotion : public Pass {
+ public:
+  LoopInvariantCodeMotion() : Pass("LoopInvariantCodeMotion") {}
+
+  void Run(Function& irfunc) override;
+
+  static std::unique_ptr<LoopInvariantCodeMotion> Factory() {
+    return std::make_unique<LoopInvariantCodeMotion>();
+  }
+};
+
+// Replace tuples, lists, and slices that never escape the function with
+// VirtualObjects, removing their allocations. If a deopt needs one of them, it
+// is materialized from its fields while reifying the frame.
+class EscapeAnalysis : public Pass {
+ public:
+  EscapeAnalysis() : Pass("EscapeAnalysis") {}
+
+  void Run(Function& irfunc) override;
+
+  static std::unique_ptr<EscapeAnalysis> Factory() {
+    return std::make_unique<EscapeAnalysis>();
+  }
+};
+
 // Remove Phis that only have one unique input value (other than their output).
 class PhiElimination : public Pass {
  public:
@@ -623,6 +623,17 @@ HIRParser::parseInstr(std::string_view opcode, Register* dst, int bb_index) {
     expect(">");
     auto operand = ParseRegister();
     NEW_INSTR(UseType, operand, ty);
+  } else if (opcode == "VirtualObject") {
+    expect("<");
+    Type ty = parseType(GetNextToken());
+    expect(",");
+    int nvalues = GetNextInteger();
+    expect(">");
+    auto vobj = VirtualObject::create(nvalues, dst, ty);
+    for (int i = 0; i < nvalues; i++) {
+      vobj->SetOperand(i, ParseRegister());
+    }
+    instruction = vobj;
   } else if (opcode == "HintType") {
     ProfiledTypes types;
     expect("<");
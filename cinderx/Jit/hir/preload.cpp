@@ -9,8 +9,11 @@
 
 #include "cinderx/Jit/bytecode.h"
 #include "cinderx/Jit/codegen/gen_asm.h"
+#include "cinderx/Jit/config.h"
 #include "cinderx/Jit/hir/optimization.h"
+#include "cinderx/Jit/runtime.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace jit::hir {
@@ -126,6 +129,34 @@ static void fill_primitive_arg_types_builtin(
   }
 }
 
+// Return true if type and all of its subclasses resolve name to func.
+static bool has_single_implementation(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name,
+    BorrowedRef<> func) {
+  if (typeLookupSafe(type, name) != func) {
+    return false;
+  }
+  BorrowedRef<> subclasses = type->tp_subclasses;
+  if (subclasses == nullptr) {
+    return true;
+  }
+  Py_ssize_t i = 0;
+  PyObject* ref;
+  while (PyDict_Next(subclasses, &i, nullptr, &ref)) {
+    JIT_DCHECK(PyWeakref_CheckRef(ref), "tp_subclasses holds weakrefs");
+    BorrowedRef<> subtype = PyWeakref_GET_OBJECT(ref);
+    if (subtype == Py_None) {
+      continue;
+    }
+    if (!has_single_implementation(
+            reinterpret_cast<PyTypeObject*>(subtype.get()), name, func)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::unique_ptr<InvokeTarget> Preloader::resolve_target_descr(
     BorrowedRef<> descr,
     int opcode) {
@@ -182,6 +213,18 @@ std::unique_ptr<InvokeTarget> Preloader::resolve_target_descr(
   if (opcode == INVOKE_METHOD) {
     target->slot = _PyClassLoader_ResolveMethod(descr);
     JIT_CHECK(target->slot != -1, "method lookup failed: {}", repr(descr));
+    BorrowedRef<> name =
+        PyTuple_GET_ITEM(descr.get(), PyTuple_GET_SIZE(descr.get()) - 1);
+    if (getConfig().devirtualize_methods && target->is_function &&
+        target->is_statically_typed && PyType_Check(container) &&
+        PyUnicode_Check(name) &&
+        has_single_implementation(
+            reinterpret_cast<PyTypeObject*>(container),
+            name,
+            target->callable)) {
+      target->devirt_type = reinterpret_cast<PyTypeObject*>(container);
+      target->devirt_name = reinterpret_cast<PyUnicodeObject*>(name.get());
+    }
   } else { // the rest of this only used by INVOKE_FUNCTION currently
     target->uses_runtime_func =
         target->is_function && usesRuntimeFunc(target->func()->func_code);
@@ -288,6 +331,13 @@ const NativeTarget& Preloader::invokeNativeTarget(BorrowedRef<> target) const {
   return *(map_get(native_targets_, target));
 }
 
+const std::vector<Ref<PyFunctionObject>>& Preloader::profiledMethodTargets(
+    BCOffset offset) const {
+  static const std::vector<Ref<PyFunctionObject>> kEmpty;
+  auto it = profiled_method_targets_.find(offset);
+  return it == profiled_method_targets_.end() ? kEmpty : it->second;
+}
+
 Type Preloader::checkArgType(long local_idx) const {
   return map_get(check_arg_types_, local_idx, TObject);
 }
@@ -343,6 +393,38 @@ BorrowedRef<> Preloader::constArg(BytecodeInstruction& bc_instr) const {
   return PyTuple_GET_ITEM(code_->co_consts, bc_instr.oparg());
 }
 
+void Preloader::preloadProfiledMethodTargets(BytecodeInstruction& bc_instr) {
+  // Only monomorphic and bimorphic call sites are worth a guarded dispatch.
+  constexpr size_t kMaxTargets = 2;
+  auto& profile_runtime = Runtime::get()->profileRuntime();
+  std::vector<BorrowedRef<PyTypeObject>> types =
+      profile_runtime.getProfiledTypeRows(code_, bc_instr.offset());
+  if (types.empty() || types.size() > kMaxTargets) {
+    return;
+  }
+  BorrowedRef<> name = PyTuple_GET_ITEM(code_->co_names, bc_instr.oparg());
+  std::vector<Ref<PyFunctionObject>> targets;
+  for (BorrowedRef<PyTypeObject> type : types) {
+    // Anything other than the generic attribute lookup may not find methods
+    // on the type, so the LoadMethod would never produce this function.
+    if (type->tp_getattro != PyObject_GenericGetAttr) {
+      continue;
+    }
+    BorrowedRef<> method = _PyType_Lookup(type, name);
+    if (method == nullptr || !PyFunction_Check(method)) {
+      continue;
+    }
+    auto func = Ref<PyFunctionObject>::create(
+        reinterpret_cast<PyFunctionObject*>(method.get()));
+    if (std::find(targets.begin(), targets.end(), func) == targets.end()) {
+      targets.emplace_back(std::move(func));
+    }
+  }
+  if (!targets.empty()) {
+    profiled_method_targets_.emplace(bc_instr.offset(), std::move(targets));
+  }
+}
+
 bool Preloader::preload() {
   if (code_->co_flags & CO_STATICALLY_COMPILED) {
     PyTypeOpt ret_type =
@@ -489,6 +571,12 @@ bool Preloader::preload() {
             target_descr, resolve_native_target(target_descr, signature));
         break;
       }
+      case LOAD_METHOD: {
+        if (getConfig().hir_opts.inliner) {
+          preloadProfiledMethodTargets(bc_instr);
+        }
+        break;
+      }
     }
   }
 
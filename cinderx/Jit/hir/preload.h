@@ -7,6 +7,7 @@
 #include "cinderx/Common/ref.h"
 #include "cinderx/StaticPython/classloader.h"
 
+#include "cinderx/Jit/bytecode_offsets.h"
 #include "cinderx/Jit/global_cache.h"
 #include "cinderx/Jit/hir/hir.h"
 #include "cinderx/Jit/hir/type.h"
@@ -14,6 +15,7 @@
 #include <map>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace jit::hir {
 
@@ -45,6 +47,11 @@ struct InvokeTarget {
   PyObject** indirect_ptr{nullptr};
   // vtable slot number (INVOKE_METHOD only)
   Py_ssize_t slot{-1};
+  // type declaring the method, set only if neither it nor any of its current
+  // subclasses dispatch the slot anywhere but callable (INVOKE_METHOD only)
+  BorrowedRef<PyTypeObject> devirt_type;
+  // name of the method in devirt_type
+  BorrowedRef<PyUnicodeObject> devirt_name;
   // is a CO_STATICALLY_COMPILED Python function or METH_TYPED builtin
   bool is_statically_typed{false};
   // is PyFunctionObject
@@ -66,6 +73,11 @@ struct InvokeTarget {
 using InvokeTargetMap =
     std::unordered_map<PyObject*, std::unique_ptr<InvokeTarget>>;
 
+// Python functions that a LOAD_METHOD resolved to for its profiled receiver
+// types, most frequent first, keyed by the LOAD_METHOD's bytecode offset.
+using ProfiledMethodMap =
+    std::unordered_map<BCOffset, std::vector<Ref<PyFunctionObject>>>;
+
 // The target of an INVOKE_NATIVE
 struct NativeTarget {
   // the address of target
@@ -129,6 +141,15 @@ class Preloader {
     return global_names_;
   }
 
+  const ProfiledMethodMap& profiledMethodTargets() const {
+    return profiled_method_targets_;
+  }
+
+  // get the functions that the LOAD_METHOD at the given offset was observed
+  // to load, or an empty vector
+  const std::vector<Ref<PyFunctionObject>>& profiledMethodTargets(
+      BCOffset offset) const;
+
   // get the type from argument check info for the given locals index, or
   // TObject
   Type checkArgType(long local_idx) const;
@@ -176,6 +197,7 @@ class Preloader {
   BorrowedRef<> constArg(BytecodeInstruction& bc_instr) const;
   GlobalCache getGlobalCache(BorrowedRef<> name) const;
   bool canCacheGlobals() const;
+  void preloadProfiledMethodTargets(BytecodeInstruction& bc_instr);
   bool preload();
 
   explicit Preloader(
@@ -206,6 +228,7 @@ class Preloader {
   std::map<long, PyTypeOpt> check_arg_pytypes_;
   // keyed by name index, names borrowed from code object
   GlobalNamesMap global_names_;
+  ProfiledMethodMap profiled_method_targets_;
   Type return_type_{TObject};
   bool has_primitive_args_{false};
   bool has_primitive_first_arg_{false};
@@ -660,6 +660,10 @@ static std::string format_immediates(const Instr& instr) {
       const auto& gs = static_cast<const UseType&>(instr);
       return fmt::format("{}", gs.type().toString());
     }
+    case Opcode::kVirtualObject: {
+      const auto& vo = static_cast<const VirtualObject&>(instr);
+      return fmt::format("{}, {}", vo.type().toString(), vo.NumOperands());
+    }
     case Opcode::kRaiseAwaitableError: {
       const auto& ra = static_cast<const RaiseAwaitableError&>(instr);
       return fmt::format("{}, {}", ra.with_prev_opcode(), ra.with_opcode());
@@ -477,9 +477,10 @@ std::vector<PredState> collectPredStates(Env& env, BasicBlock* block) {
 }
 
 // Return true iff the given Register is definitely not a reference-counted
-// value.
+// value. VirtualObjects are never allocated, so there is nothing to count.
 bool isUncounted(const Register* reg) {
-  return !reg->type().couldBe(TMortalObject);
+  return !reg->type().couldBe(TMortalObject) ||
+      (reg->instr() != nullptr && reg->instr()->IsVirtualObject());
 }
 
 // Insert an Incref of `reg` before `cursor`.
@@ -934,6 +935,10 @@ void fillDeoptLiveRegs(const StateMap& live_regs, Instr& instr) {
     auto ref_kind = rstate.kind();
     for (int i = 0, n = rstate.numCopies(); i < n; ++i) {
       Register* reg = rstate.copy(i);
+      if (reg->instr()->IsVirtualObject()) {
+        // Described by DeoptMetadata in terms of its (live) fields.
+        continue;
+      }
       deopt->emplaceLiveReg(reg, ref_kind, deoptValueKind(reg->type()));
       if (ref_kind == RefKind::kOwned) {
         // Treat anything other than the first copy as borrowed, to avoid
@@ -262,7 +262,7 @@ Register* simplifyCast(const Cast* instr) {
 
 Register* emitGetLengthInt64(Env& env, Register* obj) {
   Type ty = obj->type();
-  if (ty <= TListExact || ty <= TTupleExact || ty <= TArray) {
+  if (ty <= TListExact || ty <= TTupleExact || ty.isStaticArray()) {
     env.emit<UseType>(obj, ty.unspecialized());
     return env.emit<LoadField>(
         obj, "ob_size", offsetof(PyVarObject, ob_size), TCInt64);
@@ -329,6 +329,28 @@ Register* simplifyCompare(Env& env, const Compare* instr) {
       return env.emit<PrimitiveBoxBool>(result);
     }
   }
+  // Compare exact floats unboxed. comisd reports NaN operands as "below", so
+  // only use the above/above-or-equal forms, which are false for NaN like
+  // Python's comparisons, swapping operands for < and <=.
+  if (left->isA(TFloatExact) && right->isA(TFloatExact) &&
+      (op == CompareOp::kGreaterThan || op == CompareOp::kGreaterThanEqual ||
+       op == CompareOp::kLessThan || op == CompareOp::kLessThanEqual)) {
+    env.emit<UseType>(left, TFloatExact);
+    env.emit<UseType>(right, TFloatExact);
+    Register* unboxed_left = env.emit<PrimitiveUnbox>(left, TCDouble);
+    Register* unboxed_right = env.emit<PrimitiveUnbox>(right, TCDouble);
+    bool or_equal =
+        op == CompareOp::kGreaterThanEqual || op == CompareOp::kLessThanEqual;
+    if (op == CompareOp::kLessThan || op == CompareOp::kLessThanEqual) {
+      std::swap(unboxed_left, unboxed_right);
+    }
+    Register* result = env.emit<PrimitiveCompare>(
+        or_equal ? PrimitiveCompareOp::kGreaterThanEqualUnsigned
+                 : PrimitiveCompareOp::kGreaterThanUnsigned,
+        unboxed_left,
+        unboxed_right);
+    return env.emit<PrimitiveBoxBool>(result);
+  }
   // Emit LongCompare if both args are LongExact and the op is supported
   // between two longs.
   if (left->isA(TLongExact) && right->isA(TLongExact) &&
@@ -360,7 +382,11 @@ Register* simplifyCondBranch(Env& env, const CondBranch* instr) {
     auto convert = static_cast<IntConvert*>(cond->instr());
     Register* src = convert->src();
     if (convert->type().sizeInBytes() >= src->type().sizeInBytes()) {
-      return env.emit<CondBranch>(src, instr->true_bb(), instr->false_bb());
+      auto branch =
+          env.emitInstr<CondBranch>(src, instr->true_bb(), instr->false_bb());
+      branch->setProfiledCounts(
+          instr->profiledTrueCount(), instr->profiledFalseCount());
+      return nullptr;
     }
   }
   return nullptr;
@@ -546,6 +572,39 @@ Register* simplifyLoadMethod(Env& env, const LoadMethod* load_meth) {
       *load_meth->frameState());
 }
 
+// Perform arithmetic on two exact floats unboxed. Results are boxed right
+// away; unbox(box(x)) is folded when they feed into more float arithmetic.
+Register* simplifyFloatBinaryOp(Env& env, const BinaryOp* instr) {
+  BinaryOpKind op = instr->op();
+  if (op != BinaryOpKind::kAdd && op != BinaryOpKind::kSubtract &&
+      op != BinaryOpKind::kMultiply && op != BinaryOpKind::kTrueDivide) {
+    return nullptr;
+  }
+  if (op == BinaryOpKind::kTrueDivide &&
+      instr->getDominatingFrameState() == nullptr) {
+    // Nothing to deopt to when the divisor is zero.
+    return nullptr;
+  }
+  Register* lhs = instr->left();
+  Register* rhs = instr->right();
+  env.emit<UseType>(lhs, TFloatExact);
+  env.emit<UseType>(rhs, TFloatExact);
+  Register* unboxed_lhs = env.emit<PrimitiveUnbox>(lhs, TCDouble);
+  Register* unboxed_rhs = env.emit<PrimitiveUnbox>(rhs, TCDouble);
+  if (op == BinaryOpKind::kTrueDivide) {
+    // Let the interpreter raise ZeroDivisionError.
+    Register* zero = env.emit<LoadConst>(Type::fromCDouble(0.0));
+    Register* nonzero = env.emit<PrimitiveCompare>(
+        PrimitiveCompareOp::kNotEqual, unboxed_rhs, zero);
+    auto guard = env.emitInstr<Guard>(nonzero);
+    guard->setGuiltyReg(rhs);
+    guard->setDescr("float division by zero");
+  }
+  Register* result =
+      env.emit<DoubleBinaryOp>(op, unboxed_lhs, unboxed_rhs);
+  return env.emit<PrimitiveBox>(result, TCDouble, *instr->frameState());
+}
+
 Register* simplifyBinaryOp(Env& env, const BinaryOp* instr) {
   Register* lhs = instr->left();
   Register* rhs = instr->right();
@@ -652,6 +711,9 @@ Register* simplifyBinaryOp(Env& env, const BinaryOp* instr) {
     env.emit<UseType>(rhs, TLongExact);
     return env.emit<LongBinaryOp>(instr->op(), lhs, rhs, *instr->frameState());
   }
+  if (lhs->isA(TFloatExact) && rhs->isA(TFloatExact)) {
+    return simplifyFloatBinaryOp(env, instr);
+  }
   if ((lhs->isA(TUnicodeExact) && rhs->isA(TLongExact)) &&
       (instr->op() == BinaryOpKind::kMultiply)) {
     Register* unboxed_rhs = env.emit<IndexUnbox>(rhs, PyExc_OverflowError);
@@ -718,6 +780,15 @@ Register* simplifyPrimitiveCompare(Env& env, const PrimitiveCompare* instr) {
       return env.emit<LoadConst>(Type::fromCBool(
           instr->op() == PrimitiveCompareOp::kNotEqual ? !value : value));
     };
+    if (left->type() <= TCDouble || right->type() <= TCDouble) {
+      // Double specs that differ in their bits can still compare equal (-0.0
+      // and 0.0), and a NaN is not equal to itself.
+      if (left->type().hasDoubleSpec() && right->type().hasDoubleSpec()) {
+        return do_cbool(
+            left->type().doubleSpec() == right->type().doubleSpec());
+      }
+      return nullptr;
+    }
     if (!left->type().couldBe(right->type())) {
       return do_cbool(false);
     }
@@ -812,7 +883,8 @@ Register* simplifyLoadAttrSplitDict(
   BorrowedRef<PyHeapTypeObject> ht(type);
   auto& profile_runtime = Runtime::get()->profileRuntime();
   if (ht->ht_cached_keys == nullptr ||
-      !profile_runtime.hasPrimedDictKeys(type)) {
+      !THREADED_COMPILE_SERIALIZED_CALL(
+          profile_runtime.hasPrimedDictKeys(type))) {
     return nullptr;
   }
   PyDictKeysObject* keys = ht->ht_cached_keys;
@@ -575,6 +575,8 @@ Type outputType(
       return get_op_type(0);
     case Opcode::kBitCast:
       return static_cast<const BitCast&>(instr).type();
+    case Opcode::kVirtualObject:
+      return static_cast<const VirtualObject&>(instr).type();
     case Opcode::kLoadConst: {
       return static_cast<const LoadConst&>(instr).type();
     }
@@ -770,6 +772,107 @@ void reflowTypes(Function& func) {
   reflowTypes(&func.env, func.cfg.entry_block);
 }
 
+// A Phi can't merge VirtualObjects, which have no value at runtime. The
+// iterator of an index loop (see HIRBuilder::tryEmitIndexLoop()) is a
+// VirtualObject that flows around the loop, so replace each Phi of
+// VirtualObjects with a VirtualObject of Phis of their fields.
+static void splitVirtualObjectPhis(BasicBlock* start, Environment* env) {
+  auto def_of = [](Register* reg) {
+    Instr* def = reg->instr();
+    while (def != nullptr && def->IsAssign()) {
+      def = def->GetOperand(0)->instr();
+    }
+    return def;
+  };
+
+  // Map each Phi whose inputs are all VirtualObjects of one type, or other
+  // such Phis, to one of those VirtualObjects.
+  std::unordered_map<Phi*, const VirtualObject*> shapes;
+  for (BasicBlock* block : CFG::GetRPOTraversal(start)) {
+    for (Instr& instr : *block) {
+      if (!instr.IsPhi()) {
+        break;
+      }
+      shapes.emplace(static_cast<Phi*>(&instr), nullptr);
+    }
+  }
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto it = shapes.begin(); it != shapes.end();) {
+      Phi* phi = it->first;
+      const VirtualObject*& shape = it->second;
+      bool ok = true;
+      for (std::size_t i = 0, n = phi->NumOperands(); ok && i < n; ++i) {
+        Instr* def = def_of(phi->GetOperand(i));
+        const VirtualObject* input_shape = nullptr;
+        if (def != nullptr && def->IsVirtualObject()) {
+          input_shape = static_cast<const VirtualObject*>(def);
+        } else if (def != nullptr && def->IsPhi()) {
+          auto input_it = shapes.find(static_cast<Phi*>(def));
+          ok = input_it != shapes.end();
+          input_shape = ok ? input_it->second : nullptr;
+        } else {
+          ok = false;
+        }
+        if (input_shape == nullptr) {
+          continue;
+        }
+        if (shape == nullptr) {
+          shape = input_shape;
+          changed = true;
+        } else if (
+            shape->type() != input_shape->type() ||
+            shape->NumOperands() != input_shape->NumOperands()) {
+          ok = false;
+        }
+      }
+      if (ok) {
+        ++it;
+      } else {
+        it = shapes.erase(it);
+        changed = true;
+      }
+    }
+  }
+  std::erase_if(shapes, [](auto& item) { return item.second == nullptr; });
+
+  std::unordered_map<Phi*, std::vector<Register*>> fields;
+  for (auto& [phi, shape] : shapes) {
+    auto& regs = fields[phi];
+    for (std::size_t i = 0, n = shape->NumOperands(); i < n; ++i) {
+      regs.push_back(env->AllocateRegister());
+    }
+  }
+  for (auto& [phi, shape] : shapes) {
+    std::size_t nfields = shape->NumOperands();
+    for (std::size_t i = 0; i < nfields; ++i) {
+      std::unordered_map<BasicBlock*, Register*> args;
+      for (std::size_t j = 0, n = phi->NumOperands(); j < n; ++j) {
+        Instr* def = def_of(phi->GetOperand(j));
+        args[phi->basic_blocks()[j]] = def->IsVirtualObject()
+            ? def->GetOperand(i)
+            : fields.at(static_cast<Phi*>(def))[i];
+      }
+      auto field_phi = Phi::create(fields.at(phi)[i], args);
+      field_phi->copyBytecodeOffset(*phi);
+      field_phi->InsertBefore(*phi);
+    }
+    // Create this after the field Phis, which may refer to phi's output.
+    auto vobj = VirtualObject::create(nfields, phi->GetOutput(), shape->type());
+    for (std::size_t i = 0; i < nfields; ++i) {
+      vobj->SetOperand(i, fields.at(phi)[i]);
+    }
+    vobj->copyBytecodeOffset(*phi);
+    auto it = phi->block()->begin();
+    while (it->IsPhi()) {
+      ++it;
+    }
+    vobj->InsertBefore(*it);
+    phi->unlink();
+    delete phi;
+  }
+}
+
 void SSAify::Run(Function& irfunc) {
   Run(irfunc.cfg.entry_block, &irfunc.env);
   PhiElimination{}.Run(irfunc);
@@ -837,6 +940,7 @@ void SSAify::Run(BasicBlock* start, Environment* env) {
     delete ssablock;
   }
 
+  splitVirtualObjectPhis(start, env);
   reflowTypes(env, start);
 }
 
@@ -348,6 +348,11 @@ Type Type::fromTypeImpl(PyTypeObject* type, bool exact) {
     return exact ? it->second & TBuiltinExact : it->second;
   }
 
+  // staticarray types can't be subclassed, so they're always exact.
+  if (!exact && _Ci_StaticArray_CheckType(type)) {
+    return fromTypeImpl(type, true);
+  }
+
   {
     ThreadedCompileSerialize guard;
     if (type->tp_mro == nullptr && !(type->tp_flags & Py_TPFLAGS_READY)) {
@@ -423,6 +428,14 @@ PyTypeObject* Type::runtimePyType() const {
   return hasTypeSpec() ? typeSpec() : uniquePyType();
 }
 
+bool Type::isStaticArray() const {
+  if (*this <= TArray) {
+    return true;
+  }
+  return *this <= TObject && hasTypeSpec() &&
+      _Ci_StaticArray_CheckType(typeSpec());
+}
+
 PyObject* Type::asObject() const {
   if (*this <= TNoneType) {
     return Py_None;
@@ -152,6 +152,10 @@ class Type {
   // a subtype of all builtin exact types.
   bool isExact() const;
 
+  // Is every value of this Type a staticarray? TArray is the int64 kind;
+  // arrays of the other element kinds are exact TObjectUser specializations.
+  bool isStaticArray() const;
+
   // Equality.
   bool operator==(Type other) const;
   bool operator!=(Type other) const;
@@ -115,9 +115,11 @@ uint64_t getModuleVersion(BorrowedRef<Ci_StrictModuleObject> mod) {
 
 void maybeCollectCacheStats(
     std::unique_ptr<CacheStats>& stat,
+    CacheMissCounts& counts,
     BorrowedRef<PyTypeObject> tp,
     BorrowedRef<> name,
     CacheMissReason reason) {
+  counts[static_cast<size_t>(reason)]++;
   if (!g_collect_inline_cache_stats) {
     return;
   }
@@ -412,6 +414,165 @@ AttributeMutator::Kind AttributeMutator::get_kind() const {
   return static_cast<Kind>(type_ & kKindMask);
 }
 
+namespace {
+
+// A process-wide, direct-mapped cache of attribute and method lookups, shared
+// by every inline cache that has run out of entries of its own.
+//
+// Entries are keyed by the receiver type's version tag and the interned
+// attribute name. Modifying a type invalidates its version tag, so entries for
+// the old version can't match again. Entries that depend on the type of a data
+// descriptor are dropped by typeChanged(), since that type can change without
+// touching the receiver type. Each entry owns a reference to its name: the
+// code objects the names come from can be freed along with their compiled
+// code, and another string reusing the address must not match. Protected by
+// the GIL.
+class MegamorphicCache {
+ public:
+  AttributeMutator* findAttr(PyTypeObject* type, PyObject* name) {
+    AttrEntry& entry = attrs_[index(type, name)];
+    if (entry.matches(type, name) && !entry.mutator.isEmpty() &&
+        entry.mutator.type() == type) {
+      return &entry.mutator;
+    }
+    return nullptr;
+  }
+
+  // Take over the entry for (type, name), evicting whatever was there. The
+  // caller fills in the returned mutator, which reads as a miss until then.
+  AttributeMutator* claimAttr(PyTypeObject* type, PyObject* name) {
+    size_t idx = index(type, name);
+    AttrEntry& entry = attrs_[idx];
+    entry.version_tag = type->tp_version_tag;
+    entry.name.reset(name);
+    entry.descr_type = nullptr;
+    entry.mutator.reset();
+    watch(type).attrs.insert(idx);
+    return &entry.mutator;
+  }
+
+  // Drop the entry for (type, name) if the owner's data descriptor changes.
+  void dependOnDescrType(
+      PyTypeObject* type,
+      PyObject* name,
+      PyTypeObject* descr_type) {
+    size_t idx = index(type, name);
+    attrs_[idx].descr_type = descr_type;
+    watch(descr_type).attrs.insert(idx);
+  }
+
+  BorrowedRef<> findMethod(PyTypeObject* type, PyObject* name) {
+    MethodEntry& entry = methods_[index(type, name)];
+    if (entry.matches(type, name) && entry.type == type) {
+      return entry.value;
+    }
+    return nullptr;
+  }
+
+  void fillMethod(PyTypeObject* type, PyObject* name, BorrowedRef<> value) {
+    size_t idx = index(type, name);
+    MethodEntry& entry = methods_[idx];
+    entry.version_tag = type->tp_version_tag;
+    entry.name.reset(name);
+    entry.type = type;
+    entry.value = value;
+    watch(type).methods.insert(idx);
+  }
+
+  void typeChanged(BorrowedRef<PyTypeObject> type) {
+    auto it = dependents_.find(type);
+    if (it == dependents_.end()) {
+      return;
+    }
+    // Entries may have been taken over by other types since they were
+    // recorded here, so check each one before dropping it.
+    Dependents deps = std::move(it->second);
+    dependents_.erase(it);
+    for (size_t idx : deps.attrs) {
+      AttrEntry& entry = attrs_[idx];
+      if (entry.mutator.type() == type || entry.descr_type == type) {
+        entry.name.reset();
+        entry.descr_type = nullptr;
+        entry.mutator.reset();
+      }
+    }
+    for (size_t idx : deps.methods) {
+      MethodEntry& entry = methods_[idx];
+      if (entry.type == type) {
+        entry.name.reset();
+        entry.type.reset();
+        entry.value.reset();
+      }
+    }
+  }
+
+  // Drop every entry, releasing the names they own.
+  void clear() {
+    for (AttrEntry& entry : attrs_) {
+      entry.name.reset();
+      entry.descr_type = nullptr;
+      entry.mutator.reset();
+    }
+    for (MethodEntry& entry : methods_) {
+      entry.name.reset();
+      entry.type.reset();
+      entry.value.reset();
+    }
+    dependents_.clear();
+  }
+
+ private:
+  static constexpr size_t kNumEntries = 4096;
+
+  struct Key {
+    unsigned int version_tag{0};
+    Ref<> name;
+
+    bool matches(PyTypeObject* type, PyObject* name_) const {
+      return name.get() == name_ && version_tag == type->tp_version_tag &&
+          PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG);
+    }
+  };
+
+  struct AttrEntry : Key {
+    PyTypeObject* descr_type{nullptr};
+    AttributeMutator mutator;
+  };
+
+  struct MethodEntry : Key {
+    BorrowedRef<PyTypeObject> type;
+    BorrowedRef<> value;
+  };
+
+  // Indices of the entries that have to be dropped when a type changes.
+  struct Dependents {
+    jit::UnorderedSet<size_t> attrs;
+    jit::UnorderedSet<size_t> methods;
+  };
+
+  static size_t index(PyTypeObject* type, PyObject* name) {
+    uint64_t hash = type->tp_version_tag * uint64_t{0x9e3779b97f4a7c15} ^
+        (reinterpret_cast<uintptr_t>(name) >> 4);
+    return (hash ^ (hash >> 32)) & (kNumEntries - 1);
+  }
+
+  Dependents& watch(PyTypeObject* type) {
+    auto [it, inserted] = dependents_.try_emplace(type);
+    if (inserted) {
+      Ci_Watchers_WatchType(type);
+    }
+    return it->second;
+  }
+
+  std::array<AttrEntry, kNumEntries> attrs_;
+  std::array<MethodEntry, kNumEntries> methods_;
+  jit::UnorderedMap<BorrowedRef<PyTypeObject>, Dependents> dependents_;
+};
+
+MegamorphicCache g_megamorphic_cache;
+
+} // namespace
+
 AttributeCache::AttributeCache() {
   for (auto& entry : entries()) {
     entry.reset();
@@ -437,12 +598,33 @@ std::span<AttributeMutator> AttributeCache::entries() {
   return {entries_, getConfig().attr_cache_size};
 }
 
+size_t AttributeCache::numEntriesUsed() {
+  return std::ranges::count_if(
+      entries(), [](const AttributeMutator& e) { return !e.isEmpty(); });
+}
+
+size_t AttributeCache::capacity() {
+  return entries().size();
+}
+
 AttributeMutator* AttributeCache::findEmptyEntry() {
   auto it = std::ranges::find_if(
       entries(), [](const AttributeMutator& e) { return e.isEmpty(); });
   return it == entries().end() ? nullptr : &*it;
 }
 
+bool AttributeCache::isFull() {
+  // Entries are filled in order and only ever cleared all at once.
+  return getConfig().megamorphic_attr_cache && !entries().empty() &&
+      !entries().back().isEmpty();
+}
+
+AttributeMutator* AttributeCache::findMegamorphic(
+    PyTypeObject* type,
+    PyObject* name) {
+  return isFull() ? g_megamorphic_cache.findAttr(type, name) : nullptr;
+}
+
 void AttributeCache::fill(
     BorrowedRef<PyTypeObject> type,
     BorrowedRef<> name,
@@ -454,9 +636,21 @@ void AttributeCache::fill(
     return;
   }
 
+  // Once every entry is taken, fill the shared cache instead. It watches the
+  // types it depends on itself.
   AttributeMutator* mut = findEmptyEntry();
+  bool shared = false;
   if (mut == nullptr) {
-    return;
+    if (!isFull()) {
+      return;
+    }
+    if (descr == nullptr &&
+        (type->tp_dictoffset < 0 ||
+         !PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE))) {
+      return;
+    }
+    mut = g_megamorphic_cache.claimAttr(type, name);
+    shared = true;
   }
 
   if (descr != nullptr) {
@@ -469,14 +663,20 @@ void AttributeCache::fill(
       } else {
         // If someone deletes descr_types's __set__ method, it will no longer
         // be a data descriptor, and the cache kind has to change.
-        ac_watcher.watch(descr_type, this);
+        if (shared) {
+          g_megamorphic_cache.dependOnDescrType(type, name, descr_type);
+        } else {
+          ac_watcher.watch(descr_type, this);
+        }
         mut->set_data_descr(type, descr);
       }
     } else {
       // Non-data descriptor or class var
       mut->set_descr_or_classvar(type, descr);
     }
-    ac_watcher.watch(type, this);
+    if (!shared) {
+      ac_watcher.watch(type, this);
+    }
     return;
   }
 
@@ -498,7 +698,9 @@ void AttributeCache::fill(
   } else {
     mut->set_combined(type);
   }
-  ac_watcher.watch(type, this);
+  if (!shared) {
+    ac_watcher.watch(type, this);
+  }
 }
 
 PyObject* StoreAttrCache::invoke(
@@ -517,6 +719,9 @@ StoreAttrCache::doInvoke(PyObject* obj, PyObject* name, PyObject* value) {
       return entry.setAttr(obj, name, value);
     }
   }
+  if (AttributeMutator* mut = findMegamorphic(tp, name)) {
+    return mut->setAttr(obj, name, value);
+  }
   return invokeSlowPath(obj, name, value);
 }
 
@@ -530,6 +735,7 @@ StoreAttrCache::invokeSlowPath(PyObject* obj, PyObject* name, PyObject* value) {
   if (tp->tp_dict == nullptr && PyType_Ready(tp) < 0) {
     return nullptr;
   } else if (tp->tp_setattro != PyObject_GenericSetAttr) {
+    miss_counts_[static_cast<size_t>(CacheMissReason::kWrongTpGetAttro)]++;
     int st = PyObject_SetAttr(obj, name, value);
     return st == 0 ? Py_None : nullptr;
   }
@@ -582,6 +788,9 @@ PyObject* LoadAttrCache::doInvoke(PyObject* obj, PyObject* name) {
       return entry.getAttr(obj, name);
     }
   }
+  if (AttributeMutator* mut = findMegamorphic(tp, name)) {
+    return mut->getAttr(obj, name);
+  }
   return invokeSlowPath(obj, name);
 }
 
@@ -590,6 +799,7 @@ PyObject* __attribute__((noinline))
 LoadAttrCache::invokeSlowPath(PyObject* obj, PyObject* name) {
   BorrowedRef<PyTypeObject> tp(Py_TYPE(obj));
   if (tp->tp_getattro != PyObject_GenericGetAttr) {
+    miss_counts_[static_cast<size_t>(CacheMissReason::kWrongTpGetAttro)]++;
     return PyObject_GetAttr(obj, name);
   }
   if (tp->tp_dict == nullptr) {
@@ -801,6 +1011,13 @@ JITRT_LoadMethodResult LoadMethodCache::lookup(
       return {result, obj};
     }
   }
+  if (isFull()) {
+    if (BorrowedRef<> result = g_megamorphic_cache.findMethod(tp, name)) {
+      Py_INCREF(result);
+      Py_INCREF(obj);
+      return {result, obj};
+    }
+  }
 
   return lookupSlowPath(obj, name);
 }
@@ -830,6 +1047,15 @@ const CacheStats* LoadMethodCache::cacheStats() {
   return cache_stats_.get();
 }
 
+bool LoadMethodCache::isFull() const {
+  return getConfig().megamorphic_attr_cache && entries_.back().type != nullptr;
+}
+
+size_t LoadMethodCache::numEntriesUsed() const {
+  return std::ranges::count_if(
+      entries_, [](const Entry& e) { return e.type != nullptr; });
+}
+
 JITRT_LoadMethodResult __attribute__((noinline))
 LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
   PyTypeObject* tp = Py_TYPE(obj);
@@ -843,7 +1069,11 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
     PyObject* res = PyObject_GetAttr(obj, name);
     if (res != nullptr) {
       maybeCollectCacheStats(
-          cache_stats_, tp, name, CacheMissReason::kWrongTpGetAttro);
+          cache_stats_,
+          miss_counts_,
+          tp,
+          name,
+          CacheMissReason::kWrongTpGetAttro);
       Py_INCREF(Py_None);
       return {Py_None, res};
     }
@@ -862,7 +1092,11 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
       f = descr->ob_type->tp_descr_get;
       if (f != nullptr && PyDescr_IsData(descr)) {
         maybeCollectCacheStats(
-            cache_stats_, tp, name, CacheMissReason::kPyDescrIsData);
+            cache_stats_,
+            miss_counts_,
+            tp,
+            name,
+            CacheMissReason::kPyDescrIsData);
         PyObject* result = f(descr, obj, (PyObject*)obj->ob_type);
         Py_DECREF(descr);
         Py_INCREF(Py_None);
@@ -877,7 +1111,11 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
     attr = PyDict_GetItem(dict, name);
     if (attr != nullptr) {
       maybeCollectCacheStats(
-          cache_stats_, tp, name, CacheMissReason::kUncategorized);
+          cache_stats_,
+          miss_counts_,
+          tp,
+          name,
+          CacheMissReason::kUncategorized);
       Py_INCREF(attr);
       Py_DECREF(dict);
       Py_XDECREF(descr);
@@ -888,14 +1126,14 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
   }
 
   if (is_method) {
-    fill(tp, descr);
+    fill(tp, name, descr);
     Py_INCREF(obj);
     return {descr, obj};
   }
 
   if (f != nullptr) {
     maybeCollectCacheStats(
-        cache_stats_, tp, name, CacheMissReason::kUncategorized);
+        cache_stats_, miss_counts_, tp, name, CacheMissReason::kUncategorized);
     PyObject* result = f(descr, obj, (PyObject*)Py_TYPE(obj));
     Py_DECREF(descr);
     Py_INCREF(Py_None);
@@ -904,7 +1142,7 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
 
   if (descr != nullptr) {
     maybeCollectCacheStats(
-        cache_stats_, tp, name, CacheMissReason::kUncategorized);
+        cache_stats_, miss_counts_, tp, name, CacheMissReason::kUncategorized);
     Py_INCREF(Py_None);
     return {Py_None, descr};
   }
@@ -919,6 +1157,7 @@ LoadMethodCache::lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name) {
 
 void LoadMethodCache::fill(
     BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name,
     BorrowedRef<> value) {
   if (!PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
     // The type must have a valid version tag in order for us to be able to
@@ -940,6 +1179,9 @@ void LoadMethodCache::fill(
       return;
     }
   }
+  if (isFull()) {
+    g_megamorphic_cache.fillMethod(type, name, value);
+  }
 }
 
 LoadTypeMethodCache::~LoadTypeMethodCache() {
@@ -976,7 +1218,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
   PyTypeObject* metatype = Py_TYPE(obj);
   if (metatype->tp_getattro != PyType_Type.tp_getattro) {
     maybeCollectCacheStats(
-        cache_stats_, metatype, name, CacheMissReason::kWrongTpGetAttro);
+        cache_stats_,
+        miss_counts_,
+        metatype,
+        name,
+        CacheMissReason::kWrongTpGetAttro);
     PyObject* res = PyObject_GetAttr(obj, name);
     Py_INCREF(Py_None);
     return {Py_None, res};
@@ -999,7 +1245,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
        * type's tp_dict (and bases): call the descriptor now.
        */
       maybeCollectCacheStats(
-          cache_stats_, metatype, name, CacheMissReason::kPyDescrIsData);
+          cache_stats_,
+          miss_counts_,
+          metatype,
+          name,
+          CacheMissReason::kPyDescrIsData);
       PyObject* res =
           meta_get(meta_attribute, obj, reinterpret_cast<PyObject*>(metatype));
       Py_DECREF(meta_attribute);
@@ -1029,7 +1279,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
         // cm_callable has custom tp_descr_get that can run arbitrary
         // user code. Do not cache in this instance.
         maybeCollectCacheStats(
-            cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+            cache_stats_,
+            miss_counts_,
+            metatype,
+            name,
+            CacheMissReason::kUncategorized);
         Py_INCREF(Py_None);
         return {
             Py_None, Py_TYPE(cm_callable)->tp_descr_get(cm_callable, obj, obj)};
@@ -1037,7 +1291,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
         // It is not safe to cache custom objects decorated with classmethod
         // as they can be modified later
         maybeCollectCacheStats(
-            cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+            cache_stats_,
+            miss_counts_,
+            metatype,
+            name,
+            CacheMissReason::kUncategorized);
         BorrowedRef<> py_meth = PyMethod_New(cm_callable, obj);
         Py_INCREF(Py_None);
         return {Py_None, py_meth};
@@ -1063,14 +1321,22 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
       /* nullptr 2nd argument indicates the descriptor was
        * found on the target object itself (or a base)  */
       maybeCollectCacheStats(
-          cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+          cache_stats_,
+          miss_counts_,
+          metatype,
+          name,
+          CacheMissReason::kUncategorized);
       PyObject* res = local_get(attribute, nullptr, obj);
       Py_DECREF(attribute);
       Py_INCREF(Py_None);
       return {Py_None, res};
     }
     maybeCollectCacheStats(
-        cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+        cache_stats_,
+        miss_counts_,
+        metatype,
+        name,
+        CacheMissReason::kUncategorized);
     Py_INCREF(Py_None);
     return {Py_None, attribute};
   }
@@ -1079,7 +1345,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
    * descriptor from the metatype, if any */
   if (meta_get != nullptr) {
     maybeCollectCacheStats(
-        cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+        cache_stats_,
+        miss_counts_,
+        metatype,
+        name,
+        CacheMissReason::kUncategorized);
     PyObject* res;
     res = meta_get(meta_attribute, obj, reinterpret_cast<PyObject*>(metatype));
     Py_DECREF(meta_attribute);
@@ -1090,7 +1360,11 @@ JITRT_LoadMethodResult LoadTypeMethodCache::lookup(
   /* If an ordinary attribute was found on the metatype, return it now */
   if (meta_attribute != nullptr) {
     maybeCollectCacheStats(
-        cache_stats_, metatype, name, CacheMissReason::kUncategorized);
+        cache_stats_,
+        miss_counts_,
+        metatype,
+        name,
+        CacheMissReason::kUncategorized);
     Py_INCREF(Py_None);
     return {Py_None, meta_attribute};
   }
@@ -1236,7 +1510,12 @@ void LoadModuleMethodCache::fill(
   module_version_ = version;
 }
 
+void clearMegamorphicCache() {
+  g_megamorphic_cache.clear();
+}
+
 void notifyICsTypeChanged(BorrowedRef<PyTypeObject> type) {
+  g_megamorphic_cache.typeChanged(type);
   ac_watcher.typeChanged(type);
   ltac_watcher.typeChanged(type);
   lm_watcher.typeChanged(type);
@@ -19,6 +19,29 @@
 
 namespace jit {
 
+#define FOREACH_CACHE_MISS_REASON(V) \
+  V(WrongTpGetAttro)                 \
+  V(PyDescrIsData)                   \
+  V(Uncategorized)
+
+enum class CacheMissReason {
+#define DECLARE_CACHE_MISS_REASON(name) k##name,
+  FOREACH_CACHE_MISS_REASON(DECLARE_CACHE_MISS_REASON)
+#undef DECLARE_CACHE_MISS_REASON
+};
+
+constexpr size_t kNumCacheMissReasons = 0
+#define COUNT_CACHE_MISS_REASON(name) +1
+    FOREACH_CACHE_MISS_REASON(COUNT_CACHE_MISS_REASON)
+#undef COUNT_CACHE_MISS_REASON
+    ;
+
+std::string_view cacheMissReason(CacheMissReason reason);
+
+// Number of lookups that a cache couldn't serve or be filled for, by reason.
+// These are always collected, unlike the per-type CacheStats below.
+using CacheMissCounts = std::array<uint32_t, kNumCacheMissReasons>;
+
 // Mutator for an instance attribute that is stored in a split dictionary
 struct SplitMutator {
   PyObject* setAttr(PyObject* obj, PyObject* name, PyObject* value);
@@ -113,14 +136,26 @@ class AttributeCache {
 
   void typeChanged(PyTypeObject* type);
 
+  size_t numEntriesUsed();
+  size_t capacity();
+  const CacheMissCounts& missCounts() const {
+    return miss_counts_;
+  }
+
  protected:
   std::span<AttributeMutator> entries();
 
   AttributeMutator* findEmptyEntry();
 
+  // Whether every entry is in use, so lookups for other types should go
+  // through the process-wide megamorphic cache.
+  bool isFull();
+  AttributeMutator* findMegamorphic(PyTypeObject* type, PyObject* name);
+
   void
   fill(BorrowedRef<PyTypeObject> type, BorrowedRef<> name, BorrowedRef<> descr);
 
+  CacheMissCounts miss_counts_{};
   AttributeMutator entries_[0];
 };
 
@@ -200,19 +235,6 @@ class LoadTypeAttrCache {
   void reset();
 };
 
-#define FOREACH_CACHE_MISS_REASON(V) \
-  V(WrongTpGetAttro)                 \
-  V(PyDescrIsData)                   \
-  V(Uncategorized)
-
-enum class CacheMissReason {
-#define DECLARE_CACHE_MISS_REASON(name) k##name,
-  FOREACH_CACHE_MISS_REASON(DECLARE_CACHE_MISS_REASON)
-#undef DECLARE_CACHE_MISS_REASON
-};
-
-std::string_view cacheMissReason(CacheMissReason reason);
-
 struct CacheMiss {
   int count{0};
   CacheMissReason reason{CacheMissReason::kUncategorized};
@@ -242,12 +264,25 @@ class LoadMethodCache {
   void clearCacheStats();
   const CacheStats* cacheStats();
 
+  size_t numEntriesUsed() const;
+  size_t capacity() const {
+    return entries_.size();
+  }
+  const CacheMissCounts& missCounts() const {
+    return miss_counts_;
+  }
+
  private:
   JITRT_LoadMethodResult lookupSlowPath(BorrowedRef<> obj, BorrowedRef<> name);
-  void fill(BorrowedRef<PyTypeObject> type, BorrowedRef<> value);
+  void fill(
+      BorrowedRef<PyTypeObject> type,
+      BorrowedRef<> name,
+      BorrowedRef<> value);
+  bool isFull() const;
 
   std::array<Entry, 4> entries_;
   std::unique_ptr<CacheStats> cache_stats_;
+  CacheMissCounts miss_counts_{};
 };
 
 // A cache for LoadMethodCached instructions where we expect the receiver to be
@@ -286,11 +321,22 @@ class LoadTypeMethodCache {
   void clearCacheStats();
   const CacheStats* cacheStats();
 
+  size_t numEntriesUsed() const {
+    return type != nullptr ? 1 : 0;
+  }
+  size_t capacity() const {
+    return 1;
+  }
+  const CacheMissCounts& missCounts() const {
+    return miss_counts_;
+  }
+
  private:
   void
   fill(BorrowedRef<PyTypeObject> type, BorrowedRef<> value, bool is_bound_meth);
 
   std::unique_ptr<CacheStats> cache_stats_;
+  CacheMissCounts miss_counts_{};
 };
 
 class LoadModuleMethodCache {
@@ -314,9 +360,14 @@ class LoadModuleMethodCache {
   BorrowedRef<> value_;
 };
 
-// Invalidate all load/store attr caches for type
+// Invalidate all load/store attr caches for type, including entries in the
+// process-wide cache used by megamorphic sites.
 void notifyICsTypeChanged(BorrowedRef<PyTypeObject> type);
 
+// Drop all entries of the process-wide cache used by megamorphic sites,
+// releasing the attribute names it holds.
+void clearMegamorphicCache();
+
 } // namespace jit
 
 struct FunctionEntryCacheValue {
@@ -44,6 +44,36 @@ _PyJIT_Result Context::compilePreloader(
   return PYJIT_RESULT_OK;
 }
 
+CompiledFunction* Context::compileOSR(
+    BorrowedRef<PyCodeObject> code,
+    BorrowedRef<PyDictObject> builtins,
+    BorrowedRef<PyDictObject> globals,
+    const hir::OSREntry& osr_entry,
+    const std::string& fullname) {
+  OSRKey key{
+      CompilationKey{code, builtins, globals}, osr_entry.loop_header.value()};
+  auto it = compiled_osr_codes_.find(key);
+  if (it != compiled_osr_codes_.end()) {
+    return it->second.get();
+  }
+
+  std::unique_ptr<CompiledFunction> compiled;
+  std::unique_ptr<hir::Preloader> preloader =
+      hir::Preloader::makePreloader(code, builtins, globals, fullname);
+  if (preloader != nullptr) {
+    compile_depth++;
+    compiled = jit_compiler_.Compile(*preloader, &osr_entry);
+    compile_depth--;
+  }
+  JIT_DLOG(
+      "{} OSR entry for {} at offset {}",
+      compiled == nullptr ? "Failed to compile" : "Compiled",
+      fullname,
+      osr_entry.loop_header);
+  return compiled_osr_codes_.emplace(key, std::move(compiled))
+      .first->second.get();
+}
+
 _PyJIT_Result Context::attachCompiledCode(BorrowedRef<PyFunctionObject> func) {
   JIT_DCHECK(!didCompile(func), "Function is already compiled");
 
@@ -59,7 +89,156 @@ void Context::funcModified(BorrowedRef<PyFunctionObject> func) {
 }
 
 void Context::funcDestroyed(BorrowedRef<PyFunctionObject> func) {
-  compiled_funcs_.erase(func);
+  if (compiled_funcs_.erase(func) != 0) {
+    funcs_destroyed_since_reclaim_++;
+  }
+}
+
+void Context::codeDestroyed(BorrowedRef<PyCodeObject> code) {
+  // Only failed OSR compiles can be left for a dead code object, since
+  // compiled code keeps its code object alive.
+  ThreadedCompileSerialize guard;
+  for (auto it = compiled_osr_codes_.begin();
+       it != compiled_osr_codes_.end();) {
+    if (it->first.code_key.code == code) {
+      compiled_osr_codes_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = recompile_counts_.begin(); it != recompile_counts_.end();) {
+    if (it->first.code == code) {
+      recompile_counts_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+size_t Context::reclaimDeadCode() {
+  funcs_destroyed_since_reclaim_ = 0;
+  size_t reclaimed_bytes = 0;
+
+  // Freeing one code object can release the last reference to others (e.g.
+  // nested functions in its co_consts), so repeat until nothing changes.
+  for (;;) {
+    std::vector<std::unique_ptr<CompiledFunction>> dead;
+    {
+      ThreadedCompileSerialize guard;
+      // Every compiled version of a code object owns one reference to it,
+      // through its CodeRuntime.
+      UnorderedMap<PyObject*, Py_ssize_t> jit_refs;
+      for (const auto& [key, compiled] : compiled_codes_) {
+        jit_refs[key.code]++;
+      }
+      for (const auto& [key, compiled] : compiled_osr_codes_) {
+        if (compiled != nullptr) {
+          jit_refs[key.code_key.code]++;
+        }
+      }
+      for (const auto& compiled : retired_compiled_codes_) {
+        jit_refs[compiled->codeRuntime()->frameState()->code()]++;
+      }
+      auto is_dead = [&](PyObject* code) {
+        return Py_REFCNT(code) == jit_refs[code];
+      };
+      auto take_if_dead = [&](auto& compiled_map, auto get_code) {
+        for (auto it = compiled_map.begin(); it != compiled_map.end();) {
+          if (!is_dead(get_code(it->first))) {
+            ++it;
+            continue;
+          }
+          if (it->second != nullptr) {
+            dead.emplace_back(std::move(it->second));
+          }
+          compiled_map.erase(it++);
+        }
+      };
+      take_if_dead(
+          compiled_codes_, [](const CompilationKey& key) { return key.code; });
+      take_if_dead(compiled_osr_codes_, [](const OSRKey& key) {
+        return key.code_key.code;
+      });
+      for (auto it = retired_compiled_codes_.begin();
+           it != retired_compiled_codes_.end();) {
+        if (is_dead((*it)->codeRuntime()->frameState()->code())) {
+          dead.emplace_back(std::move(*it));
+          it = retired_compiled_codes_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    if (dead.empty()) {
+      break;
+    }
+
+    // Free the machine code before dropping the references that keep the code
+    // objects alive, since that can run arbitrary Python code.
+    std::vector<CodeRuntime*> code_runtimes;
+    for (std::unique_ptr<CompiledFunction>& compiled : dead) {
+      JIT_DLOG(
+          "Reclaiming {} bytes of code for {}",
+          compiled->codeSize(),
+          codeQualname(compiled->codeRuntime()->frameState()->code()));
+      reclaimed_bytes += compiled->codeSize();
+      code_runtimes.emplace_back(compiled->codeRuntime());
+      compiled.reset();
+    }
+    for (CodeRuntime* code_rt : code_runtimes) {
+      code_rt->releaseReferences();
+    }
+  }
+  return reclaimed_bytes;
+}
+
+void Context::maybeReclaimDeadCode(bool code_heap_full) {
+  if (funcs_destroyed_since_reclaim_ == 0) {
+    return;
+  }
+  if (code_heap_full ||
+      funcs_destroyed_since_reclaim_ >= compiled_codes_.size()) {
+    reclaimDeadCode();
+  }
+}
+
+void Context::scheduleRecompile(CodeRuntime* code_rt) {
+  const RuntimeFrameState* frame_state = code_rt->frameState();
+  BorrowedRef<PyCodeObject> code = frame_state->code();
+  CompilationKey key{code, frame_state->builtins(), frame_state->globals()};
+
+  ThreadedCompileSerialize guard;
+  auto it = compiled_codes_.find(key);
+  if (it == compiled_codes_.end() || it->second->codeRuntime() != code_rt) {
+    // Already recompiled or reclaimed, or this is an OSR compilation.
+    return;
+  }
+  if (code->co_flags & CO_STATICALLY_COMPILED) {
+    // Static Python functions may be bound directly into other compiled code.
+    return;
+  }
+  uint32_t& count = recompile_counts_[key];
+  if (count >= getConfig().max_recompiles) {
+    return;
+  }
+  count++;
+
+  JIT_DLOG(
+      "Recompiling {} after {} guard failures",
+      codeQualname(code),
+      getConfig().deopt_recompile_threshold);
+  retired_compiled_codes_.emplace_back(std::move(it->second));
+  compiled_codes_.erase(it);
+
+  for (auto func_it = compiled_funcs_.begin();
+       func_it != compiled_funcs_.end();) {
+    BorrowedRef<PyFunctionObject> func = *func_it;
+    ++func_it;
+    if (func->func_code == key.code && func->func_builtins == key.builtins &&
+        func->func_globals == key.globals) {
+      deoptFunc(func);
+    }
+  }
 }
 
 bool Context::didCompile(BorrowedRef<PyFunctionObject> func) {
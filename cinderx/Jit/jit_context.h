@@ -32,6 +32,18 @@ struct CompilationKey {
   constexpr bool operator==(const CompilationKey& other) const = default;
 };
 
+// Lookup key for loops compiled for on-stack replacement: the compilation key
+// of the containing code object and the offset of the loop header.
+struct OSRKey {
+  CompilationKey code_key;
+  int loop_header;
+
+  OSRKey(CompilationKey code_key, int loop_header)
+      : code_key(code_key), loop_header(loop_header) {}
+
+  constexpr bool operator==(const OSRKey& other) const = default;
+};
+
 } // namespace jit
 
 template <>
@@ -43,6 +55,15 @@ struct std::hash<jit::CompilationKey> {
   }
 };
 
+template <>
+struct std::hash<jit::OSRKey> {
+  std::size_t operator()(const jit::OSRKey& key) const {
+    return jit::combineHash(
+        std::hash<jit::CompilationKey>{}(key.code_key),
+        std::hash<int>{}(key.loop_header));
+  }
+};
+
 namespace jit {
 
 /*
@@ -64,6 +85,20 @@ class Context {
       BorrowedRef<PyFunctionObject> func,
       const hir::Preloader& preloader);
 
+  /*
+   * JIT compile a code object for on-stack replacement at the given loop
+   * header.
+   *
+   * Returns nullptr if the loop can't be compiled. Both successes and failures
+   * are cached, so each loop is compiled at most once.
+   */
+  CompiledFunction* compileOSR(
+      BorrowedRef<PyCodeObject> code,
+      BorrowedRef<PyDictObject> builtins,
+      BorrowedRef<PyDictObject> globals,
+      const hir::OSREntry& osr_entry,
+      const std::string& fullname);
+
   /*
    * Attach already-compiled code to the given function, if it exists.
    *
@@ -82,6 +117,38 @@ class Context {
   void funcModified(BorrowedRef<PyFunctionObject> func);
   void funcDestroyed(BorrowedRef<PyFunctionObject> func);
 
+  /*
+   * Callback invoked by the runtime when a PyCodeObject is destroyed.
+   */
+  void codeDestroyed(BorrowedRef<PyCodeObject> code);
+
+  /*
+   * Free the compiled code of every code object that is only kept alive by the
+   * JIT itself. Functions, frames and generators all hold a reference to their
+   * code object, so nothing can be running or about to run such code.
+   *
+   * Returns the number of bytes of machine code freed.
+   */
+  size_t reclaimDeadCode();
+
+  /*
+   * Call reclaimDeadCode() if enough compiled functions have been destroyed
+   * since it last ran to pay for scanning all compiled code, or if the code
+   * heap is full and any have been destroyed at all.
+   */
+  void maybeReclaimDeadCode(bool code_heap_full);
+
+  /*
+   * Throw away the compiled code owning code_rt so that the functions using it
+   * get compiled again on their next call, with the profiling data gathered
+   * since. Does nothing once the code has been recompiled
+   * jit::Config::max_recompiles times.
+   *
+   * The old code stays allocated until it is reclaimed, since it may still be
+   * running.
+   */
+  void scheduleRecompile(CodeRuntime* code_rt);
+
   /*
    * Return whether or not this context compiled the supplied function.
    */
@@ -193,6 +260,24 @@ class Context {
    */
   std::vector<std::unique_ptr<CompiledFunction>> orphaned_compiled_codes_;
 
+  /*
+   * Loops compiled for on-stack replacement. Holds nullptr for loops that
+   * failed to compile.
+   */
+  UnorderedMap<OSRKey, std::unique_ptr<CompiledFunction>> compiled_osr_codes_;
+
+  /*
+   * Code replaced by scheduleRecompile(), kept until reclaimDeadCode() finds
+   * that its code object is dead.
+   */
+  std::vector<std::unique_ptr<CompiledFunction>> retired_compiled_codes_;
+
+  /* Number of times each code object has been recompiled. */
+  UnorderedMap<CompilationKey, uint32_t> recompile_counts_;
+
+  /* Number of compiled functions destroyed since the last reclaimDeadCode(). */
+  size_t funcs_destroyed_since_reclaim_{0};
+
   Ref<> cinderjit_module_;
 };
 
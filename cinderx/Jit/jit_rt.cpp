@@ -14,6 +14,7 @@
 #include "object.h"
 #include "pycore_shadow_frame.h"
 #include "pystate.h"
+#include "structmember.h"
 
 #include "cinderx/Jit/codegen/gen_asm.h"
 #include "cinderx/Jit/frame.h"
@@ -1089,42 +1090,6 @@ PyObject* JITRT_GetObj_FromArray(char* arr, int64_t idx, ssize_t offset) {
   return ((PyObject**)(arr + offset))[idx];
 }
 
-void JITRT_SetI8_InArray(char* arr, uint64_t val, int64_t idx) {
-  arr[idx] = (int8_t)val;
-}
-
-void JITRT_SetU8_InArray(char* arr, uint64_t val, int64_t idx) {
-  arr[idx] = (uint8_t)val;
-}
-
-void JITRT_SetI16_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((int16_t*)arr)[idx] = (int16_t)val;
-}
-
-void JITRT_SetU16_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((uint16_t*)arr)[idx] = (uint16_t)val;
-}
-
-void JITRT_SetI32_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((int32_t*)arr)[idx] = (int32_t)val;
-}
-
-void JITRT_SetU32_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((uint32_t*)arr)[idx] = (uint32_t)val;
-}
-
-void JITRT_SetI64_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((int64_t*)arr)[idx] = (int64_t)val;
-}
-
-void JITRT_SetU64_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((uint64_t*)arr)[idx] = (uint64_t)val;
-}
-
-void JITRT_SetObj_InArray(char* arr, uint64_t val, int64_t idx) {
-  ((PyObject**)arr)[idx] = (PyObject*)val;
-}
-
 template <typename T>
 static T checkedUnboxImpl(PyObject* obj) {
   constexpr bool is_signed = std::is_signed_v<T>;
@@ -1250,48 +1215,131 @@ void JITRT_DoRaise(PyThreadState* tstate, PyObject* exc, PyObject* cause) {
   Cix_do_raise(tstate, exc, cause);
 }
 
-// JIT generator data free-list globals
-const size_t kGenDataFreeListMaxSize = 1024;
-static size_t gen_data_free_list_size = 0;
-static void* gen_data_free_list_tail;
+// JIT generator data is pooled in size classes of spill words, each with its
+// own free list threaded through the first word of the free blocks. Requests
+// are rounded up to the next class so a block can be reused by any generator
+// in that class; anything bigger than the last class goes straight to malloc.
+constexpr size_t kGenDataSpillWordsStep = 32;
+constexpr size_t kGenDataNumSizeClasses = 16;
+constexpr size_t kGenDataMaxPooledSpillWords = jit::kMinGenSpillWords +
+    (kGenDataNumSizeClasses - 1) * kGenDataSpillWordsStep;
+
+// Each free list starts out holding at most kGenDataInitialCap blocks. When a
+// class keeps both dropping freed blocks and missing on allocation, demand is
+// oscillating around the cap and it is doubled, up to kGenDataMaxCap. The
+// total retained across classes never exceeds kGenDataPoolMaxBytes.
+constexpr size_t kGenDataInitialCap = 1024;
+constexpr size_t kGenDataMaxCap = 64 * 1024;
+constexpr size_t kGenDataPoolMaxBytes = 64 * 1024 * 1024;
+
+namespace {
+
+struct GenDataSizeClass {
+  void* free_list{nullptr};
+  size_t size{0};
+  size_t cap{kGenDataInitialCap};
+  // Allocation misses and dropped frees since cap last changed.
+  size_t misses{0};
+  size_t drops{0};
+};
+
+std::array<GenDataSizeClass, kGenDataNumSizeClasses> gen_data_classes;
+JITRT_GenDataPoolStats gen_data_stats{};
+
+size_t genDataBytes(size_t spill_words) {
+  return spill_words * sizeof(uint64_t) + sizeof(jit::GenDataFooter);
+}
+
+} // namespace
 
-static void* gen_data_allocate(size_t spill_words) {
-  if (spill_words > jit::kMinGenSpillWords || !gen_data_free_list_size) {
-    auto data =
-        malloc(spill_words * sizeof(uint64_t) + sizeof(jit::GenDataFooter));
-    auto footer = reinterpret_cast<jit::GenDataFooter*>(
-        reinterpret_cast<uint64_t*>(data) + spill_words);
-    footer->spillWords = spill_words;
-    return data;
+// Rounds spill_words up to the size actually allocated.
+static void* gen_data_allocate(size_t& spill_words) {
+  JIT_DCHECK(spill_words >= jit::kMinGenSpillWords, "invalid size");
+  if (spill_words > kGenDataMaxPooledSpillWords) {
+    gen_data_stats.misses++;
+    return malloc(genDataBytes(spill_words));
   }
 
-  // All free list entries are spill-word size 89, so we don't need to set
-  // footer->spillWords again, it should still be set to 89 from previous use.
-  JIT_DCHECK(spill_words == jit::kMinGenSpillWords, "invalid size");
+  size_t extra_words = spill_words - jit::kMinGenSpillWords;
+  size_t idx =
+      (extra_words + kGenDataSpillWordsStep - 1) / kGenDataSpillWordsStep;
+  spill_words = jit::kMinGenSpillWords + idx * kGenDataSpillWordsStep;
+  GenDataSizeClass& size_class = gen_data_classes[idx];
+  if (size_class.size == 0) {
+    gen_data_stats.misses++;
+    size_class.misses++;
+    return malloc(genDataBytes(spill_words));
+  }
 
-  gen_data_free_list_size--;
-  auto res = gen_data_free_list_tail;
-  gen_data_free_list_tail = *reinterpret_cast<void**>(gen_data_free_list_tail);
+  gen_data_stats.hits++;
+  gen_data_stats.retained_blocks--;
+  gen_data_stats.retained_bytes -= genDataBytes(spill_words);
+  size_class.size--;
+  void* res = size_class.free_list;
+  size_class.free_list = *reinterpret_cast<void**>(res);
   return res;
 }
 
 void JITRT_GenJitDataFree(PyGenObject* gen) {
   auto gen_data_footer =
       reinterpret_cast<jit::GenDataFooter*>(gen->gi_jit_data);
-  auto gen_data = reinterpret_cast<uint64_t*>(gen_data_footer) -
-      gen_data_footer->spillWords;
+  size_t spill_words = gen_data_footer->spillWords;
+  auto gen_data = reinterpret_cast<uint64_t*>(gen_data_footer) - spill_words;
+
+  if (spill_words > kGenDataMaxPooledSpillWords) {
+    free(gen_data);
+    return;
+  }
 
-  if (gen_data_footer->spillWords != jit::kMinGenSpillWords ||
-      gen_data_free_list_size == kGenDataFreeListMaxSize) {
+  // Blocks are only ever allocated with a class-aligned spillWords, which
+  // stays valid in the footer while the block sits in the free list.
+  size_t idx = (spill_words - jit::kMinGenSpillWords) / kGenDataSpillWordsStep;
+  JIT_DCHECK(
+      spill_words == jit::kMinGenSpillWords + idx * kGenDataSpillWordsStep,
+      "invalid size");
+  GenDataSizeClass& size_class = gen_data_classes[idx];
+  size_t bytes = genDataBytes(spill_words);
+  if (size_class.size >= size_class.cap) {
+    size_class.drops++;
+    if (size_class.misses >= size_class.cap &&
+        size_class.drops >= size_class.cap &&
+        size_class.cap < kGenDataMaxCap) {
+      size_class.cap *= 2;
+      size_class.misses = 0;
+      size_class.drops = 0;
+    }
+  }
+  if (size_class.size >= size_class.cap ||
+      gen_data_stats.retained_bytes + bytes > kGenDataPoolMaxBytes) {
     free(gen_data);
     return;
   }
 
-  if (gen_data_free_list_size) {
-    *reinterpret_cast<void**>(gen_data) = gen_data_free_list_tail;
+  *reinterpret_cast<void**>(gen_data) = size_class.free_list;
+  size_class.free_list = gen_data;
+  size_class.size++;
+  gen_data_stats.retained_blocks++;
+  gen_data_stats.retained_bytes += bytes;
+}
+
+JITRT_GenDataPoolStats JITRT_GetGenDataPoolStats() {
+  return gen_data_stats;
+}
+
+size_t JITRT_TrimGenDataPool() {
+  size_t freed = gen_data_stats.retained_bytes;
+  for (GenDataSizeClass& size_class : gen_data_classes) {
+    void* block = size_class.free_list;
+    while (block != nullptr) {
+      void* next = *reinterpret_cast<void**>(block);
+      free(block);
+      block = next;
+    }
+    size_class = GenDataSizeClass{};
   }
-  gen_data_free_list_size++;
-  gen_data_free_list_tail = gen_data;
+  gen_data_stats.retained_blocks = 0;
+  gen_data_stats.retained_bytes = 0;
+  return freed;
 }
 
 enum class MakeGenObjectMode {
@@ -1351,6 +1399,7 @@ static inline PyObject* make_gen_object(
   auto suspend_data = gen_data_allocate(spill_words);
   auto footer = reinterpret_cast<jit::GenDataFooter*>(
       reinterpret_cast<uint64_t*>(suspend_data) + spill_words);
+  footer->spillWords = spill_words;
   footer->resumeEntry = resume_entry;
   footer->yieldPoint = nullptr;
   footer->state = Ci_JITGenState_JustStarted;
@@ -1824,6 +1873,85 @@ PyObject* JITRT_GetLength(PyObject* obj) {
   return PyLong_FromSsize_t(len);
 }
 
+namespace {
+
+// Offsets of a range's start, stop and step. rangeobject isn't exposed in a
+// header, so they're looked up from the type's member table once.
+struct RangeMemberOffsets {
+  Py_ssize_t start{-1};
+  Py_ssize_t stop{-1};
+  Py_ssize_t step{-1};
+};
+
+const RangeMemberOffsets& rangeMemberOffsets() {
+  static const RangeMemberOffsets offsets = [] {
+    RangeMemberOffsets result;
+    for (PyMemberDef* member = PyRange_Type.tp_members;
+         member->name != nullptr;
+         member++) {
+      if (strcmp(member->name, "start") == 0) {
+        result.start = member->offset;
+      } else if (strcmp(member->name, "stop") == 0) {
+        result.stop = member->offset;
+      } else if (strcmp(member->name, "step") == 0) {
+        result.step = member->offset;
+      }
+    }
+    JIT_CHECK(
+        result.start >= 0 && result.stop >= 0 && result.step >= 0,
+        "range is missing one of start, stop and step");
+    return result;
+  }();
+  return offsets;
+}
+
+// Return the range member at the given offset as a C long, or -1 with an
+// OverflowError set if it doesn't fit.
+long rangeMemberAsLong(PyObject* range, Py_ssize_t offset) {
+  return PyLong_AsLong(*reinterpret_cast<PyObject**>(
+      reinterpret_cast<char*>(range) + offset));
+}
+
+} // namespace
+
+Py_ssize_t JITRT_RangeIterLen(PyObject* range) {
+  // Same conditions as range_iter() in Objects/rangeobject.c uses to pick
+  // fast_range_iter().
+  const RangeMemberOffsets& offsets = rangeMemberOffsets();
+  long start = rangeMemberAsLong(range, offsets.start);
+  long stop = rangeMemberAsLong(range, offsets.stop);
+  long step = rangeMemberAsLong(range, offsets.step);
+  if ((start == -1 || stop == -1 || step == -1) && PyErr_Occurred()) {
+    PyErr_Clear();
+    return -1;
+  }
+  unsigned long len = 0;
+  if (step > 0 && start < stop) {
+    len = 1UL + (stop - 1UL - start) / step;
+  } else if (step < 0 && start > stop) {
+    len = 1UL + (start - 1UL - stop) / (0UL - step);
+  }
+  if (len > static_cast<unsigned long>(LONG_MAX)) {
+    return -1;
+  }
+  // Check for potential overflow of start + len * step.
+  if (len != 0) {
+    if (step > 0 ? stop > LONG_MAX - (step - 1)
+                 : stop < LONG_MIN + (-1 - step)) {
+      return -1;
+    }
+  }
+  return len;
+}
+
+Py_ssize_t JITRT_RangeStart(PyObject* range) {
+  return rangeMemberAsLong(range, rangeMemberOffsets().start);
+}
+
+Py_ssize_t JITRT_RangeStep(PyObject* range) {
+  return rangeMemberAsLong(range, rangeMemberOffsets().step);
+}
+
 int JITRT_DictUpdate(PyThreadState* tstate, PyObject* dict, PyObject* update) {
   if (PyDict_Update(dict, update) < 0) {
     if (_PyErr_ExceptionMatches(tstate, PyExc_AttributeError)) {
@@ -348,17 +348,6 @@ double JITRT_PowerUnsigned64(uint64_t x, uint64_t y);
 /* Array lookup helpers */
 uint64_t JITRT_GetI64_FromArray(char* arr, int64_t idx, ssize_t offset);
 
-/* Array set helpers */
-void JITRT_SetI8_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetU8_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetI16_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetU16_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetI32_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetU32_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetI64_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetU64_InArray(char* arr, uint64_t val, int64_t idx);
-void JITRT_SetObj_InArray(char* arr, uint64_t val, int64_t idx);
-
 uint64_t JITRT_UnboxU64(PyObject* obj);
 uint32_t JITRT_UnboxU32(PyObject* obj);
 uint16_t JITRT_UnboxU16(PyObject* obj);
@@ -392,6 +381,25 @@ void JITRT_DoRaise(PyThreadState* tstate, PyObject* exc, PyObject* cause);
  */
 void JITRT_GenJitDataFree(PyGenObject* gen);
 
+/*
+ * Counters for the pool of generator suspend data blocks. Hits and misses
+ * count allocations served from the pool and from malloc() respectively.
+ */
+typedef struct {
+  size_t hits;
+  size_t misses;
+  size_t retained_blocks;
+  size_t retained_bytes;
+} JITRT_GenDataPoolStats;
+
+JITRT_GenDataPoolStats JITRT_GetGenDataPoolStats();
+
+/*
+ * Releases every pooled suspend data block back to the system allocator and
+ * resets the pool's adaptive caps. Returns the number of bytes released.
+ */
+size_t JITRT_TrimGenDataPool();
+
 /*
  * Formats a f-string value
  */
@@ -555,6 +563,15 @@ Py_ssize_t JITRT_CheckSequenceBounds(PyObject* seq, Py_ssize_t i);
  * set if there was an error. */
 PyObject* JITRT_GetLength(PyObject* obj);
 
+/* Return the length of a range whose start, stop and step all fit in a C long,
+ * which iter() turns into a range_iterator. Return -1 without raising if they
+ * don't. */
+Py_ssize_t JITRT_RangeIterLen(PyObject* range);
+
+/* Return the start or step of a range accepted by JITRT_RangeIterLen(). */
+Py_ssize_t JITRT_RangeStart(PyObject* range);
+Py_ssize_t JITRT_RangeStep(PyObject* range);
+
 /* Call match_keys() in ceval.c
  * NOTE: This function is here as a wrapper around the private match_keys
  * function and should be removed when match_keys becomes public.
@@ -18,6 +18,11 @@
 namespace jit {
 
 static std::vector<std::string> capture_compilation_times_for;
+static CompilationPhaseObserver compilation_phase_observer;
+
+void setCompilationPhaseObserver(CompilationPhaseObserver observer) {
+  compilation_phase_observer = std::move(observer);
+}
 
 void parseAndSetFuncList(const std::string& flag_value) {
   capture_compilation_times_for.clear();
@@ -205,7 +210,12 @@ void CompilationPhaseTimer::end() {
   current_phase_stack_.back()->end = time_provider_();
 
   if (current_phase_stack_.back() == root_.get()) {
-    dumpPhaseTimingsAndTidy();
+    if (compilation_phase_observer) {
+      compilation_phase_observer(function_name_, *root_);
+      root_ = nullptr;
+    } else {
+      dumpPhaseTimingsAndTidy();
+    }
   }
 
   current_phase_stack_.pop_back();
@@ -8,6 +8,7 @@
 #include "cinderx/Jit/containers.h"
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -54,6 +55,14 @@ class SubPhaseTimer {
   DISALLOW_COPY_AND_ASSIGN(SubPhaseTimer);
 };
 
+// Receives the finished phase tree of every CompilationPhaseTimer instead of
+// the breakdown being written to the JIT log.
+using CompilationPhaseObserver = std::function<
+    void(const std::string& function_name, const SubPhaseTimer& root)>;
+
+// Install an observer, or restore logging by passing nullptr.
+void setCompilationPhaseObserver(CompilationPhaseObserver observer);
+
 class CompilationPhaseTimer {
  public:
   CompilationPhaseTimer(
@@ -67,7 +76,8 @@ class CompilationPhaseTimer {
 
   void start(const std::string& phase_name);
 
-  // when final start end pair is called with no nesting, then
+  // when final start end pair is called with no nesting, then the phase tree
+  // is passed to the CompilationPhaseObserver if there is one, otherwise
   // dumpPhaseTimingsAndTidy is invoked and the output dumped to the JIT debug
   // log
   void end();
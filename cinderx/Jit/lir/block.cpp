@@ -28,6 +28,9 @@ BasicBlock* BasicBlock::insertBasicBlockBetween(BasicBlock* block) {
   old_preds.erase(std::find(old_preds.begin(), old_preds.end(), this));
 
   new_block->addSuccessor(block);
+  if (likely_successor_ == block) {
+    likely_successor_ = new_block;
+  }
 
   return new_block;
 }
@@ -79,6 +82,8 @@ BasicBlock* BasicBlock::splitBefore(Instruction* instr) {
   }
 
   // update successors of first block
+  second_block->likely_successor_ = likely_successor_;
+  likely_successor_ = nullptr;
   successors_.clear();
   // addSuccessor also fixes predecessors of second block
   addSuccessor(second_block);
@@ -106,6 +111,9 @@ void BasicBlock::setSuccessor(size_t index, BasicBlock* bb) {
 
   successors_.at(index) = bb;
   bb->predecessors_.push_back(this);
+  if (likely_successor_ == old_bb) {
+    likely_successor_ = bb;
+  }
 }
 
 BasicBlock::InstrList::iterator BasicBlock::iterator_to(Instruction* instr) {
@@ -201,6 +201,17 @@ class BasicBlock {
     section_ = section;
   }
 
+  // The successor that profiling says is usually taken, or nullptr. Block
+  // sorting tries to place it right after this block so it's reached by
+  // falling through.
+  BasicBlock* likelySuccessor() const {
+    return likely_successor_;
+  }
+
+  void setLikelySuccessor(BasicBlock* block) {
+    likely_successor_ = block;
+  }
+
  private:
   int id_;
   Function* func_;
@@ -219,6 +230,8 @@ class BasicBlock {
   InstrList instrs_;
 
   jit::codegen::CodeSection section_;
+
+  BasicBlock* likely_successor_{nullptr};
 };
 
 } // namespace jit::lir
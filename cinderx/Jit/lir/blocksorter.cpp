@@ -120,7 +120,16 @@ int BasicBlockSorter::dfsSearch(BasicBlock* block) {
 void BasicBlockSorter::calcEntryBlocks() {
   for (auto block : basic_blocks_) {
     auto cur_scc = map_get(block_to_scc_map_, block);
-    for (auto succ : block->successors()) {
+    // sortRPO() places the successor visited last right after its
+    // predecessor, so visit the likely successor last to make it the
+    // fall-through.
+    std::vector<BasicBlock*> successors = block->successors();
+    auto likely = std::find(
+        successors.begin(), successors.end(), block->likelySuccessor());
+    if (likely != successors.end()) {
+      std::rotate(likely, likely + 1, successors.end());
+    }
+    for (auto succ : successors) {
       if (!basic_blocks_.count(succ) || succ == entry_) {
         continue;
       }
@@ -1,12 +1,265 @@
 // Copyright (c) Meta Platforms, Inc. and affiliates.
 
+// This file is @generated by generate_c_helper_translations.py.
+// Run 'make regen-c-helper-translations' against a built _cinderx extension
+// to update it.
+
 #include "cinderx/Jit/lir/c_helper_translations_auto.h"
 
 #include "cinderx/Jit/jit_rt.h"
 
 namespace jit::lir {
 
+// clang-format off
+
 const std::initializer_list<std::pair<const uint64_t, const char*>>
-    kCHelperMappingAuto = {};
+    kCHelperMappingAuto = {
+        {reinterpret_cast<uint64_t>(JITRT_BoxBool),
+         R"LIR(Function:
+BB %0 - succs: %2 %1
+        %4:32bit = LoadArg 0(0x0):32bit
+        %5:32bit = Move %4:32bit
+         %6:8bit = NotEqual %5:32bit, 0(0x0):32bit
+                   CondBranch %6:8bit
+
+BB %1 - preds: %0 - succs: %3
+       %7:Object = Move _Py_FalseStruct
+                   Return %7:Object
+
+BB %2 - preds: %0 - succs: %3
+       %8:Object = Move _Py_TrueStruct
+                   Return %8:Object
+
+BB %3 - preds: %1 %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_BoxI32),
+         R"LIR(Function:
+BB %0 - succs: %1
+        %2:32bit = LoadArg 0(0x0):32bit
+        %3:32bit = Move %2:32bit
+        %4:64bit = Sext %3:32bit
+       %5:Object = Call PyLong_FromLong, %4:64bit
+                   Return %5:Object
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_BoxI64),
+         R"LIR(Function:
+BB %0 - succs: %1
+        %2:64bit = LoadArg 0(0x0):64bit
+       %3:Object = Call PyLong_FromSsize_t, %2:64bit
+                   Return %3:Object
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_BoxU32),
+         R"LIR(Function:
+BB %0 - succs: %1
+        %2:32bit = LoadArg 0(0x0):32bit
+        %3:32bit = Move %2:32bit
+        %4:64bit = Zext %3:32bit
+       %5:Object = Call PyLong_FromUnsignedLong, %4:64bit
+                   Return %5:Object
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_BoxU64),
+         R"LIR(Function:
+BB %0 - succs: %1
+        %2:64bit = LoadArg 0(0x0):64bit
+       %3:Object = Call PyLong_FromSize_t, %2:64bit
+                   Return %3:Object
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_CastExact),
+         R"LIR(Function:
+BB %0 - succs: %2 %1
+       %4:Object = LoadArg 0(0x0):Object
+       %5:Object = LoadArg 1(0x1):Object
+        %6:64bit = Move [%4:Object + 0x8]:64bit
+         %7:8bit = Equal %5:Object, %6:64bit
+                   CondBranch %7:8bit
+
+BB %1 - preds: %0 - succs: %3
+        %8:64bit = Move [%6:64bit + 0x18]:64bit
+        %9:64bit = Move [%5:Object + 0x18]:64bit
+      %10:Object = Call PyErr_Format, PyExc_TypeError, "expected exactly '%s', got '%s'", %9:64bit, %8:64bit
+      %11:Object = Move 0(0x0):64bit
+                   Return %11:Object
+
+BB %2 - preds: %0 - succs: %3
+                   Return %4:Object
+
+BB %3 - preds: %1 %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_CastOptionalExact),
+         R"LIR(Function:
+BB %0 - succs: %3 %1
+       %5:Object = LoadArg 0(0x0):Object
+       %6:Object = LoadArg 1(0x1):Object
+        %7:64bit = Move [%5:Object + 0x8]:64bit
+         %8:8bit = Equal %6:Object, %7:64bit
+                   CondBranch %8:8bit
+
+BB %1 - preds: %0 - succs: %3 %2
+       %9:Object = Move _Py_NoneStruct
+        %10:8bit = Equal %5:Object, %9:Object
+                   CondBranch %10:8bit
+
+BB %2 - preds: %1 - succs: %4
+       %11:64bit = Move [%7:64bit + 0x18]:64bit
+       %12:64bit = Move [%6:Object + 0x18]:64bit
+      %13:Object = Call PyErr_Format, PyExc_TypeError, "expected exactly '%s', got '%s'", %12:64bit, %11:64bit
+      %14:Object = Move 0(0x0):64bit
+                   Return %14:Object
+
+BB %3 - preds: %0 %1 - succs: %4
+                   Return %5:Object
+
+BB %4 - preds: %2 %3
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_GetLength),
+         R"LIR(Function:
+BB %0 - succs: %2 %1
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyObject_Size, %4:Object
+         %6:8bit = LessThanSigned %5:64bit, 0(0x0):64bit
+                   CondBranch %6:8bit
+
+BB %1 - preds: %0 - succs: %3
+       %7:Object = Call PyLong_FromSsize_t, %5:64bit
+                   Return %7:Object
+
+BB %2 - preds: %0 - succs: %3
+       %8:Object = Move 0(0x0):64bit
+                   Return %8:Object
+
+BB %3 - preds: %1 %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxI16),
+         R"LIR(Function:
+BB %0 - succs: %1 %2
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyLong_AsSsize_t, %4:Object
+        %6:16bit = Move %5:64bit
+        %7:64bit = Sext %6:16bit
+        %8:32bit = Move %5:64bit
+         %9:8bit = NotEqual %5:64bit, %7:64bit
+                   CondBranch %9:8bit
+
+BB %1 - preds: %0 - succs: %2
+                   Call PyErr_SetString, PyExc_OverflowError, "int overflow"
+       %10:32bit = Move 4294967295(0xffffffff):32bit
+
+BB %2 - preds: %0 %1 - succs: %3
+       %11:32bit = Phi (BB%0, %8:32bit), (BB%1, %10:32bit)
+       %12:16bit = Move %11:32bit
+                   Return %12:16bit
+
+BB %3 - preds: %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxI32),
+         R"LIR(Function:
+BB %0 - succs: %1 %2
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyLong_AsSsize_t, %4:Object
+        %6:32bit = Move %5:64bit
+        %7:64bit = Sext %6:32bit
+        %8:32bit = Move %5:64bit
+         %9:8bit = NotEqual %5:64bit, %7:64bit
+                   CondBranch %9:8bit
+
+BB %1 - preds: %0 - succs: %2
+                   Call PyErr_SetString, PyExc_OverflowError, "int overflow"
+       %10:32bit = Move 4294967295(0xffffffff):32bit
+
+BB %2 - preds: %0 %1 - succs: %3
+       %11:32bit = Phi (BB%0, %8:32bit), (BB%1, %10:32bit)
+                   Return %11:32bit
+
+BB %3 - preds: %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxI64),
+         R"LIR(Function:
+BB %0 - succs: %1
+       %2:Object = LoadArg 0(0x0):Object
+        %3:64bit = Call PyLong_AsSsize_t, %2:Object
+                   Return %3:64bit
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxI8),
+         R"LIR(Function:
+BB %0 - succs: %1 %2
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyLong_AsSsize_t, %4:Object
+         %6:8bit = Move %5:64bit
+        %7:64bit = Sext %6:8bit
+        %8:32bit = Move %5:64bit
+         %9:8bit = NotEqual %5:64bit, %7:64bit
+                   CondBranch %9:8bit
+
+BB %1 - preds: %0 - succs: %2
+                   Call PyErr_SetString, PyExc_OverflowError, "int overflow"
+       %10:32bit = Move 4294967295(0xffffffff):32bit
+
+BB %2 - preds: %0 %1 - succs: %3
+       %11:32bit = Phi (BB%0, %8:32bit), (BB%1, %10:32bit)
+        %12:8bit = Move %11:32bit
+                   Return %12:8bit
+
+BB %3 - preds: %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxU16),
+         R"LIR(Function:
+BB %0 - succs: %2 %1
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyLong_AsSize_t, %4:Object
+         %6:8bit = GreaterThanUnsigned %5:64bit, 65535(0xffff):64bit
+                   CondBranch %6:8bit
+
+BB %1 - preds: %0 - succs: %3
+        %7:16bit = Move %5:64bit
+                   Return %7:16bit
+
+BB %2 - preds: %0 - succs: %3
+                   Call PyErr_SetString, PyExc_OverflowError, "int overflow"
+        %8:16bit = Move 65535(0xffff):16bit
+                   Return %8:16bit
+
+BB %3 - preds: %1 %2
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxU64),
+         R"LIR(Function:
+BB %0 - succs: %1
+       %2:Object = LoadArg 0(0x0):Object
+        %3:64bit = Call PyLong_AsSize_t, %2:Object
+                   Return %3:64bit
+
+BB %1 - preds: %0
+)LIR"},
+        {reinterpret_cast<uint64_t>(JITRT_UnboxU8),
+         R"LIR(Function:
+BB %0 - succs: %2 %1
+       %4:Object = LoadArg 0(0x0):Object
+        %5:64bit = Call PyLong_AsSize_t, %4:Object
+         %6:8bit = GreaterThanUnsigned %5:64bit, 255(0xff):64bit
+                   CondBranch %6:8bit
+
+BB %1 - preds: %0 - succs: %3
+         %7:8bit = Move %5:64bit
+                   Return %7:8bit
+
+BB %2 - preds: %0 - succs: %3
+                   Call PyErr_SetString, PyExc_OverflowError, "int overflow"
+         %8:8bit = Move 255(0xff):8bit
+                   Return %8:8bit
+
+BB %3 - preds: %1 %2
+)LIR"},
+};
+
+// clang-format on
 
 } // namespace jit::lir
@@ -6,6 +6,7 @@
 #include "cinderx/Jit/lir/blocksorter.h"
 #include "cinderx/Jit/lir/printer.h"
 
+#include <algorithm>
 #include <stack>
 
 namespace jit::lir {
@@ -205,6 +206,16 @@ void Function::sortBasicBlocks() {
   basic_blocks_ = sorter.getSortedBlocks();
 }
 
+void Function::sinkColdBlocks() {
+  if (basic_blocks_.size() < 2) {
+    return;
+  }
+  std::stable_partition(
+      basic_blocks_.begin(), basic_blocks_.end() - 1, [](BasicBlock* block) {
+        return block->section() == codegen::CodeSection::kHot;
+      });
+}
+
 BasicBlock* Function::allocateBasicBlock() {
   basic_block_store_.emplace_back(this);
   BasicBlock* new_block = &basic_block_store_.back();
@@ -65,6 +65,12 @@ class Function {
 
   void sortBasicBlocks();
 
+  // Move blocks in the cold section after all others except the exit block,
+  // keeping their relative order. Cold blocks may branch back into hot ones,
+  // so this is only done once register allocation no longer depends on the
+  // block order.
+  void sinkColdBlocks();
+
   void print() const;
 
  private:
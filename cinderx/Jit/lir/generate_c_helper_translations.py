@@ -0,0 +1,1724 @@
+#!/usr/bin/env python3
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import argparse
+import os
+import random
+import re
+import subprocess
+import sys
+import zlib
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional, Sequence, TextIO, Tuple, Union
+
+# This file is used to generate Jit/lir/c_helper_translations_auto.cpp.
+#
+# It disassembles the JITRT_* helpers in a built _cinderx extension and lifts
+# the ones that are small and simple enough into LIR text, which the LIR
+# inliner can then splice into JIT-compiled code in place of a call. Only a
+# restricted subset of x86-64 is understood: register and memory moves,
+# integer arithmetic without carries, compares feeding conditional branches
+# or cmov/setcc, direct calls and tail calls to functions in kSymbolMapping,
+# and frame setup that can be ignored. Anything else (stack memory, loops,
+# divisions, shifts, flags that cross blocks, ...) causes the helper to be
+# rejected with a reason, and it stays an out-of-line call. Every translation
+# is then run side by side with the machine code it came from (see
+# verify_translation()) and dropped if the two behave differently.
+#
+# The output depends on the compiler that built the extension, so it is
+# checked in and regenerated explicitly with 'make regen-c-helper-translations'
+# rather than as part of the normal build.
+
+CINDERX_ROOT = os.path.dirname(
+    os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+)
+JIT_RT_H = os.path.join(CINDERX_ROOT, "Jit", "jit_rt.h")
+SYMBOL_MAPPING_CPP = os.path.join(CINDERX_ROOT, "Jit", "lir", "symbol_mapping.cpp")
+MANUAL_TRANSLATIONS_CPP = os.path.join(
+    CINDERX_ROOT, "Jit", "lir", "c_helper_translations.cpp"
+)
+
+# Helpers larger than this (in machine instructions) are not worth inlining.
+DEFAULT_MAX_INSTRS = 40
+
+ARG_REGS = ["rdi", "rsi", "rdx", "rcx", "r8", "r9"]
+CALLER_SAVED = ["rax", "rcx", "rdx", "rsi", "rdi", "r8", "r9", "r10", "r11"]
+
+
+class LiftError(Exception):
+    pass
+
+
+# C types that can appear in helper or callee signatures, mapped to
+# (LIR data type, width in bits).
+C_TYPES: Dict[str, Tuple[str, int]] = {
+    "int8_t": ("8bit", 8),
+    "uint8_t": ("8bit", 8),
+    "int16_t": ("16bit", 16),
+    "uint16_t": ("16bit", 16),
+    "int": ("32bit", 32),
+    "int32_t": ("32bit", 32),
+    "uint32_t": ("32bit", 32),
+    "long": ("64bit", 64),
+    "int64_t": ("64bit", 64),
+    "uint64_t": ("64bit", 64),
+    "size_t": ("64bit", 64),
+    "Py_ssize_t": ("64bit", 64),
+}
+
+
+def parse_c_type(text: str) -> Optional[Tuple[str, int]]:
+    """Map a C type to (LIR data type, width), or None for void. Raises
+    LiftError for types that can't be passed in a general purpose register.
+    """
+    text = re.sub(r"\bconst\b", "", text).strip()
+    if text == "void":
+        return None
+    if text.endswith("*"):
+        return ("Object", 64)
+    if text in C_TYPES:
+        return C_TYPES[text]
+    raise LiftError(f"unsupported C type '{text}'")
+
+
+@dataclass
+class Signature:
+    ret: Optional[Tuple[str, int]]
+    params: List[Tuple[str, int]]
+    # Index of the format string argument for printf-style variadic callees.
+    format_arg: Optional[int] = None
+
+
+# Functions that lifted helpers may call. Each one must also be present in
+# kSymbolMapping so that the LIR parser can resolve it.
+CALLEES: Dict[str, Signature] = {
+    "PyErr_Format": Signature(("Object", 64), [("Object", 64)] * 2, format_arg=1),
+    "PyErr_SetString": Signature(None, [("Object", 64)] * 2),
+    "PyLong_AsSize_t": Signature(("64bit", 64), [("Object", 64)]),
+    "PyLong_AsSsize_t": Signature(("64bit", 64), [("Object", 64)]),
+    "PyLong_FromLong": Signature(("Object", 64), [("64bit", 64)]),
+    "PyLong_FromSize_t": Signature(("Object", 64), [("64bit", 64)]),
+    "PyLong_FromSsize_t": Signature(("Object", 64), [("64bit", 64)]),
+    "PyLong_FromUnsignedLong": Signature(("Object", 64), [("64bit", 64)]),
+    "PyObject_Size": Signature(("64bit", 64), [("Object", 64)]),
+    "PyType_IsSubtype": Signature(("32bit", 32), [("Object", 64)] * 2),
+}
+
+# Data symbols that lifted helpers may reference through the GOT. "pointer"
+# symbols are PyObject* variables whose kSymbolMapping entry holds their
+# value; "object" symbols are statically allocated objects whose entry holds
+# their address.
+DATA_SYMBOLS: Dict[str, str] = {
+    "PyExc_IndexError": "pointer",
+    "PyExc_OverflowError": "pointer",
+    "PyExc_TypeError": "pointer",
+    "_Py_FalseStruct": "object",
+    "_Py_NoneStruct": "object",
+    "_Py_TrueStruct": "object",
+}
+
+
+def read_helper_signatures(path: str) -> Dict[str, Signature]:
+    with open(path) as f:
+        text = f.read()
+    # Strip comments so that prototypes inside them aren't picked up.
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    sigs = {}
+    proto = re.compile(
+        r"^([A-Za-z_][\w \t\*]*?[\s\*])(JITRT_\w+)\s*\(([^;{)]*)\)\s*;", re.M
+    )
+    for m in proto.finditer(text):
+        ret, name, params = m.group(1), m.group(2), m.group(3)
+        try:
+            ret_ty = parse_c_type(ret)
+            param_tys = []
+            params = params.strip()
+            if params and params != "void":
+                for p in params.split(","):
+                    p = p.strip()
+                    if p == "...":
+                        raise LiftError("variadic helper")
+                    # Drop the parameter name.
+                    pm = re.match(r"(.*?[\s\*])\s*\w+$", p)
+                    param_tys.append(parse_c_type(pm.group(1) if pm else p))
+        except LiftError:
+            continue
+        if len(param_tys) > len(ARG_REGS):
+            continue
+        sigs[name] = Signature(ret_ty, param_tys)
+    return sigs
+
+
+def read_symbol_mapping(path: str) -> List[str]:
+    with open(path) as f:
+        return re.findall(r'\{"(\w+)",', f.read())
+
+
+def read_manual_translations(path: str) -> List[str]:
+    with open(path) as f:
+        return re.findall(r"reinterpret_cast<uint64_t>\((JITRT_\w+)\)", f.read())
+
+
+def run(cmd: Sequence[str]) -> str:
+    return subprocess.run(cmd, check=True, capture_output=True, text=True).stdout
+
+
+class Binary:
+    """The parts of the shared object that the lifter needs: helper symbols,
+    GOT slots and read-only data.
+    """
+
+    def __init__(self, path: str, objdump: str, nm: str) -> None:
+        self.path = path
+        self.objdump = objdump
+        self.helpers: Dict[str, str] = {}
+        for line in run([nm, "--defined-only", path]).splitlines():
+            parts = line.split()
+            if len(parts) != 3 or parts[1] != "T":
+                continue
+            sym = parts[2]
+            m = re.match(r"_Z(\d+)(JITRT_\w+)", sym)
+            if m and len(m.group(2)) >= int(m.group(1)):
+                self.helpers[m.group(2)[: int(m.group(1))]] = sym
+            elif sym.startswith("JITRT_"):
+                self.helpers[sym] = sym
+
+        self.got: Dict[int, str] = {}
+        for line in run([objdump, "-R", path]).splitlines():
+            parts = line.split()
+            if len(parts) == 3 and parts[1] == "R_X86_64_GLOB_DAT":
+                self.got[int(parts[0], 16)] = parts[2].split("@")[0]
+
+        self.rodata: List[Tuple[int, int, int]] = []
+        for line in run([objdump, "-h", path]).splitlines():
+            parts = line.split()
+            if len(parts) >= 6 and parts[1].startswith(".rodata"):
+                size, vma, off = (int(parts[i], 16) for i in (2, 3, 5))
+                self.rodata.append((vma, size, off))
+
+    def disassemble(self, sym: str) -> str:
+        return run(
+            [self.objdump, "-d", "--no-show-raw-insn", f"--disassemble={sym}", self.path]
+        )
+
+    def read_string(self, addr: int) -> Optional[str]:
+        for vma, size, off in self.rodata:
+            if vma <= addr < vma + size:
+                with open(self.path, "rb") as f:
+                    f.seek(off + addr - vma)
+                    data = f.read(vma + size - addr)
+                end = data.find(b"\0")
+                if end <= 0:
+                    return None
+                try:
+                    return data[:end].decode("ascii")
+                except UnicodeDecodeError:
+                    return None
+        return None
+
+
+# x86-64 register names mapped to (64-bit register, width).
+REGS: Dict[str, Tuple[str, int]] = {}
+for r in ["ax", "bx", "cx", "dx"]:
+    REGS[f"r{r}"] = (f"r{r}", 64)
+    REGS[f"e{r}"] = (f"r{r}", 32)
+    REGS[r] = (f"r{r}", 16)
+    REGS[f"{r[0]}l"] = (f"r{r}", 8)
+for r in ["si", "di", "bp", "sp"]:
+    REGS[f"r{r}"] = (f"r{r}", 64)
+    REGS[f"e{r}"] = (f"r{r}", 32)
+    REGS[r] = (f"r{r}", 16)
+    REGS[f"{r}l"] = (f"r{r}", 8)
+for i in range(8, 16):
+    REGS[f"r{i}"] = (f"r{i}", 64)
+    REGS[f"r{i}d"] = (f"r{i}", 32)
+    REGS[f"r{i}w"] = (f"r{i}", 16)
+    REGS[f"r{i}b"] = (f"r{i}", 8)
+
+SUFFIX_WIDTHS = {"b": 8, "w": 16, "l": 32, "q": 64}
+WIDTH_TYPES = {8: "8bit", 16: "16bit", 32: "32bit", 64: "64bit"}
+
+
+def mask(width: int) -> int:
+    return (1 << width) - 1
+
+
+@dataclass
+class Reg:
+    name: str
+    width: int
+
+
+@dataclass
+class Imm:
+    value: int
+
+
+@dataclass
+class Mem:
+    disp: int
+    base: Optional[str]
+    index: Optional[str]
+    scale: int
+    # Target address for %rip-relative operands, as annotated by objdump.
+    target: Optional[int] = None
+
+
+@dataclass
+class Target:
+    addr: int
+    sym: str
+
+
+Operand = Union[Reg, Imm, Mem, Target]
+
+
+@dataclass
+class Insn:
+    addr: int
+    mnemonic: str
+    operands: List[Operand]
+
+
+def parse_operand(text: str, comment: Optional[int]) -> Operand:
+    text = text.strip()
+    if text.startswith("%"):
+        if text[1:] not in REGS:
+            raise LiftError(f"unsupported register {text}")
+        return Reg(*REGS[text[1:]])
+    if text.startswith("$"):
+        return Imm(int(text[1:], 0))
+    m = re.fullmatch(r"([0-9a-f]+) <([^>]+)>", text)
+    if m:
+        return Target(int(m.group(1), 16), m.group(2))
+    m = re.fullmatch(
+        r"(-?0x[0-9a-f]+|-?\d+)?\((%\w+)?(?:,(%\w+)(?:,(\d))?)?\)", text
+    )
+    if m:
+        disp = int(m.group(1), 0) if m.group(1) else 0
+        base = m.group(2)[1:] if m.group(2) else None
+        index = m.group(3)[1:] if m.group(3) else None
+        if base == "rip":
+            return Mem(disp, "rip", None, 1, comment)
+        for r in (base, index):
+            if r is not None and REGS.get(r, (None, 0))[1] != 64:
+                raise LiftError(f"unsupported address register %{r}")
+        return Mem(disp, base, index, int(m.group(4) or 1))
+    raise LiftError(f"unsupported operand '{text}'")
+
+
+def split_operands(text: str) -> List[str]:
+    parts, depth, cur = [], 0, ""
+    for c in text:
+        if c == "(":
+            depth += 1
+        elif c == ")":
+            depth -= 1
+        if c == "," and depth == 0:
+            parts.append(cur)
+            cur = ""
+        else:
+            cur += c
+    if cur.strip():
+        parts.append(cur)
+    return parts
+
+
+def parse_disassembly(text: str) -> List[Insn]:
+    insns = []
+    started = False
+    for line in text.splitlines():
+        if re.match(r"^[0-9a-f]+ <.*>:$", line):
+            if started:
+                break
+            started = True
+            continue
+        m = re.match(r"^\s*([0-9a-f]+):\t(.*)$", line)
+        if not started or not m:
+            continue
+        addr, body = int(m.group(1), 16), m.group(2)
+        comment = None
+        if "#" in body:
+            body, note = body.split("#", 1)
+            cm = re.match(r"\s*([0-9a-f]+)", note)
+            comment = int(cm.group(1), 16) if cm else None
+        body = body.strip()
+        if "nop" in body or body in ("", "endbr64", "int3") or body.startswith("xchg   %ax,%ax"):
+            insns.append(Insn(addr, "nop", []))
+            continue
+        parts = body.split(None, 1)
+        mnemonic = parts[0]
+        if mnemonic in ("bnd", "notrack", "rep") and len(parts) > 1:
+            parts = parts[1].split(None, 1)
+            mnemonic = parts[0]
+        operands = []
+        if len(parts) > 1:
+            ops = parts[1].strip()
+            tm = re.fullmatch(r"([0-9a-f]+) <([^>]+)>", ops)
+            if tm:
+                operands = [Target(int(tm.group(1), 16), tm.group(2))]
+            else:
+                operands = [parse_operand(o, comment) for o in split_operands(ops)]
+        insns.append(Insn(addr, mnemonic, operands))
+    return insns
+
+
+# Values tracked per register while lifting.
+
+
+@dataclass(eq=False)
+class VReg:
+    id: int
+    type: str
+
+
+@dataclass(frozen=True)
+class GotAddr:
+    """The address of a data symbol, loaded from its GOT slot."""
+
+    sym: str
+
+
+@dataclass(frozen=True)
+class SymValue:
+    """The value of a pointer variable, loaded through its GOT slot."""
+
+    sym: str
+
+
+@dataclass(frozen=True)
+class StrLit:
+    text: str
+
+
+@dataclass(frozen=True)
+class Const:
+    value: int
+
+
+Value = Union[VReg, GotAddr, SymValue, StrLit, Const]
+
+
+@dataclass
+class RegState:
+    value: Value
+    # Width of the bits in the register that value describes.
+    width: int
+    # True if the register bits above width are known to be zero.
+    upper_zero: bool
+
+
+@dataclass
+class Flags:
+    kind: str  # "cmp", "test" or "result"
+    width: int
+    a: Value
+    b: Optional[Value] = None
+
+
+@dataclass(eq=False)
+class Block:
+    start: int
+    insns: List[Insn] = field(default_factory=list)
+    succs: List["Block"] = field(default_factory=list)
+    preds: List["Block"] = field(default_factory=list)
+    id: int = -1
+    lines: List[str] = field(default_factory=list)
+    phis: List[str] = field(default_factory=list)
+    terminator: Optional[str] = None
+    defs: Dict[str, RegState] = field(default_factory=dict)
+    entry: Dict[str, Optional[RegState]] = field(default_factory=dict)
+
+
+CONDITIONS = {
+    "e": "e", "z": "e", "ne": "ne", "nz": "ne",
+    "a": "a", "nbe": "a", "ae": "ae", "nb": "ae", "nc": "ae",
+    "b": "b", "nae": "b", "c": "b", "be": "be", "na": "be",
+    "g": "g", "nle": "g", "ge": "ge", "nl": "ge",
+    "l": "l", "nge": "l", "le": "le", "ng": "le",
+    "s": "s", "ns": "ns",
+}  # fmt: skip
+
+CMP_OPCODES = {
+    "e": "Equal",
+    "ne": "NotEqual",
+    "a": "GreaterThanUnsigned",
+    "ae": "GreaterThanEqualUnsigned",
+    "b": "LessThanUnsigned",
+    "be": "LessThanEqualUnsigned",
+    "g": "GreaterThanSigned",
+    "ge": "GreaterThanEqualSigned",
+    "l": "LessThanSigned",
+    "le": "LessThanEqualSigned",
+}
+
+# Conditions on (value & value) or an arithmetic result, compared against 0.
+ZERO_CMP_OPCODES = {
+    "e": "Equal",
+    "ne": "NotEqual",
+    "s": "LessThanSigned",
+    "ns": "GreaterThanEqualSigned",
+}
+# test sets CF and OF to 0, so these are also exact for test.
+TEST_CMP_OPCODES = {
+    **ZERO_CMP_OPCODES,
+    "g": "GreaterThanSigned",
+    "ge": "GreaterThanEqualSigned",
+    "l": "LessThanSigned",
+    "le": "LessThanEqualSigned",
+    "a": "NotEqual",
+    "be": "Equal",
+}
+
+BINARY_OPS = {
+    "add": "Add",
+    "sub": "Sub",
+    "and": "And",
+    "or": "Or",
+    "xor": "Xor",
+    "imul": "Mul",
+}
+UNARY_OPS = {"neg": "Negate", "not": "Invert"}
+SIMPLE_OPS = ["mov", "lea", "cmp", "test", *BINARY_OPS, *UNARY_OPS]
+
+CALLEE_SAVED = ["rbx", "r12", "r13", "r14", "r15"]
+
+
+def is_jump(insn: Insn) -> bool:
+    m = insn.mnemonic
+    return m in ("jmp", "jmpq") or (m.startswith("j") and m[1:] in CONDITIONS)
+
+
+def is_cond_jump(insn: Insn) -> bool:
+    return is_jump(insn) and insn.mnemonic not in ("jmp", "jmpq")
+
+
+def strip_suffix(mnemonic: str, known: Sequence[str]) -> Tuple[str, Optional[int]]:
+    if mnemonic in known:
+        return mnemonic, None
+    if mnemonic[:-1] in known and mnemonic[-1] in SUFFIX_WIDTHS:
+        return mnemonic[:-1], SUFFIX_WIDTHS[mnemonic[-1]]
+    return mnemonic, None
+
+
+class Lifter:
+    """Lifts the machine code of one helper into LIR text.
+
+    Blocks are lifted in reverse postorder, tracking what each register holds.
+    Registers that are read before being written in a block are resolved on
+    demand from the block's predecessors, inserting a Phi where they disagree.
+    """
+
+    def __init__(
+        self,
+        sig: Signature,
+        insns: List[Insn],
+        binary: Binary,
+        symbols: List[str],
+        max_instrs: int = DEFAULT_MAX_INSTRS,
+    ) -> None:
+        self.sig = sig
+        self.insns = [i for i in insns if i.mnemonic != "nop"]
+        self.binary = binary
+        self.symbols = set(symbols)
+        self.max_instrs = max_instrs
+        self.next_id = 0
+        self.block = Block(-1)
+        self.exit_block = Block(-1)
+        self.flags: Optional[Flags] = None
+
+    def alloc_id(self) -> int:
+        self.next_id += 1
+        return self.next_id - 1
+
+    # CFG construction.
+
+    def build_cfg(self) -> List[Block]:
+        if not self.insns:
+            raise LiftError("empty function")
+        if len(self.insns) > self.max_instrs:
+            raise LiftError(f"too large ({len(self.insns)} instructions)")
+        addrs = {i.addr for i in self.insns}
+        leaders = {self.insns[0].addr}
+        for n, insn in enumerate(self.insns):
+            if not is_jump(insn) and not insn.mnemonic.startswith("ret"):
+                continue
+            if n + 1 < len(self.insns):
+                leaders.add(self.insns[n + 1].addr)
+            for op in insn.operands:
+                if not isinstance(op, Target) or "@plt" in op.sym:
+                    continue
+                if op.addr not in addrs:
+                    raise LiftError(f"jump outside of the function to {op.sym}")
+                leaders.add(op.addr)
+
+        blocks: Dict[int, Block] = {}
+        order: List[Block] = []
+        for insn in self.insns:
+            if insn.addr in leaders:
+                blocks[insn.addr] = Block(insn.addr)
+                order.append(blocks[insn.addr])
+            order[-1].insns.append(insn)
+
+        for n, b in enumerate(order):
+            last = b.insns[-1]
+            if last.mnemonic.startswith("ret"):
+                continue
+            targets = [op for op in last.operands if isinstance(op, Target)]
+            if is_jump(last) and "@plt" not in targets[0].sym:
+                b.succs.append(blocks[targets[0].addr])
+            elif is_cond_jump(last):
+                raise LiftError("conditional tail call")
+            if not is_jump(last) or is_cond_jump(last):
+                if n + 1 >= len(order):
+                    raise LiftError("falls off the end of the function")
+                if order[n + 1] in b.succs:
+                    raise LiftError("conditional branch to the next instruction")
+                b.succs.append(order[n + 1])
+
+        # Reverse postorder from the entry, rejecting loops.
+        rpo: List[Block] = []
+        state: Dict[int, int] = {}
+
+        def visit(b: Block) -> None:
+            state[id(b)] = 1
+            for s in b.succs:
+                st = state.get(id(s), 0)
+                if st == 1:
+                    raise LiftError("loops are not supported")
+                if st == 0:
+                    visit(s)
+            state[id(b)] = 2
+            rpo.append(b)
+
+        visit(order[0])
+        rpo.reverse()
+        for b in rpo:
+            for s in b.succs:
+                s.preds.append(b)
+        return rpo
+
+    # Register state.
+
+    def state_at_end(self, block: Block, reg: str) -> Optional[RegState]:
+        if reg in block.defs:
+            return block.defs[reg]
+        return self.state_at_entry(block, reg)
+
+    def state_at_entry(self, block: Block, reg: str) -> Optional[RegState]:
+        if reg in block.entry:
+            return block.entry[reg]
+        result = None
+        if len(block.preds) == 1:
+            result = self.state_at_end(block.preds[0], reg)
+        elif block.preds:
+            states = [self.state_at_end(p, reg) for p in block.preds]
+            if any(s is None for s in states):
+                result = None
+            elif all(s == states[0] for s in states):
+                result = states[0]
+            else:
+                result = self.make_phi(block, states)
+        block.entry[reg] = result
+        return result
+
+    def make_phi(self, block: Block, states: List[RegState]) -> RegState:
+        # Constants can be materialized at whatever width the other inputs
+        # have, as long as they fit.
+        def fits(s: RegState, width: int) -> bool:
+            return isinstance(s.value, Const) and s.value.value >> width == 0
+
+        others = [s for s in states if not isinstance(s.value, Const)] or states
+        widths = [s.width for s in others]
+        width = max(widths)
+        if any(s.width < width and not s.upper_zero for s in others):
+            width = min(widths)
+        if any(isinstance(s.value, Const) and not fits(s, width) for s in states):
+            if width < 64 and not all(s.upper_zero for s in others):
+                raise LiftError("constant phi input does not fit")
+            width = 64
+        upper_zero = all(
+            fits(s, width) or (s.width == width and s.upper_zero) for s in states
+        )
+        types = {
+            s.value.type if isinstance(s.value, VReg) and s.width == width else None
+            for s in states
+        }
+        ty = "Object" if types == {"Object"} else WIDTH_TYPES[width]
+        inputs = []
+        saved = self.block
+        for pred, s in zip(block.preds, states):
+            # Conversions are appended to the (already lifted) predecessor,
+            # ahead of its terminator.
+            self.block = pred
+            v = self.materialize(self.read_state(s, width), width, ty)
+            inputs.append(f"(BB%{pred.id}, {self.out(v)})")
+        self.block = saved
+        phi = VReg(self.alloc_id(), ty)
+        block.phis.append(f"{self.out(phi):>16} = Phi {', '.join(inputs)}")
+        return RegState(phi, width, upper_zero)
+
+    def read_state(self, s: RegState, width: int) -> Value:
+        v = s.value
+        if isinstance(v, Const):
+            return Const(v.value & mask(width))
+        if not isinstance(v, VReg):
+            if width != 64:
+                raise LiftError("partial read of an address")
+            return v
+        if s.width == width:
+            return v
+        if s.width > width:
+            return self.emit(WIDTH_TYPES[width], "Move", [self.out(v)])
+        if s.upper_zero:
+            return self.emit(WIDTH_TYPES[width], "Zext", [self.out(v)])
+        raise LiftError("read of a partially written register")
+
+    def read(self, reg: Reg) -> Value:
+        if reg.name in ("rsp", "rbp"):
+            raise LiftError("stack or frame pointer used as a value")
+        s = self.state_at_end(self.block, reg.name)
+        if s is None:
+            raise LiftError(f"read of undefined register %{reg.name}")
+        return self.read_state(s, reg.width)
+
+    def write(self, reg: Reg, value: Value) -> None:
+        if reg.name in ("rsp", "rbp"):
+            raise LiftError("write to the stack or frame pointer")
+        if isinstance(value, Const) and reg.width >= 32:
+            # 32-bit writes zero the upper half of the register.
+            value = Const(value.value & mask(reg.width))
+            self.block.defs[reg.name] = RegState(value, 64, True)
+            return
+        if isinstance(value, Const):
+            value = self.materialize(value, reg.width)
+        self.block.defs[reg.name] = RegState(value, reg.width, reg.width == 32)
+
+    # Emission helpers.
+
+    def out(self, v: VReg) -> str:
+        return f"%{v.id}:{v.type}"
+
+    def use(self, v: Value, width: int = 64) -> str:
+        if isinstance(v, VReg):
+            return self.out(v)
+        if isinstance(v, Const):
+            if v.value >= 1 << 63:
+                raise LiftError("immediate does not fit in a signed 64-bit value")
+            return f"{v.value}({v.value:#x}):{WIDTH_TYPES[width]}"
+        if isinstance(v, StrLit):
+            return f'"{v.text}"'
+        if isinstance(v, GotAddr):
+            if DATA_SYMBOLS.get(v.sym) != "object":
+                raise LiftError(f"address of '{v.sym}' is not supported")
+            return self.symbol(v.sym)
+        return self.symbol(v.sym)
+
+    def symbol(self, sym: str) -> str:
+        if sym not in self.symbols:
+            raise LiftError(f"'{sym}' is not in kSymbolMapping")
+        return sym
+
+    def emit(self, ty: str, op: str, inputs: List[str]) -> VReg:
+        out = VReg(self.alloc_id(), ty)
+        self.block.lines.append(f"{self.out(out):>16} = {op} {', '.join(inputs)}")
+        return out
+
+    def emit_void(self, op: str, inputs: List[str]) -> None:
+        self.block.lines.append(f"{'':>16}   {op} {', '.join(inputs)}".rstrip())
+
+    def materialize(self, v: Value, width: int, ty: Optional[str] = None) -> VReg:
+        """Make sure that v lives in a virtual register."""
+        if isinstance(v, VReg):
+            return v
+        if ty is None:
+            ty = WIDTH_TYPES[width] if isinstance(v, Const) else "Object"
+        return self.emit(ty, "Move", [self.use(v, width)])
+
+    def operand_use(self, v: Value, width: int) -> str:
+        """Use v as a second operand, which may be a small immediate."""
+        if isinstance(v, Const) and v.value < 1 << 31:
+            return self.use(v, width)
+        return self.out(self.materialize(v, width))
+
+    def ind(self, m: Mem, width: int) -> str:
+        if m.base in (None, "rip", "rsp", "rbp") or m.index in ("rsp", "rbp"):
+            raise LiftError("unsupported memory operand")
+        base = self.materialize(self.read(Reg(m.base, 64)), 64)
+        text = f"[{self.out(base)}"
+        if m.index is not None:
+            index = self.materialize(self.read(Reg(m.index, 64)), 64)
+            text += f" + {self.out(index)}"
+            if m.scale != 1:
+                text += f" * {m.scale}"
+        if m.disp > 0:
+            text += f" + {m.disp:#x}"
+        elif m.disp < 0:
+            text += f" - {-m.disp:#x}"
+        return f"{text}]:{WIDTH_TYPES[width]}"
+
+    def load(self, m: Mem, width: int) -> Value:
+        if m.base == "rip":
+            if m.target in self.binary.got and width == 64:
+                return GotAddr(self.binary.got[m.target])
+            raise LiftError("load from non-GOT %rip-relative data")
+        if m.disp == 0 and m.index is None and m.base is not None:
+            s = self.state_at_end(self.block, m.base)
+            if s is not None and isinstance(s.value, GotAddr):
+                if width != 64 or DATA_SYMBOLS.get(s.value.sym) != "pointer":
+                    raise LiftError(f"unsupported load through '{s.value.sym}'")
+                return SymValue(s.value.sym)
+        return self.emit(WIDTH_TYPES[width], "Move", [self.ind(m, width)])
+
+    def store(self, m: Mem, v: Value, width: int) -> None:
+        src = self.operand_use(v, width)
+        self.block.lines.append(f"{self.ind(m, width):>16} = Move {src}")
+
+    def source(self, op: Operand, width: int) -> Value:
+        if isinstance(op, Reg):
+            return self.read(op)
+        if isinstance(op, Imm):
+            return Const(op.value & mask(64))
+        if isinstance(op, Mem):
+            return self.load(op, width)
+        raise LiftError("unsupported source operand")
+
+    def compare(self, cond: str) -> VReg:
+        f = self.flags
+        if f is None:
+            raise LiftError("condition flags are not known in this block")
+        opcodes = {"cmp": CMP_OPCODES, "test": TEST_CMP_OPCODES}
+        opcode = opcodes.get(f.kind, ZERO_CMP_OPCODES).get(cond)
+        if opcode is None:
+            raise LiftError(f"unsupported condition '{cond}' after {f.kind}")
+        a = self.out(self.materialize(f.a, f.width))
+        b = self.operand_use(f.b if f.b is not None else Const(0), f.width)
+        return self.emit("8bit", opcode, [a, b])
+
+    def call(self, target: Target) -> None:
+        name = target.sym.split("@")[0]
+        sig = CALLEES.get(name)
+        if sig is None:
+            raise LiftError(f"call to unsupported function '{name}'")
+        args = [self.read(Reg(ARG_REGS[i], p[1])) for i, p in enumerate(sig.params)]
+        if sig.format_arg is not None:
+            fmt = args[sig.format_arg]
+            if not isinstance(fmt, StrLit):
+                raise LiftError("variadic call without a literal format string")
+            count = len(re.findall(r"%[^%]", fmt.text.replace("%%", "")))
+            first = len(args)
+            if first + count > len(ARG_REGS):
+                raise LiftError("too many variadic arguments")
+            args += [self.read(Reg(ARG_REGS[first + i], 64)) for i in range(count)]
+        inputs = [self.symbol(name)] + [self.use(a) for a in args]
+        for r in CALLER_SAVED:
+            self.block.defs[r] = None
+        if sig.ret is None:
+            self.emit_void("Call", inputs)
+        else:
+            ret = self.emit(sig.ret[0], "Call", inputs)
+            self.block.defs["rax"] = RegState(ret, sig.ret[1], False)
+        self.flags = None
+
+    def do_return(self) -> None:
+        self.block.succs = [self.exit_block]
+        if self.sig.ret is None:
+            return
+        ty, width = self.sig.ret
+        s = self.state_at_end(self.block, "rax")
+        if s is None:
+            raise LiftError("return value is undefined")
+        v = self.materialize(self.read_state(s, width), width, ty)
+        self.block.terminator = f"{'':>16}   Return {self.out(v)}"
+
+    # Instruction lifting.
+
+    def lift_frame_insn(self, insn: Insn) -> bool:
+        """Recognize frame setup and callee-saved register spills, which don't
+        contribute to what the helper computes."""
+        m, ops = insn.mnemonic, insn.operands
+        if m in ("push", "pushq", "pop", "popq", "leave", "leaveq"):
+            if m.startswith("leave") or (
+                len(ops) == 1 and isinstance(ops[0], Reg) and ops[0].width == 64
+            ):
+                return True
+            raise LiftError(f"unsupported {m}")
+        if strip_suffix(m, ["add", "sub"])[0] in ("add", "sub") and ops[1:] == [
+            Reg("rsp", 64)
+        ]:
+            return isinstance(ops[0], Imm)
+        return strip_suffix(m, ["mov"])[0] == "mov" and ops == [
+            Reg("rsp", 64),
+            Reg("rbp", 64),
+        ]
+
+    def lift_insn(self, insn: Insn) -> None:
+        m, ops = insn.mnemonic, insn.operands
+        if self.lift_frame_insn(insn):
+            return
+        if m.startswith("ret"):
+            self.do_return()
+            return
+        if is_jump(insn):
+            target = ops[0] if ops else None
+            if not isinstance(target, Target):
+                raise LiftError("indirect jump")
+            if is_cond_jump(insn):
+                c = self.compare(CONDITIONS[m[1:]])
+                self.block.terminator = f"{'':>16}   CondBranch {self.out(c)}"
+            elif "@plt" in target.sym:
+                # Tail call.
+                self.call(target)
+                self.do_return()
+            return
+        if m in ("call", "callq"):
+            if not ops or not isinstance(ops[0], Target) or "@plt" not in ops[0].sym:
+                raise LiftError("indirect or local call")
+            self.call(ops[0])
+            return
+        if m.startswith("set") and m[3:] in CONDITIONS:
+            dst = ops[0]
+            if not isinstance(dst, Reg) or dst.width != 8:
+                raise LiftError(f"unsupported {m}")
+            self.write(dst, self.compare(CONDITIONS[m[3:]]))
+            return
+        if m.startswith("cmov") and m[4:] in CONDITIONS:
+            src, dst = ops
+            if not isinstance(dst, Reg):
+                raise LiftError(f"unsupported {m}")
+            # Select needs the value for a false condition to be an
+            # immediate.
+            b = self.read(dst)
+            if not isinstance(b, Const) or b.value >= 1 << 31:
+                raise LiftError(f"{m} of a non-constant")
+            c = self.compare(CONDITIONS[m[4:]])
+            a = self.materialize(self.source(src, dst.width), dst.width)
+            inputs = [self.out(c), self.out(a), self.use(b, dst.width)]
+            self.write(dst, self.emit(WIDTH_TYPES[dst.width], "Select", inputs))
+            return
+        if self.lift_extension(insn):
+            return
+
+        base, width = strip_suffix(m, SIMPLE_OPS)
+        if base not in SIMPLE_OPS:
+            raise LiftError(f"unsupported instruction {m}")
+        for op in ops:
+            if isinstance(op, Reg):
+                width = op.width
+        if width is None:
+            raise LiftError(f"unknown operand size for {m}")
+        dst = ops[-1]
+        if isinstance(dst, Mem) and base not in ("mov", "cmp", "test"):
+            raise LiftError(f"read-modify-write of memory ({m})")
+
+        if base == "mov":
+            src = ops[0]
+            if isinstance(dst, Mem):
+                self.store(dst, self.source(src, width), width)
+            else:
+                self.write(dst, self.source(src, width))
+        elif base == "lea":
+            src = ops[0]
+            if not isinstance(src, Mem) or width != 64:
+                raise LiftError("unsupported lea")
+            if src.base == "rip":
+                text = self.binary.read_string(src.target or 0)
+                if text is None or not re.fullmatch(r"[ !#-~]+", text):
+                    raise LiftError("lea of something other than a string literal")
+                self.write(dst, StrLit(text))
+            else:
+                self.write(dst, self.emit("64bit", "Lea", [self.ind(src, 64)]))
+        elif base in ("cmp", "test"):
+            src = ops[0]
+            a = self.source(dst, width)
+            if base == "test" and src == dst:
+                self.flags = Flags("test", width, a)
+            elif base == "test":
+                b = self.operand_use(self.source(src, width), width)
+                lhs = self.out(self.materialize(a, width))
+                and_ = self.emit(WIDTH_TYPES[width], "And", [lhs, b])
+                self.flags = Flags("result", width, and_)
+            else:
+                self.flags = Flags("cmp", width, a, self.source(src, width))
+        elif base in BINARY_OPS:
+            if base in ("xor", "sub") and len(ops) == 2 and ops[0] == dst:
+                self.write(dst, Const(0))
+                self.flags = None
+                return
+            if len(ops) == 3:
+                # Three operand imul.
+                lhs, rhs = self.source(ops[1], width), self.source(ops[0], width)
+            else:
+                lhs, rhs = self.read(dst), self.source(ops[0], width)
+            lhs_use = self.out(self.materialize(lhs, width))
+            result = self.emit(
+                WIDTH_TYPES[width], BINARY_OPS[base], [lhs_use, self.operand_use(rhs, width)]
+            )
+            self.write(dst, result)
+            self.flags = Flags("result", width, result)
+        else:
+            opcode = UNARY_OPS[base]
+            result = self.emit(
+                WIDTH_TYPES[width], opcode, [self.out(self.materialize(self.read(dst), width))]
+            )
+            self.write(dst, result)
+            # not doesn't touch the flags; the others set ZF and SF from the
+            # result.
+            if base != "not":
+                self.flags = Flags("result", width, result)
+
+    def lift_extension(self, insn: Insn) -> bool:
+        m, ops = insn.mnemonic, insn.operands
+        if m in ("cltq", "cdqe"):
+            src, dst, kind = Reg("rax", 32), Reg("rax", 64), "s"
+        elif m in ("cwtl", "cwde"):
+            src, dst, kind = Reg("rax", 16), Reg("rax", 32), "s"
+        else:
+            ext = re.fullmatch(r"mov([sz])([bwl])([wlq])", m)
+            if ext is None:
+                return False
+            src, dst = ops
+            kind = ext.group(1)
+        if not isinstance(dst, Reg):
+            raise LiftError(f"unsupported {m}")
+        if isinstance(src, Mem):
+            width = SUFFIX_WIDTHS[m[4]]
+            v = self.load(src, width)
+        elif isinstance(src, Reg):
+            width = src.width
+            v = self.read(src)
+        else:
+            raise LiftError(f"unsupported {m}")
+        op = "Sext" if kind == "s" else "Zext"
+        src_use = self.out(self.materialize(v, width))
+        self.write(dst, self.emit(WIDTH_TYPES[dst.width], op, [src_use]))
+        return True
+
+    def lift(self) -> str:
+        blocks = self.build_cfg()
+        for b in blocks:
+            b.id = self.alloc_id()
+        self.exit_block.id = self.alloc_id()
+
+        entry = blocks[0]
+        self.block = entry
+        for i, (ty, width) in enumerate(self.sig.params):
+            v = self.emit(ty, "LoadArg", [f"{i}({i:#x}):{ty}"])
+            entry.entry[ARG_REGS[i]] = RegState(v, width, False)
+        if any(width < 64 for _, width in self.sig.params):
+            # Pin the width of narrow arguments: after inlining, uses are
+            # relinked to the caller's argument, which may be defined with a
+            # wider type. LoadArgs have to come first, so do this after them.
+            for i, (ty, width) in enumerate(self.sig.params):
+                state = entry.entry[ARG_REGS[i]]
+                if width < 64:
+                    state.value = self.emit(ty, "Move", [self.out(state.value)])
+        for r in CALLER_SAVED + CALLEE_SAVED:
+            entry.entry.setdefault(r, None)
+
+        for b in blocks:
+            self.block = b
+            self.flags = None
+            for insn in b.insns:
+                self.lift_insn(insn)
+            if len(b.succs) == 2 and b.terminator is None:
+                raise LiftError("conditional branch without a condition")
+        for b in blocks:
+            if self.exit_block in b.succs:
+                self.exit_block.preds.append(b)
+
+        lines = ["Function:"]
+        for b in blocks + [self.exit_block]:
+            header = f"BB %{b.id}"
+            if b.preds:
+                header += " - preds: " + " ".join(f"%{p.id}" for p in b.preds)
+            if b.succs:
+                header += " - succs: " + " ".join(f"%{s.id}" for s in b.succs)
+            lines.append(header)
+            lines += b.phis + b.lines
+            if b.terminator:
+                lines.append(b.terminator)
+            lines.append("")
+        return "\n".join(lines[:-1]) + "\n"
+
+
+# Verification.
+#
+# Each translation is checked against the machine code it was lifted from
+# before it is written out. Small interpreters for the x86-64 subset and for
+# the emitted LIR run both on the same arguments, in a shared model of
+# everything outside the helper: memory that hasn't been stored to reads as
+# one of the arguments, a data symbol or a few boundary constants, and calls
+# are recorded and return such values too. The two have to make the same
+# calls and stores in the same order and return the same value in every
+# trial. These interpreters share nothing with the Lifter, so a mismatch
+# means the lifter got something wrong and the helper is left out.
+
+VERIFY_TRIALS = 256
+VERIFY_MAX_STEPS = 10000
+
+# Where the model places things the helper can refer to.
+SYMBOL_BASE = 0x7F0000000000
+STRING_BASE = 0x7E0000000000
+HEAP_BASE = 0x555500001000
+STACK_TOP = 0x7FFC00000000
+
+TYPE_WIDTHS = {"8bit": 8, "16bit": 16, "32bit": 32, "64bit": 64, "Object": 64}
+
+
+class VerifyError(LiftError):
+    pass
+
+
+def symbol_addr(sym: str) -> int:
+    return SYMBOL_BASE + 0x1000 * sorted(DATA_SYMBOLS).index(sym)
+
+
+def string_addr(text: str) -> int:
+    return STRING_BASE + 0x10 * zlib.crc32(text.encode())
+
+
+def signed(value: int, width: int) -> int:
+    value &= mask(width)
+    return value - (1 << width) if value >> (width - 1) else value
+
+
+class World:
+    """Memory and callees as seen by one trial of a helper or its translation."""
+
+    def __init__(self, seed: int, args: List[int]) -> None:
+        self.seed = seed
+        self.pool = [0, 1, mask(64), *args]
+        self.pool += [symbol_addr(s) for s in DATA_SYMBOLS]
+        self.memory: Dict[int, int] = {}
+        self.strings: Dict[int, str] = {}
+        self.events: List[Tuple[object, ...]] = []
+
+    def pick(self, *key: object) -> int:
+        return random.Random(repr((self.seed,) + key)).choice(self.pool)
+
+    def string(self, text: str) -> int:
+        addr = string_addr(text)
+        self.strings[addr] = text
+        return addr
+
+    def load(self, addr: int, width: int) -> int:
+        size = width // 8
+        fill = None
+        for i in range(size):
+            if (addr + i) & mask(64) not in self.memory:
+                if fill is None:
+                    fill = self.pick("load", addr, width)
+                self.memory[(addr + i) & mask(64)] = (fill >> (8 * i)) & 0xFF
+        return sum(self.memory[(addr + i) & mask(64)] << (8 * i) for i in range(size))
+
+    def store(self, addr: int, width: int, value: int) -> None:
+        value &= mask(width)
+        self.events.append(("store", addr, width, value))
+        for i in range(width // 8):
+            self.memory[(addr + i) & mask(64)] = (value >> (8 * i)) & 0xFF
+
+    def call(self, name: str, args: List[int]) -> Optional[int]:
+        sig = CALLEES.get(name)
+        if sig is None:
+            raise VerifyError(f"call to unknown function '{name}'")
+        widths = [w for _, w in sig.params]
+        if sig.format_arg is not None:
+            text = self.strings.get(args[sig.format_arg] if sig.format_arg < len(args) else -1)
+            if text is None:
+                raise VerifyError(f"{name} without a literal format string")
+            count = len(re.findall(r"%[^%]", text.replace("%%", "")))
+            widths += [64] * count
+        if len(args) < len(widths):
+            raise VerifyError(f"too few arguments to {name}")
+        args = [a & mask(w) for a, w in zip(args, widths)]
+        self.events.append(("call", name, *args))
+        if sig.ret is None:
+            return None
+        return self.pick("call", len(self.events)) & mask(sig.ret[1])
+
+
+@dataclass
+class Outcome:
+    events: List[Tuple[object, ...]]
+    ret: Optional[int]
+
+
+class MachineInterpreter:
+    """Runs a helper's disassembled machine code."""
+
+    def __init__(self, insns: List[Insn], binary: Binary, sig: Signature) -> None:
+        self.insns = insns
+        self.binary = binary
+        self.sig = sig
+        self.index = {insn.addr: n for n, insn in enumerate(insns)}
+
+    def run(self, world: World, args: List[int]) -> Outcome:
+        self.world = world
+        self.regs = {r: world.pick("reg", r) for r, _ in REGS.values()}
+        self.regs["rsp"] = STACK_TOP
+        self.stack: Dict[int, int] = {}
+        self.flags = None
+        for i, (_, width) in enumerate(self.sig.params):
+            upper = world.pick("arg", i) & ~mask(width) & mask(64)
+            self.regs[ARG_REGS[i]] = upper | (args[i] & mask(width))
+
+        pc = 0
+        for _ in range(VERIFY_MAX_STEPS):
+            if pc >= len(self.insns):
+                raise VerifyError("ran off the end of the helper")
+            insn = self.insns[pc]
+            pc += 1
+            m, ops = insn.mnemonic, insn.operands
+            if m.startswith("ret"):
+                return self.do_return()
+            if is_jump(insn):
+                target = ops[0]
+                if not isinstance(target, Target):
+                    raise VerifyError("indirect jump")
+                if "@plt" in target.sym:
+                    self.call(target)
+                    return self.do_return()
+                if not is_cond_jump(insn) or self.condition(CONDITIONS[m[1:]]):
+                    pc = self.index[target.addr]
+                continue
+            self.step(insn)
+        raise VerifyError("helper did not return")
+
+    def do_return(self) -> Outcome:
+        if self.regs["rsp"] != STACK_TOP:
+            raise VerifyError("unbalanced stack at return")
+        ret = None
+        if self.sig.ret is not None:
+            ret = self.regs["rax"] & mask(self.sig.ret[1])
+        return Outcome(self.world.events, ret)
+
+    # Operands.
+
+    def read_reg(self, reg: Reg) -> int:
+        return self.regs[reg.name] & mask(reg.width)
+
+    def write_reg(self, reg: Reg, value: int) -> None:
+        value &= mask(reg.width)
+        if reg.width < 32:
+            value |= self.regs[reg.name] & ~mask(reg.width) & mask(64)
+        self.regs[reg.name] = value
+
+    def address(self, mem: Mem) -> int:
+        if mem.base == "rip":
+            if mem.target is None:
+                raise VerifyError("%rip-relative operand without a target")
+            return mem.target
+        addr = mem.disp
+        if mem.base is not None:
+            addr += self.regs[mem.base]
+        if mem.index is not None:
+            addr += self.regs[mem.index] * mem.scale
+        return addr & mask(64)
+
+    def load(self, mem: Mem, width: int) -> int:
+        if mem.base == "rip":
+            sym = self.binary.got.get(mem.target or 0)
+            if sym not in DATA_SYMBOLS or width != 64:
+                raise VerifyError("load from non-GOT %rip-relative data")
+            return symbol_addr(sym)
+        addr = self.address(mem)
+        if mem.base in ("rsp", "rbp"):
+            return self.stack.get(addr, 0) & mask(width)
+        return self.world.load(addr, width)
+
+    def store(self, mem: Mem, width: int, value: int) -> None:
+        if mem.base in ("rip", "rsp", "rbp"):
+            raise VerifyError("store to the stack or static data")
+        self.world.store(self.address(mem), width, value)
+
+    def source(self, op: Operand, width: int) -> int:
+        if isinstance(op, Reg):
+            return self.read_reg(op)
+        if isinstance(op, Imm):
+            return op.value & mask(width)
+        if isinstance(op, Mem):
+            return self.load(op, width)
+        raise VerifyError("unsupported source operand")
+
+    def write(self, op: Operand, width: int, value: int) -> None:
+        if isinstance(op, Reg):
+            self.write_reg(op, value)
+        elif isinstance(op, Mem):
+            self.store(op, width, value)
+        else:
+            raise VerifyError("unsupported destination operand")
+
+    # Flags, kept as (zf, sf, cf, of).
+
+    def set_flags(self, result: int, width: int, cf: bool = False, of: bool = False) -> None:
+        result &= mask(width)
+        self.flags = (result == 0, bool(result >> (width - 1)), cf, of)
+
+    def condition(self, cond: str) -> bool:
+        if self.flags is None:
+            raise VerifyError("condition flags are undefined")
+        zf, sf, cf, of = self.flags
+        return {
+            "e": zf,
+            "ne": not zf,
+            "a": not cf and not zf,
+            "ae": not cf,
+            "b": cf,
+            "be": cf or zf,
+            "g": not zf and sf == of,
+            "ge": sf == of,
+            "l": sf != of,
+            "le": zf or sf != of,
+            "s": sf,
+            "ns": not sf,
+        }[cond]
+
+    # Instructions.
+
+    def push(self, value: int) -> None:
+        self.regs["rsp"] = (self.regs["rsp"] - 8) & mask(64)
+        self.stack[self.regs["rsp"]] = value
+
+    def pop(self) -> int:
+        value = self.stack.get(self.regs["rsp"], 0)
+        self.regs["rsp"] = (self.regs["rsp"] + 8) & mask(64)
+        return value
+
+    def call(self, target: Target) -> None:
+        name = target.sym.split("@")[0]
+        args = [self.regs[r] for r in ARG_REGS]
+        ret = self.world.call(name, args)
+        for r in CALLER_SAVED:
+            self.regs[r] = self.world.pick("clobber", len(self.world.events), r)
+        if ret is not None:
+            width = CALLEES[name].ret[1]
+            self.regs["rax"] = (self.regs["rax"] & ~mask(width) & mask(64)) | ret
+        self.flags = None
+
+    def step(self, insn: Insn) -> None:
+        m, ops = insn.mnemonic, insn.operands
+        if m == "nop":
+            return
+        if m in ("push", "pushq"):
+            self.push(self.source(ops[0], 64))
+            return
+        if m in ("pop", "popq"):
+            self.write(ops[0], 64, self.pop())
+            return
+        if m in ("leave", "leaveq"):
+            self.regs["rsp"] = self.regs["rbp"]
+            self.regs["rbp"] = self.pop()
+            return
+        if m in ("call", "callq"):
+            if not ops or not isinstance(ops[0], Target) or "@plt" not in ops[0].sym:
+                raise VerifyError("indirect or local call")
+            self.call(ops[0])
+            return
+        if m in ("cltq", "cdqe"):
+            self.regs["rax"] = signed(self.regs["rax"], 32) & mask(64)
+            return
+        if m in ("cwtl", "cwde"):
+            self.regs["rax"] = signed(self.regs["rax"], 16) & mask(32)
+            return
+        ext = re.fullmatch(r"mov([sz])([bwl])([wlq])", m)
+        if ext is not None:
+            src, dst = ops
+            width = src.width if isinstance(src, Reg) else SUFFIX_WIDTHS[ext.group(2)]
+            value = self.source(src, width)
+            if ext.group(1) == "s":
+                value = signed(value, width)
+            self.write(dst, dst.width, value)
+            return
+        if m.startswith("set") and m[3:] in CONDITIONS:
+            self.write(ops[0], 8, int(self.condition(CONDITIONS[m[3:]])))
+            return
+        if m.startswith("cmov") and m[4:] in CONDITIONS:
+            src, dst = ops
+            value = self.read_reg(dst)
+            if self.condition(CONDITIONS[m[4:]]):
+                value = self.source(src, dst.width)
+            self.write_reg(dst, value)
+            return
+
+        base, width = strip_suffix(m, SIMPLE_OPS)
+        if base not in SIMPLE_OPS:
+            raise VerifyError(f"unsupported instruction {m}")
+        for op in ops:
+            if isinstance(op, Reg):
+                width = op.width
+        if width is None:
+            raise VerifyError(f"unknown operand size for {m}")
+        dst = ops[-1]
+        if base == "mov":
+            self.write(dst, width, self.source(ops[0], width))
+        elif base == "lea":
+            src = ops[0]
+            if not isinstance(src, Mem):
+                raise VerifyError("lea of a non-memory operand")
+            addr = self.address(src)
+            if src.base == "rip":
+                text = self.binary.read_string(addr)
+                if text is None:
+                    raise VerifyError("lea of something other than a string")
+                addr = self.world.string(text)
+            self.write(dst, width, addr)
+        elif base in ("cmp", "sub"):
+            a, b = self.source(dst, width), self.source(ops[0], width)
+            result = (a - b) & mask(width)
+            sa, sb = signed(a, width), signed(b, width)
+            of = signed(result, width) != sa - sb
+            self.set_flags(result, width, a < b, of)
+            if base == "sub":
+                self.write(dst, width, result)
+        elif base == "add":
+            a, b = self.source(dst, width), self.source(ops[0], width)
+            result = (a + b) & mask(width)
+            of = signed(result, width) != signed(a, width) + signed(b, width)
+            self.set_flags(result, width, a + b > mask(width), of)
+            self.write(dst, width, result)
+        elif base in ("and", "or", "xor", "test"):
+            a, b = self.source(dst, width), self.source(ops[0], width)
+            result = {"and": a & b, "test": a & b, "or": a | b, "xor": a ^ b}[base]
+            self.set_flags(result, width)
+            if base != "test":
+                self.write(dst, width, result)
+        elif base == "imul":
+            if len(ops) == 3:
+                a, b = self.source(ops[1], width), self.source(ops[0], width)
+            else:
+                a, b = self.source(dst, width), self.source(ops[0], width)
+            product = signed(a, width) * signed(b, width)
+            overflow = signed(product, width) != product
+            self.set_flags(product, width, overflow, overflow)
+            self.write(dst, width, product)
+        elif base == "neg":
+            a = self.source(dst, width)
+            result = (-a) & mask(width)
+            self.set_flags(result, width, a != 0, a == 1 << (width - 1))
+            self.write(dst, width, result)
+        else:
+            self.write(dst, width, ~self.source(dst, width))
+
+
+class LirInterpreter:
+    """Runs the LIR text that a helper was lifted to."""
+
+    def __init__(self, text: str, sig: Signature) -> None:
+        self.sig = sig
+        self.blocks: Dict[int, Tuple[List[str], List[int]]] = {}
+        self.entry: Optional[int] = None
+        lines: List[str] = []
+        for line in text.splitlines():
+            line = line.strip()
+            header = re.fullmatch(r"BB %(\d+)(?: - preds:[^-]*)?(?: - succs: (.*))?", line)
+            if header:
+                succs = [int(s[1:]) for s in (header.group(2) or "").split()]
+                lines = []
+                self.blocks[int(header.group(1))] = (lines, succs)
+                if self.entry is None:
+                    self.entry = int(header.group(1))
+            elif line and line != "Function:":
+                lines.append(line)
+        if self.entry is None:
+            raise VerifyError("translation has no blocks")
+
+    def run(self, world: World, args: List[int]) -> Outcome:
+        self.world = world
+        self.args = args
+        self.values: Dict[int, int] = {}
+        block, pred = self.entry, None
+        for _ in range(VERIFY_MAX_STEPS):
+            lines, succs = self.blocks[block]
+            phis = [line for line in lines if " = Phi " in line]
+            incoming = {}
+            for line in phis:
+                out, inputs = line.split(" = Phi ")
+                for bb, value in re.findall(r"\(BB%(\d+), ([^)]*)\)", inputs):
+                    if int(bb) == pred:
+                        incoming[out] = self.operand(value)
+            for out, value in incoming.items():
+                self.define(out, value)
+            next_block = succs[0] if len(succs) == 1 else None
+            for line in lines:
+                if " = Phi " in line:
+                    continue
+                result = self.execute(line, succs)
+                if isinstance(result, Outcome):
+                    return result
+                if result is not None:
+                    next_block = result
+            if next_block is None:
+                raise VerifyError(f"BB %{block} has no successor")
+            block, pred = next_block, block
+        raise VerifyError("translation did not return")
+
+    def define(self, out: str, value: int) -> None:
+        m = re.fullmatch(r"%(\d+):(\w+)", out)
+        if m is None:
+            raise VerifyError(f"bad output '{out}'")
+        self.values[int(m.group(1))] = value & mask(TYPE_WIDTHS[m.group(2)])
+
+    def width(self, operand: str) -> int:
+        m = re.search(r":(\w+)$", operand)
+        if m is None or m.group(1) not in TYPE_WIDTHS:
+            return 64
+        return TYPE_WIDTHS[m.group(1)]
+
+    def address(self, text: str) -> Tuple[int, int]:
+        m = re.fullmatch(
+            r"\[(%\d+:\w+)(?: \+ (%\d+:\w+)(?: \* (\d))?)?(?: ([+-]) (0x[0-9a-f]+))?\]:(\w+)",
+            text,
+        )
+        if m is None:
+            raise VerifyError(f"bad memory operand '{text}'")
+        addr = self.operand(m.group(1))
+        if m.group(2):
+            addr += self.operand(m.group(2)) * int(m.group(3) or 1)
+        if m.group(5):
+            disp = int(m.group(5), 16)
+            addr += disp if m.group(4) == "+" else -disp
+        return addr & mask(64), TYPE_WIDTHS[m.group(6)]
+
+    def operand(self, text: str) -> int:
+        if text.startswith("%"):
+            m = re.fullmatch(r"%(\d+):\w+", text)
+            if m is None or int(m.group(1)) not in self.values:
+                raise VerifyError(f"use of undefined value '{text}'")
+            return self.values[int(m.group(1))]
+        if text.startswith("["):
+            return self.world.load(*self.address(text))
+        if text.startswith('"'):
+            return self.world.string(text[1:-1])
+        m = re.fullmatch(r"(-?\d+)\(-?0x[0-9a-f]+\):\w+", text)
+        if m is not None:
+            return int(m.group(1)) & mask(64)
+        if DATA_SYMBOLS.get(text) == "object":
+            return symbol_addr(text)
+        if DATA_SYMBOLS.get(text) == "pointer":
+            return self.world.load(symbol_addr(text), 64)
+        raise VerifyError(f"unsupported operand '{text}'")
+
+    def execute(self, line: str, succs: List[int]) -> Union[None, int, Outcome]:
+        out = None
+        m = re.match(r"(%\d+:\w+|\[[^\]]*\]:\w+) = (.*)$", line)
+        if m is not None:
+            out, line = m.group(1), m.group(2)
+        op, _, rest = line.partition(" ")
+        inputs = split_lir_operands(rest)
+
+        if op == "Return":
+            ret = None
+            if self.sig.ret is not None:
+                ret = self.operand(inputs[0]) & mask(self.sig.ret[1])
+            return Outcome(self.world.events, ret)
+        if op == "CondBranch":
+            return succs[0] if self.operand(inputs[0]) else succs[1]
+        if op == "Call":
+            ret = self.world.call(inputs[0], [self.operand(i) for i in inputs[1:]])
+            if out is not None:
+                if ret is None:
+                    raise VerifyError("void call used as a value")
+                self.define(out, ret)
+            return None
+        if out is None:
+            raise VerifyError(f"unsupported instruction '{line}'")
+        if out.startswith("["):
+            if op != "Move":
+                raise VerifyError(f"unsupported store '{line}'")
+            addr, width = self.address(out)
+            self.world.store(addr, width, self.operand(inputs[0]))
+            return None
+
+        width = self.width(out)
+        if op == "LoadArg":
+            index = int(inputs[0].split("(")[0])
+            value = self.args[index] & mask(self.sig.params[index][1])
+        elif op == "Move":
+            value = self.operand(inputs[0])
+        elif op == "Lea":
+            value = self.address(inputs[0])[0]
+        elif op in ("Sext", "Zext"):
+            value = self.operand(inputs[0])
+            if op == "Sext":
+                value = signed(value, self.width(inputs[0]))
+        elif op == "Select":
+            c, a, b = (self.operand(i) for i in inputs)
+            value = a if c else b
+        elif op in ("Negate", "Invert"):
+            a = self.operand(inputs[0])
+            value = -a if op == "Negate" else ~a
+        elif op in ("Add", "Sub", "And", "Or", "Xor", "Mul"):
+            a, b = (self.operand(i) for i in inputs)
+            value = {
+                "Add": a + b,
+                "Sub": a - b,
+                "And": a & b,
+                "Or": a | b,
+                "Xor": a ^ b,
+                "Mul": a * b,
+            }[op]
+        elif op in CMP_OPCODES.values():
+            cmp_width = self.width(inputs[0])
+            a, b = (self.operand(i) & mask(cmp_width) for i in inputs)
+            if op.endswith("Signed"):
+                a, b = signed(a, cmp_width), signed(b, cmp_width)
+            value = int(
+                {
+                    "Equal": a == b,
+                    "NotEqual": a != b,
+                    "GreaterThanUnsigned": a > b,
+                    "GreaterThanEqualUnsigned": a >= b,
+                    "LessThanUnsigned": a < b,
+                    "LessThanEqualUnsigned": a <= b,
+                    "GreaterThanSigned": a > b,
+                    "GreaterThanEqualSigned": a >= b,
+                    "LessThanSigned": a < b,
+                    "LessThanEqualSigned": a <= b,
+                }[op]
+            )
+        else:
+            raise VerifyError(f"unsupported instruction '{line}'")
+        self.define(out, value & mask(width))
+        return None
+
+
+def split_lir_operands(text: str) -> List[str]:
+    """Split the operands of a LIR instruction, which may be string literals
+    containing commas."""
+    parts, cur, quoted = [], "", False
+    for c in text:
+        if c == '"':
+            quoted = not quoted
+        if c == "," and not quoted:
+            parts.append(cur.strip())
+            cur = ""
+        else:
+            cur += c
+    if cur.strip():
+        parts.append(cur.strip())
+    return parts
+
+
+def trial_args(rng: random.Random, sig: Signature) -> List[int]:
+    args = []
+    for ty, width in sig.params:
+        if ty == "Object":
+            choices = [0, *(HEAP_BASE + 0x40 * i for i in range(4))]
+            choices += [symbol_addr(s) for s in DATA_SYMBOLS]
+        else:
+            top = 1 << (width - 1)
+            choices = [0, 1, 2, top - 1, top, mask(width), rng.getrandbits(width)]
+        args.append(rng.choice(choices))
+    return args
+
+
+def verify_translation(
+    name: str, sig: Signature, insns: List[Insn], lir: str, binary: Binary
+) -> None:
+    """Raise VerifyError unless lir behaves like the helper's machine code."""
+    machine = MachineInterpreter(insns, binary, sig)
+    translation = LirInterpreter(lir, sig)
+    rng = random.Random(name)
+    for trial in range(VERIFY_TRIALS):
+        args = trial_args(rng, sig)
+        expected = machine.run(World(trial, args), args)
+        actual = translation.run(World(trial, args), args)
+        if actual != expected:
+            raise VerifyError(
+                f"with arguments {[hex(a) for a in args]}, the helper did "
+                f"{expected} but the translation did {actual}"
+            )
+
+
+HEADER = """// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+// This file is @"""
+
+HEADER2 = """generated by generate_c_helper_translations.py.
+// Run 'make regen-c-helper-translations' against a built _cinderx extension
+// to update it.
+
+#include "cinderx/Jit/lir/c_helper_translations_auto.h"
+
+#include "cinderx/Jit/jit_rt.h"
+
+namespace jit::lir {
+
+// clang-format off
+
+const std::initializer_list<std::pair<const uint64_t, const char*>>
+    kCHelperMappingAuto = {
+"""
+
+FOOTER = """};
+
+// clang-format on
+
+} // namespace jit::lir
+"""
+
+
+def write_translations(file: TextIO, translations: Dict[str, str]) -> None:
+    file.write(HEADER)
+    file.write(HEADER2)
+    for name in sorted(translations):
+        file.write(f"        {{reinterpret_cast<uint64_t>({name}),\n")
+        file.write(f'         R"LIR({translations[name]})LIR"}},\n')
+    file.write(FOOTER)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description="Translate small JITRT_* helpers into LIR for the inliner."
+    )
+    parser.add_argument("cinderx_so", help="path to the built _cinderx extension")
+    parser.add_argument("output", help="file to write the generated C++ to")
+    parser.add_argument(
+        "--helper",
+        action="append",
+        default=[],
+        help="only consider this helper (may be repeated)",
+    )
+    parser.add_argument("--max-instrs", type=int, default=DEFAULT_MAX_INSTRS)
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--nm", default="nm")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    sigs = read_helper_signatures(JIT_RT_H)
+    symbols = read_symbol_mapping(SYMBOL_MAPPING_CPP)
+    binary = Binary(args.cinderx_so, args.objdump, args.nm)
+
+    translations = {}
+    # Hand-written translations take precedence over generated ones.
+    manual = set(read_manual_translations(MANUAL_TRANSLATIONS_CPP))
+    names = args.helper or sorted((set(sigs) & set(binary.helpers)) - manual)
+    for name in names:
+        if name not in sigs or name not in binary.helpers:
+            print(f"{name}: skipped, not a known helper", file=sys.stderr)
+            continue
+        try:
+            insns = parse_disassembly(binary.disassemble(binary.helpers[name]))
+            lifter = Lifter(sigs[name], insns, binary, symbols, args.max_instrs)
+            lir = lifter.lift()
+            verify_translation(name, sigs[name], insns, lir, binary)
+            translations[name] = lir
+        except VerifyError as e:
+            # This is a bug in the lifter, so always report it.
+            print(f"{name}: not translated, failed verification: {e}", file=sys.stderr)
+            continue
+        except LiftError as e:
+            if args.verbose:
+                print(f"{name}: not translated, {e}", file=sys.stderr)
+            continue
+        if args.verbose:
+            print(f"{name}: translated", file=sys.stderr)
+
+    with open(args.output, "w") as f:
+        write_translations(f, translations)
+
+
+if __name__ == "__main__":
+    main()
@@ -49,6 +49,10 @@ namespace {
 
 constexpr size_t kRefcountOffset = offsetof(PyObject, ob_refcnt);
 
+// Number of times a conditional branch must have been profiled before its
+// counts are used to lay out blocks.
+constexpr uint32_t kMinBranchSamples = 20;
+
 // _Py_RefTotal is only defined when Py_REF_DEBUG is defined.
 void* kRefTotalAddr =
 #ifdef Py_REF_DEBUG
@@ -121,7 +125,7 @@ void finishYield(
 // those floats where PyObject_RichCompareBool is used and it short
 // circuits on object identity.
 bool isTypeWithReasonablePointerEq(Type t) {
-  return t <= TArray || t <= TBytesExact || t <= TDictExact ||
+  return t.isStaticArray() || t <= TBytesExact || t <= TDictExact ||
       t <= TListExact || t <= TSetExact || t <= TTupleExact ||
       t <= TTypeExact || t <= TLongExact || t <= TBool || t <= TFunc ||
       t <= TGen || t <= TNoneType || t <= TSlice;
@@ -182,6 +186,135 @@ emitSubclassCheck(BasicBlockBuilder& bbb, hir::Register* obj, Type type) {
 
 #undef FOREACH_FAST_BUILTIN
 
+// Stands in for ob_digit[0] of zero-valued ints, which have no digits
+// allocated.
+const digit kZeroDigit = 0;
+
+static_assert(
+    PyLong_SHIFT <= 31,
+    "Operations on compact ints must not overflow 64 bits");
+
+// Load the value of an int that has at most one digit, branching to slow_path
+// if it has more than that.
+Instruction* emitCompactLongValue(
+    BasicBlockBuilder& bbb,
+    Instruction* obj,
+    BasicBlock* slow_path) {
+  Instruction* size = bbb.appendInstr(
+      OutVReg{}, Instruction::kMove, Ind{obj, offsetof(PyVarObject, ob_size)});
+
+  // -1 <= size <= 1 exactly when size + 1 <= 2 as an unsigned value.
+  Instruction* biased_size =
+      bbb.appendInstr(OutVReg{}, Instruction::kAdd, size, Imm{1});
+  Instruction* is_compact = bbb.appendInstr(
+      OutVReg{OperandBase::k8bit},
+      Instruction::kLessThanEqualUnsigned,
+      biased_size,
+      Imm{2});
+  auto compact = bbb.allocateBlock();
+  bbb.appendBranch(Instruction::kCondBranch, is_compact, compact, slow_path);
+  bbb.switchBlock(compact);
+
+  Instruction* digits = bbb.appendInstr(
+      OutVReg{}, Instruction::kLea, Ind{obj, offsetof(PyLongObject, ob_digit)});
+  Instruction* digit_addr = bbb.appendInstr(
+      OutVReg{},
+      Instruction::kSelect,
+      size,
+      digits,
+      Imm{reinterpret_cast<uint64_t>(&kZeroDigit)});
+  Instruction* digit = bbb.appendInstr(
+      OutVReg{OperandBase::k32bit}, Instruction::kMove, Ind{digit_addr, 0});
+  Instruction* magnitude =
+      bbb.appendInstr(Instruction::kZext, OutVReg{}, digit);
+  return bbb.appendInstr(OutVReg{}, Instruction::kMul, magnitude, size);
+}
+
+// Lower an operation on two ints to inline code when both of them are
+// compact, calling into the generic implementation otherwise. fast_path gets
+// the two values and returns the result object; slow_path emits the call. The
+// two results are joined by a Phi defining dst.
+template <typename FastPath, typename SlowPath>
+void emitCompactLongOp(
+    BasicBlockBuilder& bbb,
+    hir::Register* dst,
+    hir::Register* left,
+    hir::Register* right,
+    FastPath fast_path,
+    SlowPath slow_path) {
+  auto slow = bbb.allocateBlock();
+  auto done = bbb.allocateBlock();
+  if (getConfig().multiple_code_sections) {
+    slow->setSection(codegen::CodeSection::kCold);
+  }
+
+  Instruction* left_value =
+      emitCompactLongValue(bbb, bbb.getDefInstr(left), slow);
+  Instruction* right_value =
+      emitCompactLongValue(bbb, bbb.getDefInstr(right), slow);
+  Instruction* fast_result = fast_path(left_value, right_value);
+  BasicBlock* fast_end = fast_result->basicblock();
+  fast_end->addSuccessor(done);
+
+  bbb.switchBlock(slow);
+  Instruction* slow_result = slow_path();
+  BasicBlock* slow_end = slow_result->basicblock();
+  bbb.appendBlock(done);
+
+  Instruction* phi = bbb.appendInstr(dst, Instruction::kPhi);
+  phi->allocateLabelInput(fast_end);
+  phi->allocateLinkedInput(fast_result);
+  phi->allocateLabelInput(slow_end);
+  phi->allocateLinkedInput(slow_result);
+}
+
+std::optional<Instruction::Opcode> compactLongBinaryOp(BinaryOpKind op) {
+  switch (op) {
+    case BinaryOpKind::kAdd:
+      return Instruction::kAdd;
+    case BinaryOpKind::kSubtract:
+      return Instruction::kSub;
+    case BinaryOpKind::kMultiply:
+      return Instruction::kMul;
+    case BinaryOpKind::kAnd:
+      return Instruction::kAnd;
+    case BinaryOpKind::kOr:
+      return Instruction::kOr;
+    case BinaryOpKind::kXor:
+      return Instruction::kXor;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<Instruction::Opcode> compactLongCompareOp(CompareOp op) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return Instruction::kEqual;
+    case CompareOp::kNotEqual:
+      return Instruction::kNotEqual;
+    case CompareOp::kLessThan:
+      return Instruction::kLessThanSigned;
+    case CompareOp::kLessThanEqual:
+      return Instruction::kLessThanEqualSigned;
+    case CompareOp::kGreaterThan:
+      return Instruction::kGreaterThanSigned;
+    case CompareOp::kGreaterThanEqual:
+      return Instruction::kGreaterThanEqualSigned;
+    default:
+      return std::nullopt;
+  }
+}
+
+// The offset of the instruction in the function being compiled that led to
+// the given instruction, looking through any inlined calls.
+BCOffset outermostInstrOffset(const FrameState* frame) {
+  while (frame->parent != nullptr) {
+    frame = frame->parent;
+  }
+  return frame->instr_offset();
+}
+
 ssize_t shadowFrameOffsetBefore(const InlineBase* instr) {
   return -instr->inlineDepth() * ssize_t{kJITShadowFrameSize};
 }
@@ -287,6 +420,7 @@ std::unique_ptr<jit::lir::Function> LIRGenerator::TranslateFunction() {
   exit_block_ = GenerateExitBlock();
 
   // Connect all successors.
+  UnorderedMap<BasicBlock*, BasicBlock*> never_taken;
   entry_block_->addSuccessor(bb_map[hir_entry].first);
   for (auto hir_bb : translated) {
     auto hir_term = hir_bb->GetTerminator();
@@ -308,6 +442,20 @@ std::unique_ptr<jit::lir::Function> LIRGenerator::TranslateFunction() {
         last_bb->addSuccessor(target_lir_false_bb);
         last_bb->getLastInstr()->allocateLabelInput(target_lir_true_bb);
         last_bb->getLastInstr()->allocateLabelInput(target_lir_false_bb);
+
+        uint32_t true_count = condbranch->profiledTrueCount();
+        uint32_t false_count = condbranch->profiledFalseCount();
+        if (true_count + false_count >= kMinBranchSamples &&
+            target_lir_true_bb != target_lir_false_bb) {
+          bool true_likely = true_count >= false_count;
+          last_bb->setLikelySuccessor(
+              true_likely ? target_lir_true_bb : target_lir_false_bb);
+          if ((true_likely ? false_count : true_count) == 0) {
+            never_taken.emplace(
+                last_bb,
+                true_likely ? target_lir_false_bb : target_lir_true_bb);
+          }
+        }
         break;
       }
       case Opcode::kReturn: {
@@ -319,11 +467,38 @@ std::unique_ptr<jit::lir::Function> LIRGenerator::TranslateFunction() {
     }
   }
 
+  markColdBlocks(never_taken);
+
   resolvePhiOperands(bb_map);
 
   return function;
 }
 
+void LIRGenerator::markColdBlocks(
+    const UnorderedMap<BasicBlock*, BasicBlock*>& never_taken) {
+  if (never_taken.empty()) {
+    return;
+  }
+  UnorderedSet<BasicBlock*> hot{entry_block_};
+  std::vector<BasicBlock*> worklist{entry_block_};
+  while (!worklist.empty()) {
+    BasicBlock* block = worklist.back();
+    worklist.pop_back();
+    BasicBlock* skipped = map_get(never_taken, block, nullptr);
+    for (BasicBlock* succ : block->successors()) {
+      if (succ != skipped && hot.insert(succ).second) {
+        worklist.push_back(succ);
+      }
+    }
+  }
+  for (BasicBlock* block : lir_func_->basicblocks()) {
+    // The exit block falls through into the epilogue, so it has to stay put.
+    if (block != exit_block_ && !hot.contains(block)) {
+      block->setSection(codegen::CodeSection::kCold);
+    }
+  }
+}
+
 void LIRGenerator::appendGuardAlwaysFail(
     BasicBlockBuilder& bbb,
     const hir::DeoptBase& hir_instr) {
@@ -1217,6 +1392,8 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
         hir::Register* base = instr->GetOperand(0);
         Instruction* name = getNameFromIdx(bbb, instr);
         auto cache = Runtime::get()->allocateLoadAttrCache();
+        env_->code_rt->addCacheSite(
+            outermostInstrOffset(instr->frameState()), cache);
         bbb.appendCallInstruction(
             dst, jit::LoadAttrCache::invoke, cache, base, name);
         break;
@@ -1262,6 +1439,8 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
         auto instr = static_cast<const FillTypeMethodCache*>(&i);
         Instruction* name = getNameFromIdx(bbb, instr);
         auto cache_entry = load_type_method_caches_.at(instr->cache_id());
+        env_->code_rt->addCacheSite(
+            outermostInstrOffset(instr->frameState()), cache_entry);
         if (g_collect_inline_cache_stats) {
           BorrowedRef<PyCodeObject> code = instr->frameState()->code;
           cache_entry->initCacheStats(
@@ -1320,6 +1499,8 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
         hir::Register* base = instr->receiver();
         Instruction* name = getNameFromIdx(bbb, instr);
         auto cache = Runtime::get()->allocateLoadMethodCache();
+        env_->code_rt->addCacheSite(
+            outermostInstrOffset(instr->frameState()), cache);
         if (g_collect_inline_cache_stats) {
           BorrowedRef<PyCodeObject> code = instr->frameState()->code;
           cache->initCacheStats(
@@ -1417,7 +1598,28 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
       }
       case Opcode::kLongBinaryOp: {
         auto instr = static_cast<const LongBinaryOp*>(&i);
-        if (instr->op() == BinaryOpKind::kPower) {
+        // Operands of at most one digit can't overflow a 64-bit register, so
+        // the only remaining work is boxing the result.
+        if (auto op = compactLongBinaryOp(instr->op())) {
+          emitCompactLongOp(
+              bbb,
+              instr->dst(),
+              instr->left(),
+              instr->right(),
+              [&](Instruction* left, Instruction* right) {
+                Instruction* result =
+                    bbb.appendInstr(OutVReg{}, *op, left, right);
+                return bbb.appendCallInstruction(
+                    OutVReg{}, PyLong_FromSsize_t, result);
+              },
+              [&] {
+                return bbb.appendCallInstruction(
+                    OutVReg{},
+                    instr->slotMethod(),
+                    instr->left(),
+                    instr->right());
+              });
+        } else if (instr->op() == BinaryOpKind::kPower) {
           bbb.appendCallInstruction(
               instr->dst(),
               PyLong_Type.tp_as_number->nb_power,
@@ -1490,13 +1692,63 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
       }
       case Opcode::kLongCompare: {
         auto instr = static_cast<const LongCompare*>(&i);
-
-        bbb.appendCallInstruction(
+        auto op = compactLongCompareOp(instr->op());
+        if (!op) {
+          bbb.appendCallInstruction(
+              instr->dst(),
+              PyLong_Type.tp_richcompare,
+              instr->left(),
+              instr->right(),
+              static_cast<int>(instr->op()));
+          break;
+        }
+        emitCompactLongOp(
+            bbb,
             instr->dst(),
-            PyLong_Type.tp_richcompare,
             instr->left(),
             instr->right(),
-            static_cast<int>(instr->op()));
+            [&](Instruction* left, Instruction* right) {
+              Instruction* cond = bbb.appendInstr(
+                  OutVReg{OperandBase::k8bit}, *op, left, right);
+              auto true_addr = reinterpret_cast<uint64_t>(Py_True);
+              auto false_addr = reinterpret_cast<uint64_t>(Py_False);
+              Instruction* temp_true = bbb.appendInstr(
+                  Instruction::kMove, OutVReg{}, Imm{true_addr});
+              Instruction* result = bbb.appendInstr(
+                  OutVReg{},
+                  Instruction::kSelect,
+                  cond,
+                  temp_true,
+                  Imm{false_addr});
+              // The generic path returns a new reference.
+              if (!kImmortalInstances) {
+                Instruction* refcnt = bbb.appendInstr(
+                    OutVReg{},
+                    Instruction::kMove,
+                    Ind{result, kRefcountOffset});
+                bbb.appendInstr(Instruction::kInc, refcnt);
+                bbb.appendInstr(
+                    OutInd{result, kRefcountOffset},
+                    Instruction::kMove,
+                    refcnt);
+                if (kRefTotalAddr != 0) {
+                  auto total = bbb.appendInstr(
+                      OutVReg{}, Instruction::kMove, MemImm{kRefTotalAddr});
+                  bbb.appendInstr(Instruction::kInc, total);
+                  bbb.appendInstr(
+                      OutMemImm{kRefTotalAddr}, Instruction::kMove, total);
+                }
+              }
+              return result;
+            },
+            [&] {
+              return bbb.appendCallInstruction(
+                  OutVReg{},
+                  PyLong_Type.tp_richcompare,
+                  instr->left(),
+                  instr->right(),
+                  static_cast<int>(instr->op()));
+            });
         break;
       }
       case Opcode::kUnicodeCompare: {
@@ -1763,6 +2015,8 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
         Instruction* name = getNameFromIdx(bbb, instr);
         hir::Register* value = instr->GetOperand(1);
         auto cache = Runtime::get()->allocateStoreAttrCache();
+        env_->code_rt->addCacheSite(
+            outermostInstrOffset(instr->frameState()), cache);
         bbb.appendCallInstruction(
             dst, jit::StoreAttrCache::invoke, cache, base, name, value);
         break;
@@ -2173,32 +2427,24 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
       case Opcode::kStoreArrayItem: {
         auto instr = static_cast<const StoreArrayItem*>(&i);
         auto type = instr->type();
-        decltype(JITRT_SetI8_InArray)* func = nullptr;
-
-        if (type <= TCInt8) {
-          func = JITRT_SetI8_InArray;
-        } else if (type <= TCUInt8) {
-          func = JITRT_SetU8_InArray;
-        } else if (type <= TCInt16) {
-          func = JITRT_SetI16_InArray;
-        } else if (type <= TCUInt16) {
-          func = JITRT_SetU16_InArray;
-        } else if (type <= TCInt32) {
-          func = JITRT_SetI32_InArray;
-        } else if (type <= TCUInt32) {
-          func = JITRT_SetU32_InArray;
-        } else if (type <= TCInt64) {
-          func = JITRT_SetI64_InArray;
-        } else if (type <= TCUInt64) {
-          func = JITRT_SetU64_InArray;
-        } else if (type <= TObject) {
-          func = JITRT_SetObj_InArray;
-        } else {
-          JIT_ABORT("Unknown array type {}", type.toString());
-        }
+        JIT_CHECK(
+            type <= TObject || type <= TCInt || type <= TCDouble,
+            "Unknown array type {}",
+            type.toString());
 
-        bbb.appendInvokeInstruction(
-            func, instr->ob_item(), instr->value(), instr->idx());
+        // Stored inline, mirroring LoadArrayItem, so loops over typed arrays
+        // don't pay for a helper call per element.
+        Instruction* ob_item = bbb.getDefInstr(instr->ob_item());
+        Instruction* idx = bbb.getDefInstr(instr->idx());
+        auto dest = OutInd{ob_item, idx, type.sizeInBytes(), 0};
+        if (instr->idx()->type().hasIntSpec()) {
+          auto scaled_offset = static_cast<int32_t>(
+              instr->idx()->type().intSpec() * type.sizeInBytes());
+          dest = OutInd{ob_item, scaled_offset};
+        }
+        Instruction* lir =
+            bbb.appendInstr(dest, Instruction::kMove, instr->value());
+        lir->output()->setDataType(hirTypeToDataType(type));
         break;
       }
       case Opcode::kLoadSplitDictItem: {
@@ -2540,6 +2786,10 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
         // UseTypes are purely informative
         break;
       }
+      case Opcode::kVirtualObject: {
+        // VirtualObjects are only materialized on deopt
+        break;
+      }
       case Opcode::kHintType: {
         // HintTypes are purely informative
         break;
@@ -2885,6 +3135,11 @@ void LIRGenerator::resolvePhiOperands(
 
   for (auto& block : basic_blocks_) {
     block->foreachPhiInstr([&](Instruction* instr) {
+      // Phis joining the paths of a single lowered instruction are complete
+      // already.
+      if (!instr->origin()->IsPhi()) {
+        return;
+      }
       auto hir_instr = static_cast<const Phi*>(instr->origin());
       for (size_t i = 0; i < hir_instr->NumOperands(); ++i) {
         hir::BasicBlock* hir_block = hir_instr->basic_blocks().at(i);
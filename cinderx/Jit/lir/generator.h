@@ -58,6 +58,12 @@ class LIRGenerator {
   BasicBlock* GenerateEntryBlock();
   BasicBlock* GenerateExitBlock();
 
+  // Put blocks that are only reachable through branch edges that were never
+  // taken while profiling (never_taken maps a block to such a successor) in
+  // the cold section.
+  void markColdBlocks(
+      const UnorderedMap<BasicBlock*, BasicBlock*>& never_taken);
+
   void appendGuardAlwaysFail(
       BasicBlockBuilder& bbb,
       const hir::DeoptBase& instr);
@@ -5,8 +5,10 @@
 #include "cinderx/Jit/containers.h"
 #include "cinderx/Jit/lir/c_helper_translations.h"
 #include "cinderx/Jit/lir/parser.h"
+#include "cinderx/Jit/lir/verify.h"
 
 #include <shared_mutex>
+#include <sstream>
 #include <string_view>
 
 using namespace jit::codegen;
@@ -228,6 +230,19 @@ lir::Function* LIRInliner::parseFunction(uint64_t addr) {
     return nullptr;
   }
 
+  // Translations may be generated from compiled helpers, so check that they
+  // have the shape the inliner relies on before using them.
+  std::ostringstream verify_err;
+  if (!verifyCHelperTranslation(parsed_func.get(), verify_err)) {
+    JIT_LOG(
+        "Invalid LIR translation for C helper {:#x}: {}",
+        addr,
+        verify_err.str());
+    std::unique_lock guard{addr_map_guard};
+    addr_to_function.emplace(addr, nullptr);
+    return nullptr;
+  }
+
   // Guard usage of addr_to_function
   std::unique_lock guard{addr_map_guard};
   // Add function to map.
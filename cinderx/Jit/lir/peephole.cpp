@@ -0,0 +1,497 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "cinderx/Jit/lir/peephole.h"
+
+#include "cinderx/Common/util.h"
+
+#include "cinderx/Jit/codegen/x86_64.h"
+#include "cinderx/Jit/lir/function.h"
+#include "cinderx/Jit/lir/instruction.h"
+#include "cinderx/Jit/lir/operand.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <unordered_set>
+
+using namespace jit::codegen;
+
+namespace jit::lir {
+
+using RewriteResult = Rewrite::RewriteResult;
+using instr_iter_t = Rewrite::instr_iter_t;
+
+// The rules below only ever remove the instruction they are given or
+// instructions before it: Rewrite::run() has already advanced its iterator to
+// the next instruction when a rule is invoked.
+
+static bool isGp64(const OperandBase* opnd) {
+  return opnd->isReg() && !opnd->isXmm() && !opnd->isFp() &&
+      opnd->sizeInBits() == 64;
+}
+
+static bool sameLocation(const OperandBase* a, const OperandBase* b) {
+  return a->type() == b->type() &&
+      a->getPhyRegOrStackSlot() == b->getPhyRegOrStackSlot();
+}
+
+static Instruction* prevInstr(instr_iter_t instr_iter, int distance = 1) {
+  BasicBlock* block = instr_iter->get()->basicblock();
+  for (int i = 0; i < distance; i++) {
+    if (instr_iter == block->instructions().begin()) {
+      return nullptr;
+    }
+    --instr_iter;
+  }
+  return instr_iter->get();
+}
+
+// Return true if nothing reads the flags left by the given instruction: a
+// later instruction in the same block overwrites them before any conditional
+// branch. Flags are considered live at the end of a block.
+static bool flagsDeadAfter(instr_iter_t instr_iter) {
+  BasicBlock* block = instr_iter->get()->basicblock();
+  for (auto it = std::next(instr_iter); it != block->instructions().end();
+       ++it) {
+    Instruction* instr = it->get();
+    if (instr->isBranchCC()) {
+      return false;
+    }
+    switch (InstrProperty::getProperties(instr).flag_effects) {
+      case FlagEffects::kSet:
+      case FlagEffects::kInvalidate:
+        return true;
+      case FlagEffects::kNone:
+        continue;
+    }
+  }
+  return false;
+}
+
+// The condition code a compare instruction materializes with setcc, i.e. the
+// branch taken exactly when the compare produces 1.
+static Instruction::Opcode branchForCompare(Instruction::Opcode opcode) {
+  switch (opcode) {
+    case Instruction::kEqual:
+      return Instruction::kBranchZ;
+    case Instruction::kNotEqual:
+      return Instruction::kBranchNZ;
+    case Instruction::kGreaterThanSigned:
+      return Instruction::kBranchG;
+    case Instruction::kGreaterThanEqualSigned:
+      return Instruction::kBranchGE;
+    case Instruction::kLessThanSigned:
+      return Instruction::kBranchL;
+    case Instruction::kLessThanEqualSigned:
+      return Instruction::kBranchLE;
+    case Instruction::kGreaterThanUnsigned:
+      return Instruction::kBranchA;
+    case Instruction::kGreaterThanEqualUnsigned:
+      return Instruction::kBranchAE;
+    case Instruction::kLessThanUnsigned:
+      return Instruction::kBranchB;
+    case Instruction::kLessThanEqualUnsigned:
+      return Instruction::kBranchBE;
+    default:
+      JIT_ABORT("Not a compare opcode.");
+  }
+}
+
+// Remove moves that don't change anything:
+//
+//   RAX = Move RAX              ->  (removed)
+//
+//   RAX = Move [RBP - 8]            RAX = Move [RBP - 8]
+//   [RBP - 8] = Move RAX        ->
+static RewriteResult removeRedundantMove(instr_iter_t instr_iter) {
+  Instruction* instr = instr_iter->get();
+  if (!instr->isMove()) {
+    return Rewrite::kUnchanged;
+  }
+
+  const OperandBase* out = instr->output();
+  const OperandBase* in = instr->getInput(0);
+  if (!(out->isReg() || out->isStack()) || !(in->isReg() || in->isStack()) ||
+      out->dataType() != in->dataType()) {
+    return Rewrite::kUnchanged;
+  }
+
+  bool redundant = sameLocation(out, in);
+  Instruction* prev = prevInstr(instr_iter);
+  if (!redundant && prev != nullptr && prev->isMove()) {
+    const OperandBase* prev_out = prev->output();
+    const OperandBase* prev_in = prev->getInput(0);
+    redundant = prev_out->dataType() == out->dataType() &&
+        prev_in->dataType() == in->dataType() && sameLocation(prev_out, in) &&
+        sameLocation(prev_in, out);
+  }
+  if (!redundant) {
+    return Rewrite::kUnchanged;
+  }
+
+  instr->basicblock()->removeInstr(instr_iter);
+  return Rewrite::kRemoved;
+}
+
+// If instr_iter is a BranchZ or BranchNZ preceded by `Test reg, reg`, return
+// the Test's register operand.
+static const OperandBase* testedRegister(instr_iter_t instr_iter) {
+  Instruction* instr = instr_iter->get();
+  if (!instr->isBranchZ() && !instr->isBranchNZ()) {
+    return nullptr;
+  }
+  Instruction* test = prevInstr(instr_iter);
+  if (test == nullptr || !test->isTest()) {
+    return nullptr;
+  }
+  const OperandBase* lhs = test->getInput(0);
+  const OperandBase* rhs = test->getInput(1);
+  if (!lhs->isReg() || !rhs->isReg() ||
+      lhs->getPhyRegister() != rhs->getPhyRegister() ||
+      lhs->dataType() != rhs->dataType()) {
+    return nullptr;
+  }
+  return lhs;
+}
+
+// Branch on the flags of a compare instead of re-testing its 0/1 result:
+//
+//   RAX = LessThanSigned RDI, RSI        RAX = LessThanSigned RDI, RSI
+//   Test RAX, RAX                    ->  BranchL BB%1
+//   BranchNZ BB%1
+//
+// The setcc is kept since the result may have other uses.
+static RewriteResult fuseCompareBranch(instr_iter_t instr_iter) {
+  const OperandBase* reg = testedRegister(instr_iter);
+  if (reg == nullptr) {
+    return Rewrite::kUnchanged;
+  }
+  Instruction* compare = prevInstr(instr_iter, 2);
+  if (compare == nullptr || !compare->isCompare()) {
+    return Rewrite::kUnchanged;
+  }
+  // setcc only writes the low byte of a byte-sized output, so a wider test
+  // would look at bits the compare didn't produce.
+  const OperandBase* out = compare->output();
+  if (!out->isReg() || out->getPhyRegister() != reg->getPhyRegister() ||
+      out->sizeInBits() < reg->sizeInBits()) {
+    return Rewrite::kUnchanged;
+  }
+
+  Instruction* branch = instr_iter->get();
+  auto opcode = branchForCompare(compare->opcode());
+  branch->setOpcode(
+      branch->isBranchNZ() ? opcode : Instruction::negateBranchCC(opcode));
+  branch->basicblock()->removeInstr(std::prev(instr_iter));
+  return Rewrite::kChanged;
+}
+
+// Drop a Test whose zero flag was already set by the arithmetic that
+// produced its operand:
+//
+//   Sub RAX, 1                           Sub RAX, 1
+//   Test RAX, RAX                    ->  BranchZ BB%1
+//   BranchZ BB%1
+static RewriteResult fuseTestBranch(instr_iter_t instr_iter) {
+  const OperandBase* reg = testedRegister(instr_iter);
+  if (reg == nullptr) {
+    return Rewrite::kUnchanged;
+  }
+  Instruction* arith = prevInstr(instr_iter, 2);
+  if (arith == nullptr ||
+      !(arith->isAdd() || arith->isSub() || arith->isAnd() || arith->isOr() ||
+        arith->isXor() || arith->isInc() || arith->isDec())) {
+    return Rewrite::kUnchanged;
+  }
+  // Two-operand forms write their result to the first input.
+  const OperandBase* result = arith->output()->type() == OperandBase::kNone
+      ? arith->getInput(0)
+      : arith->output();
+  if (!result->isReg() || result->getPhyRegister() != reg->getPhyRegister() ||
+      result->dataType() != reg->dataType()) {
+    return Rewrite::kUnchanged;
+  }
+
+  Instruction* branch = instr_iter->get();
+  branch->basicblock()->removeInstr(std::prev(instr_iter));
+  return Rewrite::kChanged;
+}
+
+// Replace a three-operand add, which is emitted as a move followed by an add,
+// with a single LEA. LEA doesn't set flags, so this is only done when nothing
+// reads them.
+//
+//   RAX = Add RDI, RSI    ->  RAX = Lea [RDI + RSI]
+//   RAX = Add RDI, 16     ->  RAX = Lea [RDI + 0x10]
+static RewriteResult formLeaFromAdd(instr_iter_t instr_iter) {
+  Instruction* instr = instr_iter->get();
+  if (!instr->isAdd() || !isGp64(instr->output()) ||
+      !isGp64(instr->getInput(0))) {
+    return Rewrite::kUnchanged;
+  }
+
+  PhyLocation base = instr->getInput(0)->getPhyRegister();
+  PhyLocation index = PhyLocation::REG_INVALID;
+  int32_t offset = 0;
+  const OperandBase* in1 = instr->getInput(1);
+  if (isGp64(in1)) {
+    index = in1->getPhyRegister();
+    if (index == PhyLocation::RSP) {
+      std::swap(base, index);
+    }
+    if (index == PhyLocation::RSP) {
+      return Rewrite::kUnchanged;
+    }
+  } else if (
+      in1->isImm() && fitsInt32(static_cast<int64_t>(in1->getConstant()))) {
+    offset = static_cast<int32_t>(in1->getConstant());
+  } else {
+    return Rewrite::kUnchanged;
+  }
+  if (!flagsDeadAfter(instr_iter)) {
+    return Rewrite::kUnchanged;
+  }
+
+  instr->setOpcode(Instruction::kLea);
+  instr->setNumInputs(0);
+  instr->allocateMemoryIndirectInput(base, index, 0, offset);
+  return Rewrite::kChanged;
+}
+
+// Multiplications by a small power of two feeding an add become the scaled
+// index of a single LEA, and multiplications by 3, 5 or 9 become an LEA
+// adding a scaled register to itself:
+//
+//   RAX = Mul RDI, 8                 ->  RAX = Lea [RSI + RDI * 8]
+//   Add RAX, RSI
+//
+//   RAX = Mul RDI, 5                 ->  RAX = Lea [RDI + RDI * 4]
+static RewriteResult formLeaFromMul(instr_iter_t instr_iter) {
+  // Return log2(imm - bias) if the multiplication by an immediate is a
+  // 64-bit GP one and the shift is encodable as an LEA scale.
+  auto scale_shift = [](const Instruction* mul, int bias) -> int {
+    if (mul == nullptr || !mul->isMul() || !isGp64(mul->getInput(0)) ||
+        !mul->getInput(1)->isImm()) {
+      return -1;
+    }
+    const OperandBase* out = mul->output();
+    if (out->type() != OperandBase::kNone && !isGp64(out)) {
+      return -1;
+    }
+    uint64_t imm = mul->getInput(1)->getConstant();
+    for (int shift = 1; shift <= 3; shift++) {
+      if (imm == (uint64_t{1} << shift) + bias) {
+        return shift;
+      }
+    }
+    return -1;
+  };
+  auto result_reg = [](const Instruction* instr) {
+    const OperandBase* out = instr->output();
+    return PhyLocation(
+        out->type() == OperandBase::kNone
+            ? instr->getInput(0)->getPhyRegister()
+            : out->getPhyRegister());
+  };
+
+  Instruction* instr = instr_iter->get();
+  if (instr->isAdd() && instr->output()->type() == OperandBase::kNone) {
+    // Add t, b where t = Mul x, 2^k just before.
+    Instruction* mul = prevInstr(instr_iter);
+    int shift = scale_shift(mul, 0);
+    const OperandBase* dst = instr->getInput(0);
+    const OperandBase* other = instr->getInput(1);
+    if (shift < 0 || !isGp64(dst) || !isGp64(other) ||
+        dst->getPhyRegister() != result_reg(mul) ||
+        other->getPhyRegister() == dst->getPhyRegister()) {
+      return Rewrite::kUnchanged;
+    }
+    PhyLocation index = mul->getInput(0)->getPhyRegister();
+    PhyLocation base = other->getPhyRegister();
+    if (index == PhyLocation::RSP || !flagsDeadAfter(instr_iter)) {
+      return Rewrite::kUnchanged;
+    }
+
+    PhyLocation out = dst->getPhyRegister();
+    instr->setOpcode(Instruction::kLea);
+    instr->setNumInputs(0);
+    instr->output()->setPhyRegister(out);
+    instr->output()->setDataType(OperandBase::k64bit);
+    instr->allocateMemoryIndirectInput(base, index, shift, 0);
+    instr->basicblock()->removeInstr(std::prev(instr_iter));
+    return Rewrite::kChanged;
+  }
+
+  int shift = scale_shift(instr, 1);
+  if (shift < 0) {
+    return Rewrite::kUnchanged;
+  }
+  PhyLocation src = instr->getInput(0)->getPhyRegister();
+  if (src == PhyLocation::RSP || !flagsDeadAfter(instr_iter)) {
+    return Rewrite::kUnchanged;
+  }
+
+  PhyLocation out = result_reg(instr);
+  instr->setOpcode(Instruction::kLea);
+  instr->setNumInputs(0);
+  instr->output()->setPhyRegister(out);
+  instr->output()->setDataType(OperandBase::k64bit);
+  instr->allocateMemoryIndirectInput(src, src, shift, 0);
+  return Rewrite::kChanged;
+}
+
+// Remove a register-only Test or Cmp whose flags are overwritten before any
+// branch reads them.
+static RewriteResult removeDeadFlagSetter(instr_iter_t instr_iter) {
+  Instruction* instr = instr_iter->get();
+  if (!(instr->isTest() || instr->isTest32() || instr->isCmp()) ||
+      instr->output()->type() != OperandBase::kNone) {
+    return Rewrite::kUnchanged;
+  }
+  for (size_t i = 0; i < instr->getNumInputs(); i++) {
+    const OperandBase* in = instr->getInput(i);
+    if (!in->isReg() && !in->isImm()) {
+      return Rewrite::kUnchanged;
+    }
+  }
+  if (!flagsDeadAfter(instr_iter)) {
+    return Rewrite::kUnchanged;
+  }
+
+  instr->basicblock()->removeInstr(instr_iter);
+  return Rewrite::kRemoved;
+}
+
+// If the block contains nothing but an unconditional branch, return the
+// block it branches to.
+static BasicBlock* trampolineTarget(BasicBlock* block) {
+  if (block->getNumInstrs() != 1) {
+    return nullptr;
+  }
+  Instruction* instr = block->getFirstInstr();
+  return instr->isBranch() ? instr->getInput(0)->getBasicBlock() : nullptr;
+}
+
+// Retarget a branch to a block that only jumps elsewhere at the final
+// destination of the chain:
+//
+//   BB %0                            BB %0
+//     BranchZ BB%1                     BranchZ BB%2
+//   BB %1                        ->  BB %1
+//     Branch BB%2                      Branch BB%2
+static RewriteResult threadJumps(instr_iter_t instr_iter) {
+  Instruction* instr = instr_iter->get();
+  if (!instr->isBranch() && !instr->isBranchCC()) {
+    return Rewrite::kUnchanged;
+  }
+
+  BasicBlock* target = instr->getInput(0)->getBasicBlock();
+  BasicBlock* dest = target;
+  std::unordered_set<BasicBlock*> visited{target};
+  while (BasicBlock* next = trampolineTarget(dest)) {
+    if (!visited.insert(next).second) {
+      // A cycle of empty jumps; leave it alone.
+      return Rewrite::kUnchanged;
+    }
+    dest = next;
+  }
+  if (dest == target) {
+    return Rewrite::kUnchanged;
+  }
+
+  BasicBlock* block = instr->basicblock();
+  auto& succs = block->successors();
+  if (std::count(succs.begin(), succs.end(), target) != 1 ||
+      std::find(succs.begin(), succs.end(), dest) != succs.end()) {
+    return Rewrite::kUnchanged;
+  }
+
+  auto idx = std::find(succs.begin(), succs.end(), target) - succs.begin();
+  block->setSuccessor(idx, dest);
+  static_cast<Operand*>(instr->getInput(0))->setBasicBlock(dest);
+  return Rewrite::kChanged;
+}
+
+// Erase one block that only jumps elsewhere and is no longer reachable,
+// typically because threadJumps() retargeted all of its predecessors.
+static RewriteResult removeDeadTrampoline(Function* function) {
+  auto& blocks = function->basicblocks();
+  for (auto it = std::next(blocks.begin()); it != blocks.end(); ++it) {
+    BasicBlock* block = *it;
+    if (!block->predecessors().empty() || trampolineTarget(block) == nullptr) {
+      continue;
+    }
+    for (BasicBlock* succ : block->successors()) {
+      auto& preds = succ->predecessors();
+      preds.erase(std::find(preds.begin(), preds.end(), block));
+    }
+    block->successors().clear();
+    blocks.erase(it);
+    return Rewrite::kChanged;
+  }
+  return Rewrite::kUnchanged;
+}
+
+namespace {
+
+struct PeepholeRule {
+  const char* name;
+  RewriteResult (*instr_rewrite)(instr_iter_t);
+  RewriteResult (*function_rewrite)(Function*);
+  std::atomic<uint64_t> hits{0};
+};
+
+PeepholeRule rules[] = {
+    {"redundant_move", removeRedundantMove, nullptr},
+    {"fuse_compare_branch", fuseCompareBranch, nullptr},
+    {"fuse_test_branch", fuseTestBranch, nullptr},
+    {"lea_from_add", formLeaFromAdd, nullptr},
+    {"lea_from_mul", formLeaFromMul, nullptr},
+    {"dead_flag_setter", removeDeadFlagSetter, nullptr},
+    {"jump_threading", threadJumps, nullptr},
+    {"dead_trampoline", nullptr, removeDeadTrampoline},
+};
+
+RewriteResult countHit(PeepholeRule& rule, RewriteResult result) {
+  if (result != Rewrite::kUnchanged) {
+    rule.hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+} // namespace
+
+PeepholeOptimizer::PeepholeOptimizer(
+    jit::lir::Function* func,
+    jit::codegen::Environ* env)
+    : Rewrite(func, env) {
+  for (PeepholeRule& rule : rules) {
+    if (rule.instr_rewrite != nullptr) {
+      registerOneRewriteFunction(instruction_rewrite_t{
+          [&rule](instr_iter_t instr_iter) {
+            return countHit(rule, rule.instr_rewrite(instr_iter));
+          }});
+    } else {
+      registerOneRewriteFunction(
+          function_rewrite_t{[&rule](Function* function) {
+            return countHit(rule, rule.function_rewrite(function));
+          }});
+    }
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>> PeepholeOptimizer::hitCounts() {
+  std::vector<std::pair<std::string, uint64_t>> counts;
+  for (const PeepholeRule& rule : rules) {
+    counts.emplace_back(rule.name, rule.hits.load(std::memory_order_relaxed));
+  }
+  return counts;
+}
+
+void PeepholeOptimizer::resetHitCounts() {
+  for (PeepholeRule& rule : rules) {
+    rule.hits.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace jit::lir
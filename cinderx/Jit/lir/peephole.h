@@ -0,0 +1,30 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include "cinderx/Jit/codegen/environ.h"
+#include "cinderx/Jit/lir/rewrite.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jit::lir {
+
+// Pattern-based cleanups of the final instruction stream, run after
+// PostRegAllocRewrite and right before code generation. The rules live in a
+// table in peephole.cpp; each one counts the rewrites it performs, across all
+// compilations in the process, so we can see which rules fire on real
+// workloads.
+class PeepholeOptimizer : public Rewrite {
+ public:
+  PeepholeOptimizer(jit::lir::Function* func, jit::codegen::Environ* env);
+
+  // Return (rule name, number of rewrites) for every rule, in table order.
+  static std::vector<std::pair<std::string, uint64_t>> hitCounts();
+
+  static void resetHitCounts();
+};
+
+} // namespace jit::lir
@@ -195,6 +195,9 @@ void LinearScanAllocator::initialize() {
   regalloc_blocks_.clear();
   vreg_last_use_.clear();
   vreg_global_last_use_.clear();
+  loop_ranges_.clear();
+  block_starts_.clear();
+  vreg_last_allocated_.clear();
 
   max_stack_slot_ = initial_max_stack_slot_;
   free_stack_slots_.clear();
@@ -265,6 +268,7 @@ void LinearScanAllocator::calculateLiveIntervals() {
     total_ids -= bb_instrs;
     total_ids--;
     auto bb_start_id = total_ids;
+    block_starts_.push_back(bb_start_id);
 
     auto lir_bb_iter =
         regalloc_blocks_
@@ -432,6 +436,7 @@ void LinearScanAllocator::calculateLiveIntervals() {
     auto loop_iter = loop_ends.find(bb);
     if (loop_iter != loop_ends.end()) {
       for (auto& loop_end_id : loop_iter->second) {
+        loop_ranges_.emplace_back(bb_start_id, loop_end_id);
         for (auto& opnd : live) {
           LiveRange loop_range(bb_start_id, loop_end_id);
           getIntervalByVReg(opnd).addRange(loop_range);
@@ -467,6 +472,8 @@ void LinearScanAllocator::calculateLiveIntervals() {
 
     visited_blocks.insert(bb);
   }
+
+  std::reverse(block_starts_.begin(), block_starts_.end());
 }
 
 int LinearScanAllocator::initialYieldSpillSize() const {
@@ -653,6 +660,7 @@ void LinearScanAllocator::linearScan() {
     } else {
       stack_intervals.emplace(current);
     }
+    vreg_last_allocated_[current->vreg] = current;
   }
 
   std::sort(
@@ -717,6 +725,17 @@ bool LinearScanAllocator::tryAllocateFreeReg(
     }
   }
 
+  // otherwise, try to reuse the register of the value current is copied from,
+  // so that the copy becomes a no-op.
+  if (regFreeUntil == START_LOCATION) {
+    PhyLocation hint = getRegisterHint(current);
+    if (hint != PhyLocation::REG_INVALID &&
+        freeUntilPos[hint] >= current->endLocation()) {
+      reg = hint;
+      regFreeUntil = freeUntilPos[hint];
+    }
+  }
+
   // if not preallocated interval or cannot honor the preallocated register
   if (regFreeUntil == START_LOCATION) {
     auto start =
@@ -782,19 +801,38 @@ void LinearScanAllocator::allocateBlockedReg(
       std::next(nextUsePos.begin(), is_fp ? PhyLocation::XMM_REG_BASE : 0);
   auto end = std::prev(nextUsePos.end(), is_fp ? 0 : PhyLocation::XMM_REG_BASE);
 
-  auto reg_iter = std::max_element(start, end);
+  // A register used at current_start can't be taken away. Among the others,
+  // uses inside loops run on every iteration, so weigh them by loop depth
+  // before distance: evict the register whose next use is least deeply nested,
+  // and of those the one used furthest away.
+  auto spill_weight = [&](LIRLocation use) {
+    return std::make_pair(-loopDepth(use), use);
+  };
+  auto reg_iter = std::max_element(
+      start, end, [&](LIRLocation lhs, LIRLocation rhs) {
+        bool lhs_free = lhs > current_start;
+        bool rhs_free = rhs > current_start;
+        if (lhs_free != rhs_free) {
+          return rhs_free;
+        }
+        return lhs_free ? spill_weight(lhs) < spill_weight(rhs) : lhs < rhs;
+      });
   PhyLocation reg = std::distance(nextUsePos.begin(), reg_iter);
   auto& reg_use = *reg_iter;
 
   auto first_current_use = getUseAtOrAfter(current->vreg, current_start);
-  if (first_current_use >= reg_use) {
+  if (reg_use <= current_start ||
+      spill_weight(first_current_use) >= spill_weight(reg_use)) {
     auto stack_slot = getStackSlot(current->vreg);
     current->allocateTo(stack_slot);
 
     // first_current_use can be MAX_LOCATION when vreg is in a loop and there is
     // no more uses after current_start
     if (first_current_use < current->endLocation()) {
-      splitAndSave(current, first_current_use, unhandled);
+      splitAndSave(
+          current,
+          findSplitPos(current_start, first_current_use),
+          unhandled);
     }
   } else {
     current->allocateTo(reg);
@@ -854,6 +892,63 @@ LIRLocation LinearScanAllocator::getUseAtOrAfter(
   return *iter;
 }
 
+int LinearScanAllocator::loopDepth(LIRLocation loc) const {
+  int depth = 0;
+  for (auto& loop : loop_ranges_) {
+    if (loop.isInRange(loc)) {
+      depth++;
+    }
+  }
+  return depth;
+}
+
+LIRLocation LinearScanAllocator::findSplitPos(
+    LIRLocation min_loc,
+    LIRLocation max_loc) const {
+  // Splitting at the start of a basic block puts the move on the incoming
+  // edges, so a boundary is as good as the block ending there. Take the latest
+  // one that is least deeply nested, if it's better than max_loc itself.
+  LIRLocation split_pos = max_loc;
+  int split_depth = loopDepth(max_loc);
+  auto iter =
+      std::upper_bound(block_starts_.begin(), block_starts_.end(), min_loc);
+  for (; iter != block_starts_.end() && *iter <= max_loc; ++iter) {
+    int depth = loopDepth(*iter - 1);
+    if (depth < split_depth || (depth == split_depth && split_pos != max_loc)) {
+      split_pos = *iter;
+      split_depth = depth;
+    }
+  }
+  return split_pos;
+}
+
+PhyLocation LinearScanAllocator::getRegisterHint(
+    const LiveInterval* current) const {
+  // only the first interval of a vreg starts at its definition.
+  if (vreg_last_allocated_.count(current->vreg)) {
+    return PhyLocation::REG_INVALID;
+  }
+  const Instruction* instr = current->vreg->instr();
+  if (instr == nullptr ||
+      (!instr->isPhi() && instr->opcode() != Instruction::kMove)) {
+    return PhyLocation::REG_INVALID;
+  }
+
+  for (size_t i = 0; i < instr->getNumInputs(); i++) {
+    const OperandBase* input = instr->getInput(i);
+    if (!input->isLinked()) {
+      continue;
+    }
+    const LiveInterval* source =
+        map_get(vreg_last_allocated_, input->getDefine(), nullptr);
+    if (source != nullptr && source->isRegisterAllocated() &&
+        source->vreg->isFp() == current->vreg->isFp()) {
+      return source->allocated_loc;
+    }
+  }
+  return PhyLocation::REG_INVALID;
+}
+
 void LinearScanAllocator::markDisallowedRegisters(
     std::vector<LIRLocation>& locs) {
   auto stack_registers = STACK_REGISTERS;
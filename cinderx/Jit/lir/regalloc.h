@@ -185,6 +185,15 @@ class LinearScanAllocator {
   // the global last use of an operand (vreg)
   UnorderedMap<const lir::Operand*, LIRLocation> vreg_global_last_use_;
 
+  // loops as ranges from the loop header to the loop end, and the start
+  // location of each basic block in ascending order.
+  std::vector<LiveRange> loop_ranges_;
+  std::vector<LIRLocation> block_starts_;
+
+  // the most recently allocated interval of each vreg, used as register hints
+  // for the vregs it is copied into.
+  UnorderedMap<const lir::Operand*, const LiveInterval*> vreg_last_allocated_;
+
   int initial_max_stack_slot_;
   int max_stack_slot_;
   std::vector<int> free_stack_slots_;
@@ -242,6 +251,18 @@ class LinearScanAllocator {
       UnhandledQueue& unhandled);
   LIRLocation getUseAtOrAfter(const lir::Operand* vreg, LIRLocation loc) const;
 
+  // number of loops containing the location loc.
+  int loopDepth(LIRLocation loc) const;
+
+  // find a location in (min_loc, max_loc] to split an interval at. Prefers
+  // basic block boundaries outside of loops, so that the move resulting from
+  // the split is not executed on every iteration.
+  LIRLocation findSplitPos(LIRLocation min_loc, LIRLocation max_loc) const;
+
+  // return the register the vreg of current was copied from (by a Move or a
+  // Phi) if that is a good candidate to coalesce with, or REG_INVALID.
+  PhyLocation getRegisterHint(const LiveInterval* current) const;
+
   // split at loc and save the new interval to unhandled and allocated_
   void
   splitAndSave(LiveInterval* interval, LIRLocation loc, UnhandledQueue& queue);
@@ -333,6 +354,8 @@ class LinearScanAllocator {
 
   FRIEND_TEST(LinearScanAllocatorTest, RegAllocationNoSpill);
   FRIEND_TEST(LinearScanAllocatorTest, RegAllocation);
+  FRIEND_TEST(LinearScanAllocatorTest, LoopSpillsValueUsedAfterLoop);
+  FRIEND_TEST(LinearScanAllocatorTest, SplitReloadsAtLoopEntry);
 };
 
 std::ostream& operator<<(std::ostream& out, const LiveRange& rhs);
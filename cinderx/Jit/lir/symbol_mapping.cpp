@@ -9,6 +9,9 @@ namespace jit::lir {
 const std::unordered_map<std::string, uint64_t> kSymbolMapping = {
     {"PyType_IsSubtype", reinterpret_cast<uint64_t>(PyType_IsSubtype)},
     {"PyErr_Format", reinterpret_cast<uint64_t>(PyErr_Format)},
+    {"PyErr_SetString", reinterpret_cast<uint64_t>(PyErr_SetString)},
+    {"PyExc_IndexError", reinterpret_cast<uint64_t>(PyExc_IndexError)},
+    {"PyExc_OverflowError", reinterpret_cast<uint64_t>(PyExc_OverflowError)},
     {"PyExc_TypeError", reinterpret_cast<uint64_t>(PyExc_TypeError)},
     {"PyLong_FromLong", reinterpret_cast<uint64_t>(PyLong_FromLong)},
     {"PyLong_FromUnsignedLong",
@@ -17,6 +20,10 @@ const std::unordered_map<std::string, uint64_t> kSymbolMapping = {
     {"PyLong_FromSize_t", reinterpret_cast<uint64_t>(PyLong_FromSize_t)},
     {"PyLong_AsSize_t", reinterpret_cast<uint64_t>(PyLong_AsSize_t)},
     {"PyLong_AsSsize_t", reinterpret_cast<uint64_t>(PyLong_AsSsize_t)},
+    {"PyObject_Size", reinterpret_cast<uint64_t>(PyObject_Size)},
+    {"_Py_FalseStruct", reinterpret_cast<uint64_t>(&_Py_FalseStruct)},
+    {"_Py_NoneStruct", reinterpret_cast<uint64_t>(&_Py_NoneStruct)},
+    {"_Py_TrueStruct", reinterpret_cast<uint64_t>(&_Py_TrueStruct)},
 };
 
 } // namespace jit::lir
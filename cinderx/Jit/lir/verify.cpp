@@ -5,6 +5,9 @@
 #include "cinderx/Jit/lir/dce.h"
 #include "cinderx/Jit/lir/instruction.h"
 #include "cinderx/Jit/lir/printer.h"
+#include "cinderx/Jit/lir/verify.h"
+
+#include <unordered_set>
 
 namespace jit::lir {
 
@@ -51,4 +54,165 @@ bool verifyPostRegAllocInvariants(Function* func, std::ostream& err) {
   return true;
 }
 
+bool verifyCHelperTranslation(const Function* func, std::ostream& err) {
+  auto& blocks = func->basicblocks();
+  if (blocks.empty()) {
+    fmt::print(err, "ERROR: Function has no basic blocks.\n");
+    return false;
+  }
+  const BasicBlock* entry_block = func->getEntryBlock();
+  const BasicBlock* exit_block = blocks.back();
+  if (!entry_block->predecessors().empty()) {
+    fmt::print(
+        err, "ERROR: Entry block {} has predecessors.\n", entry_block->id());
+    return false;
+  }
+  if (!exit_block->successors().empty() ||
+      !exit_block->instructions().empty()) {
+    fmt::print(err, "ERROR: Exit block {} is not empty.\n", exit_block->id());
+    return false;
+  }
+
+  size_t num_returns = 0;
+  for (const BasicBlock* block : blocks) {
+    auto& succs = block->successors();
+    if (block != exit_block && succs.empty()) {
+      fmt::print(
+          err,
+          "ERROR: Basic block {} has no successors but is not the exit "
+          "block.\n",
+          block->id());
+      return false;
+    }
+    if (succs.size() > 2) {
+      fmt::print(
+          err, "ERROR: Basic block {} has too many successors.\n", block->id());
+      return false;
+    }
+    const Instruction* last = block->getLastInstr();
+    bool ends_in_branch = last != nullptr && last->isCondBranch();
+    if ((succs.size() == 2) != ends_in_branch) {
+      fmt::print(
+          err,
+          "ERROR: Basic block {} must end in a CondBranch exactly when it has "
+          "two successors.\n",
+          block->id());
+      return false;
+    }
+
+    // Instructions defined so far in this block.
+    std::unordered_set<const Instruction*> defined;
+    bool in_phis = true;
+    bool in_load_args = block == entry_block;
+    for (auto& instr : block->instructions()) {
+      if (instr->isPhi()) {
+        if (!in_phis) {
+          fmt::print(
+              err,
+              "ERROR: Phi {} is not at the start of basic block {}.\n",
+              instr->id(),
+              block->id());
+          return false;
+        }
+        if (instr->getNumInputs() != 2 * block->predecessors().size()) {
+          fmt::print(
+              err,
+              "ERROR: Phi {} does not have one input per predecessor.\n",
+              instr->id());
+          return false;
+        }
+        for (const BasicBlock* pred : block->predecessors()) {
+          if (instr->getOperandByPredecessor(pred) == nullptr) {
+            fmt::print(
+                err,
+                "ERROR: Phi {} has no input for predecessor {}.\n",
+                instr->id(),
+                pred->id());
+            return false;
+          }
+        }
+        defined.insert(instr.get());
+        continue;
+      }
+      in_phis = false;
+
+      if (instr->isLoadArg()) {
+        if (!in_load_args || instr->getNumInputs() != 1 ||
+            !instr->getInput(0)->isImm()) {
+          fmt::print(
+              err,
+              "ERROR: LoadArg {} must be at the start of the entry block and "
+              "take an immediate.\n",
+              instr->id());
+          return false;
+        }
+      } else {
+        in_load_args = false;
+      }
+
+      if ((instr->isCondBranch() || instr->isReturn()) &&
+          instr.get() != last) {
+        fmt::print(
+            err,
+            "ERROR: Instruction {} must be the last one in basic block {}.\n",
+            instr->id(),
+            block->id());
+        return false;
+      }
+      if (instr->isReturn()) {
+        if (succs.size() != 1 || succs[0] != exit_block ||
+            instr->getNumInputs() != 1) {
+          fmt::print(
+              err,
+              "ERROR: Return {} must return one value to the exit block.\n",
+              instr->id());
+          return false;
+        }
+        num_returns++;
+      }
+
+      bool ok = true;
+      auto check_def = [&](const OperandBase* opnd) {
+        if (!opnd->isLinked()) {
+          return;
+        }
+        const Instruction* def = opnd->getDefine()->instr();
+        if (def->basicblock()->function() != func ||
+            (def->basicblock() == block && !defined.count(def))) {
+          ok = false;
+        }
+      };
+      auto check_operand = [&](const OperandBase* opnd) {
+        check_def(opnd);
+        if (opnd->isInd()) {
+          auto ind = opnd->getMemoryIndirect();
+          check_def(ind->getBaseRegOperand());
+          if (ind->getIndexRegOperand() != nullptr) {
+            check_def(ind->getIndexRegOperand());
+          }
+        }
+      };
+      instr->foreachInputOperand(check_operand);
+      check_operand(instr->output());
+      if (!ok) {
+        fmt::print(
+            err,
+            "ERROR: Instruction {} uses a value before it is defined.\n",
+            instr->id());
+        return false;
+      }
+      defined.insert(instr.get());
+    }
+  }
+
+  if (num_returns != 0 && num_returns != exit_block->predecessors().size()) {
+    fmt::print(
+        err,
+        "ERROR: Only some predecessors of exit block {} return a value.\n",
+        exit_block->id());
+    return false;
+  }
+  return true;
+}
+
 } // namespace jit::lir
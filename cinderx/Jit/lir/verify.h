@@ -16,4 +16,20 @@ namespace jit::lir {
 // register allocation.
 bool verifyPostRegAllocInvariants(Function* func, std::ostream& err);
 
+// Verifies that a LIR function parsed from a C helper translation has the
+// shape the LIR inliner expects:
+//
+// - The entry block has no predecessors, and the last block is an empty exit
+//   block that is the only block without successors.
+// - LoadArg instructions only appear at the start of the entry block.
+// - Blocks with two successors end in a CondBranch, and Returns only end
+//   blocks whose single successor is the exit block. Either every predecessor
+//   of the exit block returns a value or none of them do.
+// - Phis are at the start of their block and have one input per predecessor.
+// - Every instruction input is defined before it is used within a block.
+//
+// Returns true if the function is safe to hand to the inliner. Otherwise,
+// writes a description of the first problem found to err.
+bool verifyCHelperTranslation(const Function* func, std::ostream& err);
+
 } // namespace jit::lir
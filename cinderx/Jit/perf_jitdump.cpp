@@ -7,6 +7,7 @@
 #include "cinderx/Common/util.h"
 #include "pycore_ceval.h"
 
+#include "cinderx/Jit/debug_info.h"
 #include "cinderx/Jit/pyjit.h"
 #include "cinderx/Jit/threaded_compile.h"
 
@@ -18,6 +19,7 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -26,6 +28,7 @@
 #include <regex>
 #include <sstream>
 #include <tuple>
+#include <unordered_map>
 
 #ifdef __x86_64__
 // Use the cheaper rdtsc by default. If you disable this for some reason, or
@@ -147,6 +150,224 @@ struct CodeLoadRecord : RecordHeader {
   uint64_t code_index;
 };
 
+struct CodeDebugInfoRecord : RecordHeader {
+  uint64_t code_addr;
+  uint64_t nr_entry;
+};
+
+// Followed by the NUL-terminated source file name.
+struct DebugEntry {
+  uint64_t addr;
+  int32_t lineno;
+  int32_t discrim;
+};
+
+// Followed by the .eh_frame data and then its .eh_frame_hdr.
+struct CodeUnwindingInfoRecord : RecordHeader {
+  uint64_t unwinding_size;
+  uint64_t eh_frame_hdr_size;
+  uint64_t mapped_size;
+};
+
+struct EhFrameHeader {
+  uint8_t version;
+  uint8_t eh_frame_ptr_enc;
+  uint8_t fde_count_enc;
+  uint8_t table_enc;
+  int32_t eh_frame_ptr;
+  uint32_t fde_count;
+  int32_t initial_loc;
+  int32_t fde_addr;
+};
+
+// DWARF pointer encodings and call frame instructions used in .eh_frame.
+constexpr uint8_t kDwEhPeUdata4 = 0x03;
+constexpr uint8_t kDwEhPeSdata4 = 0x0b;
+constexpr uint8_t kDwEhPePcrel = 0x10;
+constexpr uint8_t kDwEhPeDatarel = 0x30;
+constexpr uint8_t kDwCfaAdvanceLoc = 0x40;
+constexpr uint8_t kDwCfaOffset = 0x80;
+constexpr uint8_t kDwCfaRestore = 0xc0;
+constexpr uint8_t kDwCfaNop = 0x00;
+constexpr uint8_t kDwCfaAdvanceLoc1 = 0x02;
+constexpr uint8_t kDwCfaAdvanceLoc2 = 0x03;
+constexpr uint8_t kDwCfaAdvanceLoc4 = 0x04;
+constexpr uint8_t kDwCfaDefCfa = 0x0c;
+constexpr uint8_t kDwCfaDefCfaRegister = 0x0d;
+constexpr uint8_t kDwCfaDefCfaOffset = 0x0e;
+
+// x86-64 DWARF register numbers.
+constexpr uint8_t kDwRegRbp = 6;
+constexpr uint8_t kDwRegRsp = 7;
+constexpr uint8_t kDwRegRip = 16;
+
+// Sizes of `push rbp` and `mov rbp, rsp`.
+constexpr size_t kPushRbpSize = 1;
+constexpr size_t kMovRbpRspSize = 3;
+
+class ByteWriter {
+ public:
+  void u8(uint8_t value) {
+    bytes_.push_back(value);
+  }
+
+  void u16(uint16_t value) {
+    append(&value, sizeof(value));
+  }
+
+  void u32(uint32_t value) {
+    append(&value, sizeof(value));
+  }
+
+  void uleb128(uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      bytes_.push_back(value != 0 ? (byte | 0x80) : byte);
+    } while (value != 0);
+  }
+
+  void sleb128(int64_t value) {
+    while (true) {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      bool done = (value == 0 && !(byte & 0x40)) ||
+          (value == -1 && (byte & 0x40));
+      bytes_.push_back(done ? byte : (byte | 0x80));
+      if (done) {
+        return;
+      }
+    }
+  }
+
+  void patchU32(size_t offset, uint32_t value) {
+    std::memcpy(&bytes_[offset], &value, sizeof(value));
+  }
+
+  void alignWithNops(size_t alignment) {
+    while (bytes_.size() % alignment != 0) {
+      bytes_.push_back(kDwCfaNop);
+    }
+  }
+
+  size_t size() const {
+    return bytes_.size();
+  }
+
+  const std::vector<uint8_t>& bytes() const {
+    return bytes_;
+  }
+
+ private:
+  void append(const void* data, size_t size) {
+    auto begin = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), begin, begin + size);
+  }
+
+  std::vector<uint8_t> bytes_;
+};
+
+size_t roundUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Build .eh_frame data with one CIE and one FDE covering a code section of
+// code_size bytes, where frame_entries are the section-relative offsets of
+// each frame setup sequence. Sets fde_offset to the offset of the FDE.
+//
+// perf inject places .eh_frame right after the code, rounded up to 8 bytes,
+// followed by .eh_frame_hdr, which is what the pc-relative addresses here
+// are computed against.
+std::vector<uint8_t> buildEhFrame(
+    size_t code_size,
+    const std::vector<size_t>& frame_entries,
+    size_t& fde_offset) {
+  ByteWriter w;
+
+  // CIE. On entry to a function the return address is at the top of the
+  // stack.
+  w.u32(0); // length, patched below
+  w.u32(0); // CIE id
+  w.u8(1); // version
+  w.u8('z');
+  w.u8('R');
+  w.u8(0);
+  w.uleb128(1); // code alignment factor
+  w.sleb128(-8); // data alignment factor
+  w.uleb128(kDwRegRip);
+  w.uleb128(1); // augmentation data length
+  w.u8(kDwEhPePcrel | kDwEhPeSdata4);
+  w.u8(kDwCfaDefCfa);
+  w.uleb128(kDwRegRsp);
+  w.uleb128(8);
+  w.u8(kDwCfaOffset | kDwRegRip);
+  w.uleb128(1);
+  w.alignWithNops(8);
+  w.patchU32(0, w.size() - sizeof(uint32_t));
+
+  // FDE.
+  fde_offset = w.size();
+  w.u32(0); // length, patched below
+  w.u32(w.size()); // offset back to the CIE
+  w.u32(static_cast<uint32_t>(
+      -static_cast<int64_t>(roundUp(code_size, 8) + w.size())));
+  w.u32(code_size);
+  w.uleb128(0); // augmentation data length
+
+  size_t loc = 0;
+  auto advance_to = [&](size_t target) {
+    size_t delta = target - loc;
+    if (delta == 0) {
+      return;
+    } else if (delta < 0x40) {
+      w.u8(kDwCfaAdvanceLoc | delta);
+    } else if (delta <= UINT8_MAX) {
+      w.u8(kDwCfaAdvanceLoc1);
+      w.u8(delta);
+    } else if (delta <= UINT16_MAX) {
+      w.u8(kDwCfaAdvanceLoc2);
+      w.u16(delta);
+    } else {
+      w.u8(kDwCfaAdvanceLoc4);
+      w.u32(delta);
+    }
+    loc = target;
+  };
+  // Outside of the frame setup sequences, rbp points at the saved rbp with
+  // the return address above it. This also holds for generators, whose
+  // suspend data footer mirrors that layout.
+  auto rbp_frame = [&] {
+    w.u8(kDwCfaDefCfa);
+    w.uleb128(kDwRegRbp);
+    w.uleb128(16);
+    w.u8(kDwCfaOffset | kDwRegRbp);
+    w.uleb128(2);
+  };
+
+  if (frame_entries.empty() || frame_entries.front() != 0) {
+    rbp_frame();
+  }
+  for (size_t entry : frame_entries) {
+    advance_to(entry);
+    w.u8(kDwCfaDefCfa);
+    w.uleb128(kDwRegRsp);
+    w.uleb128(8);
+    w.u8(kDwCfaRestore | kDwRegRbp);
+    advance_to(entry + kPushRbpSize);
+    w.u8(kDwCfaDefCfaOffset);
+    w.uleb128(16);
+    w.u8(kDwCfaOffset | kDwRegRbp);
+    w.uleb128(2);
+    advance_to(entry + kPushRbpSize + kMovRbpRspSize);
+    w.u8(kDwCfaDefCfaRegister);
+    w.uleb128(kDwRegRbp);
+  }
+  w.alignWithNops(8);
+  w.patchU32(fde_offset, w.size() - fde_offset - sizeof(uint32_t));
+
+  return w.bytes();
+}
+
 // The gettid() syscall doesn't have a C wrapper.
 pid_t gettid() {
   return syscall(SYS_gettid);
@@ -455,6 +676,107 @@ void copyFileInfo(FileInfo& info) {
   }
 }
 
+// Write a JIT_CODE_DEBUG_INFO record mapping addresses in [code, code + size)
+// to source lines. Inlined code is attributed to the innermost function, since
+// each entry only has room for one location.
+void writeDebugInfoRecord(
+    std::FILE* file,
+    const std::vector<std::pair<uintptr_t, UnitCallStack>>& call_stacks,
+    uintptr_t code,
+    std::size_t size) {
+  std::unordered_map<PyCodeObject*, std::string> filenames;
+  std::vector<std::pair<DebugEntry, const std::string*>> entries;
+  for (auto& [addr, call_stack] : call_stacks) {
+    if (addr < code || addr >= code + size || call_stack.empty()) {
+      continue;
+    }
+    const CodeObjLoc& loc = call_stack.back();
+    int lineno = loc.lineNo();
+    if (lineno < 0) {
+      continue;
+    }
+    auto [it, inserted] = filenames.try_emplace(loc.code.get());
+    if (inserted) {
+      it->second = unicodeAsString(loc.code->co_filename);
+    }
+    entries.emplace_back(DebugEntry{addr, lineno, 0}, &it->second);
+  }
+  if (entries.empty()) {
+    return;
+  }
+
+  CodeDebugInfoRecord record;
+  record.type = JIT_CODE_DEBUG_INFO;
+  record.total_size = sizeof(record);
+  for (auto& [entry, filename] : entries) {
+    record.total_size += sizeof(entry) + filename->size() + 1;
+  }
+  record.timestamp = getTimestamp();
+  record.code_addr = code;
+  record.nr_entry = entries.size();
+
+  std::fwrite(&record, sizeof(record), 1, file);
+  for (auto& [entry, filename] : entries) {
+    std::fwrite(&entry, sizeof(entry), 1, file);
+    std::fwrite(filename->c_str(), 1, filename->size() + 1, file);
+  }
+}
+
+// Write a JIT_CODE_UNWINDING_INFO record for the code section [code, code +
+// size), which perf applies to the next JIT_CODE_LOAD record.
+void writeUnwindingInfoRecord(
+    std::FILE* file,
+    const std::vector<uintptr_t>& frame_entries,
+    uintptr_t code,
+    std::size_t size) {
+#ifdef __x86_64__
+  std::vector<size_t> offsets;
+  for (uintptr_t entry : frame_entries) {
+    if (entry >= code && entry < code + size) {
+      offsets.push_back(entry - code);
+    }
+  }
+  std::sort(offsets.begin(), offsets.end());
+
+  size_t fde_offset;
+  std::vector<uint8_t> eh_frame = buildEhFrame(size, offsets, fde_offset);
+
+  int32_t eh_frame_size = eh_frame.size();
+  EhFrameHeader header;
+  header.version = 1;
+  header.eh_frame_ptr_enc = kDwEhPePcrel | kDwEhPeSdata4;
+  header.fde_count_enc = kDwEhPeUdata4;
+  header.table_enc = kDwEhPeDatarel | kDwEhPeSdata4;
+  header.eh_frame_ptr = -(eh_frame_size +
+                          static_cast<int32_t>(
+                              offsetof(EhFrameHeader, eh_frame_ptr)));
+  header.fde_count = 1;
+  header.initial_loc =
+      -(static_cast<int32_t>(roundUp(size, 8)) + eh_frame_size);
+  header.fde_addr = -(eh_frame_size - static_cast<int32_t>(fde_offset));
+
+  CodeUnwindingInfoRecord record;
+  record.type = JIT_CODE_UNWINDING_INFO;
+  record.unwinding_size = eh_frame.size() + sizeof(header);
+  record.eh_frame_hdr_size = sizeof(header);
+  record.mapped_size = roundUp(record.unwinding_size, 16);
+  size_t content_size = sizeof(record) + record.unwinding_size;
+  record.total_size = roundUp(content_size, 8);
+  record.timestamp = getTimestamp();
+
+  std::fwrite(&record, sizeof(record), 1, file);
+  std::fwrite(eh_frame.data(), 1, eh_frame.size(), file);
+  std::fwrite(&header, sizeof(header), 1, file);
+  static const char kPadding[8] = {};
+  std::fwrite(kPadding, 1, record.total_size - content_size, file);
+#else
+  (void)file;
+  (void)frame_entries;
+  (void)code;
+  (void)size;
+#endif
+}
+
 void copyParentPidMap() {
   copyFileInfo(g_pid_map);
 }
@@ -483,7 +805,8 @@ void copyJitdumpFile() {
 void registerFunction(
     const std::vector<std::pair<void*, std::size_t>>& code_sections,
     const std::string& name,
-    const std::string& prefix) {
+    const std::string& prefix,
+    const FunctionInfo* info) {
   ThreadedCompileSerialize guard;
 
   initFiles();
@@ -500,12 +823,23 @@ void registerFunction(
     // Make sure no parent or child process writes concurrently.
     ExclusiveFileLock write_lock(file);
 
+    std::vector<std::pair<uintptr_t, UnitCallStack>> call_stacks;
+    if (info != nullptr && info->debug_info != nullptr) {
+      call_stacks = info->debug_info->getAllUnitCallStacks();
+    }
+
     static uint64_t code_index = 0;
     for (auto& section_and_size : code_sections) {
       auto const prefixed_name = prefix + ":" + name;
 
       void* code = section_and_size.first;
       std::size_t size = section_and_size.second;
+      auto code_addr = reinterpret_cast<uintptr_t>(code);
+      if (info != nullptr) {
+        writeDebugInfoRecord(file, call_stacks, code_addr, size);
+        writeUnwindingInfoRecord(file, info->frame_entries, code_addr, size);
+      }
+
       CodeLoadRecord record;
       record.type = JIT_CODE_LOAD;
 
@@ -3,9 +3,14 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+namespace jit {
+class DebugInfo;
+}
+
 namespace jit::perf {
 
 extern const std::string kDefaultSymbolPrefix;
@@ -25,10 +30,22 @@ extern int jit_perfmap;
 //                   directory.
 extern std::string perf_jitdump_dir;
 
+// Extra information about a compiled function, used to emit jitdump debug
+// info and unwinding records ahead of its code load records.
+struct FunctionInfo {
+  // Source locations for addresses in the generated code. May be null.
+  const DebugInfo* debug_info{nullptr};
+
+  // Address of every `push rbp; mov rbp, rsp` sequence in the generated code.
+  // Everywhere else, the canonical frame address is rbp + 16.
+  std::vector<uintptr_t> frame_entries;
+};
+
 void registerFunction(
     const std::vector<std::pair<void*, std::size_t>>& code_sections,
     const std::string& name,
-    const std::string& prefix = kDefaultSymbolPrefix);
+    const std::string& prefix = kDefaultSymbolPrefix,
+    const FunctionInfo* info = nullptr);
 
 // After-fork callback for child processes. Performs any cleanup necessary for
 // per-process state, including handling of Linux perf pid maps.
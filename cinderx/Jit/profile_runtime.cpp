@@ -13,8 +13,10 @@
 
 #include <folly/tracing/StaticTracepoint.h>
 
+#include <algorithm>
 #include <fstream>
 #include <istream>
+#include <optional>
 #include <ostream>
 
 namespace jit {
@@ -124,6 +126,76 @@ std::vector<hir::Type> ProfileRuntime::getProfiledTypes(
   return result;
 }
 
+std::vector<BorrowedRef<PyTypeObject>> ProfileRuntime::getProfiledTypeRows(
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) const {
+  std::vector<BorrowedRef<PyTypeObject>> result;
+
+  // Always prioritize profiles loaded from a file.
+  auto loaded_it = loaded_profiles_.find(codeKey(code));
+  if (loaded_it != loaded_profiles_.end()) {
+    auto types_it = loaded_it->second.find(bc_off);
+    if (types_it != loaded_it->second.end()) {
+      for (auto const& row : types_it->second) {
+        if (row.empty()) {
+          return {};
+        }
+        BorrowedRef<PyTypeObject> py_type = s_live_types.get(row[0]);
+        if (py_type == nullptr) {
+          return {};
+        }
+        result.emplace_back(py_type);
+      }
+      return result;
+    }
+  }
+
+  auto code_it = profiles_.find(code);
+  if (code_it == profiles_.end()) {
+    return {};
+  }
+  auto& typed_hits = code_it->second.typed_hits;
+  auto type_profiler_it = typed_hits.find(bc_off);
+  if (type_profiler_it == typed_hits.end()) {
+    return {};
+  }
+  auto& type_profiler = type_profiler_it->second;
+  if (type_profiler->empty() || type_profiler->other() > 0) {
+    return {};
+  }
+
+  std::vector<int> rows;
+  for (int row = 0; row < type_profiler->rows(); ++row) {
+    if (type_profiler->count(row) > 0 &&
+        type_profiler->type(row, 0) != nullptr) {
+      rows.push_back(row);
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(), [&](int a, int b) {
+    return type_profiler->count(a) > type_profiler->count(b);
+  });
+  for (int row : rows) {
+    result.emplace_back(type_profiler->type(row, 0));
+  }
+  return result;
+}
+
+BranchProfile ProfileRuntime::getBranchProfile(
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) const {
+  auto code_it = profiles_.find(code);
+  if (code_it == profiles_.end()) {
+    return {};
+  }
+  return map_get(code_it->second.branch_hits, bc_off, BranchProfile{});
+}
+
+const CodeProfile* ProfileRuntime::codeProfile(
+    BorrowedRef<PyCodeObject> code) const {
+  auto code_it = profiles_.find(code);
+  return code_it == profiles_.end() ? nullptr : &code_it->second;
+}
+
 std::vector<hir::Type> ProfileRuntime::getLoadedProfiledTypes(
     CodeKey code,
     BCOffset bc_off) const {
@@ -157,6 +229,25 @@ std::vector<hir::Type> ProfileRuntime::getLoadedProfiledTypes(
   return result;
 }
 
+// Get the truthiness of a value when it can be computed without calling into
+// Python code, which could have side effects.
+static std::optional<bool> knownTruthiness(PyObject* obj) {
+  if (obj == Py_True) {
+    return true;
+  }
+  if (obj == Py_False || obj == Py_None) {
+    return false;
+  }
+  if (PyLong_CheckExact(obj) || PyList_CheckExact(obj) ||
+      PyTuple_CheckExact(obj)) {
+    return Py_SIZE(obj) != 0;
+  }
+  if (PyDict_CheckExact(obj)) {
+    return PyDict_GET_SIZE(obj) != 0;
+  }
+  return std::nullopt;
+}
+
 void ProfileRuntime::profileInstr(
     BorrowedRef<PyFrameObject> frame,
     PyObject** stack_top,
@@ -192,6 +283,23 @@ void ProfileRuntime::profileInstr(
     pair.first->second->recordTypes(get_type(stack_offsets)...);
   };
 
+  switch (opcode) {
+    case JUMP_IF_FALSE_OR_POP:
+    case JUMP_IF_TRUE_OR_POP:
+    case POP_JUMP_IF_FALSE:
+    case POP_JUMP_IF_TRUE: {
+      std::optional<bool> truthy = knownTruthiness(stack_top[-1]);
+      if (truthy.has_value()) {
+        int opcode_offset = frame->f_lasti * sizeof(_Py_CODEUNIT);
+        BranchProfile& branch =
+            profiles_[Ref<PyCodeObject>::create(frame->f_code)]
+                .branch_hits[BCOffset{opcode_offset}];
+        (*truthy ? branch.true_count : branch.false_count)++;
+      }
+      break;
+    }
+  }
+
   // TODO(T127457244): Centralize the information about which stack inputs are
   // interesting for which opcodes.
   switch (opcode) {
@@ -313,6 +421,9 @@ void ProfileRuntime::profileInstr(
     }
 
     // The below are all shadow bytecodes that will be removed with 3.12.
+    case FOR_ITER_LIST:
+    case FOR_ITER_RANGE:
+    case FOR_ITER_TUPLE:
     case LOAD_ATTR_DICT_DESCR:
     case LOAD_ATTR_DICT_NO_DESCR:
     case LOAD_ATTR_MODULE:
@@ -339,10 +450,14 @@ void ProfileRuntime::profileInstr(
     case LOAD_PRIMITIVE_FIELD:
       profile_stack(0);
       break;
+    case BINARY_ADD_FLOAT:
+    case BINARY_ADD_INT:
     case BINARY_SUBSCR_DICT:
     case BINARY_SUBSCR_DICT_STR:
     case BINARY_SUBSCR_LIST:
     case BINARY_SUBSCR_TUPLE:
+    case COMPARE_OP_INT:
+    case COMPARE_OP_STR:
     case STORE_ATTR_DESCR:
     case STORE_ATTR_DICT:
     case STORE_ATTR_SLOT:
@@ -351,6 +466,14 @@ void ProfileRuntime::profileInstr(
     case STORE_PRIMITIVE_FIELD:
       profile_stack(1, 0);
       break;
+    case STORE_SUBSCR_DICT:
+    case STORE_SUBSCR_LIST:
+      profile_stack(2, 1, 0);
+      break;
+    case CALL_FUNCTION_BUILTIN:
+    case CALL_FUNCTION_PY:
+      profile_stack(oparg);
+      break;
     case BINARY_SUBSCR_TUPLE_CONST_INT:
       // This instruction replaces a LOAD_CONST and a BINARY_SUBSCR.  The index
       // field is stored within the oparg instead of on the stack.
@@ -442,6 +565,23 @@ void ProfileRuntime::unregisterType(BorrowedRef<PyTypeObject> type) {
   s_live_types.erase(type);
 }
 
+void ProfileRuntime::recordGuardFailure(
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) {
+  guard_failures_[code].emplace(bc_off);
+}
+
+bool ProfileRuntime::hasGuardFailure(
+    BorrowedRef<PyCodeObject> code,
+    BCOffset bc_off) const {
+  auto it = guard_failures_.find(code);
+  return it != guard_failures_.end() && it->second.contains(bc_off);
+}
+
+void ProfileRuntime::unregisterCode(BorrowedRef<PyCodeObject> code) {
+  guard_failures_.erase(code);
+}
+
 void ProfileRuntime::setStripPattern(std::regex regex) {
   strip_pattern_ = std::move(regex);
 }
@@ -538,6 +678,7 @@ void ProfileRuntime::clear() {
   profiles_.clear();
   candidates_.clear();
   loaded_profiles_.clear();
+  guard_failures_.clear();
   s_live_types.clear();
 
   can_profile_ = true;
@@ -16,11 +16,20 @@
 
 namespace jit {
 
+// Number of times a conditional jump saw a true or false condition.  Only
+// conditions whose truthiness can be read without running Python code are
+// counted.
+struct BranchProfile {
+  uint32_t true_count{0};
+  uint32_t false_count{0};
+};
+
 // Profiling information for a PyCodeObject. Includes the total number of
 // bytecodes executed and type profiles for certain opcodes, keyed by bytecode
 // offset.
 struct CodeProfile {
   UnorderedMap<BCOffset, std::unique_ptr<TypeProfiler>> typed_hits;
+  UnorderedMap<BCOffset, BranchProfile> branch_hits;
   int64_t total_hits{0};
 };
 
@@ -68,6 +77,25 @@ class ProfileRuntime {
       const CodeKey& code_key,
       BCOffset bc_off) const;
 
+  // For a given code object and bytecode offset, get every type seen for the
+  // instruction's first input, most frequent first.  Unlike getProfiledTypes()
+  // this includes polymorphic bytecodes, but will be empty if more types were
+  // seen than the profiler could record.
+  std::vector<BorrowedRef<PyTypeObject>> getProfiledTypeRows(
+      BorrowedRef<PyCodeObject> code,
+      BCOffset bc_off) const;
+
+  // For a given code object and bytecode offset of a conditional jump, get how
+  // often its condition was true or false.  Will be all zeroes if the jump
+  // wasn't profiled.
+  BranchProfile getBranchProfile(
+      BorrowedRef<PyCodeObject> code,
+      BCOffset bc_off) const;
+
+  // Get everything profiled for a code object in this process, or nullptr if
+  // it hasn't been profiled.
+  const CodeProfile* codeProfile(BorrowedRef<PyCodeObject> code) const;
+
   // Record a type profile for an instruction and its current Python stack.
   void profileInstr(
       BorrowedRef<PyFrameObject> frame,
@@ -79,6 +107,17 @@ class ProfileRuntime {
   // frame, some of which may not have had their types recorded.
   void countProfiledInstrs(BorrowedRef<PyCodeObject> code, Py_ssize_t count);
 
+  // Record that a guard on the profiled types of an instruction failed in
+  // compiled code. Later compilations don't guard on that instruction's
+  // profiled types.
+  void recordGuardFailure(BorrowedRef<PyCodeObject> code, BCOffset bc_off);
+
+  // Check if a guard on the profiled types of an instruction has failed.
+  bool hasGuardFailure(BorrowedRef<PyCodeObject> code, BCOffset bc_off) const;
+
+  // Inform the profiling code that a code object is about to be destroyed.
+  void unregisterCode(BorrowedRef<PyCodeObject> code);
+
   // Check whether the given type has split dict keys primed from profile data,
   // which implies that they are unlikely to change at runtime.
   bool hasPrimedDictKeys(BorrowedRef<PyTypeObject> type) const;
@@ -156,6 +195,10 @@ class ProfileRuntime {
   // Profiles loaded from a file.
   UnorderedMap<CodeKey, CodeProfileData> loaded_profiles_;
 
+  // Instructions whose profiled types failed a guard in compiled code.
+  UnorderedMap<BorrowedRef<PyCodeObject>, UnorderedSet<BCOffset>>
+      guard_failures_;
+
   // Tracks split dict keys for profiled types.
   UnorderedMap<std::string, std::vector<std::string>> type_dict_keys_;
 
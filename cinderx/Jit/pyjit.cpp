@@ -27,25 +27,34 @@
 #include "cinderx/Jit/jit_flag_processor.h"
 #include "cinderx/Jit/jit_gdb_support.h"
 #include "cinderx/Jit/jit_list.h"
+#include "cinderx/Jit/jit_rt.h"
 #include "cinderx/Jit/jit_time_log.h"
 #include "cinderx/Jit/lir/inliner.h"
+#include "cinderx/Jit/lir/peephole.h"
 #include "cinderx/Jit/perf_jitdump.h"
 #include "cinderx/Jit/profile_runtime.h"
 #include "cinderx/Jit/runtime.h"
 #include "cinderx/Jit/type_profiler.h"
 
+#include <algorithm>
 #include <atomic>
 #include <charconv>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <type_traits>
 #include <unordered_set>
 #include <utility>
+#include <variant>
 
 #define DEFAULT_CODE_SIZE 2 * 1024 * 1024
 
@@ -92,6 +101,10 @@ static UnitDeletedCallback handle_unit_deleted_during_preload = nullptr;
 static std::unordered_map<BorrowedRef<PyCodeObject>, CodeData> jit_code_data;
 // Every unit has an entry in jit_preloaders during batch compile.
 static PreloaderMap jit_preloaders;
+// Preloaders for the job a background compile worker is currently compiling.
+// Background workers never look at jit_preloaders, which belongs to the
+// threads running Python code.
+static thread_local PreloaderMap* tls_job_preloaders{nullptr};
 
 namespace jit {
 
@@ -136,8 +149,10 @@ hir::Preloader* lookupPreloader(BorrowedRef<> unit) {
       "Compilation unit has to be a code object but is instead {}",
       typeFullname(Py_TYPE(code)));
 
-  auto it = jit_preloaders.find(code);
-  return it != jit_preloaders.end() ? it->second.get() : nullptr;
+  const PreloaderMap& preloaders =
+      tls_job_preloaders != nullptr ? *tls_job_preloaders : jit_preloaders;
+  auto it = preloaders.find(code);
+  return it != preloaders.end() ? it->second.get() : nullptr;
 }
 
 bool isPreloaded(BorrowedRef<> unit) {
@@ -204,8 +219,8 @@ struct CompilationTimer {
         std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
 
     double time = time_span.count();
-    total_compliation_time += time;
     jit::ThreadedCompileSerialize guard;
+    total_compliation_time += time;
     jit_time_functions.emplace(func, time_span);
   }
 
@@ -333,6 +348,44 @@ void initFlagProcessor() {
         },
         "Combined with -X jit-auto, configure the runtime to type profile each "
         "function for a number of calls before compiling it");
+    xarg_flag_processor
+        .addOption(
+            "jit-auto-background-workers",
+            "PYTHONJITAUTOBACKGROUNDWORKERS",
+            getMutableConfig().auto_jit_background_workers,
+            "Combined with -X jit-auto, compile hot functions on <COUNT> "
+            "background threads while they keep running in the interpreter")
+        .withFlagParamName("COUNT");
+    xarg_flag_processor
+        .addOption(
+            "jit-osr-threshold",
+            "PYTHONJITOSRTHRESHOLD",
+            [](unsigned threshold) {
+              getMutableConfig().osr_threshold = threshold;
+            },
+            "Move a running interpreted frame into JIT-compiled code once one "
+            "of its loops has taken <COUNT> back-edges")
+        .withFlagParamName("COUNT");
+    xarg_flag_processor
+        .addOption(
+            "jit-deopt-recompile-threshold",
+            "PYTHONJITDEOPTRECOMPILETHRESHOLD",
+            [](unsigned threshold) {
+              getMutableConfig().deopt_recompile_threshold = threshold;
+            },
+            "Recompile a function without its profile-based type guards once "
+            "they have failed <COUNT> times")
+        .withFlagParamName("COUNT");
+    xarg_flag_processor
+        .addOption(
+            "jit-max-recompiles",
+            "PYTHONJITMAXRECOMPILES",
+            [](unsigned max_recompiles) {
+              getMutableConfig().max_recompiles = max_recompiles;
+            },
+            "Combined with -X jit-deopt-recompile-threshold, recompile each "
+            "function at most <COUNT> times")
+        .withFlagParamName("COUNT");
 
     xarg_flag_processor.addOption(
         "jit-debug",
@@ -493,6 +546,12 @@ void initFlagProcessor() {
         g_disable_lir_inliner,
         "disable JIT lir inlining");
 
+    xarg_flag_processor.addOption(
+        "jit-disable-lir-peephole",
+        "PYTHONJITDISABLELIRPEEPHOLE",
+        [](std::string) { getMutableConfig().lir_peephole = false; },
+        "disable the JIT's LIR peephole optimizer");
+
     xarg_flag_processor.addOption(
         "jit-disable-huge-pages",
         "PYTHONJITDISABLEHUGEPAGES",
@@ -653,6 +712,16 @@ void initFlagProcessor() {
         dynamic_comparison_elim,
         "jit-dynamic-comparison-elim",
         "PYTHONJITDYNAMICCOMPARISIONELIM");
+    HIR_OPTIMIZATION_OPTION(
+        "escape analysis",
+        escape_analysis,
+        "jit-escape-analysis",
+        "PYTHONJITESCAPEANALYSIS");
+    HIR_OPTIMIZATION_OPTION(
+        "global value numbering",
+        global_value_numbering,
+        "jit-global-value-numbering",
+        "PYTHONJITGLOBALVALUENUMBERING");
     HIR_OPTIMIZATION_OPTION(
         "guard type removal",
         guard_type_removal,
@@ -663,6 +732,11 @@ void initFlagProcessor() {
         inliner,
         "jit-enable-hir-inliner",
         "PYTHONJITENABLEHIRINLINER");
+    HIR_OPTIMIZATION_OPTION(
+        "loop-invariant code motion",
+        loop_invariant_code_motion,
+        "jit-loop-invariant-code-motion",
+        "PYTHONJITLOOPINVARIANTCODEMOTION");
     HIR_OPTIMIZATION_OPTION(
         "phi elimination", phi_elim, "jit-phi-elim", "PYTHONJITPHIELIM");
     HIR_OPTIMIZATION_OPTION(
@@ -776,6 +850,31 @@ void initFlagProcessor() {
         },
         "Use inline caches for attribute access instructions");
 
+    xarg_flag_processor.addOption(
+        "jit-megamorphic-attr-cache",
+        "PYTHONJITMEGAMORPHICATTRCACHE",
+        [](int val) {
+          if (use_jit) {
+            getMutableConfig().megamorphic_attr_cache = !!val;
+          } else {
+            warnJITOff("jit-megamorphic-attr-cache");
+          }
+        },
+        "Back full attribute and method inline caches with a process-wide "
+        "lookup cache");
+
+    xarg_flag_processor.addOption(
+        "jit-devirtualize-methods",
+        "PYTHONJITDEVIRTUALIZEMETHODS",
+        [](int val) {
+          if (use_jit) {
+            getMutableConfig().devirtualize_methods = !!val;
+          } else {
+            warnJITOff("jit-devirtualize-methods");
+          }
+        },
+        "Call Static Python methods directly when no subclass overrides them");
+
     xarg_flag_processor.addOption(
         "jit-attr-cache-size",
         "PYTHONJITATTRCACHESIZE",
@@ -895,6 +994,203 @@ static void compile_worker_thread() {
   JIT_DLOG("Finished compile worker in thread {}", std::this_thread::get_id());
 }
 
+namespace {
+
+// A function that crossed the auto-JIT threshold and is waiting to be compiled
+// by a background worker. Preloading happens on the thread that queued the
+// function, so each job carries the preloaders for the function and its
+// dependencies.
+struct BackgroundCompileJob {
+  Ref<PyFunctionObject> func;
+  PreloaderMap preloaders;
+};
+
+// Work queue for the background compile workers. Jobs are pushed by threads
+// holding the GIL and popped by workers that don't hold it, so the queue has
+// its own lock. Jobs must be destroyed with the GIL held, since they own
+// references to Python objects.
+class BackgroundCompileQueue {
+ public:
+  void push(std::unique_ptr<BackgroundCompileJob> job) {
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      jobs_.emplace_back(std::move(job));
+    }
+    cond_.notify_one();
+  }
+
+  // Block until a job is available. Returns nullptr once the queue has been
+  // shut down. The job stays owned by the queue until it is passed to
+  // finish().
+  BackgroundCompileJob* pop() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    cond_.wait(guard, [&] { return shutdown_ || !jobs_.empty(); });
+    if (shutdown_) {
+      return nullptr;
+    }
+    in_flight_.emplace_back(std::move(jobs_.front()));
+    jobs_.pop_front();
+    return in_flight_.back().get();
+  }
+
+  std::unique_ptr<BackgroundCompileJob> finish(BackgroundCompileJob* job) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    auto it = std::find_if(
+        in_flight_.begin(), in_flight_.end(), [&](auto& j) {
+          return j.get() == job;
+        });
+    JIT_CHECK(it != in_flight_.end(), "Finished an unknown compile job");
+    std::unique_ptr<BackgroundCompileJob> result = std::move(*it);
+    in_flight_.erase(it);
+    return result;
+  }
+
+  // Stop handing out jobs and return the ones that were never started.
+  std::deque<std::unique_ptr<BackgroundCompileJob>> shutdown() {
+    std::deque<std::unique_ptr<BackgroundCompileJob>> pending;
+    {
+      std::lock_guard<std::mutex> guard{mutex_};
+      shutdown_ = true;
+      pending.swap(jobs_);
+    }
+    cond_.notify_all();
+    return pending;
+  }
+
+  // Functions that were queued or being compiled when the process forked. The
+  // lock isn't taken, since it may have been held by a thread that doesn't
+  // exist in the child.
+  std::vector<BorrowedRef<PyFunctionObject>> funcsAfterFork() const {
+    std::vector<BorrowedRef<PyFunctionObject>> funcs;
+    for (auto& job : jobs_) {
+      funcs.emplace_back(job->func);
+    }
+    for (auto& job : in_flight_) {
+      funcs.emplace_back(job->func);
+    }
+    return funcs;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::unique_ptr<BackgroundCompileJob>> jobs_;
+  std::vector<std::unique_ptr<BackgroundCompileJob>> in_flight_;
+  bool shutdown_{false};
+};
+
+struct BackgroundCompiler {
+  BackgroundCompileQueue queue;
+  std::vector<std::thread> workers;
+};
+
+} // namespace
+
+// Created when the first function is queued for background compilation.
+static BackgroundCompiler* g_background_compiler{nullptr};
+
+// Set once the background workers have been stopped for shutdown. Hot
+// functions are compiled on the calling thread from then on.
+static bool g_background_compile_stopped{false};
+
+static void background_compile_job(
+    BackgroundCompileQueue& queue,
+    BackgroundCompileJob* job) {
+  BorrowedRef<PyFunctionObject> func{job->func};
+  _PyJIT_Result result = PYJIT_RESULT_NO_PRELOADER;
+  tls_job_preloaders = &job->preloaders;
+  if (hir::Preloader* preloader = lookupPreloader(func)) {
+    CompilationTimer timer(func);
+    result = jit_ctx->compilePreloader(nullptr, *preloader);
+  }
+  tls_job_preloaders = nullptr;
+
+  // Installing the entry point and dropping the job's references both need
+  // the GIL, which the serialize guard takes on background workers.
+  ThreadedCompileSerialize guard;
+  if (_PyJIT_IsEnabled() && !jit_ctx->didCompile(func)) {
+    if (result == PYJIT_RESULT_OK) {
+      // This looks the code up using the function's current code object,
+      // globals, and builtins, so a function that was modified while it was
+      // queued doesn't get stale code.
+      jit_ctx->attachCompiledCode(func);
+    } else if (result == PYJIT_RESULT_RETRY) {
+      // Someone else is compiling the same code. Send the function back
+      // through auto-JIT rather than spinning here; its next call will queue
+      // it again or pick up the finished code.
+      PyEntry_init(func);
+    }
+  }
+  queue.finish(job).reset();
+}
+
+static void background_compile_worker_thread(BackgroundCompileQueue* queue) {
+  JIT_DLOG(
+      "Started background compile worker in thread {}",
+      std::this_thread::get_id());
+  // Keep a thread state for the lifetime of the worker, but only hold the GIL
+  // while touching data shared with the threads running Python code.
+  PyGILState_STATE gil_state = PyGILState_Ensure();
+  PyThreadState* tstate = PyEval_SaveThread();
+  ThreadedCompileContext::setBackgroundWorkerThread(true);
+  while (BackgroundCompileJob* job = queue->pop()) {
+    background_compile_job(*queue, job);
+  }
+  ThreadedCompileContext::setBackgroundWorkerThread(false);
+  PyEval_RestoreThread(tstate);
+  PyGILState_Release(gil_state);
+  JIT_DLOG(
+      "Finished background compile worker in thread {}",
+      std::this_thread::get_id());
+}
+
+static BackgroundCompiler& ensure_background_compiler() {
+  if (g_background_compiler == nullptr) {
+    g_background_compiler = new BackgroundCompiler();
+    size_t num_workers = getConfig().auto_jit_background_workers;
+    for (size_t i = 0; i < num_workers; i++) {
+      g_background_compiler->workers.emplace_back(
+          background_compile_worker_thread, &g_background_compiler->queue);
+    }
+  }
+  return *g_background_compiler;
+}
+
+// Stop the background compile workers, waiting for any compiles that are in
+// progress. Must be called with the GIL held, and before the runtime starts
+// finalizing, since the workers need the GIL to finish.
+static void stop_background_compile_workers() {
+  if (g_background_compiler == nullptr) {
+    return;
+  }
+  g_background_compile_stopped = true;
+  // Functions that were still queued just keep running in the interpreter.
+  auto pending = g_background_compiler->queue.shutdown();
+  Py_BEGIN_ALLOW_THREADS;
+  for (std::thread& worker : g_background_compiler->workers) {
+    worker.join();
+  }
+  Py_END_ALLOW_THREADS;
+  delete g_background_compiler;
+  g_background_compiler = nullptr;
+}
+
+// The worker threads don't survive a fork. Leak the parent's queue, whose lock
+// and threads can't be cleaned up, and send the functions that were waiting on
+// it back through auto-JIT so the child queues them again.
+static void reset_background_compile_after_fork() {
+  if (g_background_compiler == nullptr) {
+    return;
+  }
+  for (BorrowedRef<PyFunctionObject> func :
+       g_background_compiler->queue.funcsAfterFork()) {
+    if (!_PyJIT_IsCompiled(func)) {
+      PyEntry_init(func);
+    }
+  }
+  g_background_compiler = nullptr;
+}
+
 static void compile_perf_trampoline_entries() {
   for (const auto& unit : perf_trampoline_reg_units) {
     if (PyFunction_Check(unit)) {
@@ -1180,6 +1476,7 @@ static PyObject* dump_elf(PyObject* /* self */, PyObject* arg) {
   Py_ssize_t filename_size = 0;
   const char* filename = PyUnicode_AsUTF8AndSize(arg, &filename_size);
 
+  auto& profile_runtime = Runtime::get()->profileRuntime();
   std::vector<elf::CodeEntry> entries;
   for (BorrowedRef<PyFunctionObject> func : jit_ctx->compiledFuncs()) {
     BorrowedRef<PyCodeObject> code{func->func_code};
@@ -1192,6 +1489,7 @@ static PyObject* dump_elf(PyObject* /* self */, PyObject* arg) {
       entry.file_name = unicodeAsString(code->co_filename);
     }
     entry.lineno = code->co_firstlineno;
+    entry.code_key = profile_runtime.codeKey(code);
 
     entries.emplace_back(std::move(entry));
   }
@@ -1395,6 +1693,210 @@ Ref<> make_deopt_stats() {
   return stats;
 }
 
+void set_int_item(BorrowedRef<> dict, const char* key, int64_t value) {
+  auto value_obj = Ref<>::steal(check(PyLong_FromLongLong(value)));
+  check(PyDict_SetItemString(dict, key, value_obj));
+}
+
+void set_str_item(BorrowedRef<> dict, const char* key, const char* value) {
+  auto value_obj = Ref<>::steal(check(PyUnicode_FromString(value)));
+  check(PyDict_SetItemString(dict, key, value_obj));
+}
+
+// Per-bytecode-offset dicts for a function's performance report, created on
+// demand and emitted in offset order.
+class OffsetReports {
+ public:
+  explicit OffsetReports(BorrowedRef<PyCodeObject> code) : code_(code) {}
+
+  BorrowedRef<> at(BCOffset offset) {
+    Ref<>& dict = reports_[offset.value()];
+    if (dict == nullptr) {
+      dict = Ref<>::steal(check(PyDict_New()));
+      int lineno = code_->co_linetable != nullptr
+          ? PyCode_Addr2Line(code_, offset.value())
+          : -1;
+      set_int_item(dict, "lineno", lineno);
+    }
+    return dict;
+  }
+
+  // Get the list stored under key for the given offset, creating it if needed.
+  BorrowedRef<> list(BCOffset offset, const char* key) {
+    BorrowedRef<> dict = at(offset);
+    BorrowedRef<> list = PyDict_GetItemString(dict, key);
+    if (list == nullptr) {
+      auto new_list = Ref<>::steal(check(PyList_New(0)));
+      check(PyDict_SetItemString(dict, key, new_list));
+      list = new_list;
+    }
+    return list;
+  }
+
+  Ref<> toDict() const {
+    auto result = Ref<>::steal(check(PyDict_New()));
+    for (auto& [offset, dict] : reports_) {
+      auto offset_obj = Ref<>::steal(check(PyLong_FromLong(offset)));
+      check(PyDict_SetItem(result, offset_obj, dict));
+    }
+    return result;
+  }
+
+ private:
+  BorrowedRef<PyCodeObject> code_;
+  std::map<int, Ref<>> reports_;
+};
+
+void add_profile_report(OffsetReports& offsets, const CodeProfile& profile) {
+  for (auto& [offset, types] : profile.typed_hits) {
+    if (types->empty()) {
+      continue;
+    }
+    auto rows = Ref<>::steal(check(PyList_New(0)));
+    int64_t hits = types->other();
+    for (int row = 0; row < types->rows() && types->count(row) != 0; ++row) {
+      auto row_dict = Ref<>::steal(check(PyDict_New()));
+      auto type_names = Ref<>::steal(check(PyList_New(0)));
+      for (int col = 0; col < types->cols(); ++col) {
+        auto name = Ref<>::steal(check(
+            PyUnicode_FromString(typeFullname(types->type(row, col)).c_str())));
+        check(PyList_Append(type_names, name));
+      }
+      check(PyDict_SetItemString(row_dict, "types", type_names));
+      set_int_item(row_dict, "count", types->count(row));
+      check(PyList_Append(rows, row_dict));
+      hits += types->count(row);
+    }
+    BorrowedRef<> dict = offsets.at(offset);
+    set_int_item(dict, "profiled_hits", hits);
+    check(PyDict_SetItemString(dict, "profiled_types", rows));
+    set_int_item(dict, "profiled_other_types", types->other());
+  }
+  for (auto& [offset, branch] : profile.branch_hits) {
+    auto branch_dict = Ref<>::steal(check(PyDict_New()));
+    set_int_item(branch_dict, "true", branch.true_count);
+    set_int_item(branch_dict, "false", branch.false_count);
+    check(PyDict_SetItemString(offsets.at(offset), "branch", branch_dict));
+  }
+}
+
+void add_deopt_report(OffsetReports& offsets, BorrowedRef<PyCodeObject> code) {
+  Runtime* runtime = Runtime::get();
+  for (auto& [deopt_idx, stat] : runtime->deoptStats()) {
+    const DeoptMetadata& meta = runtime->getDeoptMetadata(deopt_idx);
+    if (meta.frame_meta.empty() || meta.frame_meta[0].code != code) {
+      continue;
+    }
+    // Deopts in inlined code are attributed to the call that was inlined.
+    BCOffset offset = meta.inline_depth() == 0
+        ? meta.instr_offset()
+        : meta.frame_meta[0].instr_offset();
+    auto deopt = Ref<>::steal(check(PyDict_New()));
+    set_str_item(deopt, "reason", deoptReasonName(meta.reason));
+    set_str_item(deopt, "description", meta.descr);
+    set_int_item(deopt, "count", stat.count);
+    auto guilty_types = Ref<>::steal(check(PyDict_New()));
+    for (size_t i = 0; i < stat.types.size && stat.types.types[i] != nullptr;
+         ++i) {
+      set_int_item(
+          guilty_types,
+          typeFullname(stat.types.types[i]).c_str(),
+          stat.types.counts[i]);
+    }
+    if (stat.types.other > 0) {
+      set_int_item(guilty_types, "<other>", stat.types.other);
+    }
+    check(PyDict_SetItemString(deopt, "guilty_types", guilty_types));
+    check(PyList_Append(offsets.list(offset, "deopts"), deopt));
+  }
+}
+
+template <typename T>
+Ref<> make_cache_report(const char* kind, T* cache) {
+  auto report = Ref<>::steal(check(PyDict_New()));
+  set_str_item(report, "kind", kind);
+  set_int_item(report, "entries_used", cache->numEntriesUsed());
+  set_int_item(report, "capacity", cache->capacity());
+  auto misses = Ref<>::steal(check(PyDict_New()));
+  const CacheMissCounts& counts = cache->missCounts();
+  for (size_t i = 0; i < counts.size(); ++i) {
+    if (counts[i] != 0) {
+      set_int_item(
+          misses,
+          cacheMissReason(static_cast<CacheMissReason>(i)).data(),
+          counts[i]);
+    }
+  }
+  check(PyDict_SetItemString(report, "misses", misses));
+  return report;
+}
+
+void add_cache_report(OffsetReports& offsets, const CodeRuntime& code_rt) {
+  for (const CacheSite& site : code_rt.cacheSites()) {
+    Ref<> report = std::visit(
+        [](auto* cache) {
+          using T = std::remove_pointer_t<decltype(cache)>;
+          if constexpr (std::is_same_v<T, LoadAttrCache>) {
+            return make_cache_report("LoadAttr", cache);
+          } else if constexpr (std::is_same_v<T, StoreAttrCache>) {
+            return make_cache_report("StoreAttr", cache);
+          } else if constexpr (std::is_same_v<T, LoadMethodCache>) {
+            return make_cache_report("LoadMethod", cache);
+          } else {
+            return make_cache_report("LoadTypeMethod", cache);
+          }
+        },
+        site.cache);
+    check(PyList_Append(offsets.list(site.bc_offset, "caches"), report));
+  }
+}
+
+void add_inline_report(
+    OffsetReports& offsets,
+    const hir::Function::InlineFunctionStats& stats) {
+  for (const auto& failure : stats.call_site_failures) {
+    auto report = Ref<>::steal(check(PyDict_New()));
+    set_str_item(report, "callee", failure.callee.c_str());
+    set_str_item(report, "reason", hir::getInlineFailureName(failure.type));
+    check(PyList_Append(
+        offsets.list(failure.bc_offset, "inline_failures"), report));
+  }
+}
+
+Ref<> make_function_perf_report(BorrowedRef<PyFunctionObject> func) {
+  BorrowedRef<PyCodeObject> code = func->func_code;
+  CompiledFunction* compiled =
+      jit_ctx != nullptr ? jit_ctx->lookupFunc(func) : nullptr;
+  const CodeProfile* profile =
+      Runtime::get()->profileRuntime().codeProfile(code);
+
+  auto report = Ref<>::steal(check(PyDict_New()));
+  check(PyDict_SetItemString(report, "qualname", func->func_qualname));
+  check(PyDict_SetItemString(report, "filename", code->co_filename));
+  check(PyDict_SetItemString(
+      report, "compiled", compiled != nullptr ? Py_True : Py_False));
+  set_int_item(
+      report,
+      "total_profiled_bytecodes",
+      profile != nullptr ? profile->total_hits : 0);
+
+  OffsetReports offsets{code};
+  if (profile != nullptr) {
+    add_profile_report(offsets, *profile);
+  }
+  add_deopt_report(offsets, code);
+  if (compiled != nullptr) {
+    set_int_item(report, "code_size", compiled->codeSize());
+    const auto& inline_stats = compiled->inlinedFunctionsStats();
+    set_int_item(
+        report, "num_inlined_functions", inline_stats.num_inlined_functions);
+    add_cache_report(offsets, *compiled->codeRuntime());
+    add_inline_report(offsets, inline_stats);
+  }
+  check(PyDict_SetItemString(report, "offsets", offsets.toDict()));
+  return report;
+}
+
 } // namespace
 
 static PyObject* get_and_clear_runtime_stats(PyObject* /* self */, PyObject*) {
@@ -1413,6 +1915,20 @@ static PyObject* get_and_clear_runtime_stats(PyObject* /* self */, PyObject*) {
   return stats.release();
 }
 
+static PyObject* get_function_perf_report(
+    PyObject* /* self */,
+    PyObject* func) {
+  if (!PyFunction_Check(func)) {
+    PyErr_SetString(PyExc_TypeError, "Expected a Python function");
+    return nullptr;
+  }
+  try {
+    return make_function_perf_report(func).release();
+  } catch (const CAPIError&) {
+    return nullptr;
+  }
+}
+
 static PyObject* clear_runtime_stats(PyObject* /* self */, PyObject*) {
   Runtime::get()->clearDeoptStats();
   Py_RETURN_NONE;
@@ -1534,6 +2050,21 @@ static PyObject* jit_suppress(PyObject*, PyObject* func_obj) {
   return func_obj;
 }
 
+static PyObject* get_peephole_stats(PyObject*, PyObject*) {
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  for (auto& [name, hits] : lir::PeepholeOptimizer::hitCounts()) {
+    auto count = Ref<>::steal(PyLong_FromUnsignedLongLong(hits));
+    if (count == nullptr ||
+        PyDict_SetItemString(stats, name.c_str(), count) < 0) {
+      return nullptr;
+    }
+  }
+  return stats.release();
+}
+
 static PyObject* get_allocator_stats(PyObject*, PyObject*) {
   auto base_allocator = CodeAllocator::get();
   if (base_allocator == nullptr) {
@@ -1577,9 +2108,46 @@ static PyObject* get_allocator_stats(PyObject*, PyObject*) {
       PyDict_SetItemString(stats, "huge_allocs", huge_allocs) < 0) {
     return nullptr;
   }
+  auto free_bytes = Ref<>::steal(PyLong_FromLong(allocator->freeBytes()));
+  if (free_bytes == nullptr ||
+      PyDict_SetItemString(stats, "free_bytes", free_bytes) < 0) {
+    return nullptr;
+  }
   return stats.release();
 }
 
+static PyObject* get_gen_data_pool_stats(PyObject*, PyObject*) {
+  JITRT_GenDataPoolStats pool_stats = JITRT_GetGenDataPoolStats();
+  auto stats = Ref<>::steal(PyDict_New());
+  if (stats == nullptr) {
+    return nullptr;
+  }
+  std::pair<const char*, size_t> counters[] = {
+      {"hits", pool_stats.hits},
+      {"misses", pool_stats.misses},
+      {"retained_blocks", pool_stats.retained_blocks},
+      {"retained_bytes", pool_stats.retained_bytes},
+  };
+  for (auto& [name, value] : counters) {
+    auto count = Ref<>::steal(PyLong_FromSize_t(value));
+    if (count == nullptr || PyDict_SetItemString(stats, name, count) < 0) {
+      return nullptr;
+    }
+  }
+  return stats.release();
+}
+
+static PyObject* trim_gen_data_pool(PyObject*, PyObject*) {
+  return PyLong_FromSize_t(JITRT_TrimGenDataPool());
+}
+
+static PyObject* reclaim_dead_code(PyObject*, PyObject*) {
+  if (jit_ctx == nullptr) {
+    return PyLong_FromLong(0);
+  }
+  return PyLong_FromSize_t(jit_ctx->reclaimDeadCode());
+}
+
 static PyObject* is_hir_inliner_enabled(PyObject* /* self */, PyObject*) {
   if (getConfig().hir_opts.inliner) {
     Py_RETURN_TRUE;
@@ -1662,6 +2230,12 @@ static int deopt_gen_visitor(PyObject* obj, void*) {
 
 static PyObject* after_fork_child(PyObject*, PyObject*) {
   perf::afterForkChild();
+  reset_background_compile_after_fork();
+  Py_RETURN_NONE;
+}
+
+static PyObject* stop_background_compile(PyObject*, PyObject*) {
+  stop_background_compile_workers();
   Py_RETURN_NONE;
 }
 
@@ -1721,6 +2295,12 @@ static PyMethodDef jit_methods[] = {
      get_and_clear_runtime_stats,
      METH_NOARGS,
      "Returns information about the runtime behavior of JIT-compiled code."},
+    {"get_function_perf_report",
+     get_function_perf_report,
+     METH_O,
+     "Returns a JSON-serializable report of how a function has been running, "
+     "with profiled types, branch counts, deopts, inline cache misses, and "
+     "inlining failures keyed by bytecode offset. Doesn't clear any stats."},
     {"clear_runtime_stats",
      clear_runtime_stats,
      METH_NOARGS,
@@ -1770,6 +2350,26 @@ static PyMethodDef jit_methods[] = {
      get_allocator_stats,
      METH_NOARGS,
      "Return stats from the code allocator as a dictionary."},
+    {"get_peephole_stats",
+     get_peephole_stats,
+     METH_NOARGS,
+     "Return a dictionary mapping each LIR peephole rule to the number of "
+     "times it has rewritten code."},
+    {"get_gen_data_pool_stats",
+     get_gen_data_pool_stats,
+     METH_NOARGS,
+     "Return hit/miss counts and retained memory of the pool backing JIT "
+     "generator and coroutine suspend data."},
+    {"trim_gen_data_pool",
+     trim_gen_data_pool,
+     METH_NOARGS,
+     "Release all pooled generator suspend data back to the system allocator "
+     "and return the number of bytes released."},
+    {"reclaim_dead_code",
+     reclaim_dead_code,
+     METH_NOARGS,
+     "Free the compiled code of functions that can no longer be called, and "
+     "return the number of bytes freed."},
     {"is_hir_inliner_enabled",
      is_hir_inliner_enabled,
      METH_NOARGS,
@@ -1809,6 +2409,12 @@ static PyMethodDef jit_methods[] = {
      after_fork_child,
      METH_NOARGS,
      "Callback to be invoked by the runtime after fork()."},
+    {"stop_background_compile",
+     stop_background_compile,
+     METH_NOARGS,
+     "Stop the auto-JIT background compile workers, waiting for compiles that "
+     "are in progress. Functions compiled after this are compiled on the "
+     "calling thread. Registered to run at exit."},
     {"_deopt_gen",
      deopt_gen,
      METH_O,
@@ -1908,6 +2514,13 @@ bool preloadFuncAndDeps(BorrowedRef<PyFunctionObject> func) {
         worklist.push_back(func);
       }
     }
+    for (const auto& [offset, targets] : preloader->profiledMethodTargets()) {
+      for (BorrowedRef<PyFunctionObject> target : targets) {
+        if (!isPreloaded(target) && shouldCompile(target)) {
+          worklist.push_back(target);
+        }
+      }
+    }
   }
   return true;
 }
@@ -1957,6 +2570,25 @@ static int register_fork_callback(BorrowedRef<> cinderjit_module) {
   return 0;
 }
 
+// Call atexit.register(cinderjit.stop_background_compile), so the background
+// compile workers are stopped while they can still take the GIL. Returns 0 on
+// success and -1 on errors.
+static int register_atexit_callback(BorrowedRef<> cinderjit_module) {
+  auto atexit_module = Ref<>::steal(
+      PyImport_ImportModuleLevel("atexit", nullptr, nullptr, nullptr, 0));
+  if (atexit_module == nullptr) {
+    return -1;
+  }
+  auto callback = Ref<>::steal(
+      PyObject_GetAttrString(cinderjit_module, "stop_background_compile"));
+  if (callback == nullptr) {
+    return -1;
+  }
+  auto result = Ref<>::steal(
+      PyObject_CallMethod(atexit_module, "register", "O", callback.get()));
+  return result == nullptr ? -1 : 0;
+}
+
 // Initialize some interned strings that can be used even when the JIT is off.
 int _PyJIT_InitializeInternedStrings() {
 #define INTERN_STR(s)                                            \
@@ -2120,6 +2752,11 @@ int _PyJIT_Initialize() {
   CodeAllocator::makeGlobalCodeAllocator();
 
   jit_ctx = new Context();
+  Runtime::get()->setRecompileCallback([](CodeRuntime* code_rt) {
+    if (jit_ctx != nullptr) {
+      jit_ctx->scheduleRecompile(code_rt);
+    }
+  });
 
   PyObject* mod = PyModule_Create(&jit_module);
   if (mod == nullptr) {
@@ -2143,6 +2780,10 @@ int _PyJIT_Initialize() {
   if (install_jit_audit_hook() < 0 || register_fork_callback(mod) < 0) {
     return -1;
   }
+  if (getConfig().auto_jit_background_workers > 0 &&
+      register_atexit_callback(mod) < 0) {
+    return -1;
+  }
 
   getMutableConfig().init_state = InitState::kInitialized;
   getMutableConfig().is_enabled = use_jit;
@@ -2172,6 +2813,21 @@ int _PyJIT_IsAutoJITEnabled() {
   return _PyJIT_AutoJITThreshold() > 0;
 }
 
+unsigned _PyJIT_OSRThreshold() {
+  // OSR entries adopt the interpreter's frame, which only makes sense when
+  // JIT-compiled code runs with a real frame.
+  if (!_PyJIT_IsEnabled() || getConfig().frame_mode != FrameMode::kNormal) {
+    return 0;
+  }
+  return getConfig().osr_threshold;
+}
+
+int _PyJIT_IsBackgroundCompileEnabled() {
+  return _PyJIT_IsAutoJITEnabled() &&
+      getConfig().auto_jit_background_workers > 0 &&
+      !g_background_compile_stopped;
+}
+
 int _PyJIT_Enable() {
   if (getConfig().init_state != InitState::kInitialized) {
     return 0;
@@ -2200,6 +2856,97 @@ _PyJIT_Result _PyJIT_CompileFunction(PyFunctionObject* raw_func) {
   return compile_func(func);
 }
 
+_PyJIT_Result _PyJIT_ScheduleCompileFunction(PyFunctionObject* raw_func) {
+  if (jit_ctx == nullptr) {
+    return PYJIT_NOT_INITIALIZED;
+  }
+
+  BorrowedRef<PyFunctionObject> func{raw_func};
+
+  if (!shouldCompile(func)) {
+    return PYJIT_RESULT_NOT_ON_JITLIST;
+  }
+
+  jit_reg_units.erase(func);
+  auto job = std::make_unique<BackgroundCompileJob>();
+  job->func = Ref<PyFunctionObject>::create(func);
+  {
+    IsolatedPreloaders ip;
+    if (!preloadFuncAndDeps(func)) {
+      return PYJIT_RESULT_PYTHON_EXCEPTION;
+    }
+    job->preloaders.swap(jit_preloaders);
+  }
+  ensure_background_compiler().queue.push(std::move(job));
+  return PYJIT_RESULT_OK;
+}
+
+int _PyJIT_OSREnter(
+    PyFrameObject* frame,
+    int loop_header,
+    PyObject** stack_pointer,
+    PyObject** result) {
+  if (jit_ctx == nullptr || _PyJIT_OSRThreshold() == 0) {
+    return 0;
+  }
+
+  // Only plain function frames that are not inside a try, with, or async for
+  // block are supported; the OSR entry starts with an empty block stack.
+  PyThreadState* tstate = PyThreadState_GET();
+  BorrowedRef<PyCodeObject> code = frame->f_code;
+  if (frame->f_gen != nullptr || frame->f_iblock != 0 ||
+      tstate->cframe->use_tracing || tstate->profile_interp ||
+      (code->co_flags & (kCoFlagsAnyGenerator | CO_STATICALLY_COMPILED)) ||
+      !PyDict_CheckExact(frame->f_globals) ||
+      !PyDict_CheckExact(frame->f_builtins)) {
+    return 0;
+  }
+
+  _Py_IDENTIFIER(__name__);
+  BorrowedRef<> module_name =
+      _PyDict_GetItemIdWithError(frame->f_globals, &PyId___name__);
+  if (module_name == nullptr && PyErr_Occurred()) {
+    return -1;
+  }
+  if (!shouldCompile(module_name, code)) {
+    return 0;
+  }
+
+  hir::OSREntry osr_entry{
+      BCIndex{loop_header},
+      static_cast<int>(stack_pointer - frame->f_valuestack)};
+  CompiledFunction* compiled = jit_ctx->compileOSR(
+      code,
+      frame->f_builtins,
+      frame->f_globals,
+      osr_entry,
+      codeFullname(module_name, code));
+  if (compiled == nullptr) {
+    return PyErr_Occurred() ? -1 : 0;
+  }
+
+  // The compiled code borrows the frame's values from args, which owns them
+  // until it returns. The frame's slots are cleared so that deopting can store
+  // fresh references into them.
+  std::vector<PyObject*> args{frame->f_localsplus, stack_pointer};
+  std::fill(frame->f_localsplus, stack_pointer, nullptr);
+  frame->f_stackdepth = 0;
+
+  // The compiled code links its own shadow frame for the interpreter's frame,
+  // and takes over the reference that linking a new frame would create.
+  _PyShadowFrame* shadow_frame = tstate->shadow_frame;
+  _PyShadowFrame_Pop(tstate, shadow_frame);
+  Py_INCREF(frame);
+  *result =
+      compiled->vectorcallEntry()(nullptr, args.data(), args.size(), nullptr);
+  _PyShadowFrame_PushInterp(tstate, shadow_frame, frame);
+
+  for (PyObject* arg : args) {
+    Py_XDECREF(arg);
+  }
+  return 1;
+}
+
 // Recursively search the given co_consts tuple for any code objects that are
 // on the current jit-list, using the given module name to form a
 // fully-qualified function name.
@@ -2239,9 +2986,14 @@ int _PyJIT_RegisterFunction(PyFunctionObject* func) {
   }
 
   bool skip = !_PyJIT_IsEnabled();
-  auto max_code_size = getConfig().max_code_size;
-  if ((!skip) && max_code_size) {
-    skip = CodeAllocator::get()->usedBytes() >= max_code_size;
+  if (!skip) {
+    auto max_code_size = getConfig().max_code_size;
+    auto code_heap_full = [&] {
+      return max_code_size != 0 &&
+          CodeAllocator::get()->usedBytes() >= max_code_size;
+    };
+    jit_ctx->maybeReclaimDeadCode(code_heap_full());
+    skip = code_heap_full();
   }
 
   if (skip) {
@@ -2312,6 +3064,12 @@ void _PyJIT_TypeDestroyed(PyTypeObject* type) {
   }
 }
 
+void _PyJIT_VTableModified(PyTypeObject* type, PyObject* name) {
+  if (auto rt = Runtime::getUnchecked()) {
+    rt->notifyMethodOverridden(type, name);
+  }
+}
+
 void _PyJIT_FuncModified(PyFunctionObject* func) {
   if (jit_ctx) {
     jit_ctx->funcModified(func);
@@ -2343,6 +3101,12 @@ void _PyJIT_CodeDestroyed(PyCodeObject* code) {
       handle_unit_deleted_during_preload(code_obj);
     }
   }
+  if (jit_ctx) {
+    jit_ctx->codeDestroyed(code);
+  }
+  if (Runtime* runtime = Runtime::getUnchecked()) {
+    runtime->profileRuntime().unregisterCode(code);
+  }
 }
 
 static void dump_jit_stats() {
@@ -2374,6 +3138,10 @@ int _PyJIT_Finalize() {
   // invoke the JIT while we're finalizing our data structures.
   getMutableConfig().is_enabled = 0;
 
+  // Normally done by the atexit callback; any worker still running at this
+  // point has to finish before the code it's compiling into goes away.
+  stop_background_compile_workers();
+
   // Deopt all JIT generators, since JIT generators reference code and other
   // metadata that we will be freeing later in this function.
   PyUnstable_GC_VisitObjects(deopt_gen_visitor, nullptr);
@@ -2399,6 +3167,8 @@ int _PyJIT_Finalize() {
   // invoked the JIT directly without initializing a full jit::Context.
   jit::Runtime::get()->clearDeoptStats();
   jit::Runtime::get()->releaseReferences();
+  // The shared inline cache owns references to attribute names.
+  jit::clearMegamorphicCache();
 
   if (getMutableConfig().init_state == InitState::kInitialized) {
     delete g_jit_list;
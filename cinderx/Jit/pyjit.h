@@ -72,6 +72,12 @@ PyAPI_FUNC(unsigned) _PyJIT_AutoJITThreshold(void);
  */
 PyAPI_FUNC(unsigned) _PyJIT_AutoJITProfileThreshold(void);
 
+/*
+ * Returns 1 if auto-JIT hands hot functions to background compile workers
+ * rather than compiling them on the calling thread, and 0 otherwise.
+ */
+PyAPI_FUNC(int) _PyJIT_IsBackgroundCompileEnabled(void);
+
 /*
  * JIT compile func and patch its entry point.
  *
@@ -81,6 +87,38 @@ PyAPI_FUNC(unsigned) _PyJIT_AutoJITProfileThreshold(void);
  */
 PyAPI_FUNC(_PyJIT_Result) _PyJIT_CompileFunction(PyFunctionObject* func);
 
+/*
+ * Preload func and queue it to be JIT compiled by a background worker, which
+ * patches its entry point once the compiled code is ready. func is kept alive
+ * until then.
+ *
+ * Returns PYJIT_RESULT_OK if func was queued, or
+ * PYJIT_RESULT_PYTHON_EXCEPTION if preloading raised an exception.
+ */
+PyAPI_FUNC(_PyJIT_Result) _PyJIT_ScheduleCompileFunction(PyFunctionObject* func);
+
+/*
+ * Get the number of loop back-edges after which an interpreted frame is
+ * transferred into JIT-compiled code. Returns 0 when on-stack replacement is
+ * disabled.
+ */
+PyAPI_FUNC(unsigned) _PyJIT_OSRThreshold(void);
+
+/*
+ * Continue executing frame f, which is about to jump back to the loop header
+ * at instruction index loop_header, in JIT-compiled code. stack_pointer is the
+ * top of f's value stack.
+ *
+ * Returns 1 if f ran to completion, storing its result (or NULL if it raised)
+ * in *result. Returns 0 if the loop can't be compiled and f should stay in the
+ * interpreter, and -1 with an exception set on error.
+ */
+PyAPI_FUNC(int) _PyJIT_OSREnter(
+    PyFrameObject* f,
+    int loop_header,
+    PyObject** stack_pointer,
+    PyObject** result);
+
 /*
  * Registers a function with the JIT to be compiled in the future.
  *
@@ -111,6 +149,14 @@ PyAPI_FUNC(void) _PyJIT_FuncModified(PyFunctionObject* func);
 PyAPI_FUNC(void) _PyJIT_FuncDestroyed(PyFunctionObject* func);
 PyAPI_FUNC(void) _PyJIT_CodeDestroyed(PyCodeObject* code);
 
+/*
+ * Informs the JIT that a Static Python type was created with a vtable as a
+ * subclass of a static type (name is NULL), or that the vtable slot for name
+ * is about to be updated on type.  Used to invalidate devirtualized method
+ * calls.
+ */
+PyAPI_FUNC(void) _PyJIT_VTableModified(PyTypeObject* type, PyObject* name);
+
 /*
  * Clean up any resources allocated by the JIT.
  *
@@ -251,6 +251,16 @@ void Runtime::clearGuardFailureCallback() {
   guard_failure_callback_ = nullptr;
 }
 
+void Runtime::setRecompileCallback(Runtime::RecompileCallback cb) {
+  recompile_callback_ = std::move(cb);
+}
+
+void Runtime::requestRecompile(CodeRuntime* code_rt) {
+  if (recompile_callback_) {
+    recompile_callback_(code_rt);
+  }
+}
+
 void Runtime::addReference(Ref<>&& obj) {
   JIT_CHECK(obj != nullptr, "Can't own a reference to nullptr");
   // Serialize as we modify the globally accessible references_ object.
@@ -270,6 +280,7 @@ void Runtime::releaseReferences() {
   }
   references_.clear();
   type_deopt_patchers_.clear();
+  method_override_patchers_.clear();
 }
 
 std::optional<std::string> symbolize(const void* func) {
@@ -292,12 +303,48 @@ void Runtime::watchType(
   type_deopt_patchers_[type].emplace_back(patcher);
 }
 
+void Runtime::forgetCode(std::span<const std::byte> code) {
+  std::vector<std::unique_ptr<DeoptPatcher>> dead_patchers;
+  {
+    ThreadedCompileSerialize guard;
+    for (auto it = type_deopt_patchers_.begin();
+         it != type_deopt_patchers_.end();) {
+      std::erase_if(it->second, [&](TypeDeoptPatcher* patcher) {
+        return patcher->isLinkedInto(code);
+      });
+      it = it->second.empty() ? type_deopt_patchers_.erase(it) : std::next(it);
+    }
+    for (auto it = method_override_patchers_.begin();
+         it != method_override_patchers_.end();) {
+      std::erase_if(it->second, [&](MethodOverrideDeoptPatcher* patcher) {
+        return patcher->isLinkedInto(code);
+      });
+      it = it->second.empty() ? method_override_patchers_.erase(it)
+                              : std::next(it);
+    }
+    for (auto& patcher : deopt_patchers_) {
+      if (patcher->isLinkedInto(code)) {
+        dead_patchers.emplace_back(std::move(patcher));
+      }
+    }
+    std::erase(deopt_patchers_, nullptr);
+  }
+  // The patchers are destroyed without holding the lock, since dropping their
+  // references can run arbitrary code.
+}
+
 void Runtime::notifyTypeModified(
     BorrowedRef<PyTypeObject> lookup_type,
     BorrowedRef<PyTypeObject> new_type) {
   notifyICsTypeChanged(lookup_type);
 
   ThreadedCompileSerialize guard;
+  if (new_type == nullptr) {
+    // Every MethodOverrideDeoptPatcher for the destroyed type is also watching
+    // it as a TypeDeoptPatcher, and gets patched below.
+    method_override_patchers_.erase(lookup_type);
+  }
+
   auto it = type_deopt_patchers_.find(lookup_type);
   if (it == type_deopt_patchers_.end()) {
     return;
@@ -318,4 +365,37 @@ void Runtime::notifyTypeModified(
   }
 }
 
+void Runtime::watchMethodOverrides(
+    BorrowedRef<PyTypeObject> type,
+    MethodOverrideDeoptPatcher* patcher) {
+  ThreadedCompileSerialize guard;
+  method_override_patchers_[type].emplace_back(patcher);
+}
+
+void Runtime::notifyMethodOverridden(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<> name) {
+  ThreadedCompileSerialize guard;
+  if (method_override_patchers_.empty() || type->tp_mro == nullptr) {
+    return;
+  }
+
+  // Devirtualized calls are keyed by the type declaring the method, which is
+  // type itself or one of its bases.
+  BorrowedRef<PyTupleObject> mro{type->tp_mro};
+  for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(mro); i++) {
+    BorrowedRef<PyTypeObject> base{PyTuple_GET_ITEM(mro, i)};
+    auto it = method_override_patchers_.find(base);
+    if (it == method_override_patchers_.end()) {
+      continue;
+    }
+    std::erase_if(it->second, [&](MethodOverrideDeoptPatcher* patcher) {
+      return patcher->maybePatchOverride(type, name);
+    });
+    if (it->second.empty()) {
+      method_override_patchers_.erase(it);
+    }
+  }
+}
+
 } // namespace jit
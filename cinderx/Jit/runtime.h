@@ -19,13 +19,16 @@
 #include "cinderx/Jit/threaded_compile.h"
 
 #include <optional>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <variant>
 #include <vector>
 
 namespace jit {
 
+class MethodOverrideDeoptPatcher;
 class TypeDeoptPatcher;
 
 class GenYieldPoint {
@@ -104,6 +107,18 @@ class alignas(16) RuntimeFrameState {
   BorrowedRef<> globals_;
 };
 
+// An inline cache used by a compiled function, along with the bytecode offset
+// (in the outermost code object) of the instruction it serves.
+struct CacheSite {
+  BCOffset bc_offset;
+  std::variant<
+      LoadAttrCache*,
+      StoreAttrCache*,
+      LoadMethodCache*,
+      LoadTypeMethodCache*>
+      cache;
+};
+
 // Runtime data for a PyCodeObject object, containing caches and any other data
 // associated with a JIT-compiled function.
 class alignas(16) CodeRuntime {
@@ -159,6 +174,24 @@ class alignas(16) CodeRuntime {
     return &gen_yield_points_.back();
   }
 
+  // Count a failed guard on a profiled type in this function, and return the
+  // new total.
+  size_t recordGuardFailure() {
+    return ++guard_failures_;
+  }
+
+  // Remember which instruction a cache was allocated for, so the cache's state
+  // can be reported back per bytecode offset.
+  template <typename T>
+  void addCacheSite(BCOffset bc_offset, T* cache) {
+    ThreadedCompileSerialize guard;
+    cache_sites_.push_back(CacheSite{bc_offset, cache});
+  }
+
+  const std::vector<CacheSite>& cacheSites() const {
+    return cache_sites_;
+  }
+
   void set_frame_size(int size) {
     frame_size_ = size;
   }
@@ -190,6 +223,10 @@ class alignas(16) CodeRuntime {
 
   int frame_size_{-1};
 
+  size_t guard_failures_{0};
+
+  std::vector<CacheSite> cache_sites_;
+
   DebugInfo debug_info_;
 };
 
@@ -365,6 +402,13 @@ class Runtime {
   void guardFailed(const DeoptMetadata& deopt_meta);
   void clearGuardFailureCallback();
 
+  using RecompileCallback = std::function<void(CodeRuntime*)>;
+
+  // Set the function to be called when compiled code has failed enough guards
+  // on profiled types that it should be recompiled.
+  void setRecompileCallback(RecompileCallback cb);
+  void requestRecompile(CodeRuntime* code_rt);
+
   // Ensure that this Runtime owns a reference to the given owned object,
   // keeping it alive for use by the compiled code. Transfer ownership of the
   // object to the CodeRuntime.
@@ -378,6 +422,10 @@ class Runtime {
   // Release any references this Runtime holds to Python objects.
   void releaseReferences();
 
+  // Drop all metadata that refers to the machine code in `code`, which is
+  // about to be freed.
+  void forgetCode(std::span<const std::byte> code);
+
   template <typename T, typename... Args>
   T* allocateDeoptPatcher(Args&&... args) {
     deopt_patchers_.emplace_back(
@@ -455,6 +503,20 @@ class Runtime {
       BorrowedRef<PyTypeObject> lookup_type,
       BorrowedRef<PyTypeObject> new_type);
 
+  // When a subclass of type is created, or the vtable slot of a method is
+  // updated on type or one of its subclasses, call
+  // patcher->maybePatchOverride().
+  void watchMethodOverrides(
+      BorrowedRef<PyTypeObject> type,
+      MethodOverrideDeoptPatcher* patcher);
+
+  // Callback for when the Static Python class loader gives type a vtable
+  // because it was created as a subclass of a static type (name is nullptr),
+  // or when the vtable slot for name is about to be updated on type.
+  void notifyMethodOverridden(
+      BorrowedRef<PyTypeObject> type,
+      BorrowedRef<> name);
+
   template <typename F>
   REQUIRES_CALLABLE(F, int, PyObject*)
   int forEachOwnedRef(PyGenObject* gen, std::size_t deopt_idx, F func) {
@@ -500,6 +562,7 @@ class Runtime {
   std::vector<DeoptMetadata> deopt_metadata_;
   DeoptStats deopt_stats_;
   GuardFailureCallback guard_failure_callback_;
+  RecompileCallback recompile_callback_;
 
   // Note: Ideally this would be separate from JIT metadata.  It should be
   // usable even when the JIT is fully reset.
@@ -513,6 +576,10 @@ class Runtime {
 
   std::unordered_map<BorrowedRef<PyTypeObject>, std::vector<TypeDeoptPatcher*>>
       type_deopt_patchers_;
+  std::unordered_map<
+      BorrowedRef<PyTypeObject>,
+      std::vector<MethodOverrideDeoptPatcher*>>
+      method_override_patchers_;
 };
 
 // Symbolize and demangle the given function.
@@ -51,11 +51,26 @@ class ThreadedCompileContext {
     return compile_running_;
   }
 
+  // Mark the calling thread as a background compile worker. Background workers
+  // compile while other threads keep running Python code, so rather than the
+  // threaded-compile mutex they take the GIL whenever they touch data shared
+  // with the rest of the runtime.
+  static void setBackgroundWorkerThread(bool is_worker) {
+    is_background_worker_ = is_worker;
+  }
+
+  static bool isBackgroundWorkerThread() {
+    return is_background_worker_;
+  }
+
   // Returns true if it's safe for the current thread to access data protected
   // by the threaded compile lock, either because no threaded compile is active
   // or the current thread holds the lock. May return true erroneously, but
   // shouldn't return false erroneously.
   bool canAccessSharedData() const {
+    if (isBackgroundWorkerThread()) {
+      return background_lock_depth_ > 0;
+    }
     return !compileRunning() ||
         mutex_holder_.load(std::memory_order_relaxed) ==
         std::this_thread::get_id();
@@ -65,6 +80,12 @@ class ThreadedCompileContext {
   friend class ThreadedCompileSerialize;
 
   void lock() {
+    if (isBackgroundWorkerThread()) {
+      if (background_lock_depth_++ == 0) {
+        background_gil_state_ = PyGILState_Ensure();
+      }
+      return;
+    }
     if (compileRunning()) {
       mutex_.lock();
       mutex_holder_.store(
@@ -73,6 +94,12 @@ class ThreadedCompileContext {
   }
 
   void unlock() {
+    if (isBackgroundWorkerThread()) {
+      if (--background_lock_depth_ == 0) {
+        PyGILState_Release(background_gil_state_);
+      }
+      return;
+    }
     if (compileRunning()) {
       mutex_holder_.store(std::thread::id{}, std::memory_order_relaxed);
       mutex_.unlock();
@@ -106,6 +133,13 @@ class ThreadedCompileContext {
 
   std::vector<BorrowedRef<>> work_queue_;
   std::vector<BorrowedRef<>> retry_list_;
+
+  // Per-thread state for background compile workers. The GIL is taken when
+  // the outermost lock() is entered and released when it is exited.
+  static inline thread_local bool is_background_worker_{false};
+  static inline thread_local int background_lock_depth_{0};
+  static inline thread_local PyGILState_STATE background_gil_state_{
+      PyGILState_UNLOCKED};
 };
 
 extern ThreadedCompileContext g_threaded_compile_context;
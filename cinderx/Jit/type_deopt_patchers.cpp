@@ -74,6 +74,52 @@ bool TypeAttrDeoptPatcher::maybePatch(BorrowedRef<PyTypeObject> new_ty) {
   return should_patch;
 }
 
+MethodOverrideDeoptPatcher::MethodOverrideDeoptPatcher(
+    BorrowedRef<PyTypeObject> type,
+    BorrowedRef<PyUnicodeObject> method_name,
+    BorrowedRef<> target_func)
+    : TypeAttrDeoptPatcher{type, method_name, target_func} {}
+
+bool MethodOverrideDeoptPatcher::maybePatch(BorrowedRef<PyTypeObject> new_ty) {
+  // Already patched through maybePatchOverride().
+  if (attr_name_ == nullptr) {
+    return true;
+  }
+  return TypeAttrDeoptPatcher::maybePatch(new_ty);
+}
+
+bool MethodOverrideDeoptPatcher::maybePatchOverride(
+    BorrowedRef<PyTypeObject> subtype,
+    BorrowedRef<> name) {
+  if (attr_name_ == nullptr) {
+    return true;
+  }
+
+  bool should_patch;
+  if (name != nullptr) {
+    // The slot is about to be updated, so we can't look at the new value yet.
+    // Any update of the method we devirtualized is treated as an override.
+    should_patch = PyUnicode_Check(name) &&
+        PyUnicode_Compare(name, attr_name_) == 0;
+  } else {
+    // A new subclass either inherits target_func or overrides it, possibly
+    // through another base class.
+    BorrowedRef<PyUnicodeObject> attr_name{attr_name_};
+    should_patch = typeLookupSafe(subtype, attr_name) != target_object_;
+  }
+  if (should_patch) {
+    patch();
+    attr_name_.reset();
+    target_object_.reset();
+  }
+  return should_patch;
+}
+
+void MethodOverrideDeoptPatcher::init() {
+  TypeAttrDeoptPatcher::init();
+  Runtime::get()->watchMethodOverrides(type_, this);
+}
+
 SplitDictDeoptPatcher::SplitDictDeoptPatcher(
     BorrowedRef<PyTypeObject> type,
     BorrowedRef<PyUnicodeObject> attr_name,
@@ -38,11 +38,35 @@ class TypeAttrDeoptPatcher : public TypeDeoptPatcher {
 
   bool maybePatch(BorrowedRef<PyTypeObject> new_ty) override;
 
- private:
+ protected:
   Ref<PyUnicodeObject> attr_name_;
   Ref<> target_object_;
 };
 
+// Patch a DeoptPatchpoint when a Static Python method call that was
+// devirtualized to target_func may dispatch somewhere else: the method is
+// reassigned on the declaring type, or a subclass of it overrides the method
+// (either when the subclass is created or by a later assignment).
+class MethodOverrideDeoptPatcher : public TypeAttrDeoptPatcher {
+ public:
+  MethodOverrideDeoptPatcher(
+      BorrowedRef<PyTypeObject> type,
+      BorrowedRef<PyUnicodeObject> method_name,
+      BorrowedRef<> target_func);
+
+  bool maybePatch(BorrowedRef<PyTypeObject> new_ty) override;
+
+  // Called when subtype, which has the watched type in its MRO, is created
+  // (name is nullptr) or has the vtable slot for name updated. Returns true if
+  // the patcher has been patched and no longer needs to be notified.
+  bool maybePatchOverride(
+      BorrowedRef<PyTypeObject> subtype,
+      BorrowedRef<> name);
+
+ protected:
+  void init() override;
+};
+
 class SplitDictDeoptPatcher : public TypeDeoptPatcher {
  public:
   SplitDictDeoptPatcher(
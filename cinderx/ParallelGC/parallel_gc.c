@@ -1157,6 +1157,16 @@ Ci_deduce_unreachable_parallel(Ci_ParGCState *par_gc, PyGC_Head *base, PyGC_Head
 static int
 Ci_should_use_par_gc(Ci_ParGCState *par_gc, int gen);
 
+static Py_ssize_t
+Ci_take_old_gen_slice(Ci_ParGCState *par_gc, GCState *gcstate, int gen, PyGC_Head *young);
+
+static void
+Ci_finish_old_gen_slice(Ci_ParGCState *par_gc, GCState *gcstate, Py_ssize_t slice_size,
+                        _PyTime_t elapsed);
+
+static void
+Ci_reset_old_gen_rotation(Ci_ParGCState *par_gc, GCState *gcstate);
+
 /* This is the main function.  Read this to understand how the
  * collection process works. */
 static Py_ssize_t
@@ -1213,8 +1223,13 @@ gc_collect_main(Ci_PyGCImpl *gc_impl, PyThreadState *tstate, int generation,
         old = young;
     validate_list(old, collecting_clear_unreachable_clear);
 
+    /* In incremental mode, scan a slice of the oldest generation along with
+     * the young ones. */
     Ci_ParGCState *par_gc = (Ci_ParGCState *) gc_impl;
-    if (Ci_should_use_par_gc(par_gc, generation)) {
+    Py_ssize_t slice_size = Ci_take_old_gen_slice(par_gc, gcstate, generation, young);
+    _PyTime_t slice_start = slice_size > 0 ? _PyTime_GetMonotonicClock() : 0;
+
+    if (Ci_should_use_par_gc(par_gc, generation) || slice_size > 0) {
         Ci_deduce_unreachable_parallel(par_gc, young, &unreachable);
     } else {
         deduce_unreachable(young, &unreachable);
@@ -1224,7 +1239,9 @@ gc_collect_main(Ci_PyGCImpl *gc_impl, PyThreadState *tstate, int generation,
     /* Move reachable objects to next generation. */
     if (young != old) {
         if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
+            /* Survivors from an old-generation slice were already counted. */
+            Py_ssize_t promoted = gc_list_size(young) - slice_size;
+            gcstate->long_lived_pending += Py_MAX(promoted, 0);
         }
         gc_list_merge(young, old);
     }
@@ -1234,6 +1251,7 @@ gc_collect_main(Ci_PyGCImpl *gc_impl, PyThreadState *tstate, int generation,
         untrack_dicts(young);
         gcstate->long_lived_pending = 0;
         gcstate->long_lived_total = gc_list_size(young);
+        Ci_reset_old_gen_rotation(par_gc, gcstate);
     }
 
     /* All objects in unreachable are trash, but objects reachable from
@@ -1325,6 +1343,11 @@ gc_collect_main(Ci_PyGCImpl *gc_impl, PyThreadState *tstate, int generation,
         *n_uncollectable = n;
     }
 
+    if (slice_size > 0) {
+        Ci_finish_old_gen_slice(par_gc, gcstate, slice_size,
+                                _PyTime_GetMonotonicClock() - slice_start);
+    }
+
     struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
     stats->collections++;
     stats->collected += m;
@@ -1528,6 +1551,49 @@ typedef struct {
     unsigned long thread_id;
 } Ci_ParGCWorker;
 
+/* Incremental collection of the oldest generation.
+
+   A full collection pauses for time proportional to the whole heap. In
+   incremental mode, each collection of the second-oldest generation also
+   scans a slice taken from the head of the oldest generation. Survivors are
+   appended to its tail, so successive slices rotate through the whole
+   generation. Slices are sized to fit a pause budget, based on how long
+   previous slices took.
+
+   Collecting a subset of the heap is sound without a write barrier: the
+   subset is treated like a young generation, so any object referenced from
+   outside of it (including by something mutated between slices) has external
+   references left after subtract_refs and is kept alive. What a slice can't
+   find is a cycle whose members fall in different slices. Those are left to
+   full collections: a completed rotation resets the long-lived object counts
+   that trigger them, except once every CI_ROTATIONS_PER_FULL_COLLECTION
+   rotations, when the counts are set so the next collection of the oldest
+   generation is a full one. */
+#define CI_MIN_OLD_GEN_SLICE 1000
+#define CI_ROTATIONS_PER_FULL_COLLECTION 4
+
+typedef struct {
+    // Target pause for a collection that includes a slice, in microseconds.
+    // Incremental mode is disabled when this is 0.
+    int64_t slice_budget_us;
+
+    // Number of objects to take from the oldest generation in the next slice.
+    Py_ssize_t next_slice_size;
+
+    // Objects scanned since the current rotation began, and the approximate
+    // size of the oldest generation at that point.
+    Py_ssize_t rotation_scanned;
+    Py_ssize_t rotation_size;
+
+    // Statistics
+    Py_ssize_t rotations;
+    Py_ssize_t slices;
+    Py_ssize_t slice_objects;
+    _PyTime_t last_slice_time;
+    _PyTime_t max_slice_time;
+    _PyTime_t total_slice_time;
+} Ci_IncrementalGC;
+
 struct Ci_ParGCState {
     Ci_PyGCImpl gc_impl;
 
@@ -1559,6 +1625,8 @@ struct Ci_ParGCState {
     // it is safe to destroy shared state.
     _Py_atomic_int num_workers_active;
 
+    Ci_IncrementalGC incremental;
+
     size_t num_workers;
     Ci_ParGCWorker workers[];
 };
@@ -1569,6 +1637,80 @@ Ci_should_use_par_gc(Ci_ParGCState *par_gc, int gen)
     return par_gc != NULL && gen >= par_gc->min_gen;
 }
 
+// Move a slice of the oldest generation into young, returning the number of
+// objects moved.
+static Py_ssize_t
+Ci_take_old_gen_slice(Ci_ParGCState *par_gc, GCState *gcstate, int gen, PyGC_Head *young)
+{
+    if (par_gc == NULL || par_gc->incremental.slice_budget_us == 0 ||
+        gen != NUM_GENERATIONS - 2) {
+        return 0;
+    }
+    Ci_IncrementalGC *incr = &par_gc->incremental;
+    PyGC_Head *oldest = GEN_HEAD(gcstate, NUM_GENERATIONS - 1);
+    if (incr->rotation_size == 0) {
+        Ci_reset_old_gen_rotation(par_gc, gcstate);
+    }
+    Py_ssize_t remaining = incr->rotation_size - incr->rotation_scanned;
+    Py_ssize_t limit = Py_MIN(incr->next_slice_size, Py_MAX(remaining, 0));
+    Py_ssize_t n = 0;
+    while (n < limit && !gc_list_is_empty(oldest)) {
+        gc_list_move(GC_NEXT(oldest), young);
+        n++;
+    }
+    return n;
+}
+
+static void
+Ci_finish_old_gen_slice(Ci_ParGCState *par_gc, GCState *gcstate, Py_ssize_t slice_size,
+                        _PyTime_t elapsed)
+{
+    Ci_IncrementalGC *incr = &par_gc->incremental;
+    incr->slices++;
+    incr->slice_objects += slice_size;
+    incr->last_slice_time = elapsed;
+    incr->max_slice_time = Py_MAX(incr->max_slice_time, elapsed);
+    incr->total_slice_time += elapsed;
+
+    // Scale the next slice so the pause fits the budget, growing by at most
+    // 2x at a time so one fast slice doesn't lead to a huge one.
+    _PyTime_t budget = _PyTime_FromNanoseconds(incr->slice_budget_us * 1000);
+    Py_ssize_t next = incr->next_slice_size * 2;
+    if (elapsed > budget) {
+        next = (Py_ssize_t) ((double) slice_size * budget / elapsed);
+    } else if (elapsed > 0) {
+        next = Py_MIN(next, (Py_ssize_t) ((double) slice_size * budget / elapsed));
+    }
+    incr->next_slice_size = Py_MAX(next, CI_MIN_OLD_GEN_SLICE);
+
+    incr->rotation_scanned += slice_size;
+    if (incr->rotation_scanned < incr->rotation_size) {
+        return;
+    }
+    incr->rotations++;
+    if (incr->rotations % CI_ROTATIONS_PER_FULL_COLLECTION == 0) {
+        // Push the long-lived counts past the 25% growth ratio that
+        // gc_collect_generations() requires, so the next time the oldest
+        // generation's threshold is hit we do a full collection.
+        gcstate->long_lived_pending = gcstate->long_lived_total;
+    } else {
+        gcstate->long_lived_total += gcstate->long_lived_pending;
+        gcstate->long_lived_pending = 0;
+    }
+    incr->rotation_scanned = 0;
+    incr->rotation_size = gcstate->long_lived_total + gcstate->long_lived_pending;
+}
+
+// Start a new rotation through the oldest generation, e.g. after a full
+// collection has scanned all of it.
+static void
+Ci_reset_old_gen_rotation(Ci_ParGCState *par_gc, GCState *gcstate)
+{
+    Ci_IncrementalGC *incr = &par_gc->incremental;
+    incr->rotation_scanned = 0;
+    incr->rotation_size = gcstate->long_lived_total + gcstate->long_lived_pending;
+}
+
 static inline int
 Ci_gc_is_collecting_atomic(PyGC_Head *g)
 {
@@ -2364,6 +2506,56 @@ Cinder_GetParallelGCSettings()
     return settings;
 }
 
+int
+Cinder_SetParallelGCSliceBudget(int64_t budget_us)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    struct _gc_runtime_state *gc_state = &tstate->interp->gc;
+
+    Ci_PyGCImpl *impl = Ci_PyGC_GetImpl(gc_state);
+    if (!Ci_is_par_gc(impl)) {
+        _PyErr_SetString(tstate, PyExc_RuntimeError, "parallel gc is not enabled");
+        return -1;
+    }
+    if (budget_us < 0) {
+        _PyErr_SetString(tstate, PyExc_ValueError, "invalid slice budget");
+        return -1;
+    }
+
+    Ci_ParGCState *par_gc = (Ci_ParGCState *) impl;
+    Ci_IncrementalGC *incr = &par_gc->incremental;
+    incr->slice_budget_us = budget_us;
+    incr->next_slice_size = CI_MIN_OLD_GEN_SLICE * 10;
+    Ci_reset_old_gen_rotation(par_gc, gc_state);
+    return 0;
+}
+
+PyObject *
+Cinder_GetParallelGCStats()
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    struct _gc_runtime_state *gc_state = &tstate->interp->gc;
+
+    Ci_PyGCImpl *impl = Ci_PyGC_GetImpl(gc_state);
+    if (!Ci_is_par_gc(impl)) {
+        Py_RETURN_NONE;
+    }
+
+    Ci_IncrementalGC *incr = &((Ci_ParGCState *) impl)->incremental;
+    return Py_BuildValue(
+        "{sLsnsnsnsLsLsL}",
+        "slice_budget_us", (long long) incr->slice_budget_us,
+        "slices", incr->slices,
+        "slice_objects", incr->slice_objects,
+        "rotations", incr->rotations,
+        "last_slice_us",
+        (long long) _PyTime_AsMicroseconds(incr->last_slice_time, _PyTime_ROUND_CEILING),
+        "max_slice_us",
+        (long long) _PyTime_AsMicroseconds(incr->max_slice_time, _PyTime_ROUND_CEILING),
+        "total_slice_us",
+        (long long) _PyTime_AsMicroseconds(incr->total_slice_time, _PyTime_ROUND_CEILING));
+}
+
 void
 Cinder_DisableParallelGC()
 {
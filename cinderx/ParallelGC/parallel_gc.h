@@ -25,6 +25,23 @@ PyAPI_FUNC(int) Cinder_EnableParallelGC(size_t min_gen, size_t num_threads);
  */
 PyAPI_FUNC(PyObject *) Cinder_GetParallelGCSettings(void);
 
+/*
+ * Collect the oldest generation incrementally, aiming for pauses of at most
+ * budget_us microseconds. Each collection of the second-oldest generation
+ * also scans a slice of the oldest one; full collections still happen, but
+ * much less often. A budget of 0 disables incremental collection.
+ *
+ * Returns 0 on success or -1 with an exception set if parallel gc is not
+ * enabled or the budget is invalid.
+ */
+PyAPI_FUNC(int) Cinder_SetParallelGCSliceBudget(int64_t budget_us);
+
+/*
+ * Returns a dictionary of statistics about incremental collection, including
+ * per-slice timing, or None when parallel gc is disabled.
+ */
+PyAPI_FUNC(PyObject *) Cinder_GetParallelGCStats(void);
+
 /*
  * Disable parallel gc.
  *
@@ -2,6 +2,7 @@
 from __future__ import annotations
 
 import functools
+import operator
 import random
 import time
 from asyncio import iscoroutinefunction
@@ -103,6 +104,50 @@ def __len__(self) -> int:
         def __class_getitem__(cls, key) -> Type[staticarray]:
             return staticarray
 
+        def _new(self, data):
+            res = staticarray(0)
+            res._data = data
+            return res
+
+        def fill(self, val) -> None:
+            self._data = [val] * len(self._data)
+
+        def copy(self) -> staticarray:
+            return self._new(list(self._data))
+
+        def sum(self):
+            return sum(self._data)
+
+        def min(self):
+            return min(self._data)
+
+        def max(self):
+            return max(self._data)
+
+        def dot(self, other: staticarray):
+            return sum(x * y for x, y in zip(self._data, other._data, strict=True))
+
+        def add(self, other: staticarray) -> staticarray:
+            return self._new(
+                [x + y for x, y in zip(self._data, other._data, strict=True)]
+            )
+
+        def mul(self, other: staticarray) -> staticarray:
+            return self._new(
+                [x * y for x, y in zip(self._data, other._data, strict=True)]
+            )
+
+        def compare(self, op: str, val) -> staticarray:
+            cmp = {
+                "<": operator.lt,
+                "<=": operator.le,
+                "==": operator.eq,
+                "!=": operator.ne,
+                ">": operator.gt,
+                ">=": operator.ge,
+            }[op]
+            return self._new([int(cmp(x, val)) for x in self._data])
+
 
 try:
     import cinder
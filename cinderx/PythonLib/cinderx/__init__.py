@@ -13,6 +13,7 @@
             _compile_perf_trampoline_pre_fork,
             _get_entire_call_stack_as_qualnames_with_lineno,
             _get_entire_call_stack_as_qualnames_with_lineno_and_frame,
+            _get_shadow_code,
             _is_compile_perf_trampoline_pre_fork_enabled,
             async_cached_classproperty,
             async_cached_property,
@@ -27,7 +28,9 @@
             get_and_clear_type_profiles,
             get_and_clear_type_profiles_with_metadata,
             get_parallel_gc_settings,
+            get_parallel_gc_stats,
             init as cinderx_init,
+            set_parallel_gc_slice_budget,
             set_profile_interp,
             set_profile_interp_all,
             set_profile_interp_period,
@@ -105,7 +105,15 @@
     PRIM_OP_SUB_DBL,
     PRIM_OP_SUB_INT,
     PRIM_OP_XOR_INT,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT16,
+    SEQ_ARRAY_INT32,
     SEQ_ARRAY_INT64,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_ARRAY_UINT32,
+    SEQ_ARRAY_UINT64,
+    SEQ_ARRAY_UINT8,
     SEQ_CHECKED_LIST,
     SEQ_LIST,
     SEQ_LIST_INEXACT,
@@ -333,10 +341,9 @@ def __init__(self) -> None:
             is_exact=True,
         )
 
-        # We have found no strong reason (yet) to support arrays of other types of
-        # primitives
         self.allowed_array_types: List[Class] = [
-            self.int64,
+            *self.all_cint_types,
+            self.double,
         ]
 
         self.static_method = StaticMethodDecorator(
@@ -8373,15 +8380,29 @@ class OptionalInstance(UnionInstance):
     klass: OptionalType
 
 
+ARRAY_SEQ_TYPES: Mapping[int, int] = {
+    TYPED_INT8: SEQ_ARRAY_INT8,
+    TYPED_INT16: SEQ_ARRAY_INT16,
+    TYPED_INT32: SEQ_ARRAY_INT32,
+    TYPED_INT64: SEQ_ARRAY_INT64,
+    TYPED_UINT8: SEQ_ARRAY_UINT8,
+    TYPED_UINT16: SEQ_ARRAY_UINT16,
+    TYPED_UINT32: SEQ_ARRAY_UINT32,
+    TYPED_UINT64: SEQ_ARRAY_UINT64,
+    TYPED_DOUBLE: SEQ_ARRAY_DOUBLE,
+}
+
+
 class ArrayInstance(Object["ArrayClass"]):
+    def _element_type_code(self) -> int:
+        return self.klass.index.instance.as_oparg()
+
     def _seq_type(self) -> int:
-        idx = self.klass.index
-        if not isinstance(idx, CIntType):
+        seq_type = ARRAY_SEQ_TYPES.get(self._element_type_code())
+        if seq_type is None:
             # should never happen
-            raise SyntaxError(f"Invalid Array type: {idx}")
-        if idx.size != 3 or not idx.signed:
-            raise SyntaxError(f"Only int64 Arrays are currently supported")
-        return SEQ_ARRAY_INT64
+            raise SyntaxError(f"Invalid Array type: {self.klass.index}")
+        return seq_type
 
     def get_iter_type(self, node: ast.expr, visitor: TypeBinder) -> Value:
         return self.klass.index.instance
@@ -8427,7 +8448,7 @@ def emit_load_subscr(
             if code_gen.get_type(node.slice).klass != self.klass.type_env.slice:
                 # Falling back to BINARY_SUBSCR here, so we need to unbox the output
                 code_gen.emit("REFINE_TYPE", self.klass.index.boxed.type_descr)
-                code_gen.emit("PRIMITIVE_UNBOX", TYPED_INT64)
+                code_gen.emit("PRIMITIVE_UNBOX", self._element_type_code())
 
     def emit_store_subscr(
         self, node: ast.Subscript, code_gen: Static310CodeGenerator
@@ -8440,7 +8461,7 @@ def emit_store_subscr(
                 # Falling back to STORE_SUBSCR here, so need to box the value first
                 code_gen.emit("ROT_THREE")
                 code_gen.emit("ROT_THREE")
-                code_gen.emit("PRIMITIVE_BOX", TYPED_INT64)
+                code_gen.emit("PRIMITIVE_BOX", self._element_type_code())
                 code_gen.emit("ROT_THREE")
             super().emit_store_subscr(node, code_gen)
 
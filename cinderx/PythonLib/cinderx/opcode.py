@@ -140,5 +140,17 @@ def shadow_op(name, op):
     shadow_op("LOAD_ATTR_DICT_DESCR", 252)
     shadow_op("LOAD_ATTR_UNCACHABLE", 253)
 
+    shadow_op("BINARY_ADD_INT", 201)
+    shadow_op("BINARY_ADD_FLOAT", 202)
+    shadow_op("COMPARE_OP_INT", 203)
+    shadow_op("COMPARE_OP_STR", 204)
+    shadow_op("FOR_ITER_LIST", 214)
+    shadow_op("FOR_ITER_RANGE", 188)
+    shadow_op("FOR_ITER_TUPLE", 173)
+    shadow_op("CALL_FUNCTION_PY", 167)
+    shadow_op("CALL_FUNCTION_BUILTIN", 153)
+    shadow_op("STORE_SUBSCR_LIST", 151)
+    shadow_op("STORE_SUBSCR_DICT", 150)
+
     shadow_op("LOAD_GLOBAL_CACHED", 254)
     shadow_op("SHADOW_NOP", 255)
@@ -67,7 +67,15 @@
     rand,
     RAND_MAX,
     resolve_primitive_descr,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT16,
+    SEQ_ARRAY_INT32,
     SEQ_ARRAY_INT64,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_ARRAY_UINT32,
+    SEQ_ARRAY_UINT64,
+    SEQ_ARRAY_UINT8,
     SEQ_CHECKED_LIST,
     SEQ_LIST,
     SEQ_LIST_INEXACT,
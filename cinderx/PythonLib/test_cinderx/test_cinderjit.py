@@ -8,10 +8,13 @@
 import faulthandler
 import gc
 import itertools
+import json
+import math
 import multiprocessing
 import os
 import re
 import shutil
+import struct
 import subprocess
 import sys
 import tempfile
@@ -391,6 +394,59 @@ def test_inliner_dump_json(self):
                 shutil.rmtree(dumpdir)
                 self.assertEqual(proc.returncode, 0, proc.stderr)
 
+    @cinder_support.skipUnlessJITEnabled("Runs a subprocess with the JIT enabled")
+    def test_inline_profiled_polymorphic_method(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+
+            class A:
+                def f(self, x):
+                    return x + 1
+
+            class B:
+                def f(self, x):
+                    return x * 2
+
+            class C:
+                def f(self, x):
+                    return -x
+
+            def g(obj, x):
+                return obj.f(x)
+
+            objs = [A(), B()]
+            for i in range(300):
+                g(objs[i % 2], i)
+            print(f"compiled: {cinderjit.is_jit_compiled(g)}")
+            print(f"inlined: {cinderjit.get_num_inlined_functions(g)}")
+            print(f"results: {g(A(), 3)} {g(B(), 3)} {g(C(), 3)}")
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=100",
+                    "-X",
+                    "jit-auto-profile=100",
+                    "-X",
+                    "jit-enable-hir-inliner",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+            self.assertEqual(proc.returncode, 0, proc)
+            self.assertEqual(
+                proc.stdout, "compiled: True\ninlined: 2\nresults: 4 6 -3\n"
+            )
+
 
 class InlineCacheStatsTests(unittest.TestCase):
     @jit_suppress
@@ -1178,6 +1234,48 @@ class D:
         d = D()
         self.assertEqual(get_attr(d), "in D")
 
+    def test_megamorphic_site(self):
+        def make_class():
+            class C:
+                def __init__(self, x):
+                    self.x = x
+
+                def m(self):
+                    return self.x
+
+            return C
+
+        @cinder_support.failUnlessJITCompiled
+        def get_x_plus_m(o):
+            return o.x + o.m()
+
+        classes = [make_class() for _ in range(8)]
+        objs = [cls(i) for i, cls in enumerate(classes)]
+        for _ in range(3):
+            self.assertEqual(
+                [get_x_plus_m(o) for o in objs], [2 * i for i in range(8)]
+            )
+
+        # Modifying a type must invalidate its entries in the shared cache.
+        classes[5].x = property(lambda self: 100)
+        classes[6].m = lambda self: -1
+        self.assertEqual(get_x_plus_m(objs[5]), 200)
+        self.assertEqual(get_x_plus_m(objs[6]), 5)
+
+        # So must turning a data descriptor into a non-data descriptor.
+        class Desc:
+            def __get__(self, obj, objtype):
+                return 42
+
+            def __set__(self, obj, value):
+                pass
+
+        classes[7].x = Desc()
+        self.assertEqual(get_x_plus_m(objs[7]), 84)
+        self.assertEqual(get_x_plus_m(objs[7]), 84)
+        del Desc.__set__
+        self.assertEqual(get_x_plus_m(objs[7]), 14)
+
 
 class SetNonDataDescrAttrTests(unittest.TestCase):
     @cinder_support.failUnlessJITCompiled
@@ -3870,6 +3968,53 @@ def test_c_call_error_raised(self):
             self._c_func_that_sets_pyerr()
 
 
+class FloatArithmeticTests(unittest.TestCase):
+    """
+    Arithmetic and ordered comparisons on exact floats are done on unboxed
+    doubles. NaN operands and zero divisors must still behave like they do in
+    the interpreter.
+    """
+
+    @cinder_support.failUnlessJITCompiled
+    def _nan_arithmetic(self):
+        inf = 1e309
+        nan = inf - inf
+        one = 1.0
+        return (nan, nan + one, one - nan, nan * one, one / nan)
+
+    @cinder_support.failUnlessJITCompiled
+    def _nan_compare(self):
+        nan = 1e309 * 0.0
+        one = 1.0
+        return (nan < one, nan <= one, nan > one, nan >= one, one < nan, one >= nan)
+
+    @cinder_support.failUnlessJITCompiled
+    def _divide_by_zero(self):
+        one = 1.0
+        zero = 0.0
+        return one / zero
+
+    @cinder_support.failUnlessJITCompiled
+    def _divide_by_negative_zero(self):
+        one = 1.0
+        zero = -0.0
+        return one / zero
+
+    def test_nan_arithmetic(self):
+        for value in self._nan_arithmetic():
+            self.assertIsInstance(value, float)
+            self.assertTrue(math.isnan(value))
+
+    def test_nan_compare(self):
+        self.assertEqual(self._nan_compare(), (False,) * 6)
+
+    def test_divide_by_zero_raises(self):
+        with self.assertRaisesRegex(ZeroDivisionError, "float division by zero"):
+            self._divide_by_zero()
+        with self.assertRaisesRegex(ZeroDivisionError, "float division by zero"):
+            self._divide_by_negative_zero()
+
+
 class UnpackSequenceTests(unittest.TestCase):
     @failUnlessHasOpcodes("UNPACK_SEQUENCE")
     @cinder_support.failUnlessJITCompiled
@@ -4323,6 +4468,110 @@ def g():
 
             self.assertEqual(cinderjit.get_num_inlined_functions(g), 1)
 
+    def test_peephole_stats(self):
+        before = cinderjit.get_peephole_stats()
+        self.assertIn("fuse_compare_branch", before)
+        self.assertIn("jump_threading", before)
+
+        def f(x, y):
+            if x is y:
+                return 1
+            if x is None:
+                return 2
+            return 3
+
+        cinderjit.force_compile(f)
+        self.assertTrue(cinderjit.is_jit_compiled(f))
+
+        after = cinderjit.get_peephole_stats()
+        self.assertEqual(before.keys(), after.keys())
+        for name, hits in after.items():
+            self.assertGreaterEqual(hits, before[name], name)
+        # Each identity test is only used by the branch after it, so the
+        # branch reads the compare's flags directly.
+        self.assertEqual(
+            after["fuse_compare_branch"] - before["fuse_compare_branch"], 2
+        )
+        self.assertEqual(f(None, None), 1)
+        self.assertEqual(f(None, 0), 2)
+        self.assertEqual(f(0, None), 3)
+
+    def test_gen_data_pool(self):
+        # Keep enough values live across the yield to need a spill area
+        # bigger than the smallest size class.
+        names = [f"v{i}" for i in range(150)]
+        src = "def g():\n"
+        src += "".join(f"    {name} = object()\n" for name in names)
+        src += f"    yield\n    return ({', '.join(names)},)\n"
+        ns = {}
+        exec(src, ns)
+        g = ns["g"]
+        cinderjit.force_compile(g)
+        self.assertTrue(cinderjit.is_jit_compiled(g))
+
+        cinderjit.trim_gen_data_pool()
+        gens = [g() for _ in range(10)]
+        for gen in gens:
+            next(gen)
+        del gens, gen
+        before = cinderjit.get_gen_data_pool_stats()
+        self.assertGreaterEqual(before["retained_blocks"], 10)
+
+        gen = g()
+        next(gen)
+        with self.assertRaises(StopIteration) as exc:
+            next(gen)
+        self.assertEqual(len(exc.exception.value), len(names))
+        after = cinderjit.get_gen_data_pool_stats()
+        self.assertEqual(after["hits"], before["hits"] + 1)
+
+        del gen
+        retained = cinderjit.get_gen_data_pool_stats()["retained_bytes"]
+        self.assertEqual(cinderjit.trim_gen_data_pool(), retained)
+        stats = cinderjit.get_gen_data_pool_stats()
+        self.assertEqual(stats["retained_blocks"], 0)
+        self.assertEqual(stats["retained_bytes"], 0)
+
+    def test_function_perf_report(self):
+        class C:
+            def __init__(self):
+                self.x = 1
+
+            def m(self):
+                return self.x
+
+        def f(c):
+            return c.x + c.m()
+
+        cinderjit.force_compile(f)
+        self.assertTrue(cinderjit.is_jit_compiled(f))
+        for _ in range(10):
+            self.assertEqual(f(C()), 2)
+
+        report = cinderjit.get_function_perf_report(f)
+        exported = json.loads(json.dumps(report))
+        self.assertEqual(exported["qualname"], f.__qualname__)
+        self.assertEqual(len(exported["offsets"]), len(report["offsets"]))
+        self.assertTrue(report["compiled"])
+        self.assertGreater(report["code_size"], 0)
+
+        caches = [
+            cache
+            for offset in report["offsets"].values()
+            for cache in offset.get("caches", [])
+        ]
+        kinds = {cache["kind"] for cache in caches}
+        self.assertIn("LoadAttr", kinds)
+        self.assertIn("LoadMethod", kinds)
+        for cache in caches:
+            self.assertLessEqual(cache["entries_used"], cache["capacity"])
+            self.assertIsInstance(cache["misses"], dict)
+        for offset in report["offsets"].values():
+            self.assertIn("lineno", offset)
+
+        with self.assertRaises(TypeError):
+            cinderjit.get_function_perf_report(1)
+
     def test_max_code_size_slow(self):
         code = textwrap.dedent(
             """
@@ -4415,6 +4664,241 @@ def onek_asserts(actual_stdout):
                 ],
             )
 
+    def test_reclaim_dead_code(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+
+            # Redefine f in the same namespace, like importlib.reload() does.
+            ns = {}
+
+            def churn(i):
+                exec(f"def f(x):\\n    return x + {i}\\n", ns)
+                assert ns["f"](1) == i + 1
+                assert cinderjit.is_jit_compiled(ns["f"])
+
+            churn(-2)
+            churn(-1)
+            used_bytes = cinderjit.get_allocator_stats()["used_bytes"]
+            cinderjit.reclaim_dead_code()
+            func_size = used_bytes - cinderjit.get_allocator_stats()["used_bytes"]
+            print(f"reclaimed: {func_size > 0}")
+
+            for i in range(4000):
+                churn(i)
+            growth = cinderjit.get_allocator_stats()["used_bytes"] - used_bytes
+            print(f"bounded: {growth < 1000 * func_size}")
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            for params in [[], ["-X", "jit-disable-huge-pages"]]:
+                proc = subprocess.run(
+                    [sys.executable, "-X", "jit", *params, "mod.py"],
+                    cwd=tmp,
+                    stdout=subprocess.PIPE,
+                    encoding=sys.stdout.encoding,
+                )
+                self.assertEqual(proc.returncode, 0, proc)
+                self.assertEqual(proc.stdout, "reclaimed: True\nbounded: True\n")
+
+    def test_recompile_after_failed_profiled_guards(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+
+            def f(x):
+                return x + 1
+
+            for i in range(300):
+                f(i)
+            print(f"compiled: {cinderjit.is_jit_compiled(f)}")
+
+            # Each call fails the guard on the profiled int type until f is
+            # recompiled.
+            for i in range(20):
+                f(float(i))
+
+            cinderjit.get_and_clear_runtime_stats()
+            for i in range(20):
+                f(float(i))
+            stats = cinderjit.get_and_clear_runtime_stats()
+            deopts = [d for d in stats["deopt"] if d["normal"]["func_qualname"] == "f"]
+            print(f"recompiled: {cinderjit.is_jit_compiled(f)}")
+            print(f"deopts: {deopts}")
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=100",
+                    "-X",
+                    "jit-auto-profile=100",
+                    "-X",
+                    "jit-deopt-recompile-threshold=10",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+            self.assertEqual(proc.returncode, 0, proc)
+            self.assertEqual(
+                proc.stdout, "compiled: True\nrecompiled: True\ndeopts: []\n"
+            )
+
+    def test_profiled_int_ops_across_compact_boundary(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+            import operator
+
+            def f(a, b):
+                return (
+                    a + b, a - b, a * b, a & b, a | b, a ^ b,
+                    a < b, a <= b, a == b, a != b, a > b, a >= b,
+                )
+
+            for i in range(300):
+                f(i, 3)
+            print(f"compiled: {cinderjit.is_jit_compiled(f)}")
+
+            ops = [
+                operator.add, operator.sub, operator.mul,
+                operator.and_, operator.or_, operator.xor,
+                operator.lt, operator.le, operator.eq,
+                operator.ne, operator.gt, operator.ge,
+            ]
+            values = [0, 1, -1, 7, -7, 2**30 - 1, -(2**30 - 1), 2**30, -(2**30), 2**62, -(2**64)]
+            mismatches = [
+                (a, b)
+                for a in values
+                for b in values
+                if f(a, b) != tuple(op(a, b) for op in ops)
+            ]
+            print(f"mismatches: {mismatches}")
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=100",
+                    "-X",
+                    "jit-auto-profile=100",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+            self.assertEqual(proc.returncode, 0, proc)
+            self.assertEqual(proc.stdout, "compiled: True\nmismatches: []\n")
+
+    def test_profiled_index_loops(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+            import sys
+
+            def sum_list(xs):
+                result = 0
+                for x in xs:
+                    result += x
+                return result
+
+            def sum_tuple(xs):
+                result = 0
+                for x in xs:
+                    result += x
+                return result
+
+            def sum_range(r, items):
+                result = 0
+                for i in r:
+                    result += items[i]
+                return result
+
+            def grow(xs):
+                seen = []
+                for x in xs:
+                    if len(xs) < 6:
+                        xs.append(x + 10)
+                    seen.append(x)
+                return seen
+
+            def gen(xs):
+                for x in xs:
+                    yield x
+
+            items = list(range(11))
+            for i in range(300):
+                sum_list([1, 2, 3])
+                sum_tuple((1, 2, 3))
+                sum_range(range(3), items)
+                grow([1, 2])
+                list(gen([1, 2]))
+            funcs = [sum_list, sum_tuple, sum_range, grow, gen]
+            print(f"compiled: {all(cinderjit.is_jit_compiled(f) for f in funcs)}")
+
+            print(sum_list([1, 2, 3]), sum_tuple((4, 5)), sum_list([]))
+            print(sum_range(range(10, 0, -3), items), sum_range(range(0), items))
+            print(grow([1, 2]), list(gen((7, 8, 9))))
+            # Deopt in the middle of the loop, which has to continue with a
+            # real iterator.
+            print(sum_list([1, 2, 2.5, 3]), sum_tuple((1, 2.5, 3)))
+            print(sum_range(range(4), [1, 2, 2.5, 3]))
+            # Iterables of a type other than the profiled one.
+            print(sum_list((4, 5)), sum_range([0, 1], items))
+            # Too large for a range_iterator.
+            print(sum_range(range(2**70, 2**70 + 2), {2**70: 1, 2**70 + 1: 2}))
+            # The bounds fit in a C long, but start + len * step doesn't.
+            big = sys.maxsize
+            print(sum_range(range(big - 3, big, 2), {big - 3: 1, big - 1: 4}))
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=100",
+                    "-X",
+                    "jit-auto-profile=100",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+            self.assertEqual(proc.returncode, 0, proc)
+            self.assertEqual(
+                proc.stdout,
+                "compiled: True\n"
+                "6 9 0\n"
+                "22 0\n"
+                "[1, 2, 11, 12, 21, 22] [7, 8, 9]\n"
+                "8.5 6.5\n"
+                "8.5\n"
+                "9 1\n"
+                "3\n"
+                "5\n",
+            )
+
     def test_max_code_size_fast(self):
         code = textwrap.dedent(
             """
@@ -4500,6 +4984,102 @@ def run_proc():
                 run_proc(),
             )
 
+    @cinder_support.skipUnlessJITEnabled("Runs a subprocess with the JIT enabled")
+    def test_auto_jit_background_compile(self):
+        code = textwrap.dedent(
+            """
+            import cinderjit
+            import time
+
+            def f(x):
+                return x + 1
+
+            total = 0
+            for i in range(100):
+                total += f(i)
+
+            # f is compiled by a background worker, and keeps running in the
+            # interpreter until the compiled code is installed.
+            deadline = time.monotonic() + 60
+            while not cinderjit.is_jit_compiled(f) and time.monotonic() < deadline:
+                total += f(0)
+                time.sleep(0.01)
+            print(f"compiled: {cinderjit.is_jit_compiled(f)}")
+            print(f"f(41): {f(41)}")
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=10",
+                    "-X",
+                    "jit-auto-background-workers=2",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+        self.assertEqual(proc.returncode, 0, proc)
+        self.assertEqual(proc.stdout, "compiled: True\nf(41): 42\n")
+
+    def test_osr_enters_hot_loop(self):
+        # f is never called often enough to be compiled as a whole, so its loop
+        # can only run in JIT-compiled code through OSR.
+        code = textwrap.dedent(
+            """
+            def f(n, fail_at):
+                total = 0
+                items = []
+                for i in range(n):
+                    if i == fail_at:
+                        # A new type at the loop's add forces a deopt back to
+                        # the interpreter.
+                        total = float(total)
+                    total += i
+                    items.append(i)
+                return total, len(items)
+
+            def g(n):
+                for i in range(n):
+                    if i == n - 1:
+                        raise ValueError(i)
+
+            print(f(1000, -1))
+            print(f(1000, 900))
+            try:
+                g(1000)
+            except ValueError as e:
+                print(repr(e))
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            dirpath = Path(tmp)
+            codepath = dirpath / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit-auto=1000000",
+                    "-X",
+                    "jit-osr-threshold=100",
+                    "mod.py",
+                ],
+                cwd=tmp,
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+        self.assertEqual(proc.returncode, 0, proc)
+        self.assertEqual(
+            proc.stdout, "(499500, 1000)\n(499500.0, 1000)\nValueError(999)\n"
+        )
+
 
 @cinder_support.failUnlessJITCompiled
 def _outer(inner):
@@ -5566,6 +6146,83 @@ def find_mapped_funcs(which):
         self.assertEqual(find_mapped_funcs("child1"), {"main", "child1", "compute"})
         self.assertEqual(find_mapped_funcs("child2"), {"main", "child2", "compute"})
 
+    @cinder_support.skipUnlessJITEnabled("Runs a subprocess with the JIT enabled")
+    def test_jitdump_debug_and_unwinding_info(self):
+        code = textwrap.dedent(
+            """
+            def compute(x):
+                y = x * 2
+                return str(y)
+
+            compute(1)
+        """
+        )
+        with tempfile.TemporaryDirectory() as tmp:
+            codepath = Path(tmp) / "mod.py"
+            codepath.write_text(code)
+            proc = subprocess.run(
+                [
+                    sys.executable,
+                    "-X",
+                    "jit",
+                    "-X",
+                    f"jit-perf-dumpdir={tmp}",
+                    str(codepath),
+                ],
+                stdout=subprocess.PIPE,
+                encoding=sys.stdout.encoding,
+            )
+            self.assertEqual(proc.returncode, 0, proc)
+            (dump,) = Path(tmp).glob("jit-*.dump")
+            data = dump.read_bytes()
+
+        JIT_CODE_LOAD, JIT_CODE_DEBUG_INFO, JIT_CODE_UNWINDING_INFO = 0, 2, 4
+        pos = struct.unpack_from("=I", data, 8)[0]
+        records = []
+        while pos < len(data):
+            rtype, size = struct.unpack_from("=II", data, pos)
+            records.append((rtype, data[pos + 16 : pos + size]))
+            pos += size
+
+        lines = set()
+        load_index = None
+        for i, (rtype, body) in enumerate(records):
+            if rtype == JIT_CODE_LOAD:
+                name = body[40 : body.index(b"\0", 40)].decode()
+                if name.endswith(":__main__:compute"):
+                    load_index = i
+                    code_addr = struct.unpack_from("=Q", body, 8)[0]
+                    break
+        self.assertIsNotNone(load_index)
+
+        # The debug info and unwinding info for the code come right before its
+        # load record.
+        debug_type, debug = records[load_index - 2]
+        self.assertEqual(debug_type, JIT_CODE_DEBUG_INFO)
+        debug_addr, nr_entry = struct.unpack_from("=QQ", debug)
+        self.assertEqual(debug_addr, code_addr)
+        pos = 16
+        for _ in range(nr_entry):
+            addr, lineno, _ = struct.unpack_from("=Qii", debug, pos)
+            end = debug.index(b"\0", pos + 16)
+            self.assertEqual(debug[pos + 16 : end].decode(), str(codepath))
+            self.assertGreaterEqual(addr, code_addr)
+            lines.add(lineno)
+            pos = end + 1
+        self.assertTrue(lines <= {2, 3, 4}, lines)
+        self.assertIn(4, lines)
+
+        unwind_type, unwind = records[load_index - 1]
+        self.assertEqual(unwind_type, JIT_CODE_UNWINDING_INFO)
+        unwinding_size, hdr_size, _ = struct.unpack_from("=QQQ", unwind)
+        eh_frame_size = unwinding_size - hdr_size
+        version, _, _, _, eh_frame_ptr, fde_count = struct.unpack_from(
+            "=BBBBiI", unwind, 24 + eh_frame_size
+        )
+        self.assertEqual(version, 1)
+        self.assertEqual(eh_frame_ptr, -(eh_frame_size + 4))
+        self.assertEqual(fde_count, 1)
+
 
 class BatchCompileTests(unittest.TestCase):
     @cinder_support.skipUnlessJITEnabled("Runs a subprocess with the JIT enabled")
@@ -1,4 +1,4 @@
-from __static__ import Array, int32, int64, int8
+from __static__ import Array, int32, int64, int8, uint64, uint8
 
 import itertools
 import re
@@ -8,7 +8,15 @@
 
 from cinderx.compiler.static.types import (
     FAST_LEN_ARRAY,
+    SEQ_ARRAY_DOUBLE,
+    SEQ_ARRAY_INT16,
+    SEQ_ARRAY_INT32,
     SEQ_ARRAY_INT64,
+    SEQ_ARRAY_INT8,
+    SEQ_ARRAY_UINT16,
+    SEQ_ARRAY_UINT32,
+    SEQ_ARRAY_UINT64,
+    SEQ_ARRAY_UINT8,
     TypedSyntaxError,
 )
 
@@ -512,3 +520,129 @@ def f() -> int64:
             r"cannot unpack multiple values from Array\[int64] while iterating",
         ):
             self.compile(codestr, modname="foo.py")
+
+    def test_array_element_types(self):
+        cases = [
+            ("int8", -100, SEQ_ARRAY_INT8),
+            ("int16", -30000, SEQ_ARRAY_INT16),
+            ("int32", -(2**30), SEQ_ARRAY_INT32),
+            ("int64", -(2**62), SEQ_ARRAY_INT64),
+            ("uint8", 255, SEQ_ARRAY_UINT8),
+            ("uint16", 65535, SEQ_ARRAY_UINT16),
+            ("uint32", 2**32 - 1, SEQ_ARRAY_UINT32),
+            ("uint64", 2**64 - 1, SEQ_ARRAY_UINT64),
+            ("double", -2.5, SEQ_ARRAY_DOUBLE),
+        ]
+        for prim, value, seq_type in cases:
+            zero = "0.0" if prim == "double" else "0"
+            codestr = f"""
+                from __static__ import Array, {prim}, box
+
+                def make() -> Array[{prim}]:
+                    a = Array[{prim}](3)
+                    a[0] = {value}
+                    a[2] = a[0]
+                    return a
+
+                def last(a: Array[{prim}]) -> {prim}:
+                    t: {prim} = {zero}
+                    for el in a:
+                        t = el
+                    return t
+            """
+            with self.subTest(prim=prim):
+                with self.in_module(codestr) as mod:
+                    self.assertInBytecode(mod.make, "SEQUENCE_SET", seq_type)
+                    self.assertInBytecode(mod.make, "SEQUENCE_GET", seq_type)
+                    self.assertInBytecode(
+                        mod.last, "SEQUENCE_GET", seq_type | SEQ_SUBSCR_UNCHECKED
+                    )
+                    a = mod.make()
+                    self.assertEqual(list(a), [value, 0, value])
+                    self.assertEqual(mod.last(a), value)
+
+    def test_array_element_type_is_distinct(self):
+        codestr = """
+            from __static__ import Array, int8, int64
+
+            def h(x: Array[int8]) -> int8:
+                return x[0]
+        """
+        with self.in_module(codestr) as mod:
+            self.assertEqual(mod.h(Array[int8](1)), 0)
+            with self.assertRaises(TypeError):
+                mod.h(Array[int64](1))
+
+    def test_array_set_out_of_range_nonstatic(self):
+        a = Array[int8](1)
+        with self.assertRaises(OverflowError):
+            a[0] = 128
+        a[0] = -128
+        self.assertEqual(a[0], -128)
+
+    def test_array_bulk_ops(self):
+        codestr = """
+            from __static__ import Array, int8, int64, double
+
+            def ints() -> Array[int8]:
+                a = Array[int8](4)
+                a[0] = 1
+                a[1] = -2
+                a[2] = 100
+                a[3] = 7
+                return a
+
+            def doubles() -> Array[double]:
+                a = Array[double](3)
+                a[0] = 0.5
+                a[1] = -1.5
+                a[2] = 4.0
+                return a
+        """
+        with self.in_module(codestr) as mod:
+            a = mod.ints()
+            self.assertEqual(a.sum(), 106)
+            self.assertEqual(a.min(), -2)
+            self.assertEqual(a.max(), 100)
+            self.assertEqual(a.dot(a), 1 + 4 + 10000 + 49)
+            # Elementwise arithmetic wraps like primitive int8 arithmetic.
+            self.assertEqual(list(a.add(a)), [2, -4, -56, 14])
+            self.assertEqual(list(a.mul(a)), [1, 4, 16, 49])
+            mask = a.compare(">", 0)
+            self.assertIs(type(mask), Array[uint8])
+            self.assertEqual(list(mask), [1, 0, 1, 1])
+            self.assertEqual(list(a.compare("==", 7)), [0, 0, 0, 1])
+            b = a.copy()
+            b.fill(3)
+            self.assertEqual(list(b), [3, 3, 3, 3])
+            self.assertEqual(list(a), [1, -2, 100, 7])
+
+            d = mod.doubles()
+            self.assertEqual(d.sum(), 3.0)
+            self.assertEqual(d.min(), -1.5)
+            self.assertEqual(d.max(), 4.0)
+            self.assertEqual(d.dot(d), 0.25 + 2.25 + 16.0)
+            self.assertEqual(list(d.add(d)), [1.0, -3.0, 8.0])
+            self.assertEqual(list(d.compare("<=", 0.5)), [1, 1, 0])
+
+    def test_array_bulk_ops_errors(self):
+        a = Array[int64](2)
+        with self.assertRaisesRegex(ValueError, "lengths differ"):
+            a.dot(Array[int64](3))
+        with self.assertRaises(TypeError):
+            a.add(Array[int32](2))
+        with self.assertRaisesRegex(ValueError, "empty"):
+            Array[int64](0).min()
+        with self.assertRaisesRegex(ValueError, "unknown comparison"):
+            a.compare("<>", 0)
+        with self.assertRaises(OverflowError):
+            Array[int8](2).fill(1000)
+
+    def test_array_sum_overflow(self):
+        a = Array[int64](3)
+        a.fill(2**62)
+        self.assertEqual(a.sum(), 3 * 2**62)
+        self.assertEqual(a.dot(a), 3 * 2**124)
+        u = Array[uint64](2)
+        u.fill(2**64 - 1)
+        self.assertEqual(u.sum(), 2 * (2**64 - 1))
@@ -1,8 +1,14 @@
 import asyncio
+import unittest
 from cinder import cached_property
 
 from .common import StaticTestBase
 
+try:
+    import cinderjit
+except ImportError:
+    cinderjit = None
+
 
 class InvokeTests(StaticTestBase):
     def test_invoke_simple(self):
@@ -922,3 +928,45 @@ def x(c: C):
             self.assertEqual(mod.C.f.__code__.co_freevars, ("__class__",))
             self.assertEqual(mod.x(c), 42)
             self.assertEqual(mod.x(c), 42)
+
+    @unittest.skipIf(cinderjit is None, "JIT disabled")
+    def test_invoke_devirtualized_method_new_subclass(self):
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            def x(c: C) -> int:
+                return c.f()
+        """
+        with self.in_module(codestr) as mod:
+            cinderjit.force_compile(mod.x)
+            self.assertEqual(mod.x(mod.C()), 1)
+
+            class D(mod.C):
+                def f(self) -> int:
+                    return 2
+
+            self.assertEqual(mod.x(D()), 2)
+            self.assertEqual(mod.x(mod.C()), 1)
+
+    @unittest.skipIf(cinderjit is None, "JIT disabled")
+    def test_invoke_devirtualized_method_patched(self):
+        codestr = """
+            class C:
+                def f(self) -> int:
+                    return 1
+
+            class D(C):
+                pass
+
+            def x(c: C) -> int:
+                return c.f()
+        """
+        with self.in_module(codestr) as mod:
+            cinderjit.force_compile(mod.x)
+            self.assertEqual(mod.x(mod.D()), 1)
+
+            mod.D.f = lambda self: 3
+            self.assertEqual(mod.x(mod.D()), 3)
+            self.assertEqual(mod.x(mod.C()), 1)
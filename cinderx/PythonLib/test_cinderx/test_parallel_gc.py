@@ -2,6 +2,7 @@
 
 import gc
 import unittest
+import weakref
 
 import test.test_gc
 
@@ -50,6 +51,50 @@ def test_set_invalid_num_threads(self):
         with self.assertRaisesRegex(ValueError, "invalid num_threads"):
             cinder.enable_parallel_gc(2, -1)
 
+    def test_set_slice_budget_when_disabled(self):
+        with self.assertRaisesRegex(RuntimeError, "not enabled"):
+            cinder.set_parallel_gc_slice_budget(1000)
+
+    def test_set_invalid_slice_budget(self):
+        cinder.enable_parallel_gc(2, 8)
+        with self.assertRaisesRegex(ValueError, "invalid slice budget"):
+            cinder.set_parallel_gc_slice_budget(-1)
+
+    def test_get_stats(self):
+        self.assertEqual(cinder.get_parallel_gc_stats(), None)
+        cinder.enable_parallel_gc(2, 8)
+        stats = cinder.get_parallel_gc_stats()
+        self.assertEqual(stats["slice_budget_us"], 0)
+        self.assertEqual(stats["slices"], 0)
+
+    def test_incremental_collects_old_cycle(self):
+        class Node:
+            pass
+
+        cinder.enable_parallel_gc(2, 8)
+        cinder.set_parallel_gc_slice_budget(1000)
+
+        a = Node()
+        a.other = Node()
+        a.other.other = a
+        ref = weakref.ref(a)
+        # Move the cycle to the oldest generation.
+        gc.collect()
+        del a
+
+        for _ in range(10000):
+            if ref() is None:
+                break
+            gc.collect(1)
+        self.assertIsNone(ref())
+
+        stats = cinder.get_parallel_gc_stats()
+        self.assertEqual(stats["slice_budget_us"], 1000)
+        self.assertGreater(stats["slices"], 0)
+        self.assertGreater(stats["slice_objects"], 0)
+        self.assertGreaterEqual(stats["max_slice_us"], stats["last_slice_us"])
+        self.assertGreaterEqual(stats["total_slice_us"], stats["max_slice_us"])
+
 
 # Run all the GC tests with parallel GC enabled
 
@@ -4,6 +4,7 @@
 
 import builtins
 import cinder
+import dis
 import gc
 import inspect
 import opcode
@@ -2641,6 +2642,179 @@ def f(c, k):
         for __ in range(REPETITION):
             self.assertEqual(f(l, 1), 2)
 
+    def test_binary_add_to_other_types(self):
+        def f(a, b):
+            return a + b
+
+        def g(a, b):
+            a += b
+            return a
+
+        for func in (f, g):
+            for __ in range(REPETITION):
+                self.assertEqual(func(1, 2), 3)
+                self.assertEqual(func(2**70, 1), 2**70 + 1)
+            for __ in range(REPETITION):
+                self.assertEqual(func(1.5, 2.0), 3.5)
+            for __ in range(REPETITION):
+                self.assertEqual(func("a", "b"), "ab")
+                self.assertEqual(func([1], [2]), [1, 2])
+                self.assertEqual(func(1, 2.5), 3.5)
+            self.assertRaises(TypeError, func, 1, "a")
+
+    def test_compare_op_to_other_types(self):
+        def f(a, b):
+            return a < b
+
+        for __ in range(REPETITION):
+            self.assertTrue(f(1, 2))
+            self.assertFalse(f(2**70, 1))
+        for __ in range(REPETITION):
+            self.assertTrue(f("a", "b"))
+            self.assertFalse(f("b", "a"))
+        for __ in range(REPETITION):
+            self.assertTrue(f(1, 2.5))
+            self.assertTrue(f((1,), (2,)))
+        self.assertRaises(TypeError, f, 1, "a")
+
+    def test_for_iter_to_other_iterators(self):
+        def f(it):
+            total = 0
+            for x in it:
+                total += x
+            return total
+
+        for __ in range(REPETITION):
+            self.assertEqual(f([1, 2, 3]), 6)
+        for __ in range(REPETITION):
+            self.assertEqual(f(range(-3, 10, 2)), 21)
+        for __ in range(REPETITION):
+            self.assertEqual(f((1, 2, 3)), 6)
+        for __ in range(REPETITION):
+            self.assertEqual(f({1: 0, 2: 0}), 3)
+            self.assertEqual(f(x for x in [4, 5]), 9)
+
+    def test_for_iter_list_mutated(self):
+        def f(l):
+            res = []
+            for x in l:
+                if x == 0:
+                    l.append(1)
+                res.append(x)
+            return res
+
+        for __ in range(REPETITION):
+            self.assertEqual(f([0, 2]), [0, 2, 1])
+
+    def test_call_function_to_other_callables(self):
+        def add(a, b):
+            return a + b
+
+        def f(func, a, b):
+            return func(a, b)
+
+        for __ in range(REPETITION):
+            self.assertEqual(f(add, 1, 2), 3)
+        for __ in range(REPETITION):
+            self.assertEqual(f(max, 1, 2), 2)
+            self.assertEqual(f(divmod, 7, 2), (3, 1))
+        for __ in range(REPETITION):
+            self.assertEqual(f(lambda a, b: a * b, 3, 4), 12)
+            self.assertEqual(f(complex, 1, 2), 1 + 2j)
+        self.assertRaises(TypeError, f, add, 1, "a")
+        self.assertRaises(TypeError, f, divmod, 1, "a")
+
+    def test_call_builtin_with_profiling(self):
+        def f(x):
+            return len(x)
+
+        for __ in range(REPETITION):
+            self.assertEqual(f([1]), 1)
+
+        calls = []
+
+        def profile(frame, event, arg):
+            if event == "c_call":
+                calls.append(arg)
+
+        sys.setprofile(profile)
+        try:
+            f([1])
+        finally:
+            sys.setprofile(None)
+        self.assertIn(len, calls)
+
+    def _shadow_opname(self, func, opname):
+        """Return the name of the shadow opcode in place of the only `opname`
+        instruction in func's byte code."""
+        (offset,) = [
+            instr.offset
+            for instr in dis.get_instructions(func)
+            if instr.opname == opname
+        ]
+        shadow = cinder._get_shadow_code(func.__code__)
+        self.assertIsNotNone(shadow)
+        return opcode.opname[shadow[offset]]
+
+    def test_polymorphic_site_stays_generic(self):
+        def f(a, b):
+            return a + b
+
+        for __ in range(REPETITION):
+            self.assertEqual(f(1, 2), 3)
+        self.assertEqual(self._shadow_opname(f, "BINARY_ADD"), "BINARY_ADD_INT")
+
+        for __ in range(REPETITION):
+            self.assertEqual(f(1, 2), 3)
+            self.assertEqual(f(1.5, 2.0), 3.5)
+        self.assertEqual(self._shadow_opname(f, "BINARY_ADD"), "BINARY_ADD")
+
+        # The site has given up on specializing, even for a single type.
+        for __ in range(REPETITION):
+            self.assertEqual(f(1, 2), 3)
+        self.assertEqual(self._shadow_opname(f, "BINARY_ADD"), "BINARY_ADD")
+
+    def test_call_builtin_not_quickened_while_profiling(self):
+        def f(x):
+            return len(x)
+
+        sys.setprofile(lambda frame, event, arg: None)
+        try:
+            for __ in range(REPETITION):
+                self.assertEqual(f([1]), 1)
+        finally:
+            sys.setprofile(None)
+        self.assertEqual(self._shadow_opname(f, "CALL_FUNCTION"), "CALL_FUNCTION")
+
+        for __ in range(REPETITION):
+            self.assertEqual(f([1]), 1)
+        self.assertEqual(
+            self._shadow_opname(f, "CALL_FUNCTION"), "CALL_FUNCTION_BUILTIN"
+        )
+
+    def test_store_subscr_to_other_types(self):
+        def f(c, k, v):
+            c[k] = v
+
+        l = [0, 0, 0]
+        d = {}
+        for __ in range(REPETITION):
+            f(l, 0, 1)
+            f(l, -1, 2)
+        self.assertEqual(l, [1, 0, 2])
+        self.assertRaises(IndexError, f, l, 3, 0)
+        self.assertRaises(IndexError, f, l, 2**70, 0)
+        self.assertRaises(TypeError, f, l, "a", 0)
+        for __ in range(REPETITION):
+            f(d, "a", 1)
+            f(d, 1, 2)
+        self.assertEqual(d, {"a": 1, 1: 2})
+        self.assertRaises(TypeError, f, d, [], 0)
+        for __ in range(REPETITION):
+            f(l, slice(0, 2), [5, 6])
+            f(UserDict(), "a", 1)
+        self.assertEqual(l, [5, 6, 2])
+
     def test_tuple_int_const_key_two_tuples(self):
         t = (1, 2, 3)
         t2 = (3, 4, 5)
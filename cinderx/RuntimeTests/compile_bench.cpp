@@ -0,0 +1,485 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+// Benchmark for JIT compile time. Replays a corpus of functions through the
+// compiler and reports how long each compilation phase takes, along with the
+// peak heap usage and generated code size of each function.
+//
+// The corpus is made of the Python test cases in RuntimeTests/hir_tests, plus
+// any files passed with --corpus. Those hold a marshalled list of code
+// objects, as written by RuntimeTests/make_compile_bench_corpus.py.
+//
+// Usage:
+//   compile_bench [--hir-tests DIR] [--corpus FILE]... [--iterations N]
+//                 [--verbose]
+
+#include "Python.h"
+#include "cinderx/Common/ref.h"
+#include "cinderx/Common/util.h"
+#include "cinderx/StaticPython/strictmoduleobject.h"
+#include "internal/pycore_interp.h"
+#include "marshal.h"
+
+#include "cinderx/Jit/compiler.h"
+#include "cinderx/Jit/config.h"
+#include "cinderx/Jit/hir/preload.h"
+#include "cinderx/Jit/jit_time_log.h"
+#include "cinderx/Jit/pyjit.h"
+
+#include "cinderx/RuntimeTests/testutil.h"
+
+#include <fmt/format.h>
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The JIT allocates all of its compile-time data structures with operator
+// new, so tracking it here gives the heap usage of a compilation.
+std::atomic<size_t> g_heap_bytes{0};
+std::atomic<size_t> g_heap_peak{0};
+
+void* trackedAlloc(size_t size) {
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  size_t bytes = g_heap_bytes += malloc_usable_size(ptr);
+  size_t peak = g_heap_peak.load(std::memory_order_relaxed);
+  while (bytes > peak && !g_heap_peak.compare_exchange_weak(peak, bytes)) {
+  }
+  return ptr;
+}
+
+void trackedFree(void* ptr) {
+  if (ptr != nullptr) {
+    g_heap_bytes -= malloc_usable_size(ptr);
+    std::free(ptr);
+  }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  return trackedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+  return trackedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  trackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  trackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  trackedFree(ptr);
+}
+
+namespace {
+
+constexpr char kModName[] = "compile_bench";
+constexpr char kDisabledPrefix[] = "@disabled";
+
+struct BenchFunction {
+  std::string name;
+  Ref<PyFunctionObject> func;
+};
+
+struct Options {
+  std::string hir_tests_dir{"RuntimeTests/hir_tests"};
+  std::vector<std::string> corpus_files;
+  int iterations{5};
+  bool verbose{false};
+};
+
+// Phase timings for one compilation, keyed by the path of the phase in the
+// CompilationPhaseTimer tree, e.g. "Overall compilation/Lowering into HIR".
+using PhaseTimes = std::map<std::string, int64_t>;
+
+void addPhaseTimes(
+    PhaseTimes& times,
+    const jit::SubPhaseTimer& phase,
+    const std::string& prefix) {
+  std::string path = prefix.empty() ? phase.sub_phase_name
+                                    : prefix + "/" + phase.sub_phase_name;
+  times[path] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     phase.end - phase.start)
+                     .count();
+  for (auto& child : phase.children) {
+    addPhaseTimes(times, *child, path);
+  }
+}
+
+Ref<> makeGlobals(bool compile_static) {
+  auto name = Ref<>::steal(PyUnicode_FromString(kModName));
+  if (name == nullptr) {
+    return nullptr;
+  }
+  Ref<> module;
+  Ref<> globals;
+  if (compile_static) {
+    globals = Ref<>::steal(PyDict_New());
+    if (globals == nullptr ||
+        PyDict_SetItemString(globals, "__name__", name) < 0) {
+      return nullptr;
+    }
+    auto args = Ref<>::steal(PyTuple_Pack(1, globals.get()));
+    auto kwargs = Ref<>::steal(PyDict_New());
+    if (args == nullptr || kwargs == nullptr) {
+      return nullptr;
+    }
+    module = Ref<>::steal(
+        Ci_StrictModule_New(&Ci_StrictModule_Type, args.get(), kwargs.get()));
+  } else {
+    module = Ref<>::steal(PyModule_NewObject(name));
+    if (module != nullptr) {
+      globals = Ref<>::create(PyModule_GetDict(module));
+    }
+  }
+  if (module == nullptr) {
+    return nullptr;
+  }
+
+  // Look up the builtins module to mimic real code, like RuntimeTest does.
+  auto modules = PyThreadState_Get()->interp->modules;
+  auto builtins = PyDict_GetItemString(modules, "builtins");
+  if (PyDict_SetItemString(globals, "__builtins__", builtins) < 0 ||
+      PyDict_SetItemString(modules, kModName, module) < 0) {
+    return nullptr;
+  }
+  return globals;
+}
+
+// Compile src with the Cinder compiler and return its `test` function.
+Ref<PyFunctionObject> compileTestFunction(
+    const std::string& src,
+    bool compile_static) {
+  const char* compiler_module =
+      compile_static ? "cinderx.compiler.static" : "cinderx.compiler";
+  const char* exec_fn = compile_static ? "exec_static" : "exec_cinder";
+  auto compiler = Ref<>::steal(PyImport_ImportModule(compiler_module));
+  if (compiler == nullptr) {
+    return nullptr;
+  }
+  auto exec = Ref<>::steal(PyObject_GetAttrString(compiler, exec_fn));
+  auto globals = makeGlobals(compile_static);
+  auto src_obj = Ref<>::steal(PyUnicode_FromString(src.c_str()));
+  auto mod_name = Ref<>::steal(PyUnicode_FromString(kModName));
+  if (exec == nullptr || globals == nullptr || src_obj == nullptr ||
+      mod_name == nullptr) {
+    return nullptr;
+  }
+  auto res = Ref<>::steal(PyObject_CallFunctionObjArgs(
+      exec.get(),
+      src_obj.get(),
+      globals.get(),
+      globals.get(),
+      mod_name.get(),
+      nullptr));
+  if (res == nullptr) {
+    return nullptr;
+  }
+  BorrowedRef<> func = PyDict_GetItemString(globals, "test");
+  if (func == nullptr || !PyFunction_Check(func)) {
+    return nullptr;
+  }
+  return Ref<PyFunctionObject>::create(func);
+}
+
+bool loadHIRTests(const Options& opts, std::vector<BenchFunction>& corpus) {
+  std::vector<std::filesystem::path> paths;
+  std::error_code ec;
+  for (auto& entry :
+       std::filesystem::directory_iterator(opts.hir_tests_dir, ec)) {
+    if (entry.path().extension() == ".txt") {
+      paths.push_back(entry.path());
+    }
+  }
+  if (ec) {
+    std::cerr << "Couldn't read " << opts.hir_tests_dir << ": " << ec.message()
+              << std::endl;
+    return false;
+  }
+  std::sort(paths.begin(), paths.end());
+
+  for (auto& path : paths) {
+    auto suite = ReadHIRTestSuite(path.string());
+    if (suite == nullptr) {
+      return false;
+    }
+    // Mirrors the suites registered with HIRTest::kCompileStatic.
+    std::string filename = path.filename().string();
+    bool compile_static = filename.find("static") != std::string::npos ||
+        filename == "dead_code_elimination_and_simplify_test.txt" ||
+        filename == "hir_builder_native_calls_test.txt" ||
+        filename == "super_access_test.txt";
+    for (auto& test_case : suite->test_cases) {
+      if (test_case.src_is_hir ||
+          test_case.name.starts_with(kDisabledPrefix)) {
+        continue;
+      }
+      auto func = compileTestFunction(test_case.src, compile_static);
+      if (func == nullptr) {
+        // Some cases exercise compiler errors on purpose.
+        PyErr_Clear();
+        continue;
+      }
+      corpus.push_back(
+          {fmt::format("{}.{}", suite->name, test_case.name), std::move(func)});
+    }
+  }
+  return true;
+}
+
+bool loadCorpusFile(const std::string& path, std::vector<BenchFunction>& corpus) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Couldn't open " << path << std::endl;
+    return false;
+  }
+  std::string data{
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  auto codes = Ref<>::steal(
+      PyMarshal_ReadObjectFromString(data.data(), data.size()));
+  if (codes == nullptr || !PyList_Check(codes)) {
+    PyErr_Clear();
+    std::cerr << path << " doesn't hold a marshalled list of code objects"
+              << std::endl;
+    return false;
+  }
+
+  auto globals = makeGlobals(false);
+  if (globals == nullptr) {
+    return false;
+  }
+  size_t skipped = 0;
+  for (Py_ssize_t i = 0; i < PyList_GET_SIZE(codes.get()); i++) {
+    BorrowedRef<PyCodeObject> code = PyList_GET_ITEM(codes.get(), i);
+    // Closures need cells that only their enclosing function can provide.
+    if (!PyCode_Check(code) || PyCode_GetNumFree(code) > 0) {
+      skipped++;
+      continue;
+    }
+    auto func = Ref<PyFunctionObject>::steal(
+        PyFunction_NewWithQualName(code, globals, code->co_qualname));
+    if (func == nullptr) {
+      return false;
+    }
+    corpus.push_back(
+        {fmt::format(
+             "{}:{}",
+             jit::unicodeAsString(code->co_filename),
+             jit::unicodeAsString(code->co_qualname)),
+         std::move(func)});
+  }
+  if (skipped > 0) {
+    std::cerr << "Skipped " << skipped << " closures in " << path
+              << std::endl;
+  }
+  return true;
+}
+
+struct FunctionResult {
+  PhaseTimes phase_times;
+  size_t peak_heap{0};
+  size_t code_size{0};
+  bool compiled{false};
+};
+
+// Compile func opts.iterations times, keeping the fastest time of each phase.
+FunctionResult benchmarkFunction(
+    const Options& opts,
+    BorrowedRef<PyFunctionObject> func) {
+  FunctionResult result;
+  PhaseTimes iteration_times;
+  jit::setCompilationPhaseObserver(
+      [&](const std::string&, const jit::SubPhaseTimer& root) {
+        addPhaseTimes(iteration_times, root, "");
+      });
+
+  for (int i = 0; i < opts.iterations; i++) {
+    iteration_times.clear();
+    size_t heap_base = g_heap_bytes.load();
+    g_heap_peak = heap_base;
+
+    auto start = std::chrono::steady_clock::now();
+    auto preloader = jit::hir::Preloader::makePreloader(func);
+    iteration_times["Preload"] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    if (preloader == nullptr) {
+      PyErr_Clear();
+      break;
+    }
+    auto compiled = jit::Compiler().Compile(*preloader);
+    if (compiled == nullptr) {
+      break;
+    }
+
+    result.compiled = true;
+    result.code_size = compiled->codeSize();
+    result.peak_heap = std::max(result.peak_heap, g_heap_peak - heap_base);
+    for (auto& [phase, ns] : iteration_times) {
+      auto [it, inserted] = result.phase_times.emplace(phase, ns);
+      if (!inserted) {
+        it->second = std::min(it->second, ns);
+      }
+    }
+  }
+
+  jit::setCompilationPhaseObserver(nullptr);
+  return result;
+}
+
+bool parseArgs(int argc, char* argv[], Options& opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--hir-tests" && has_value) {
+      opts.hir_tests_dir = argv[++i];
+    } else if (arg == "--corpus" && has_value) {
+      opts.corpus_files.emplace_back(argv[++i]);
+    } else if (arg == "--iterations" && has_value) {
+      opts.iterations = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--verbose") {
+      opts.verbose = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--hir-tests DIR] [--corpus FILE]... [--iterations N] "
+                   "[--verbose]"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int runBenchmarks(const Options& opts) {
+  std::vector<BenchFunction> corpus;
+  if (!opts.hir_tests_dir.empty() && !loadHIRTests(opts, corpus)) {
+    return 1;
+  }
+  for (auto& path : opts.corpus_files) {
+    if (!loadCorpusFile(path, corpus)) {
+      return 1;
+    }
+  }
+
+  // Every compilation reports its phases, not only ones matching -X jit-time.
+  jit::parseAndSetFuncList("*");
+
+  PhaseTimes total_times;
+  std::vector<std::string> phase_order;
+  size_t total_code_size = 0;
+  size_t max_peak_heap = 0;
+  size_t num_compiled = 0;
+  for (auto& bench_func : corpus) {
+    FunctionResult result = benchmarkFunction(opts, bench_func.func);
+    if (!result.compiled) {
+      std::cerr << "Failed to compile " << bench_func.name << std::endl;
+      continue;
+    }
+    num_compiled++;
+    total_code_size += result.code_size;
+    max_peak_heap = std::max(max_peak_heap, result.peak_heap);
+    for (auto& [phase, ns] : result.phase_times) {
+      if (total_times.emplace(phase, 0).second) {
+        phase_order.push_back(phase);
+      }
+      total_times[phase] += ns;
+    }
+    if (opts.verbose) {
+      std::cout << fmt::format(
+          "{:<72} {:>10.1f}us {:>8}KiB {:>8}B\n",
+          bench_func.name,
+          result.phase_times["Overall compilation"] / 1000.0,
+          result.peak_heap / 1024,
+          result.code_size);
+    }
+  }
+  jit::parseAndSetFuncList("");
+
+  std::sort(phase_order.begin(), phase_order.end());
+  std::cout << fmt::format(
+      "Compiled {} of {} functions, best of {} iterations each\n\n",
+      num_compiled,
+      corpus.size(),
+      opts.iterations);
+  std::cout << fmt::format(
+      "{:<64} {:>12} {:>12}\n", "Phase", "Total/us", "Mean/us");
+  for (auto& phase : phase_order) {
+    double total_us = total_times[phase] / 1000.0;
+    std::cout << fmt::format(
+        "{:<64} {:>12.1f} {:>12.2f}\n",
+        phase,
+        total_us,
+        num_compiled == 0 ? 0.0 : total_us / num_compiled);
+  }
+  std::cout << fmt::format(
+      "\nTotal code size: {} bytes\nLargest peak heap usage: {} KiB\n",
+      total_code_size,
+      max_peak_heap / 1024);
+  return 0;
+}
+
+} // namespace
+
+#ifdef BAKED_IN_PYTHONPATH
+#define _QUOTE(x) #x
+#define QUOTE(x) _QUOTE(x)
+#define _BAKED_IN_PYTHONPATH QUOTE(BAKED_IN_PYTHONPATH)
+#endif
+
+int main(int argc, char* argv[]) {
+#ifdef BAKED_IN_PYTHONPATH
+  setenv("PYTHONPATH", _BAKED_IN_PYTHONPATH, 1);
+#endif
+
+  Options opts;
+  if (!parseArgs(argc, argv, opts)) {
+    return 2;
+  }
+
+  wchar_t* argv0 = Py_DecodeLocale(argv[0], nullptr);
+  if (argv0 == nullptr) {
+    std::cerr << "Py_DecodeLocale() failed to allocate\n";
+    std::abort();
+  }
+  Py_SetProgramName(argv0);
+
+  jit::getMutableConfig().force_init = true;
+  Py_Initialize();
+  int result;
+  {
+    jit::IsolatedPreloaders isolated_preloaders;
+    result = runBenchmarks(opts);
+  }
+  jit::getMutableConfig().force_init = false;
+  if (Py_FinalizeEx() < 0) {
+    result = 1;
+  }
+
+  PyMem_RawFree(argv0);
+  return result;
+}
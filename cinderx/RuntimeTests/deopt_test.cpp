@@ -184,6 +184,72 @@ def test(a, b):
   ASSERT_EQ(PyLong_AsLong(result), 30);
 }
 
+TEST_F(ReifyFrameTest, ReifyVirtualTuple) {
+  const char* src = R"(
+def test(a, b):
+  t = (a, b)
+  return t[0] + t[1]
+)";
+  Ref<PyFunctionObject> func(compileAndGet(src, "test"));
+  ASSERT_NE(func, nullptr);
+
+  uint64_t regs[PhyLocation::NUM_GP_REGS];
+
+  auto a = Ref<>::steal(PyLong_FromLong(10));
+  ASSERT_NE(a, nullptr);
+  regs[PhyLocation::RDI] = reinterpret_cast<uint64_t>(a.get());
+  LiveValue a_val{
+      PhyLocation{PhyLocation::RDI},
+      RefKind::kOwned,
+      ValueKind::kObject,
+      LiveValue::Source::kUnknown};
+
+  auto b = Ref<>::steal(PyLong_FromLong(20));
+  ASSERT_NE(b, nullptr);
+  regs[PhyLocation::RSI] = reinterpret_cast<uint64_t>(b.get());
+  LiveValue b_val{
+      PhyLocation{PhyLocation::RSI},
+      RefKind::kOwned,
+      ValueKind::kObject,
+      LiveValue::Source::kUnknown};
+
+  // t was never allocated; it is rebuilt from a and b.
+  LiveValue t_val{
+      PhyLocation{0},
+      RefKind::kUncounted,
+      ValueKind::kObject,
+      LiveValue::Source::kUnknown,
+      LiveValue::VirtualKind::kTuple,
+      {0, 1}};
+
+  PyCodeObject* code =
+      reinterpret_cast<PyCodeObject*>(PyFunction_GetCode(func));
+
+  DeoptMetadata dm;
+  dm.live_values = {a_val, b_val, t_val};
+  DeoptFrameMetadata dfm;
+  dfm.localsplus = {0, 1, 2};
+  dfm.next_instr_offset = BCOffset{8};
+  dm.frame_meta.push_back(dfm);
+
+  PyThreadState* tstate = PyThreadState_Get();
+  auto frame = Ref<PyFrameObject>::steal(
+      PyFrame_New(tstate, code, PyFunction_GetGlobals(func), nullptr));
+
+  reifyFrame(frame, dm, dfm, regs);
+
+  PyObject* t = frame->f_localsplus[2];
+  ASSERT_TRUE(PyTuple_CheckExact(t));
+  ASSERT_EQ(PyTuple_GET_SIZE(t), 2);
+  ASSERT_EQ(PyTuple_GET_ITEM(t, 0), a.get());
+  ASSERT_EQ(PyTuple_GET_ITEM(t, 1), b.get());
+
+  auto result = Ref<>::steal(PyEval_EvalFrame(frame));
+  ASSERT_NE(result, nullptr);
+  ASSERT_TRUE(PyLong_CheckExact(result));
+  ASSERT_EQ(PyLong_AsLong(result), 30);
+}
+
 TEST_F(ReifyFrameTest, ReifyInLoop) {
   const char* src = R"(
 def test(num):
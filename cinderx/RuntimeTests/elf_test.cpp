@@ -37,3 +37,42 @@ TEST_F(ElfTest, OneEntry) {
 
   verifyMagic(result);
 }
+
+TEST_F(ElfTest, RoundTripEntries) {
+  std::stringstream ss;
+
+  const char code1[] = "\x55\x48\x89\xe5\xc3";
+  const char code2[] = "\xc3";
+
+  elf::CodeEntry entry1;
+  entry1.code = std::as_bytes(std::span{code1, sizeof(code1) - 1});
+  entry1.func_name = "mod:f";
+  entry1.code_key = "mod.py:1:f:1234";
+
+  elf::CodeEntry entry2;
+  entry2.code = std::as_bytes(std::span{code2, sizeof(code2) - 1});
+  entry2.func_name = "mod:g";
+
+  elf::writeEntries(ss, {entry1, entry2});
+
+  auto entries = elf::readEntries(ss);
+  ASSERT_TRUE(entries.has_value());
+  ASSERT_EQ(entries->size(), 2u);
+
+  EXPECT_EQ((*entries)[0].func_name, "mod:f");
+  EXPECT_EQ((*entries)[0].code_key, "mod.py:1:f:1234");
+  ASSERT_EQ((*entries)[0].code.size(), entry1.code.size());
+  EXPECT_EQ(
+      std::memcmp(
+          (*entries)[0].code.data(), entry1.code.data(), entry1.code.size()),
+      0);
+
+  EXPECT_EQ((*entries)[1].func_name, "mod:g");
+  EXPECT_EQ((*entries)[1].code_key, "");
+  EXPECT_EQ((*entries)[1].code.size(), 1u);
+}
+
+TEST_F(ElfTest, ReadRejectsGarbage) {
+  std::stringstream ss{"not an elf file"};
+  EXPECT_FALSE(elf::readEntries(ss).has_value());
+}
@@ -5,6 +5,8 @@
 
 #include "cinderx/Jit/hir/ssa.h"
 #include "cinderx/Jit/hir/type.h"
+#include "cinderx/StaticPython/classloader.h"
+#include "cinderx/StaticPython/static_array.h"
 
 #include "cinderx/RuntimeTests/fixtures.h"
 
@@ -232,6 +234,23 @@ my_obj = MyClass()
   EXPECT_EQ(Type::fromObject(my_obj).runtimePyType(), my_class);
 }
 
+TEST_F(HIRTypeTest, StaticArrayTypes) {
+  EXPECT_EQ(Type::fromType(&PyStaticArray_Type), TArray);
+  EXPECT_TRUE(TArray.isStaticArray());
+
+  PyTypeObject* int8_array = _Ci_StaticArray_TypeForElement(TYPED_INT8);
+  ASSERT_NE(int8_array, nullptr);
+  Type int8_ty = Type::fromType(int8_array);
+  EXPECT_EQ(int8_ty, Type::fromTypeExact(int8_array));
+  EXPECT_TRUE(int8_ty.isStaticArray());
+  EXPECT_EQ(int8_ty.runtimePyType(), int8_array);
+  EXPECT_FALSE(int8_ty.couldBe(TArray));
+
+  EXPECT_FALSE(TObject.isStaticArray());
+  EXPECT_FALSE((TArray | int8_ty).isStaticArray());
+  EXPECT_FALSE(TListExact.isStaticArray());
+}
+
 TEST_F(HIRTypeTest, IsExact) {
   EXPECT_FALSE(TObject.isExact());
   EXPECT_TRUE(TObjectExact.isExact());
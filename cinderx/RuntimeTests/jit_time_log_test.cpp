@@ -76,3 +76,30 @@ Phase                Time/µs       Leaf/%     Sub Phase/%     Unattributed Time
 
 )") != std::string::npos);
 }
+
+TEST_F(JITTimeLogTest, ObserverReceivesPhaseTree) {
+  std::vector<std::string> phases;
+  setCompilationPhaseObserver(
+      [&](const std::string& function_name, const SubPhaseTimer& root) {
+        phases.push_back(function_name);
+        phases.push_back(root.sub_phase_name);
+        for (auto& child : root.children) {
+          phases.push_back(child->sub_phase_name);
+        }
+      });
+
+  CompilationPhaseTimer compilation_phase_timer("function_name");
+  compilation_phase_timer.start("Overall compilation");
+  compilation_phase_timer.start("Subphase 1");
+  compilation_phase_timer.end();
+  testing::internal::CaptureStderr();
+  compilation_phase_timer.end();
+  std::string output = testing::internal::GetCapturedStderr();
+  setCompilationPhaseObserver(nullptr);
+
+  EXPECT_EQ(output, "");
+  EXPECT_EQ(
+      phases,
+      (std::vector<std::string>{
+          "function_name", "Overall compilation", "Subphase 1"}));
+}
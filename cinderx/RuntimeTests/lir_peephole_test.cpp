@@ -0,0 +1,178 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include "cinderx/Jit/codegen/environ.h"
+#include "cinderx/Jit/lir/parser.h"
+#include "cinderx/Jit/lir/peephole.h"
+#include "cinderx/Jit/lir/verify.h"
+
+#include "cinderx/RuntimeTests/fixtures.h"
+#include "cinderx/RuntimeTests/testutil.h"
+
+#include <map>
+
+using namespace jit;
+
+namespace jit::lir {
+class LIRPeepholeTest : public RuntimeTest {
+ protected:
+  void runPeephole(Function* func) {
+    jit::codegen::Environ env;
+    PeepholeOptimizer peephole(func, &env);
+    peephole.run();
+    ASSERT_TRUE(verifyPostRegAllocInvariants(func, std::cout));
+  }
+
+  std::vector<Instruction::Opcode> opcodes(BasicBlock* block) {
+    std::vector<Instruction::Opcode> result;
+    for (auto& instr : block->instructions()) {
+      result.push_back(instr->opcode());
+    }
+    return result;
+  }
+};
+
+TEST_F(LIRPeepholeTest, FusesCompareIntoBranch) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %1 %2
+      RAX:Object = LessThanSigned RDI:Object, RSI:Object
+                   Test RAX:Object, RAX:Object
+                   BranchZ BB%2
+BB %1 - preds: %0
+      RAX:Object = Move RDI:Object
+BB %2 - preds: %0
+      RAX:Object = Move RSI:Object
+)");
+
+  Parser parser;
+  auto func = parser.parse(lir_input_str);
+  runPeephole(func.get());
+
+  EXPECT_EQ(
+      opcodes(func->basicblocks()[0]),
+      (std::vector<Instruction::Opcode>{
+          Instruction::kLessThanSigned, Instruction::kBranchGE}));
+}
+
+TEST_F(LIRPeepholeTest, FusesArithmeticIntoBranch) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %1 %2
+                   Sub RDI:64bit, RSI:64bit
+                   Test RDI:64bit, RDI:64bit
+                   BranchNZ BB%2
+BB %1 - preds: %0
+      RAX:Object = Move RDI:Object
+BB %2 - preds: %0
+      RAX:Object = Move RSI:Object
+)");
+
+  Parser parser;
+  auto func = parser.parse(lir_input_str);
+  runPeephole(func.get());
+
+  EXPECT_EQ(
+      opcodes(func->basicblocks()[0]),
+      (std::vector<Instruction::Opcode>{
+          Instruction::kSub, Instruction::kBranchNZ}));
+}
+
+TEST_F(LIRPeepholeTest, FormsLeaOnlyWhenFlagsAreDead) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %1 %2
+      RAX:Object = Add RDI:Object, RSI:Object
+      RCX:Object = Add RDI:Object, RSI:Object
+                   Test RDX:Object, RDX:Object
+                   BranchNZ BB%2
+BB %1 - preds: %0
+      RAX:Object = Add RDI:Object, RSI:Object
+BB %2 - preds: %0
+      RAX:Object = Move RSI:Object
+)");
+
+  Parser parser;
+  auto func = parser.parse(lir_input_str);
+  runPeephole(func.get());
+
+  auto& blocks = func->basicblocks();
+  EXPECT_EQ(
+      opcodes(blocks[0]),
+      (std::vector<Instruction::Opcode>{
+          Instruction::kLea,
+          Instruction::kLea,
+          Instruction::kTest,
+          Instruction::kBranchNZ}));
+  Instruction* lea = blocks[0]->getFirstInstr();
+  ASSERT_TRUE(lea->getInput(0)->isInd());
+  auto ind = lea->getInput(0)->getMemoryIndirect();
+  EXPECT_EQ(ind->getBaseRegOperand()->getPhyRegister(), PhyLocation::RDI);
+  EXPECT_EQ(ind->getIndexRegOperand()->getPhyRegister(), PhyLocation::RSI);
+
+  // Flags are conservatively live at the end of a block.
+  EXPECT_EQ(
+      opcodes(blocks[1]),
+      (std::vector<Instruction::Opcode>{Instruction::kAdd}));
+}
+
+TEST_F(LIRPeepholeTest, RemovesRedundantInstructionsAndCountsHits) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %1 %2
+      RAX:Object = Move RDI:Object
+      RDI:Object = Move RAX:Object
+      RSI:Object = Move RSI:Object
+                   Test RSI:Object, RSI:Object
+                   Test RAX:Object, RAX:Object
+                   BranchNZ BB%2
+BB %1 - preds: %0
+      RAX:Object = Move RDI:Object
+BB %2 - preds: %0
+      RAX:Object = Move RSI:Object
+)");
+
+  PeepholeOptimizer::resetHitCounts();
+  Parser parser;
+  auto func = parser.parse(lir_input_str);
+  runPeephole(func.get());
+
+  EXPECT_EQ(
+      opcodes(func->basicblocks()[0]),
+      (std::vector<Instruction::Opcode>{
+          Instruction::kMove, Instruction::kTest, Instruction::kBranchNZ}));
+
+  std::map<std::string, uint64_t> hits;
+  for (auto& [name, count] : PeepholeOptimizer::hitCounts()) {
+    hits[name] = count;
+  }
+  EXPECT_EQ(hits["redundant_move"], 2u);
+  EXPECT_EQ(hits["dead_flag_setter"], 1u);
+  EXPECT_EQ(hits["jump_threading"], 0u);
+}
+
+TEST_F(LIRPeepholeTest, ThreadsJumpsAndRemovesTrampolines) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %1 %2
+                   Test RDI:Object, RDI:Object
+                   BranchNZ BB%2
+BB %1 - preds: %0 - succs: %3
+      RAX:Object = Move RSI:Object
+                   Branch BB%3
+BB %2 - preds: %0 - succs: %3
+                   Branch BB%3
+BB %3 - preds: %1 %2
+      RAX:Object = Move RDI:Object
+)");
+
+  Parser parser;
+  auto func = parser.parse(lir_input_str);
+  BasicBlock* dest = func->basicblocks()[3];
+  runPeephole(func.get());
+
+  auto& blocks = func->basicblocks();
+  ASSERT_EQ(blocks.size(), 3u);
+  Instruction* branch = blocks[0]->getLastInstr();
+  ASSERT_TRUE(branch->isBranchNZ());
+  EXPECT_EQ(branch->getInput(0)->getBasicBlock(), dest);
+  EXPECT_EQ(dest->predecessors().size(), 2u);
+}
+
+} // namespace jit::lir
@@ -417,6 +417,34 @@ BB %10 - preds: %0 %7 - section: hot
       parsed_func->basicblocks()[2]->section(), codegen::CodeSection::kHot);
 }
 
+TEST(LIRTest, SortPlacesLikelySuccessorNextAndSinksColdBlocks) {
+  Function func;
+  auto entry = func.allocateBasicBlock();
+  auto then_bb = func.allocateBasicBlock();
+  auto else_bb = func.allocateBasicBlock();
+  auto join = func.allocateBasicBlock();
+  auto exit = func.allocateBasicBlock();
+  entry->addSuccessor(then_bb);
+  entry->addSuccessor(else_bb);
+  then_bb->addSuccessor(join);
+  else_bb->addSuccessor(join);
+  join->addSuccessor(exit);
+
+  func.sortBasicBlocks();
+  ASSERT_EQ(func.basicblocks()[1], else_bb);
+
+  entry->setLikelySuccessor(then_bb);
+  func.sortBasicBlocks();
+  std::vector<BasicBlock*> expected{entry, then_bb, else_bb, join, exit};
+  EXPECT_EQ(func.basicblocks(), expected);
+
+  // Cold blocks move after every hot block, but the exit block stays last.
+  then_bb->setSection(codegen::CodeSection::kCold);
+  func.sinkColdBlocks();
+  expected = {entry, else_bb, join, then_bb, exit};
+  EXPECT_EQ(func.basicblocks(), expected);
+}
+
 TEST(LIRTest, MemoryIndirectTests) {
   ASSERT_TRUE(MemoryIndirectTestCase("[RCX:Object]", PhyLocation::RCX));
   ASSERT_TRUE(MemoryIndirectTestCase(
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+
+#include "cinderx/Jit/lir/c_helper_translations.h"
 #include "cinderx/Jit/lir/parser.h"
 #include "cinderx/Jit/lir/verify.h"
 
@@ -135,4 +138,74 @@ BB %1 - preds: %0 - section: .coldtext
       "1.\n");
 }
 
+TEST_F(LIRVerifyTest, TestCHelperTranslationsAreInlineable) {
+  for (auto& [addr, lir_str] : kCHelperMapping) {
+    Parser parser;
+    auto parsed_func = parser.parse(lir_str);
+    std::stringstream err;
+    EXPECT_TRUE(verifyCHelperTranslation(parsed_func.get(), err))
+        << "C helper " << std::hex << addr << ": " << err.str();
+  }
+}
+
+TEST_F(LIRVerifyTest, TestCHelperTranslationOK) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %2 %1
+       %3:Object = LoadArg 0(0x0):Object
+         %4:8bit = Equal %3:Object, 0(0x0):Object
+                   CondBranch %4:8bit
+BB %1 - preds: %0 - succs: %2
+       %5:Object = Move [%3:Object + 0x8]:Object
+BB %2 - preds: %0 %1 - succs: %6
+       %7:Object = Phi (BB%0, %3:Object), (BB%1, %5:Object)
+                   Return %7:Object
+BB %6 - preds: %2
+)");
+  Parser parser;
+  auto parsed_func = parser.parse(lir_input_str);
+  ASSERT_EQ(verifyCHelperTranslation(parsed_func.get(), std::cout), true);
+}
+
+TEST_F(LIRVerifyTest, TestCHelperTranslationPartialReturnDisallowed) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %2 %1
+       %3:Object = LoadArg 0(0x0):Object
+         %4:8bit = Equal %3:Object, 0(0x0):Object
+                   CondBranch %4:8bit
+BB %1 - preds: %0 - succs: %5
+                   Return %3:Object
+BB %2 - preds: %0 - succs: %5
+       %6:Object = Move [%3:Object + 0x8]:Object
+BB %5 - preds: %1 %2
+)");
+  Parser parser;
+  auto parsed_func = parser.parse(lir_input_str);
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(verifyCHelperTranslation(parsed_func.get(), std::cout), false);
+  std::string output = testing::internal::GetCapturedStdout();
+  ASSERT_EQ(
+      output,
+      "ERROR: Only some predecessors of exit block 5 return a value.\n");
+}
+
+TEST_F(LIRVerifyTest, TestCHelperTranslationLateLoadArgDisallowed) {
+  auto lir_input_str = fmt::format(R"(Function:
+BB %0 - succs: %4
+       %1:Object = LoadArg 0(0x0):Object
+       %2:Object = Move [%1:Object + 0x8]:Object
+       %3:Object = LoadArg 1(0x1):Object
+                   Return %3:Object
+BB %4 - preds: %0
+)");
+  Parser parser;
+  auto parsed_func = parser.parse(lir_input_str);
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(verifyCHelperTranslation(parsed_func.get(), std::cout), false);
+  std::string output = testing::internal::GetCapturedStdout();
+  ASSERT_EQ(
+      output,
+      "ERROR: LoadArg 3 must be at the start of the entry block and take an "
+      "immediate.\n");
+}
+
 } // namespace jit::lir
@@ -155,11 +155,14 @@ int main(int argc, char* argv[]) {
   register_test("dynamic_comparison_elimination_test.txt");
   register_test("hir_builder_test.txt");
   register_test("hir_builder_static_test.txt", HIRTest::kCompileStatic);
+  register_test("escape_analysis_test.txt");
+  register_test("global_value_numbering_test.txt");
   register_test("guard_type_removal_test.txt");
   register_test("inliner_test.txt");
   register_test("inliner_elimination_test.txt");
   register_test("inliner_static_test.txt", HIRTest::kCompileStatic);
   register_test("inliner_elimination_static_test.txt", HIRTest::kCompileStatic);
+  register_test("loop_invariant_code_motion_test.txt");
   register_test("phi_elimination_test.txt");
   register_test("refcount_insertion_test.txt");
   register_test("refcount_insertion_static_test.txt", HIRTest::kCompileStatic);
@@ -0,0 +1,55 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""Write a corpus of code objects for the compile_bench benchmark.
+
+Every function in the given modules, including methods and nested functions,
+is collected from the modules' compiled code and written out as a marshalled
+list of code objects. Run this with the same Python that compile_bench embeds
+so the bytecode matches.
+
+Usage: make_compile_bench_corpus.py OUTPUT MODULE [MODULE ...]
+"""
+
+import importlib.util
+import inspect
+import marshal
+import sys
+from types import CodeType
+from typing import Iterator
+
+
+def function_codes(code: CodeType) -> Iterator[CodeType]:
+    for const in code.co_consts:
+        if isinstance(const, CodeType):
+            # Class bodies are code objects too, but never become functions.
+            if const.co_flags & inspect.CO_NEWLOCALS:
+                yield const
+            yield from function_codes(const)
+
+
+def main(argv: list[str]) -> int:
+    if len(argv) < 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    output, modules = argv[1], argv[2:]
+    codes = []
+    for name in modules:
+        spec = importlib.util.find_spec(name)
+        if spec is None or spec.loader is None:
+            print(f"Can't find module {name}", file=sys.stderr)
+            return 1
+        module_code = spec.loader.get_code(name)
+        if module_code is None:
+            print(f"Module {name} has no Python code", file=sys.stderr)
+            return 1
+        codes.extend(function_codes(module_code))
+
+    with open(output, "wb") as f:
+        marshal.dump(codes, f)
+    print(f"Wrote {len(codes)} code objects to {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
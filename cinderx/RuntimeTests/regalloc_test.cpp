@@ -10,6 +10,7 @@
 #include <fmt/ostream.h>
 
 #include <algorithm>
+#include <bit>
 #include <sstream>
 #include <vector>
 
@@ -57,6 +58,12 @@ class LinearScanAllocatorTest : public ::testing::Test {
     return res;
   }
 
+  // number of general purpose registers available to the allocator.
+  static int numAllocatableGPRegs() {
+    return std::popcount(static_cast<unsigned>(
+        (codegen::ALL_GP_REGISTERS - codegen::STACK_REGISTERS).GetMask()));
+  }
+
   std::unique_ptr<LinearScanAllocator> runAllocator(Function* func) {
     auto allocator = std::make_unique<LinearScanAllocator>(func);
     allocator->run();
@@ -294,6 +301,141 @@ BB %28
   }
 }
 
+TEST_F(LinearScanAllocatorTest, LoopSpillsValueUsedAfterLoop) {
+  // Fill every register before the loop in BB%2000. %100 is next used right
+  // after that loop, the others only in the later loop in BB%4000. Allocating
+  // %2001 inside the first loop has to evict one of them. By distance alone
+  // that would be one of the values used in the later loop; weighted by loop
+  // depth it's %100.
+  int num_regs = numAllocatableGPRegs();
+  std::string lir_source = "Function:\nBB %1000 - succs: %2000\n";
+  for (int i = 1; i < num_regs; i++) {
+    lir_source += fmt::format("  %{} = Move {}\n", i, i);
+  }
+  lir_source += R"(  %100 = Move 100
+  Branch BB%2000
+BB %2000 - succs: %2000 %3000
+  %2001 = Move 0
+  CondBranch %2001, BB%2000, BB%3000
+BB %3000 - succs: %4000
+  %3001 = Add %100, 1
+  Branch BB%4000
+BB %4000 - succs: %4000 %5000
+  %4001 = Add %1, %3001
+)";
+  int last = 4001;
+  for (int i = 2; i < num_regs; i++, last++) {
+    lir_source += fmt::format("  %{} = Add %{}, %{}\n", last + 1, i, last);
+  }
+  lir_source += fmt::format(
+      "  CondBranch %{0}, BB%4000, BB%5000\n"
+      "BB %5000 - succs: %6000\n"
+      "  Return %{0}\n"
+      "BB %6000\n",
+      last);
+
+  Parser parser;
+  auto lir_func = parser.parse(lir_source);
+  auto instrs = parser.getOutputInstrMap();
+  auto opnd_id_map = buildOperandToIndexMap(instrs);
+
+  LinearScanAllocator lsallocator(lir_func.get());
+  lsallocator.initialize();
+  lsallocator.calculateLiveIntervals();
+  lsallocator.linearScan();
+
+  const Operand* in_loop = instrs.at(2001)->output();
+  auto in_loop_iter = std::find_if(
+      lsallocator.allocated_.begin(),
+      lsallocator.allocated_.end(),
+      [&](auto& interval) { return interval->vreg == in_loop; });
+  ASSERT_NE(in_loop_iter, lsallocator.allocated_.end());
+  LIRLocation loc = (*in_loop_iter)->startLocation();
+  EXPECT_TRUE((*in_loop_iter)->isRegisterAllocated());
+
+  int num_checked = 0;
+  for (auto& interval : lsallocator.allocated_) {
+    auto id_iter = opnd_id_map.find(interval->vreg);
+    if (id_iter == opnd_id_map.end() || id_iter->second > 100 ||
+        !interval->covers(loc)) {
+      continue;
+    }
+    num_checked++;
+    if (id_iter->second == 100) {
+      EXPECT_FALSE(interval->isRegisterAllocated()) << *interval;
+    } else {
+      EXPECT_TRUE(interval->isRegisterAllocated()) << *interval;
+    }
+  }
+  EXPECT_EQ(num_checked, num_regs);
+}
+
+TEST_F(LinearScanAllocatorTest, SplitReloadsAtLoopEntry) {
+  // %100 doesn't fit into a register next to the values used in the loop in
+  // BB%2000, so it is spilled at its definition. Its next use is in the loop
+  // in BB%4000, and it should be reloaded once when entering that loop
+  // rather than on every iteration.
+  int num_regs = numAllocatableGPRegs();
+  std::string lir_source = "Function:\nBB %1000 - succs: %2000\n";
+  for (int i = 1; i <= num_regs; i++) {
+    lir_source += fmt::format("  %{} = Move {}\n", i, i);
+  }
+  lir_source += R"(  %100 = Move 100
+  Branch BB%2000
+BB %2000 - succs: %2000 %3000
+  %2001 = Add %1, 1
+)";
+  int last = 2001;
+  for (int i = 2; i <= num_regs; i++, last++) {
+    lir_source += fmt::format("  %{} = Add %{}, %{}\n", last + 1, i, last);
+  }
+  lir_source += fmt::format(
+      "  CondBranch %{}, BB%2000, BB%3000\n", last);
+  lir_source += R"(BB %3000 - succs: %4000
+  Branch BB%4000
+BB %4000 - succs: %4000 %5000
+  %4001 = Add %100, 1
+  CondBranch %4001, BB%4000, BB%5000
+BB %5000 - succs: %6000
+  Return %4001
+BB %6000
+)";
+
+  Parser parser;
+  auto lir_func = parser.parse(lir_source);
+  auto instrs = parser.getOutputInstrMap();
+
+  LinearScanAllocator lsallocator(lir_func.get());
+  lsallocator.initialize();
+  lsallocator.calculateLiveIntervals();
+
+  const Operand* spilled = instrs.at(100)->output();
+  LIRLocation def_loc = lsallocator.vreg_interval_.at(spilled).startLocation();
+  // The Move defining %100 needs a register for its output, too.
+  LIRLocation use_loc =
+      *lsallocator.vreg_phy_uses_.at(spilled).upper_bound(def_loc);
+  LIRLocation loop_start =
+      lsallocator.regalloc_blocks_.at(instrs.at(4001)->basicblock())
+          .block_start_index;
+  ASSERT_LT(loop_start, use_loc);
+  EXPECT_EQ(lsallocator.findSplitPos(def_loc, use_loc), loop_start);
+
+  lsallocator.linearScan();
+
+  std::vector<const LiveInterval*> intervals;
+  for (auto& interval : lsallocator.allocated_) {
+    if (interval->vreg == spilled) {
+      intervals.push_back(interval.get());
+    }
+  }
+  std::sort(intervals.begin(), intervals.end(), LiveIntervalPtrLess);
+  ASSERT_EQ(intervals.size(), 2u);
+  EXPECT_EQ(intervals[0]->startLocation(), def_loc);
+  EXPECT_FALSE(intervals[0]->isRegisterAllocated());
+  EXPECT_EQ(intervals[1]->startLocation(), loop_start);
+  EXPECT_TRUE(intervals[1]->isRegisterAllocated());
+}
+
 TEST_F(LinearScanAllocatorTest, InoutRegTest) {
   // OptimizeMoveSequence should not set reg operands that are also output
   auto lirfunc = std::make_unique<Function>();
@@ -319,6 +461,31 @@ TEST_F(LinearScanAllocatorTest, InoutRegTest) {
       add->output()->getPhyRegister() == add->getInput(1)->getPhyRegister());
 }
 
+TEST_F(LinearScanAllocatorTest, MoveCoalescesWithDyingSource) {
+  // A Move from a vreg whose last use is the Move should reuse its register,
+  // even when a lower-numbered register is free.
+  auto lirfunc = std::make_unique<Function>();
+  auto bb = lirfunc->allocateBasicBlock();
+
+  auto a =
+      bb->allocateInstr(Instruction::kMove, nullptr, lir::OutVReg(), Imm(1));
+  auto b =
+      bb->allocateInstr(Instruction::kMove, nullptr, lir::OutVReg(), Imm(2));
+  bb->allocateInstr(Instruction::kTest, nullptr, lir::VReg(a), lir::VReg(a));
+  auto copy = bb->allocateInstr(
+      Instruction::kMove, nullptr, lir::OutVReg(), lir::VReg(b));
+
+  bb->allocateInstr(Instruction::kReturn, nullptr, lir::VReg(copy));
+
+  auto epilogue = lirfunc->allocateBasicBlock();
+  bb->addSuccessor(epilogue);
+
+  runAllocator(lirfunc.get());
+
+  ASSERT_EQ(
+      copy->output()->getPhyRegister(), copy->getInput(0)->getPhyRegister());
+}
+
 TEST_F(LinearScanAllocatorTest, CallWithSideEffectTest) {
   // RewriteLIR should not remove function calls
   // since they may have side effects
@@ -664,6 +664,29 @@ _PyShadow_GetOriginalConst(_PyShadow_EvalState *state,
     return PyTuple_GET_ITEM(state->code->co_consts, oparg);
 }
 
+int
+_PyShadow_Deoptimize(_PyShadow_EvalState *state,
+                     const _Py_CODEUNIT *next_instr)
+{
+    _Py_CODEUNIT *rawcode = (_Py_CODEUNIT *)PyBytes_AS_STRING(state->code->co_code);
+    Py_ssize_t index = next_instr - *state->first_instr - 1;
+    int opcode = _Py_OPCODE(rawcode[index]);
+    int oparg = _PyShadow_GetOriginalOparg(state, next_instr);
+
+    _PyShadowCode *shadow = state->shadow;
+    if (shadow->quicken_misses == NULL) {
+        shadow->quicken_misses =
+            PyMem_Calloc(shadow->len / sizeof(_Py_CODEUNIT), 1);
+    }
+    if (shadow->quicken_misses != NULL &&
+        shadow->quicken_misses[index] < QUICKEN_MAX_MISSES) {
+        shadow->quicken_misses[index]++;
+    }
+
+    _PyShadow_PatchByteCode(state, next_instr, opcode, oparg);
+    return opcode;
+}
+
 PyObject *
 _PyShadow_LoadAttrPolymorphic(_PyShadow_EvalState *state,
                               const _Py_CODEUNIT *next_instr,
@@ -2566,6 +2589,8 @@ _PyShadow_InitCache(PyCodeObject *co)
     shadow->field_caches = NULL;
     shadow->field_cache_size = 0;
 
+    shadow->quicken_misses = NULL;
+
     cache_init(&shadow->l1_cache);
     cache_init(&shadow->cast_cache);
     shadow->arg_checks = NULL;
@@ -2585,6 +2610,8 @@ _PyShadowCode_Free(_PyShadowCode *shadow)
         PyMem_Free(shadow->functions);
     }
 
+    PyMem_Free(shadow->quicken_misses);
+
     if (shadow->polymorphic_caches_size) {
         for (Py_ssize_t i = 0; i < shadow->polymorphic_caches_size; i++) {
             if (shadow->polymorphic_caches[i] == NULL) {
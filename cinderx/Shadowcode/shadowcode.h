@@ -73,6 +73,8 @@ _PyShadow_FindCache(PyObject *from)
 
 #define INITIAL_POLYMORPHIC_CACHE_ARRAY_SIZE 4
 #define POLYMORPHIC_CACHE_SIZE 4
+/* Deoptimizations after which a quickened instruction stays generic */
+#define QUICKEN_MAX_MISSES 8
 
 /* Gets a code cache object from the given weak-referencable object.  This
 supports getting caches from types and modules (at least).
@@ -191,6 +193,10 @@ typedef struct _PyShadowCode {
     PyObject ***functions;
     Py_ssize_t functions_size;
 
+    /* Number of times each instruction has been deoptimized from a quickened
+     * form, allocated on the first deoptimization. */
+    unsigned char *quicken_misses;
+
     _Py_CODEUNIT code[];
 } _PyShadowCode;
 
@@ -398,6 +404,196 @@ PyObject *_PyShadow_BinarySubscrWithCache(_PyShadow_EvalState *shadow,
                                           PyObject *sub,
                                           int oparg);
 
+/* Quickening of the generic arithmetic, comparison, iteration, call and
+ * store instructions.  The generic opcode patches itself to a specialized
+ * form based on the operand types it sees; the specialized form re-checks
+ * the types and patches the site back to the generic opcode on a miss. */
+
+/* Patch the current instruction back to the opcode it had in co_code, and
+ * return that opcode so the caller can dispatch to it.  This counts as a miss
+ * against the instruction; see _PyShadow_PatchQuickened(). */
+int _PyShadow_Deoptimize(_PyShadow_EvalState *shadow,
+                         const _Py_CODEUNIT *next_instr);
+
+/* Layouts of the builtin sequence iterators, which are private to their
+ * object files.  These must be kept in sync with listobject.c, tupleobject.c
+ * and rangeobject.c. */
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t it_index;
+    PyObject *it_seq; /* Set to NULL when iterator is exhausted */
+} _PyShadow_SeqIterObject;
+
+typedef struct {
+    PyObject_HEAD
+    long index;
+    long start;
+    long step;
+    long len;
+} _PyShadow_RangeIterObject;
+
+/* Patch the current instruction to a quickened opcode, unless it has been
+ * deoptimized QUICKEN_MAX_MISSES times already.  Sites that keep seeing
+ * different types are left generic rather than respecialized on every
+ * execution. */
+static inline void
+_PyShadow_PatchQuickened(_PyShadow_EvalState *shadow,
+                         const _Py_CODEUNIT *next_instr,
+                         int op,
+                         int oparg)
+{
+    unsigned char *misses = shadow->shadow->quicken_misses;
+    if (misses != NULL &&
+        misses[next_instr - *shadow->first_instr - 1] >= QUICKEN_MAX_MISSES) {
+        return;
+    }
+    _PyShadow_PatchByteCode(shadow, next_instr, op, oparg);
+}
+
+static inline void
+_PyShadow_QuickenBinaryAdd(_PyShadow_EvalState *shadow,
+                           const _Py_CODEUNIT *next_instr,
+                           PyObject *left,
+                           PyObject *right,
+                           int oparg)
+{
+    if (Py_TYPE(left) != Py_TYPE(right)) {
+        return;
+    }
+    if (PyLong_CheckExact(left)) {
+        _PyShadow_PatchQuickened(shadow, next_instr, BINARY_ADD_INT, oparg);
+    } else if (PyFloat_CheckExact(left)) {
+        _PyShadow_PatchQuickened(
+            shadow, next_instr, BINARY_ADD_FLOAT, oparg);
+    }
+}
+
+static inline void
+_PyShadow_QuickenCompareOp(_PyShadow_EvalState *shadow,
+                           const _Py_CODEUNIT *next_instr,
+                           PyObject *left,
+                           PyObject *right,
+                           int oparg)
+{
+    if (Py_TYPE(left) != Py_TYPE(right)) {
+        return;
+    }
+    if (PyLong_CheckExact(left)) {
+        _PyShadow_PatchQuickened(shadow, next_instr, COMPARE_OP_INT, oparg);
+    } else if (PyUnicode_CheckExact(left)) {
+        _PyShadow_PatchQuickened(shadow, next_instr, COMPARE_OP_STR, oparg);
+    }
+}
+
+static inline void
+_PyShadow_QuickenForIter(_PyShadow_EvalState *shadow,
+                         const _Py_CODEUNIT *next_instr,
+                         PyObject *iter,
+                         int oparg)
+{
+    PyTypeObject *type = Py_TYPE(iter);
+    if (type == &PyListIter_Type) {
+        _PyShadow_PatchQuickened(shadow, next_instr, FOR_ITER_LIST, oparg);
+    } else if (type == &PyRangeIter_Type) {
+        _PyShadow_PatchQuickened(shadow, next_instr, FOR_ITER_RANGE, oparg);
+    } else if (type == &PyTupleIter_Type) {
+        _PyShadow_PatchQuickened(shadow, next_instr, FOR_ITER_TUPLE, oparg);
+    }
+}
+
+static inline void
+_PyShadow_QuickenCallFunction(_PyShadow_EvalState *shadow,
+                              const _Py_CODEUNIT *next_instr,
+                              PyObject *func,
+                              int oparg,
+                              int tracing)
+{
+    if (PyFunction_Check(func)) {
+        _PyShadow_PatchQuickened(shadow, next_instr, CALL_FUNCTION_PY, oparg);
+    } else if (PyCFunction_CheckExact(func) &&
+               ((PyCFunctionObject *)func)->vectorcall != NULL && !tracing) {
+        /* CALL_FUNCTION_BUILTIN deoptimizes while tracing, so that builtin
+         * calls are still reported. */
+        _PyShadow_PatchQuickened(
+            shadow, next_instr, CALL_FUNCTION_BUILTIN, oparg);
+    }
+}
+
+static inline void
+_PyShadow_QuickenStoreSubscr(_PyShadow_EvalState *shadow,
+                             const _Py_CODEUNIT *next_instr,
+                             PyObject *container,
+                             PyObject *sub,
+                             int oparg)
+{
+    if (PyList_CheckExact(container) && PyLong_CheckExact(sub)) {
+        _PyShadow_PatchQuickened(
+            shadow, next_instr, STORE_SUBSCR_LIST, oparg);
+    } else if (PyDict_CheckExact(container)) {
+        _PyShadow_PatchQuickened(
+            shadow, next_instr, STORE_SUBSCR_DICT, oparg);
+    }
+}
+
+/* Advance a list or tuple iterator, returning a new reference to the next
+ * item or NULL (without an exception set) when it is exhausted. */
+static inline PyObject *
+_PyShadow_SeqIterNext(PyObject *iter, int is_list)
+{
+    _PyShadow_SeqIterObject *it = (_PyShadow_SeqIterObject *)iter;
+    PyObject *seq = it->it_seq;
+    if (seq == NULL) {
+        return NULL;
+    }
+    Py_ssize_t size =
+        is_list ? PyList_GET_SIZE(seq) : PyTuple_GET_SIZE(seq);
+    if (it->it_index < size) {
+        PyObject *item = is_list ? PyList_GET_ITEM(seq, it->it_index)
+                                 : PyTuple_GET_ITEM(seq, it->it_index);
+        it->it_index++;
+        Py_INCREF(item);
+        return item;
+    }
+    it->it_seq = NULL;
+    Py_DECREF(seq);
+    return NULL;
+}
+
+static inline int
+_PyShadow_StoreSubscrList(PyObject *list, PyObject *sub, PyObject *v)
+{
+    Py_ssize_t i = PyLong_AsSsize_t(sub);
+    if (i == -1 && PyErr_Occurred()) {
+        /* let the generic path raise the IndexError */
+        PyErr_Clear();
+        return PyObject_SetItem(list, sub, v);
+    }
+    if (i < 0) {
+        i += PyList_GET_SIZE(list);
+    }
+    if (i < 0 || i >= PyList_GET_SIZE(list)) {
+        return PyObject_SetItem(list, sub, v);
+    }
+    PyObject *old_value = PyList_GET_ITEM(list, i);
+    Py_INCREF(v);
+    PyList_SET_ITEM(list, i, v);
+    Py_DECREF(old_value);
+    return 0;
+}
+
+static inline PyObject *
+_PyShadow_RangeIterNext(PyObject *iter)
+{
+    _PyShadow_RangeIterObject *r = (_PyShadow_RangeIterObject *)iter;
+    if (r->index < r->len) {
+        /* cast to unsigned to avoid possible signed overflow
+           in intermediate calculations. */
+        return PyLong_FromLong(
+            (long)(r->start + (unsigned long)(r->index++) * r->step));
+    }
+    return NULL;
+}
+
 Py_ssize_t _Py_NO_INLINE _PyShadow_FixDictOffset(PyObject *obj,
                                                  Py_ssize_t dictoffset);
 
@@ -38,7 +38,7 @@ _static_exec(PyObject *m)
         return -1;
     }
 
-    if (PyType_Ready(&PyStaticArray_Type) < 0 ||
+    if (_Ci_StaticArray_ReadyTypes() < 0 ||
         PyModule_AddObjectRef(m, "staticarray", (PyObject*)&PyStaticArray_Type)) {
         return -1;
     }
@@ -80,7 +80,15 @@ _static_exec(PyObject *m)
     SET_TYPE_CODE(SEQ_LIST)
     SET_TYPE_CODE(SEQ_TUPLE)
     SET_TYPE_CODE(SEQ_LIST_INEXACT)
+    SET_TYPE_CODE(SEQ_ARRAY_INT8)
+    SET_TYPE_CODE(SEQ_ARRAY_INT16)
+    SET_TYPE_CODE(SEQ_ARRAY_INT32)
     SET_TYPE_CODE(SEQ_ARRAY_INT64)
+    SET_TYPE_CODE(SEQ_ARRAY_UINT8)
+    SET_TYPE_CODE(SEQ_ARRAY_UINT16)
+    SET_TYPE_CODE(SEQ_ARRAY_UINT32)
+    SET_TYPE_CODE(SEQ_ARRAY_UINT64)
+    SET_TYPE_CODE(SEQ_ARRAY_DOUBLE)
     SET_TYPE_CODE(SEQ_SUBSCR_UNCHECKED)
 
     SET_TYPE_CODE(SEQ_REPEAT_INEXACT_SEQ)
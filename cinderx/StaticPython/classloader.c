@@ -2713,6 +2713,7 @@ _PyClassLoader_UpdateSlot(PyTypeObject *type,
     if (check_if_final_method_overridden(type, name)) {
         return -1;
     }
+    _PyJIT_VTableModified(type, name);
     _PyType_VTable *vtable = (_PyType_VTable *)type->tp_cache;
     if (vtable == NULL) {
         return 0;
@@ -4028,6 +4029,8 @@ _PyClassLoader_AddSubclass(PyTypeObject *base, PyTypeObject *type)
     if (vtable == NULL) {
         return -1;
     }
+    /* the new subclass may override methods that the JIT devirtualized */
+    _PyJIT_VTableModified(type, NULL);
     return 0;
 }
 
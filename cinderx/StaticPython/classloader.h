@@ -251,9 +251,18 @@ CiAPI_FUNC(int) _PyClassLoader_IsFinalMethodOverridden(PyTypeObject *base_type,
 #define SEQ_REPEAT_REVERSED (1 << 6)
 #define SEQ_REPEAT_PRIMITIVE_NUM (1 << 7)
 
-// For arrays, the constant contains the element type in the higher
-// nibble
+// For integer arrays, the constant contains the element type in the higher
+// nibble.  TYPED_DOUBLE doesn't fit in the three bits TYPED_ARRAY leaves free
+// there, so double arrays are flagged by a bit above SEQ_CHECKED_LIST instead.
+#define SEQ_ARRAY_INT8 ((TYPED_INT8 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_INT16 ((TYPED_INT16 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_INT32 ((TYPED_INT32 << 4) | TYPED_ARRAY)
 #define SEQ_ARRAY_INT64 ((TYPED_INT64 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT8 ((TYPED_UINT8 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT16 ((TYPED_UINT16 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT32 ((TYPED_UINT32 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_UINT64 ((TYPED_UINT64 << 4) | TYPED_ARRAY)
+#define SEQ_ARRAY_DOUBLE ((1 << 9) | TYPED_ARRAY)
 #define SEQ_REPEAT_FLAGS (     \
     SEQ_REPEAT_INEXACT_SEQ   | \
     SEQ_REPEAT_INEXACT_NUM   | \
@@ -264,6 +273,9 @@ CiAPI_FUNC(int) _PyClassLoader_IsFinalMethodOverridden(PyTypeObject *base_type,
 
 #define _Py_IS_TYPED_ARRAY(x) (x & TYPED_ARRAY)
 #define _Py_IS_TYPED_ARRAY_SIGNED(x) (x & (TYPED_INT_SIGNED << 4))
+#define _Py_SEQ_ARRAY_ELEMENT_TYPE(x)                            \
+    (((x) & SEQ_ARRAY_DOUBLE) == SEQ_ARRAY_DOUBLE ? TYPED_DOUBLE \
+                                                  : (((x) >> 4) & 7))
 
 
 #define Ci_Py_SIG_INT8 (TYPED_INT8 << 2)
@@ -2,11 +2,338 @@
 
 #include "cinderx/StaticPython/static_array.h"
 
+#include "cinderx/StaticPython/classloader.h"
+
 /**
  *   Lightweight implementation of Static Arrays.
+ *
+ *   There is one exact type per element kind (staticarray is the int64 array,
+ *   staticarray[int8], staticarray[double], etc. hold the others).  They all
+ *   share PyStaticArrayObject's layout; ob_item is just reinterpreted as a
+ *   buffer of the element type, so the JIT can address elements of any kind
+ *   with a single scaled load or store.
+ *
+ *   Bulk operations are written as plain loops over the unboxed element
+ *   buffer, one instance per element kind, so the C compiler can vectorize
+ *   them for whatever instruction set cinderx is built for.
  */
 
-#define ArrayItemType int64_t
+#define STATICARRAY_ITEMS(op) ((char *)((PyStaticArrayObject *)(op))->ob_item)
+
+/* Integer reductions accumulate in 64 bits.  For arrays of at most this many
+ * elements, sums of 8/16/32-bit elements and dot products of 8/16-bit
+ * elements can't overflow the accumulator, so they skip the per-element
+ * overflow checks. */
+#define STATICARRAY_MAX_UNCHECKED ((Py_ssize_t)1 << 31)
+
+typedef struct {
+    PyTypeObject *type;
+    int typecode;
+    PyObject *(*getitem)(const char *items, Py_ssize_t index);
+    int (*unbox)(PyObject *value, void *out);
+    int (*fill)(char *items, Py_ssize_t n, PyObject *value);
+    PyObject *(*sum)(const char *items, Py_ssize_t n);
+    PyObject *(*min)(const char *items, Py_ssize_t n);
+    PyObject *(*max)(const char *items, Py_ssize_t n);
+    PyObject *(*dot)(const char *a, const char *b, Py_ssize_t n);
+    void (*add)(char *dst, const char *a, const char *b, Py_ssize_t n);
+    void (*mul)(char *dst, const char *a, const char *b, Py_ssize_t n);
+    int (*compare)(
+        uint8_t *dst, const char *items, Py_ssize_t n, int op, PyObject *value);
+} StaticArrayDescr;
+
+static const StaticArrayDescr *staticarray_descr(PyTypeObject *type);
+
+/* Slow paths for integer reductions which overflow 64 bits. */
+static PyObject *
+staticarray_sum_boxed(PyObject *(*getitem)(const char *, Py_ssize_t),
+                      const char *items, Py_ssize_t n)
+{
+    PyObject *total = PyLong_FromLong(0);
+    for (Py_ssize_t i = 0; total != NULL && i < n; i++) {
+        PyObject *item = getitem(items, i);
+        if (item == NULL) {
+            Py_DECREF(total);
+            return NULL;
+        }
+        Py_SETREF(total, PyNumber_Add(total, item));
+        Py_DECREF(item);
+    }
+    return total;
+}
+
+static PyObject *
+staticarray_dot_boxed(PyObject *(*getitem)(const char *, Py_ssize_t),
+                      const char *a, const char *b, Py_ssize_t n)
+{
+    PyObject *total = PyLong_FromLong(0);
+    for (Py_ssize_t i = 0; total != NULL && i < n; i++) {
+        PyObject *x = getitem(a, i);
+        PyObject *y = x == NULL ? NULL : getitem(b, i);
+        PyObject *prod = y == NULL ? NULL : PyNumber_Multiply(x, y);
+        Py_XDECREF(x);
+        Py_XDECREF(y);
+        if (prod == NULL) {
+            Py_DECREF(total);
+            return NULL;
+        }
+        Py_SETREF(total, PyNumber_Add(total, prod));
+        Py_DECREF(prod);
+    }
+    return total;
+}
+
+static int
+staticarray_value_out_of_range(PyObject *value)
+{
+    PyErr_Format(PyExc_OverflowError,
+                 "%R is out of range for the staticarray element type",
+                 value);
+    return -1;
+}
+
+#define STATICARRAY_SIGNED_UNBOX(NAME, CTYPE, MINV, MAXV)                      \
+    static int NAME##_unbox(PyObject *value, void *out)                        \
+    {                                                                          \
+        long long val = PyLong_AsLongLong(value);                              \
+        if (val == -1 && PyErr_Occurred()) {                                   \
+            return -1;                                                         \
+        }                                                                      \
+        if (val < (MINV) || val > (MAXV)) {                                    \
+            return staticarray_value_out_of_range(value);                      \
+        }                                                                      \
+        *(CTYPE *)out = (CTYPE)val;                                            \
+        return 0;                                                              \
+    }
+
+#define STATICARRAY_UNSIGNED_UNBOX(NAME, CTYPE, MAXV)                          \
+    static int NAME##_unbox(PyObject *value, void *out)                        \
+    {                                                                          \
+        unsigned long long val = PyLong_AsUnsignedLongLong(value);             \
+        if (val == (unsigned long long)-1 && PyErr_Occurred()) {               \
+            return -1;                                                         \
+        }                                                                      \
+        if (val > (MAXV)) {                                                    \
+            return staticarray_value_out_of_range(value);                      \
+        }                                                                      \
+        *(CTYPE *)out = (CTYPE)val;                                            \
+        return 0;                                                              \
+    }
+
+#define STATICARRAY_COMPARE_LOOP(OP)                                           \
+    for (Py_ssize_t i = 0; i < n; i++) {                                       \
+        dst[i] = a[i] OP x;                                                    \
+    }                                                                          \
+    break;
+
+/* Kernels shared by every element kind.  Elementwise arithmetic is done in
+ * WIDE, which for integers is an unsigned type at least as wide as int, so
+ * that results wrap around like primitive Static Python arithmetic does. */
+#define STATICARRAY_KERNELS(NAME, CTYPE, WIDE, BOX)                            \
+    static PyObject *NAME##_getitem(const char *items, Py_ssize_t index)       \
+    {                                                                          \
+        return BOX(((const CTYPE *)items)[index]);                             \
+    }                                                                          \
+                                                                               \
+    static int NAME##_fill(char *items, Py_ssize_t n, PyObject *value)         \
+    {                                                                          \
+        CTYPE x;                                                               \
+        if (NAME##_unbox(value, &x) < 0) {                                     \
+            return -1;                                                         \
+        }                                                                      \
+        CTYPE *a = (CTYPE *)items;                                             \
+        for (Py_ssize_t i = 0; i < n; i++) {                                   \
+            a[i] = x;                                                          \
+        }                                                                      \
+        return 0;                                                              \
+    }                                                                          \
+                                                                               \
+    static PyObject *NAME##_min(const char *items, Py_ssize_t n)               \
+    {                                                                          \
+        const CTYPE *a = (const CTYPE *)items;                                 \
+        CTYPE res = a[0];                                                      \
+        for (Py_ssize_t i = 1; i < n; i++) {                                   \
+            res = a[i] < res ? a[i] : res;                                     \
+        }                                                                      \
+        return BOX(res);                                                       \
+    }                                                                          \
+                                                                               \
+    static PyObject *NAME##_max(const char *items, Py_ssize_t n)               \
+    {                                                                          \
+        const CTYPE *a = (const CTYPE *)items;                                 \
+        CTYPE res = a[0];                                                      \
+        for (Py_ssize_t i = 1; i < n; i++) {                                   \
+            res = a[i] > res ? a[i] : res;                                     \
+        }                                                                      \
+        return BOX(res);                                                       \
+    }                                                                          \
+                                                                               \
+    static void NAME##_add(                                                    \
+        char *dst, const char *x, const char *y, Py_ssize_t n)                 \
+    {                                                                          \
+        CTYPE *d = (CTYPE *)dst;                                               \
+        const CTYPE *a = (const CTYPE *)x;                                     \
+        const CTYPE *b = (const CTYPE *)y;                                     \
+        for (Py_ssize_t i = 0; i < n; i++) {                                   \
+            d[i] = (CTYPE)((WIDE)a[i] + (WIDE)b[i]);                           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void NAME##_mul(                                                    \
+        char *dst, const char *x, const char *y, Py_ssize_t n)                 \
+    {                                                                          \
+        CTYPE *d = (CTYPE *)dst;                                               \
+        const CTYPE *a = (const CTYPE *)x;                                     \
+        const CTYPE *b = (const CTYPE *)y;                                     \
+        for (Py_ssize_t i = 0; i < n; i++) {                                   \
+            d[i] = (CTYPE)((WIDE)a[i] * (WIDE)b[i]);                           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static int NAME##_compare(uint8_t *dst, const char *items, Py_ssize_t n,   \
+                              int op, PyObject *value)                         \
+    {                                                                          \
+        CTYPE x;                                                               \
+        if (NAME##_unbox(value, &x) < 0) {                                     \
+            return -1;                                                         \
+        }                                                                      \
+        const CTYPE *a = (const CTYPE *)items;                                 \
+        switch (op) {                                                          \
+            case Py_LT: STATICARRAY_COMPARE_LOOP(<)                            \
+            case Py_LE: STATICARRAY_COMPARE_LOOP(<=)                           \
+            case Py_EQ: STATICARRAY_COMPARE_LOOP(==)                           \
+            case Py_NE: STATICARRAY_COMPARE_LOOP(!=)                           \
+            case Py_GT: STATICARRAY_COMPARE_LOOP(>)                            \
+            case Py_GE: STATICARRAY_COMPARE_LOOP(>=)                           \
+        }                                                                      \
+        return 0;                                                              \
+    }
+
+/* Integer sum and dot product, accumulated in ACC.  When SUM_CHECKED or
+ * DOT_CHECKED is 0 the reduction can't overflow for arrays of up to
+ * STATICARRAY_MAX_UNCHECKED elements and runs without overflow checks;
+ * otherwise overflowing ACC falls back to computing with Python ints. */
+#define STATICARRAY_INT_REDUCTIONS(NAME, CTYPE, ACC, BOX, SUM_CHECKED,         \
+                                   DOT_CHECKED)                                \
+    static PyObject *NAME##_sum(const char *items, Py_ssize_t n)               \
+    {                                                                          \
+        const CTYPE *a = (const CTYPE *)items;                                 \
+        ACC total = 0;                                                         \
+        if (!(SUM_CHECKED) && n <= STATICARRAY_MAX_UNCHECKED) {                \
+            for (Py_ssize_t i = 0; i < n; i++) {                               \
+                total += a[i];                                                 \
+            }                                                                  \
+            return BOX(total);                                                 \
+        }                                                                      \
+        for (Py_ssize_t i = 0; i < n; i++) {                                   \
+            if (__builtin_add_overflow(total, a[i], &total)) {                 \
+                return staticarray_sum_boxed(NAME##_getitem, items, n);        \
+            }                                                                  \
+        }                                                                      \
+        return BOX(total);                                                     \
+    }                                                                          \
+                                                                               \
+    static PyObject *NAME##_dot(const char *x, const char *y, Py_ssize_t n)    \
+    {                                                                          \
+        const CTYPE *a = (const CTYPE *)x;                                     \
+        const CTYPE *b = (const CTYPE *)y;                                     \
+        ACC total = 0;                                                         \
+        if (!(DOT_CHECKED) && n <= STATICARRAY_MAX_UNCHECKED) {                \
+            for (Py_ssize_t i = 0; i < n; i++) {                               \
+                total += (ACC)a[i] * (ACC)b[i];                                \
+            }                                                                  \
+            return BOX(total);                                                 \
+        }                                                                      \
+        for (Py_ssize_t i = 0; i < n; i++) {                                   \
+            ACC prod;                                                          \
+            if (__builtin_mul_overflow((ACC)a[i], (ACC)b[i], &prod) ||         \
+                __builtin_add_overflow(total, prod, &total)) {                 \
+                return staticarray_dot_boxed(NAME##_getitem, x, y, n);         \
+            }                                                                  \
+        }                                                                      \
+        return BOX(total);                                                     \
+    }
+
+#define STATICARRAY_DESCR(NAME, TYPE, TYPECODE)                                \
+    {                                                                          \
+        .type = (TYPE),                                                        \
+        .typecode = (TYPECODE),                                                \
+        .getitem = NAME##_getitem,                                             \
+        .unbox = NAME##_unbox,                                                 \
+        .fill = NAME##_fill,                                                   \
+        .sum = NAME##_sum,                                                     \
+        .min = NAME##_min,                                                     \
+        .max = NAME##_max,                                                     \
+        .dot = NAME##_dot,                                                     \
+        .add = NAME##_add,                                                     \
+        .mul = NAME##_mul,                                                     \
+        .compare = NAME##_compare,                                             \
+    }
+
+STATICARRAY_SIGNED_UNBOX(int8, int8_t, INT8_MIN, INT8_MAX)
+STATICARRAY_SIGNED_UNBOX(int16, int16_t, INT16_MIN, INT16_MAX)
+STATICARRAY_SIGNED_UNBOX(int32, int32_t, INT32_MIN, INT32_MAX)
+STATICARRAY_SIGNED_UNBOX(int64, int64_t, INT64_MIN, INT64_MAX)
+STATICARRAY_UNSIGNED_UNBOX(uint8, uint8_t, UINT8_MAX)
+STATICARRAY_UNSIGNED_UNBOX(uint16, uint16_t, UINT16_MAX)
+STATICARRAY_UNSIGNED_UNBOX(uint32, uint32_t, UINT32_MAX)
+STATICARRAY_UNSIGNED_UNBOX(uint64, uint64_t, UINT64_MAX)
+
+static int double_unbox(PyObject *value, void *out)
+{
+    double val = PyFloat_AsDouble(value);
+    if (val == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    *(double *)out = val;
+    return 0;
+}
+
+STATICARRAY_KERNELS(int8, int8_t, uint32_t, PyLong_FromLong)
+STATICARRAY_KERNELS(int16, int16_t, uint32_t, PyLong_FromLong)
+STATICARRAY_KERNELS(int32, int32_t, uint32_t, PyLong_FromLong)
+STATICARRAY_KERNELS(int64, int64_t, uint64_t, PyLong_FromLongLong)
+STATICARRAY_KERNELS(uint8, uint8_t, uint32_t, PyLong_FromUnsignedLong)
+STATICARRAY_KERNELS(uint16, uint16_t, uint32_t, PyLong_FromUnsignedLong)
+STATICARRAY_KERNELS(uint32, uint32_t, uint32_t, PyLong_FromUnsignedLong)
+STATICARRAY_KERNELS(uint64, uint64_t, uint64_t, PyLong_FromUnsignedLongLong)
+STATICARRAY_KERNELS(double, double, double, PyFloat_FromDouble)
+
+STATICARRAY_INT_REDUCTIONS(int8, int8_t, int64_t, PyLong_FromLongLong, 0, 0)
+STATICARRAY_INT_REDUCTIONS(int16, int16_t, int64_t, PyLong_FromLongLong, 0, 0)
+STATICARRAY_INT_REDUCTIONS(int32, int32_t, int64_t, PyLong_FromLongLong, 0, 1)
+STATICARRAY_INT_REDUCTIONS(int64, int64_t, int64_t, PyLong_FromLongLong, 1, 1)
+STATICARRAY_INT_REDUCTIONS(
+    uint8, uint8_t, uint64_t, PyLong_FromUnsignedLongLong, 0, 0)
+STATICARRAY_INT_REDUCTIONS(
+    uint16, uint16_t, uint64_t, PyLong_FromUnsignedLongLong, 0, 0)
+STATICARRAY_INT_REDUCTIONS(
+    uint32, uint32_t, uint64_t, PyLong_FromUnsignedLongLong, 0, 1)
+STATICARRAY_INT_REDUCTIONS(
+    uint64, uint64_t, uint64_t, PyLong_FromUnsignedLongLong, 1, 1)
+
+/* Float reductions add up in index order, which gives the same result as
+ * calling sum() on the boxed elements. */
+static PyObject *double_sum(const char *items, Py_ssize_t n)
+{
+    const double *a = (const double *)items;
+    double total = 0.0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        total += a[i];
+    }
+    return PyFloat_FromDouble(total);
+}
+
+static PyObject *double_dot(const char *x, const char *y, Py_ssize_t n)
+{
+    const double *a = (const double *)x;
+    const double *b = (const double *)y;
+    double total = 0.0;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        total += a[i] * b[i];
+    }
+    return PyFloat_FromDouble(total);
+}
 
 static void
 staticarray_dealloc(PyStaticArrayObject *op)
@@ -15,13 +342,13 @@ staticarray_dealloc(PyStaticArrayObject *op)
     Py_TYPE(op)->tp_free((PyObject *)op);
 }
 
-static PyStaticArrayObject* staticarray_alloc(Py_ssize_t size) {
-    PyStaticArrayObject *op = PyObject_GC_NewVar(PyStaticArrayObject, &PyStaticArray_Type, size);
+static PyStaticArrayObject* staticarray_alloc(PyTypeObject *type, Py_ssize_t size) {
+    PyStaticArrayObject *op = PyObject_GC_NewVar(PyStaticArrayObject, type, size);
     return op;
 }
 
 static inline void staticarray_zeroinitialize(PyStaticArrayObject* sa, Py_ssize_t size) {
-    memset(sa->ob_item, 0, size * PyStaticArray_Type.tp_itemsize);
+    memset(sa->ob_item, 0, size * Py_TYPE(sa)->tp_itemsize);
 }
 
 static PyObject *
@@ -42,14 +369,17 @@ staticarray_vectorcall(PyObject *type, PyObject * const*args,
     if (size == -1 && PyErr_Occurred()) {
         return NULL;
     }
-    PyStaticArrayObject *new = staticarray_alloc(size);
+    PyStaticArrayObject *new = staticarray_alloc((PyTypeObject *)type, size);
+    if (new == NULL) {
+        return NULL;
+    }
     staticarray_zeroinitialize(new, size);
     return (PyObject*)new;
 }
 
 static PyObject *
 staticarray_to_list(PyObject* sa) {
-    PyStaticArrayObject* array = (PyStaticArrayObject*)sa;
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(sa));
     PyObject *list = PyList_New(Py_SIZE(sa));
 
     if (list == NULL) {
@@ -57,8 +387,7 @@ staticarray_to_list(PyObject* sa) {
     }
 
     for (Py_ssize_t i = 0; i < Py_SIZE(sa); i++) {
-        ArrayItemType val = array->ob_item[i];
-        PyObject *boxed_val = PyLong_FromLong(val);
+        PyObject *boxed_val = descr->getitem(STATICARRAY_ITEMS(sa), i);
         if (boxed_val == NULL) {
             Py_DECREF(list);
             return NULL;
@@ -71,10 +400,17 @@ staticarray_to_list(PyObject* sa) {
 static PyObject *
 staticarray_repr(PyObject *sa)
 {
-    return PyUnicode_FromFormat(
-        "staticarray[%d](%R)",
+    PyObject *list = staticarray_to_list(sa);
+    if (list == NULL) {
+        return NULL;
+    }
+    PyObject *res = PyUnicode_FromFormat(
+        "%s[%zd](%R)",
+        Py_TYPE(sa)->tp_name,
         Py_SIZE(sa),
-        staticarray_to_list(sa));
+        list);
+    Py_DECREF(list);
+    return res;
 }
 
 static Py_ssize_t
@@ -92,10 +428,12 @@ staticarray_concat(PyStaticArrayObject *first, PyObject *other)
 {
     Py_ssize_t size;
     PyStaticArrayObject *np;
-    if (!PyStaticArray_CheckExact(other)) {
+    if (!Py_IS_TYPE(other, Py_TYPE(first))) {
         PyErr_Format(PyExc_TypeError,
-             "can only append staticarray (not \"%.200s\") to staticarray",
-                 Py_TYPE(other)->tp_name);
+             "can only append %.200s (not \"%.200s\") to %.200s",
+                 Py_TYPE(first)->tp_name,
+                 Py_TYPE(other)->tp_name,
+                 Py_TYPE(first)->tp_name);
         return NULL;
     }
     PyStaticArrayObject *second = (PyStaticArrayObject*)other;
@@ -103,16 +441,16 @@ staticarray_concat(PyStaticArrayObject *first, PyObject *other)
         return PyErr_NoMemory();
     }
     size = Py_SIZE(first) + Py_SIZE(second);
-    np = staticarray_alloc(size);
+    np = staticarray_alloc(Py_TYPE(first), size);
     if (np == NULL) {
         return NULL;
     }
-    Py_ssize_t itemsize = PyStaticArray_Type.tp_itemsize;
+    Py_ssize_t itemsize = Py_TYPE(first)->tp_itemsize;
     if (Py_SIZE(first) > 0) {
         memcpy(np->ob_item, first->ob_item, Py_SIZE(first) * itemsize);
     }
     if (Py_SIZE(second) > 0) {
-        memcpy(np->ob_item + Py_SIZE(first),
+        memcpy(STATICARRAY_ITEMS(np) + Py_SIZE(first) * itemsize,
                second->ob_item, Py_SIZE(second) * itemsize);
     }
     return (PyObject *)np;
@@ -124,27 +462,28 @@ staticarray_repeat(PyStaticArrayObject *array, Py_ssize_t n)
     Py_ssize_t size;
     PyStaticArrayObject *np;
     if (n < 0) {
-        return (PyObject*)staticarray_alloc(0);
+        return (PyObject*)staticarray_alloc(Py_TYPE(array), 0);
     }
     if ((Py_SIZE(array) != 0) && (n > PY_SSIZE_T_MAX / Py_SIZE(array))) {
         return PyErr_NoMemory();
     }
     size = Py_SIZE(array) * n;
-    np = (PyStaticArrayObject *)staticarray_alloc(size);
+    np = (PyStaticArrayObject *)staticarray_alloc(Py_TYPE(array), size);
     if (np == NULL)
         return NULL;
     if (size == 0)
         return (PyObject *)np;
 
-    Py_ssize_t oldsize = Py_SIZE(array);
-    Py_ssize_t newsize = oldsize * n;
-    Py_ssize_t itemsize = PyStaticArray_Type.tp_itemsize;
+    Py_ssize_t itemsize = Py_TYPE(array)->tp_itemsize;
+    Py_ssize_t oldsize = Py_SIZE(array) * itemsize;
+    Py_ssize_t newsize = size * itemsize;
+    char *items = STATICARRAY_ITEMS(np);
 
     Py_ssize_t done = oldsize;
-    memcpy(np->ob_item, array->ob_item, oldsize * itemsize);
+    memcpy(items, array->ob_item, oldsize);
     while (done < newsize) {
         Py_ssize_t ncopy = (done <= newsize-done) ? done : newsize-done;
-        memcpy(np->ob_item + done, np->ob_item, ncopy * itemsize);
+        memcpy(items + done, items, ncopy);
         done += ncopy;
     }
 
@@ -159,8 +498,8 @@ staticarray_getitem(PyStaticArrayObject *array, Py_ssize_t index)
         PyErr_SetString(PyExc_IndexError, "array index out of range");
         return NULL;
     }
-    assert (PyStaticArray_Type.tp_itemsize == sizeof(long));
-    return PyLong_FromLong(array->ob_item[index]);
+    return staticarray_descr(Py_TYPE(array))->getitem(
+        STATICARRAY_ITEMS(array), index);
 }
 
 static int
@@ -171,18 +510,186 @@ staticarray_setitem(PyStaticArrayObject *array, Py_ssize_t index, PyObject* valu
         PyErr_SetString(PyExc_IndexError, "array index out of range");
         return -1;
     }
-    assert (PyStaticArray_Type.tp_itemsize == sizeof(long));
-    ArrayItemType val = PyLong_AsLong(value);
-    if (val == -1 && PyErr_Occurred()) {
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError,
+                        "staticarray doesn't support item deletion");
+        return -1;
+    }
+    return staticarray_descr(Py_TYPE(array))->unbox(
+        value, STATICARRAY_ITEMS(array) + index * Py_TYPE(array)->tp_itemsize);
+}
+
+static int
+staticarray_check_operand(PyStaticArrayObject *array, PyObject *other)
+{
+    if (!Py_IS_TYPE(other, Py_TYPE(array))) {
+        PyErr_Format(PyExc_TypeError,
+                     "expected %.200s, got %.200s",
+                     Py_TYPE(array)->tp_name,
+                     Py_TYPE(other)->tp_name);
+        return -1;
+    }
+    if (Py_SIZE(other) != Py_SIZE(array)) {
+        PyErr_Format(PyExc_ValueError,
+                     "staticarray lengths differ (%zd != %zd)",
+                     Py_SIZE(array),
+                     Py_SIZE(other));
         return -1;
     }
-    array->ob_item[index] = val;
     return 0;
 }
 
+static PyObject *
+staticarray_fill(PyStaticArrayObject *array, PyObject *value)
+{
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    if (descr->fill(STATICARRAY_ITEMS(array), Py_SIZE(array), value) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+staticarray_copy(PyStaticArrayObject *array, PyObject *Py_UNUSED(ignored))
+{
+    PyStaticArrayObject *np = staticarray_alloc(Py_TYPE(array), Py_SIZE(array));
+    if (np == NULL) {
+        return NULL;
+    }
+    memcpy(np->ob_item,
+           array->ob_item,
+           Py_SIZE(array) * Py_TYPE(array)->tp_itemsize);
+    return (PyObject *)np;
+}
+
+static PyObject *
+staticarray_sum(PyStaticArrayObject *array, PyObject *Py_UNUSED(ignored))
+{
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    return descr->sum(STATICARRAY_ITEMS(array), Py_SIZE(array));
+}
+
+static PyObject *
+staticarray_min(PyStaticArrayObject *array, PyObject *Py_UNUSED(ignored))
+{
+    if (Py_SIZE(array) == 0) {
+        PyErr_SetString(PyExc_ValueError, "min() of an empty staticarray");
+        return NULL;
+    }
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    return descr->min(STATICARRAY_ITEMS(array), Py_SIZE(array));
+}
+
+static PyObject *
+staticarray_max(PyStaticArrayObject *array, PyObject *Py_UNUSED(ignored))
+{
+    if (Py_SIZE(array) == 0) {
+        PyErr_SetString(PyExc_ValueError, "max() of an empty staticarray");
+        return NULL;
+    }
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    return descr->max(STATICARRAY_ITEMS(array), Py_SIZE(array));
+}
+
+static PyObject *
+staticarray_dot(PyStaticArrayObject *array, PyObject *other)
+{
+    if (staticarray_check_operand(array, other) < 0) {
+        return NULL;
+    }
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    return descr->dot(
+        STATICARRAY_ITEMS(array), STATICARRAY_ITEMS(other), Py_SIZE(array));
+}
+
+static PyObject *
+staticarray_elementwise(
+    PyStaticArrayObject *array,
+    PyObject *other,
+    void (*kernel)(char *, const char *, const char *, Py_ssize_t))
+{
+    if (staticarray_check_operand(array, other) < 0) {
+        return NULL;
+    }
+    PyStaticArrayObject *np = staticarray_alloc(Py_TYPE(array), Py_SIZE(array));
+    if (np == NULL) {
+        return NULL;
+    }
+    kernel(STATICARRAY_ITEMS(np),
+           STATICARRAY_ITEMS(array),
+           STATICARRAY_ITEMS(other),
+           Py_SIZE(array));
+    return (PyObject *)np;
+}
+
+static PyObject *
+staticarray_add(PyStaticArrayObject *array, PyObject *other)
+{
+    return staticarray_elementwise(
+        array, other, staticarray_descr(Py_TYPE(array))->add);
+}
+
+static PyObject *
+staticarray_mul(PyStaticArrayObject *array, PyObject *other)
+{
+    return staticarray_elementwise(
+        array, other, staticarray_descr(Py_TYPE(array))->mul);
+}
+
+static PyTypeObject staticarray_uint8_type;
+
+static PyObject *
+staticarray_compare(PyStaticArrayObject *array,
+                    PyObject *const *args,
+                    Py_ssize_t nargs)
+{
+    static const char *const op_names[] = {"<", "<=", "==", "!=", ">", ">="};
+
+    if (!_PyArg_CheckPositional("compare", nargs, 2, 2)) {
+        return NULL;
+    }
+    int op = -1;
+    if (PyUnicode_Check(args[0])) {
+        for (int i = Py_LT; i <= Py_GE; i++) {
+            if (PyUnicode_CompareWithASCIIString(args[0], op_names[i]) == 0) {
+                op = i;
+                break;
+            }
+        }
+    }
+    if (op == -1) {
+        PyErr_Format(PyExc_ValueError, "unknown comparison operator %R", args[0]);
+        return NULL;
+    }
+
+    PyStaticArrayObject *mask =
+        staticarray_alloc(&staticarray_uint8_type, Py_SIZE(array));
+    if (mask == NULL) {
+        return NULL;
+    }
+    const StaticArrayDescr *descr = staticarray_descr(Py_TYPE(array));
+    if (descr->compare((uint8_t *)mask->ob_item,
+                       STATICARRAY_ITEMS(array),
+                       Py_SIZE(array),
+                       op,
+                       args[1]) < 0) {
+        Py_DECREF(mask);
+        return NULL;
+    }
+    return (PyObject *)mask;
+}
+
 PyObject *
 staticarray___class_getitem__(PyObject *origin, PyObject *args)
 {
+    if (PyType_Check(args)) {
+        int typecode = _PyClassLoader_GetTypeCode((PyTypeObject *)args);
+        PyTypeObject *type = _Ci_StaticArray_TypeForElement(typecode);
+        if (type != NULL) {
+            Py_INCREF(type);
+            return (PyObject *)type;
+        }
+    }
     Py_INCREF(origin);
     return origin;
 }
@@ -203,6 +710,9 @@ PyObject *staticarray_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
         return NULL;
     }
     PyStaticArrayObject *new = (PyStaticArrayObject *)type->tp_alloc(type, size);
+    if (new == NULL) {
+        return NULL;
+    }
     staticarray_zeroinitialize(new, size);
     return (PyObject*)new;
 }
@@ -217,27 +727,92 @@ static PySequenceMethods staticarray_as_sequence = {
 
 static PyMethodDef staticarray_methods[] = {
     {"__class_getitem__", (PyCFunction)staticarray___class_getitem__, METH_O|METH_CLASS, PyDoc_STR("")},
+    {"fill", (PyCFunction)staticarray_fill, METH_O,
+     PyDoc_STR("Set every element of the array to the given value.")},
+    {"copy", (PyCFunction)staticarray_copy, METH_NOARGS,
+     PyDoc_STR("Return a copy of the array.")},
+    {"sum", (PyCFunction)staticarray_sum, METH_NOARGS,
+     PyDoc_STR("Return the sum of the elements of the array.")},
+    {"min", (PyCFunction)staticarray_min, METH_NOARGS,
+     PyDoc_STR("Return the smallest element of the array.")},
+    {"max", (PyCFunction)staticarray_max, METH_NOARGS,
+     PyDoc_STR("Return the largest element of the array.")},
+    {"dot", (PyCFunction)staticarray_dot, METH_O,
+     PyDoc_STR("Return the dot product with an array of the same type and length.")},
+    {"add", (PyCFunction)staticarray_add, METH_O,
+     PyDoc_STR("Return a new array holding the elementwise sum with another array.")},
+    {"mul", (PyCFunction)staticarray_mul, METH_O,
+     PyDoc_STR("Return a new array holding the elementwise product with another array.")},
+    {"compare", (PyCFunction)(void(*)(void))staticarray_compare, METH_FASTCALL,
+     PyDoc_STR("compare(op, value)\n\nReturn a staticarray[uint8] mask holding 1 "
+               "where `element op value` is true and 0 elsewhere.")},
     {NULL,              NULL}   /* sentinel */
 };
 
-PyTypeObject PyStaticArray_Type = {
-    PyVarObject_HEAD_INIT(&PyType_Type, 0)
-    "staticarray",
-    .tp_alloc = PyType_GenericAlloc,
-    .tp_basicsize = sizeof(PyStaticArrayObject) - sizeof(PyObject *),
-    .tp_itemsize = sizeof(ArrayItemType),
-    .tp_dealloc = (destructor)staticarray_dealloc,
-    .tp_flags = Py_TPFLAGS_DEFAULT |
-        Py_TPFLAGS_HAVE_GC,
-    .tp_free = PyObject_GC_Del,
-    .tp_vectorcall = staticarray_vectorcall,
-    .tp_repr = staticarray_repr,
-    .tp_methods = staticarray_methods,
-    .tp_new = staticarray_new,
-    .tp_as_sequence = &staticarray_as_sequence,
-    .tp_traverse = staticarray_traverse,
+#define STATICARRAY_TYPE(NAME, CTYPE)                                          \
+    {                                                                          \
+        PyVarObject_HEAD_INIT(&PyType_Type, 0)                                 \
+        NAME,                                                                  \
+        .tp_alloc = PyType_GenericAlloc,                                       \
+        .tp_basicsize = sizeof(PyStaticArrayObject) - sizeof(PyObject *),     \
+        .tp_itemsize = sizeof(CTYPE),                                          \
+        .tp_dealloc = (destructor)staticarray_dealloc,                         \
+        .tp_flags = Py_TPFLAGS_DEFAULT |                                       \
+            Py_TPFLAGS_HAVE_GC,                                                \
+        .tp_free = PyObject_GC_Del,                                            \
+        .tp_vectorcall = staticarray_vectorcall,                               \
+        .tp_repr = staticarray_repr,                                           \
+        .tp_methods = staticarray_methods,                                     \
+        .tp_new = staticarray_new,                                             \
+        .tp_as_sequence = &staticarray_as_sequence,                            \
+        .tp_traverse = staticarray_traverse,                                   \
+    }
+
+PyTypeObject PyStaticArray_Type = STATICARRAY_TYPE("staticarray", int64_t);
+static PyTypeObject staticarray_int8_type =
+    STATICARRAY_TYPE("staticarray[int8]", int8_t);
+static PyTypeObject staticarray_int16_type =
+    STATICARRAY_TYPE("staticarray[int16]", int16_t);
+static PyTypeObject staticarray_int32_type =
+    STATICARRAY_TYPE("staticarray[int32]", int32_t);
+static PyTypeObject staticarray_uint8_type =
+    STATICARRAY_TYPE("staticarray[uint8]", uint8_t);
+static PyTypeObject staticarray_uint16_type =
+    STATICARRAY_TYPE("staticarray[uint16]", uint16_t);
+static PyTypeObject staticarray_uint32_type =
+    STATICARRAY_TYPE("staticarray[uint32]", uint32_t);
+static PyTypeObject staticarray_uint64_type =
+    STATICARRAY_TYPE("staticarray[uint64]", uint64_t);
+static PyTypeObject staticarray_double_type =
+    STATICARRAY_TYPE("staticarray[double]", double);
+
+/* The int64 array comes first since it's by far the most common. */
+static const StaticArrayDescr staticarray_descrs[] = {
+    STATICARRAY_DESCR(int64, &PyStaticArray_Type, TYPED_INT64),
+    STATICARRAY_DESCR(int8, &staticarray_int8_type, TYPED_INT8),
+    STATICARRAY_DESCR(int16, &staticarray_int16_type, TYPED_INT16),
+    STATICARRAY_DESCR(int32, &staticarray_int32_type, TYPED_INT32),
+    STATICARRAY_DESCR(uint8, &staticarray_uint8_type, TYPED_UINT8),
+    STATICARRAY_DESCR(uint16, &staticarray_uint16_type, TYPED_UINT16),
+    STATICARRAY_DESCR(uint32, &staticarray_uint32_type, TYPED_UINT32),
+    STATICARRAY_DESCR(uint64, &staticarray_uint64_type, TYPED_UINT64),
+    STATICARRAY_DESCR(double, &staticarray_double_type, TYPED_DOUBLE),
 };
 
+#define STATICARRAY_NUM_KINDS \
+    ((int)(sizeof(staticarray_descrs) / sizeof(staticarray_descrs[0])))
+
+static const StaticArrayDescr *
+staticarray_descr(PyTypeObject *type)
+{
+    for (int i = 0; i < STATICARRAY_NUM_KINDS; i++) {
+        if (staticarray_descrs[i].type == type) {
+            return &staticarray_descrs[i];
+        }
+    }
+    return NULL;
+}
+
 /** StaticArray internal C-API **/
 
 int _Ci_StaticArray_Set(PyObject *array, Py_ssize_t index, PyObject *value) {
@@ -249,3 +824,29 @@ PyObject* _Ci_StaticArray_Get(PyObject *array, Py_ssize_t index) {
     PyStaticArrayObject *sa = (PyStaticArrayObject *)array;
     return staticarray_getitem(sa, index);
 }
+
+int _Ci_StaticArray_Check(PyObject *op) {
+    return _Ci_StaticArray_CheckType(Py_TYPE(op));
+}
+
+int _Ci_StaticArray_CheckType(PyTypeObject *type) {
+    return staticarray_descr(type) != NULL;
+}
+
+PyTypeObject *_Ci_StaticArray_TypeForElement(int typecode) {
+    for (int i = 0; i < STATICARRAY_NUM_KINDS; i++) {
+        if (staticarray_descrs[i].typecode == typecode) {
+            return staticarray_descrs[i].type;
+        }
+    }
+    return NULL;
+}
+
+int _Ci_StaticArray_ReadyTypes(void) {
+    for (int i = 0; i < STATICARRAY_NUM_KINDS; i++) {
+        if (PyType_Ready(staticarray_descrs[i].type) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
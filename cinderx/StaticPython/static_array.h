@@ -11,6 +11,8 @@ extern "C" {
 
 CiAPI_DATA(PyTypeObject) PyStaticArray_Type;
 #define PyStaticArray_CheckExact(op) Py_IS_TYPE(op, &PyStaticArray_Type)
+/* True for a staticarray of any element type. */
+#define PyStaticArray_Check(op) _Ci_StaticArray_Check((PyObject *)(op))
 
 typedef struct {
     PyObject_VAR_HEAD
@@ -21,6 +23,13 @@ typedef struct {
 
 CiAPI_FUNC(int) _Ci_StaticArray_Set(PyObject *array, Py_ssize_t index, PyObject *value);
 CiAPI_FUNC(PyObject*) _Ci_StaticArray_Get(PyObject *array, Py_ssize_t index);
+CiAPI_FUNC(int) _Ci_StaticArray_Check(PyObject *op);
+/* True if type is the staticarray type of some element kind. */
+CiAPI_FUNC(int) _Ci_StaticArray_CheckType(PyTypeObject *type);
+/* Returns the staticarray type holding elements of the given TYPED_* type, or
+ * NULL if arrays of that element type aren't supported. */
+CiAPI_FUNC(PyTypeObject*) _Ci_StaticArray_TypeForElement(int typecode);
+CiAPI_FUNC(int) _Ci_StaticArray_ReadyTypes(void);
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,18 @@ static PyObject *clear_all_shadow_caches(PyObject *, PyObject *) {
   Py_RETURN_NONE;
 }
 
+static PyObject *get_shadow_code(PyObject *, PyObject *arg) {
+  if (!PyCode_Check(arg)) {
+    PyErr_SetString(PyExc_TypeError, "expected a code object");
+    return nullptr;
+  }
+  _PyShadowCode *shadow = ((PyCodeObject *)arg)->co_mutable->shadow;
+  if (shadow == nullptr) {
+    Py_RETURN_NONE;
+  }
+  return PyBytes_FromStringAndSize((const char *)shadow->code, shadow->len);
+}
+
 PyDoc_STRVAR(strict_module_patch_doc, "strict_module_patch(mod, name, value)\n\
 Patch a field in a strict module\n\
 Requires patching to be enabled");
@@ -236,6 +248,45 @@ static PyObject *cinder_get_parallel_gc_settings(PyObject *,
   return Cinder_GetParallelGCSettings();
 }
 
+PyDoc_STRVAR(cinder_set_parallel_gc_slice_budget_doc,
+             "set_parallel_gc_slice_budget(budget_us)\n\
+\n\
+Collect the oldest generation incrementally, in slices that aim to pause for\n\
+at most `budget_us` microseconds. Each collection of the middle generation\n\
+also scans a slice of the oldest one. Full collections still happen, but much\n\
+less often. Pass 0 to go back to collecting the oldest generation at once.\n\
+\n\
+A RuntimeError is raised if parallel gc is not enabled, and a ValueError if\n\
+the budget is negative.");
+static PyObject *cinder_set_parallel_gc_slice_budget(PyObject *,
+                                                     PyObject *arg) {
+  long long budget_us = PyLong_AsLongLong(arg);
+  if (budget_us == -1 && PyErr_Occurred()) {
+    return nullptr;
+  }
+  if (Cinder_SetParallelGCSliceBudget(budget_us) < 0) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(cinder_get_parallel_gc_stats_doc, "get_parallel_gc_stats()\n\
+\n\
+Return statistics about incremental collection by the parallel garbage\n\
+collector, or None if the parallel collector is not enabled.\n\
+\n\
+Returns a dictionary with the following keys:\n\
+\n\
+    slice_budget_us: Target pause per slice, or 0 if not incremental.\n\
+    slices: Number of slices of the oldest generation collected.\n\
+    slice_objects: Total number of objects scanned by those slices.\n\
+    rotations: Number of times the slices have covered the oldest generation.\n\
+    last_slice_us, max_slice_us, total_slice_us: Pause times of collections\n\
+        that included a slice.");
+static PyObject *cinder_get_parallel_gc_stats(PyObject *, PyObject *) {
+  return Cinder_GetParallelGCStats();
+}
+
 static PyObject*
 compile_perf_trampoline_pre_fork(PyObject *, PyObject *) {
     _PyPerfTrampoline_CompilePerfTrampolinePreFork();
@@ -409,6 +460,9 @@ static void shadowcode_code_sizeof(struct _PyShadowCode *shadow, Py_ssize_t *res
             shadow->polymorphic_caches_size;
     *res += sizeof(_FieldCache) * shadow->field_cache_size;
     *res += sizeof(_Py_CODEUNIT) * shadow->len;
+    if (shadow->quicken_misses != nullptr) {
+      *res += shadow->len / sizeof(_Py_CODEUNIT);
+    }
 }
 
 static int get_current_code_flags(PyThreadState* tstate) {
@@ -705,6 +759,8 @@ static PyMethodDef _cinderx_methods[] = {
      "Clears caches associated with the JIT.  This may have a negative effect "
      "on performance of existing JIT compiled code."},
     {"clear_all_shadow_caches", clear_all_shadow_caches, METH_NOARGS, ""},
+    {"_get_shadow_code", get_shadow_code, METH_O,
+     "Return the shadow byte code of a code object, or None if it has none."},
     {"strict_module_patch", strict_module_patch, METH_VARARGS,
      strict_module_patch_doc},
     {"strict_module_patch_delete", strict_module_patch_delete, METH_VARARGS,
@@ -740,6 +796,10 @@ static PyMethodDef _cinderx_methods[] = {
      cinder_disable_parallel_gc_doc},
     {"get_parallel_gc_settings", cinder_get_parallel_gc_settings, METH_NOARGS,
      cinder_get_parallel_gc_settings_doc},
+    {"set_parallel_gc_slice_budget", cinder_set_parallel_gc_slice_budget,
+     METH_O, cinder_set_parallel_gc_slice_budget_doc},
+    {"get_parallel_gc_stats", cinder_get_parallel_gc_stats, METH_NOARGS,
+     cinder_get_parallel_gc_stats_doc},
     {"_compile_perf_trampoline_pre_fork", compile_perf_trampoline_pre_fork,
      METH_NOARGS, "Compile perf-trampoline entries before forking"},
     {"_is_compile_perf_trampoline_pre_fork_enabled",
@@ -109,6 +109,7 @@
     "Jit/lir/instruction.cpp",
     "Jit/lir/operand.cpp",
     "Jit/lir/parser.cpp",
+    "Jit/lir/peephole.cpp",
     "Jit/lir/postalloc.cpp",
     "Jit/lir/postgen.cpp",
     "Jit/lir/printer.cpp",